@@ -56,6 +56,63 @@
 #include <pbs_version.h>
 
 
+/**
+ * @brief
+ *	delete one job, used for the jobs a job list request could not find
+ *	and when the server does not support job list requests
+ *
+ * @param[in] job_id_out - job id
+ * @param[in] server_out - server of the job
+ * @param[in] warg - extend string of the request
+ * @param[in] located - TRUE if the job was already looked for
+ * @param[in,out] num_deleted - count of deleted jobs, may be NULL
+ *
+ * @return - int
+ * @retval   0 - success
+ * @retval  !0 - pbs_errno
+ *
+ */
+static int
+delete_job(char *job_id_out, char *server_out, char *warg, int located, int *num_deleted)
+{
+	int connect;
+	int stat=0;
+	int any_failed=0;
+	char rmt_server[MAXSERVERNAME];
+
+cnt:
+	connect = cnt2server(server_out);
+	if (connect <= 0) {
+		fprintf(stderr, "qdel: cannot connect to server %s (errno=%d)\n",
+			pbs_server, pbs_errno);
+		return pbs_errno;
+	}
+
+	stat = pbs_deljob(connect, job_id_out, warg);
+
+	/*
+	 * The counter num_deleted should not be updated  when a history job is deleted .
+	 */
+	if ((num_deleted != NULL) && (pbs_errno != PBSE_HISTJOBDELETED))
+		(*num_deleted)++;
+	if (stat && (pbs_errno != PBSE_UNKJOBID && pbs_errno != PBSE_HISTJOBDELETED)) {
+		prt_job_err("qdel", connect, job_id_out);
+		any_failed = pbs_errno;
+	} else if (stat && (pbs_errno == PBSE_UNKJOBID) && !located) {
+		located = TRUE;
+		if (locate_job(job_id_out, server_out, rmt_server)) {
+			pbs_disconnect(connect);
+			server_out = rmt_server;
+			goto cnt;
+		}
+		prt_job_err("qdel", connect, job_id_out);
+		any_failed = pbs_errno;
+	}
+
+	pbs_disconnect(connect);
+	return any_failed;
+}
+
 int
 main(argc, argv, envp) /* qdel */
 int argc;
@@ -74,13 +131,19 @@ char **envp;
 
 	char job_id_out[PBS_MAXCLTJOBID];
 	char server_out[MAXSERVERNAME];
+	char next_job_id[PBS_MAXCLTJOBID];
+	char next_server[MAXSERVERNAME];
 	char rmt_server[MAXSERVERNAME];
+	char **jobids;
+	struct batch_jobresult *results;
+	struct batch_jobresult *pres;
 
 	char *keystr, *valuestr;
 	int dfltmail = 0;
 	int dfltmailflg = FALSE;
 	int mails;				/* number of emails we can send */
 	int num_deleted = 0;
+	int nomail = FALSE;
 	struct attrl *attr;
 	struct batch_status *ss = NULL;
 
@@ -161,23 +224,47 @@ char **envp;
 		exit(1);
 	}
 
-	for (; optind < argc; optind++) {
+	/*
+	 * Jobs given one after the other for the same server are deleted
+	 * with one job list request
+	 */
+	jobids = (char **)malloc(argc * sizeof(char *));
+	if (jobids == NULL) {
+		fprintf(stderr, "qdel: out of memory\n");
+		exit(1);
+	}
+
+	while (optind < argc) {
 		int connect;
 		int stat=0;
-		int located = FALSE;
+		int njobs=0;
+		int ndone;
+		int nsend;
+		int i;
 
-		strcpy(job_id, argv[optind]);
+		strcpy(job_id, argv[optind++]);
 		if (get_server(job_id, job_id_out, server_out)) {
 			fprintf(stderr, "qdel: illegally formed job identifier: %s\n", job_id);
 			any_failed = 1;
 			continue;
 		}
-cnt:
+		jobids[njobs++] = strdup(job_id_out);
+		while (optind < argc) {
+			strcpy(job_id, argv[optind]);
+			if (get_server(job_id, next_job_id, next_server) ||
+				strcmp(next_server, server_out))
+				break;
+			jobids[njobs++] = strdup(next_job_id);
+			optind++;
+		}
+
 		connect = cnt2server(server_out);
 		if (connect <= 0) {
 			fprintf(stderr, "qdel: cannot connect to server %s (errno=%d)\n",
 				pbs_server, pbs_errno);
 			any_failed = pbs_errno;
+			for (i = 0; i < njobs; i++)
+				free(jobids[i]);
 			continue;
 		}
 
@@ -208,48 +295,80 @@ cnt:
 			}
 		}
 
-		/* when jobs to be deleted over 1000, mail function is disabled
-		 * by sending the flag below to server via its extend field:
-		 *   "" -- delete a job with a mail
-		 *   "nomail" -- delete a job without sending a mail
-		 *   "force" -- force job to be deleted with a mail
-		 *   "nomailforce" -- force job to be deleted without sending a mail
-		 *   "nomaildeletehist" -- delete history of a job without sending mail
-		 *   "nomailforcedeletehist" -- force delete history of a job without sending mail.
-		 */
-		mails = dfltmail ? dfltmail : 1000;
-		if (num_deleted == mails) {
-
-			strcat(warg1, warg);
-			strcpy(warg, warg1);
+		for (ndone = 0; ndone < njobs; ndone += nsend) {
 
+			/* when jobs to be deleted over 1000, mail function is disabled
+			 * by sending the flag below to server via its extend field:
+			 *   "" -- delete a job with a mail
+			 *   "nomail" -- delete a job without sending a mail
+			 *   "force" -- force job to be deleted with a mail
+			 *   "nomailforce" -- force job to be deleted without sending a mail
+			 *   "nomaildeletehist" -- delete history of a job without sending mail
+			 *   "nomailforcedeletehist" -- force delete history of a job without sending mail.
+			 * A job list request stops at the job the mail is disabled from.
+			 */
+			mails = dfltmail ? dfltmail : 1000;
+			if (!nomail && (num_deleted >= mails)) {
 
-		}
+				strcat(warg1, warg);
+				strcpy(warg, warg1);
+				nomail = TRUE;
 
+			}
+			nsend = njobs - ndone;
+			if (!nomail && (nsend > mails - num_deleted))
+				nsend = mails - num_deleted;
 
-		stat = pbs_deljob(connect, job_id_out, warg);
-
-		/*
-		 * The counter num_deleted should not be updated  when a history job is deleted .
-		 */
-		if (pbs_errno != PBSE_HISTJOBDELETED)
-			num_deleted++;
-		if (stat && (pbs_errno != PBSE_UNKJOBID && pbs_errno != PBSE_HISTJOBDELETED)) {
-			prt_job_err("qdel", connect, job_id_out);
-			any_failed = pbs_errno;
-		} else if (stat && (pbs_errno == PBSE_UNKJOBID) && !located) {
-			located = TRUE;
-			if (locate_job(job_id_out, server_out, rmt_server)) {
+			results = NULL;
+			stat = pbs_deljoblist(connect, jobids + ndone, nsend, warg, &results);
+			if (stat == PBSE_UNKREQ) {
+				/* server does not know job lists, delete one by one */
 				pbs_disconnect(connect);
-				strcpy(server_out, rmt_server);
-				goto cnt;
+				connect = -1;
+				for (i = ndone; i < njobs; i++) {
+					mails = dfltmail ? dfltmail : 1000;
+					if (!nomail && (num_deleted >= mails)) {
+						strcat(warg1, warg);
+						strcpy(warg, warg1);
+						nomail = TRUE;
+					}
+					if ((stat = delete_job(jobids[i], server_out, warg, FALSE, &num_deleted)) != 0)
+						any_failed = stat;
+				}
+				break;
+			} else if (stat) {
+				for (i = ndone; i < ndone + nsend; i++)
+					prt_job_err("qdel", connect, jobids[i]);
+				any_failed = stat;
 			}
-			prt_job_err("qdel", connect, job_id_out);
-			any_failed = pbs_errno;
+
+			/*
+			 * The counter num_deleted should not be updated  when a history job is deleted .
+			 */
+			num_deleted += nsend;
+			for (pres = results; pres; pres = pres->next) {
+				if (pres->code == PBSE_HISTJOBDELETED) {
+					num_deleted--;
+					continue;
+				}
+				if ((pres->code == PBSE_UNKJOBID) &&
+					locate_job(pres->name, server_out, rmt_server)) {
+					if ((stat = delete_job(pres->name, rmt_server, warg, TRUE, NULL)) != 0)
+						any_failed = stat;
+					continue;
+				}
+				prt_job_result("qdel", pres);
+				any_failed = pres->code;
+			}
+			pbs_jobresultfree(results);
 		}
 
-		pbs_disconnect(connect);
+		if (connect > 0)
+			pbs_disconnect(connect);
+		for (i = 0; i < njobs; i++)
+			free(jobids[i]);
 	}
+	free(jobids);
 
 	/*cleanup security library initializations before exiting*/
 	CS_close_app();
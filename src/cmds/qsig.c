@@ -56,6 +56,56 @@
 #include <pbs_version.h>
 
 
+/**
+ * @brief
+ *	signal one job, used for the jobs a job list request could not find
+ *	and when the server does not support job list requests
+ *
+ * @param[in] job_id_out - job id
+ * @param[in] server_out - server of the job
+ * @param[in] sig_string - signal
+ * @param[in] located - TRUE if the job was already looked for
+ *
+ * @return - int
+ * @retval   0 - success
+ * @retval  !0 - pbs_errno
+ *
+ */
+static int
+signal_job(char *job_id_out, char *server_out, char *sig_string, int located)
+{
+	int connect;
+	int stat=0;
+	int any_failed=0;
+	char rmt_server[MAXSERVERNAME];
+
+cnt:
+	connect = cnt2server(server_out);
+	if (connect <= 0) {
+		fprintf(stderr, "qsig: cannot connect to server %s (errno=%d)\n",
+			pbs_server, pbs_errno);
+		return pbs_errno;
+	}
+
+	stat = pbs_sigjob(connect, job_id_out, sig_string, NULL);
+	if (stat && (pbs_errno != PBSE_UNKJOBID)) {
+		prt_job_err("qsig", connect, job_id_out);
+		any_failed = pbs_errno;
+	} else if (stat && (pbs_errno == PBSE_UNKJOBID) && !located) {
+		located = TRUE;
+		if (locate_job(job_id_out, server_out, rmt_server)) {
+			pbs_disconnect(connect);
+			server_out = rmt_server;
+			goto cnt;
+		}
+		prt_job_err("qsig", connect, job_id_out);
+		any_failed = pbs_errno;
+	}
+
+	pbs_disconnect(connect);
+	return any_failed;
+}
+
 int
 main(int argc, char **argv, char **envp) /* qsig */
 {
@@ -67,7 +117,12 @@ main(int argc, char **argv, char **envp) /* qsig */
 
 	char job_id_out[PBS_MAXCLTJOBID];
 	char server_out[MAXSERVERNAME];
+	char next_job_id[PBS_MAXCLTJOBID];
+	char next_server[MAXSERVERNAME];
 	char rmt_server[MAXSERVERNAME];
+	char **jobids;
+	struct batch_jobresult *results;
+	struct batch_jobresult *pres;
 
 #define MAX_SIGNAL_TYPE_LEN 32
 	static char sig_string[MAX_SIGNAL_TYPE_LEN+1] = "SIGTERM";
@@ -106,43 +161,78 @@ main(int argc, char **argv, char **envp) /* qsig */
 		exit(2);
 	}
 
-	for (; optind < argc; optind++) {
+	/*
+	 * Jobs given one after the other for the same server are signaled
+	 * with one job list request
+	 */
+	jobids = (char **)malloc(argc * sizeof(char *));
+	if (jobids == NULL) {
+		fprintf(stderr, "qsig: out of memory\n");
+		exit(2);
+	}
+
+	while (optind < argc) {
 		int connect;
 		int stat=0;
-		int located = FALSE;
+		int njobs=0;
+		int i;
 
-		strcpy(job_id, argv[optind]);
+		strcpy(job_id, argv[optind++]);
 		if (get_server(job_id, job_id_out, server_out)) {
 			fprintf(stderr, "qsig: illegally formed job identifier: %s\n", job_id);
 			any_failed = 1;
 			continue;
 		}
-cnt:
+		jobids[njobs++] = strdup(job_id_out);
+		while (optind < argc) {
+			strcpy(job_id, argv[optind]);
+			if (get_server(job_id, next_job_id, next_server) ||
+				strcmp(next_server, server_out))
+				break;
+			jobids[njobs++] = strdup(next_job_id);
+			optind++;
+		}
+
 		connect = cnt2server(server_out);
 		if (connect <= 0) {
 			fprintf(stderr, "qsig: cannot connect to server %s (errno=%d)\n",
 				pbs_server, pbs_errno);
 			any_failed = pbs_errno;
-			continue;
-		}
-
-		stat = pbs_sigjob(connect, job_id_out, sig_string, NULL);
-		if (stat && (pbs_errno != PBSE_UNKJOBID)) {
-			prt_job_err("qsig", connect, job_id_out);
-			any_failed = pbs_errno;
-		} else if (stat && (pbs_errno == PBSE_UNKJOBID) && !located) {
-			located = TRUE;
-			if (locate_job(job_id_out, server_out, rmt_server)) {
+		} else {
+			results = NULL;
+			stat = pbs_sigjoblist(connect, jobids, njobs, sig_string, NULL, &results);
+			if (stat == PBSE_UNKREQ) {
+				/* server does not know job lists, signal one by one */
 				pbs_disconnect(connect);
-				strcpy(server_out, rmt_server);
-				goto cnt;
+				connect = -1;
+				for (i = 0; i < njobs; i++) {
+					if ((stat = signal_job(jobids[i], server_out, sig_string, FALSE)) != 0)
+						any_failed = stat;
+				}
+			} else if (stat) {
+				for (i = 0; i < njobs; i++)
+					prt_job_err("qsig", connect, jobids[i]);
+				any_failed = stat;
 			}
-			prt_job_err("qsig", connect, job_id_out);
-			any_failed = pbs_errno;
+			for (pres = results; pres; pres = pres->next) {
+				if ((pres->code == PBSE_UNKJOBID) &&
+					locate_job(pres->name, server_out, rmt_server)) {
+					if ((stat = signal_job(pres->name, rmt_server, sig_string, TRUE)) != 0)
+						any_failed = stat;
+					continue;
+				}
+				prt_job_result("qsig", pres);
+				any_failed = pres->code;
+			}
+			pbs_jobresultfree(results);
+			if (connect > 0)
+				pbs_disconnect(connect);
 		}
 
-		pbs_disconnect(connect);
+		for (i = 0; i < njobs; i++)
+			free(jobids[i]);
 	}
+	free(jobids);
 
 	/*cleanup security library initializations before exiting*/
 	CS_close_app();
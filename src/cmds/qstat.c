@@ -2167,7 +2167,8 @@ main(int argc, char **argv, char **envp) /* qstat */
 	char *conflict = "qstat: conflicting options.\n";
 	char *pc;
 	int located = FALSE;
-	char extend[4];
+	char extend[256];
+	char *order_opts = NULL;
 	int wide=0;
 	int format = 0;
 	time_t timenow;
@@ -2212,9 +2213,9 @@ main(int argc, char **argv, char **envp) /* qstat */
 
 #if !defined(PBS_NO_POSIX_VIOLATION)
 #ifdef NAS /* localmod 071 */
-#define GETOPT_ARGS "aeinpqrstwxu:fGHJMQEBW:T1"
+#define GETOPT_ARGS "aeinpqrstwxu:fGHJMO:QEBW:T1"
 #else
-#define GETOPT_ARGS "ainpqrstwxu:fGHJMQEBW:T1F:D:"
+#define GETOPT_ARGS "ainpqrstwxu:fGHJMO:QEBW:T1F:D:"
 #endif /* localmod 071 */
 #else
 #define GETOPT_ARGS "fQBW:"
@@ -2322,6 +2323,11 @@ main(int argc, char **argv, char **envp) /* qstat */
 					strcat(extend, "x");
 				break;
 
+			case 'O':
+				/* sort and paging options, sent after the extend flags */
+				order_opts = optarg;
+				break;
+
 			case 'u':
 				alt_opt |= ALT_DISPLAY_u;
 				display_attribs = &alt_attribs[0];
@@ -2559,12 +2565,21 @@ main(int argc, char **argv, char **envp) /* qstat */
 	}
 #endif /* PBS_NO_POSIX_VIOLATION */
 
+	if (order_opts != NULL) {
+		if ((mode != JOBS) || (*order_opts == '\0') ||
+			(strlen(extend) + strlen(order_opts) + 2 > sizeof(extend)))
+			errflg++;
+		else
+			sprintf(extend + strlen(extend), "%c%s", STAT_ORDER_SEP, order_opts);
+	}
+
 	if (errflg) {
 		static char usag2[]="qstat --version\n";
 		static char usage[]="usage: \n\
-qstat [-f] [-J] [-p] [-t] [-x] [-E] [-F format] [-D delim] [ job_identifier... | destination... ]\n\
-qstat [-a|-i|-r|-H|-T] [-J] [-t] [-u user] [-n] [-s] [-G|-M] [-1] [-w]\n\
+qstat [-f] [-J] [-p] [-t] [-x] [-E] [-F format] [-D delim] [-O order]\n\
 \t[ job_identifier... | destination... ]\n\
+qstat [-a|-i|-r|-H|-T] [-J] [-t] [-u user] [-n] [-s] [-G|-M] [-1] [-w]\n\
+\t[-O order] [ job_identifier... | destination... ]\n\
 qstat -Q [-f] [-F format] [-D delim] [ destination... ]\n\
 qstat -q [-G|-M] [ destination... ]\n\
 qstat -B [-f] [-F format] [-D delim] [ server_name... ]\n";
@@ -2770,7 +2785,7 @@ job_no_args:
 					else
 						p_status = pbs_statjob(connect, job_id_out, display_attribs, extend);
 				} else {
-					p_status = pbs_selstat(connect, new_atropl, NULL, extend);
+					p_status = pbs_selstat(connect, new_atropl, display_attribs, extend);
 				}
 
 				if (added_queue) {
@@ -878,7 +878,7 @@ strdup_esc_commas(char *str_to_dup)
 static void
 print_usage(void)
 {
-	static char usage2[]="       qsub --version\n";
+	static char usage2[]="       qsub --batch file\n       qsub --version\n";
 #ifdef WIN32
 	static char usage[]=
 		"usage: qsub [-a date_time] [-A account_string] [-c interval]\n"
@@ -5702,6 +5702,278 @@ regular_submit(int daemon_up)
 
 /* End of "Daemon" functions. */
 
+/* The following functions support the "Batch Submission" capability of qsub. */
+
+#define QSUB_BATCH_CHUNK 1000 /* jobs handed to pbs_submit_batch() at a time */
+
+static struct batch_submit batch_jobs[QSUB_BATCH_CHUNK]; /* jobs not yet submitted */
+static int batch_lines[QSUB_BATCH_CHUNK]; /* line of each job in the batch file */
+static int batch_njobs = 0; /* number of jobs in batch_jobs */
+
+/**
+ * @brief
+ *	Report the outcome of one job of a batch submission: the job id on
+ *	stdout, or the error on stderr prefixed with the line of the job.
+ *
+ * @param[in] line - line of the job in the batch file
+ * @param[in] name - job id, NULL if the job was not submitted
+ * @param[in] code - PBS error code of the submission
+ * @param[in] text - error message from the server, may be NULL
+ *
+ * @return int
+ * @retval 0 - the job was submitted
+ * @retval 1 - the job was not submitted
+ */
+static int
+batch_report(int line, char *name, int code, char *text)
+{
+	if (name != NULL) {
+		printf("%s\n", name);
+		return 0;
+	}
+	if ((text == NULL) || (*text == '\0'))
+		text = pbse_to_txt(code);
+	if (text != NULL)
+		fprintf(stderr, "qsub: line %d: %s\n", line, text);
+	else
+		fprintf(stderr, "qsub: line %d: Error (%d) submitting job\n", line, code);
+	return 1;
+}
+
+/**
+ * @brief
+ *	Submit the jobs collected in batch_jobs and free them.  If the server
+ *	is too old to take batch submissions, the jobs are submitted one at a
+ *	time on a new connection.
+ *
+ * @return int
+ * @retval 0 - all the jobs were submitted
+ * @retval 1 - some jobs were not submitted
+ */
+static int
+batch_flush(void)
+{
+	struct batch_jobresult *results = NULL;
+	struct batch_jobresult *pres;
+	char *jobid;
+	int errs = 0;
+	int rc;
+	int i;
+
+	if (batch_njobs == 0)
+		return 0;
+
+	rc = pbs_submit_batch(sd_svr, batch_jobs, batch_njobs, NULL, &results);
+	if ((rc == PBSE_UNKREQ) && (results == NULL)) {
+		/* the server closed the connection, submit the jobs one by one */
+		pbs_disconnect(sd_svr);
+		if ((sd_svr = cnt2server(server_out)) <= 0) {
+			fprintf(stderr, "qsub: cannot connect to server %s (errno=%d)\n",
+				pbs_server, pbs_errno);
+			exit_qsub(pbs_errno);
+		}
+		for (i = 0; i < batch_njobs; i++) {
+			jobid = pbs_submit(sd_svr, batch_jobs[i].attrib,
+				batch_jobs[i].script, batch_jobs[i].destination, NULL);
+			errs |= batch_report(batch_lines[i], jobid, pbs_errno,
+				pbs_geterrmsg(sd_svr));
+			free(jobid);
+		}
+	} else {
+		for (i = 0, pres = results; i < batch_njobs; i++) {
+			if (pres != NULL) {
+				errs |= batch_report(batch_lines[i], pres->name,
+					pres->code, pres->text);
+				pres = pres->next;
+			} else {
+				/* never sent, the connection failed before */
+				errs |= batch_report(batch_lines[i], NULL, rc,
+					pbs_geterrmsg(sd_svr));
+			}
+		}
+		pbs_jobresultfree(results);
+	}
+
+	for (i = 0; i < batch_njobs; i++) {
+		free_attrl((struct attrl *) batch_jobs[i].attrib);
+		if (batch_jobs[i].script != NULL) {
+			(void)unlink(batch_jobs[i].script);
+			free(batch_jobs[i].script);
+		}
+		free(batch_jobs[i].destination);
+	}
+	memset(batch_jobs, 0, sizeof(batch_jobs));
+	batch_njobs = 0;
+
+	if ((rc != PBSE_NONE) && (rc != PBSE_UNKREQ)) {
+		fprintf(stderr, "qsub: batch submission failed (%d)\n", rc);
+		exit_qsub(rc);
+	}
+	return errs;
+}
+
+/**
+ * @brief
+ *	Parse one line of a batch file into a job and add it to batch_jobs.
+ *	The line holds the options and the script, or "--" and the command,
+ *	of the job, as they would be given to qsub.  Directives in the script
+ *	and the server's default_qsub_arguments apply as they would for qsub.
+ *
+ * @param[in] line - the line of the batch file
+ * @param[in] lineno - its line number, for messages
+ *
+ * @return int
+ * @retval 0 - the job was added
+ * @retval 1 - the line is in error, the message was printed
+ */
+static int
+batch_parse(char *line, int lineno)
+{
+	static char *vect[MAX_ARGV_LEN + 1];
+	char script[MAXPATHLEN + 1] = "";
+	char msg[MAXPATHLEN + 1] = "";
+	struct stat statbuf;
+	char *cmdargs;
+	int argc;
+	int command_flag;
+
+	/* start from a clean set of options for each job */
+	restore_opts();
+	free_attrl(attrib);
+	attrib = NULL;
+	free(v_value);
+	v_value = NULL;
+	destination[0] = '\0';
+	dir_prefix[0] = '\0';
+	script_tmp[0] = '\0';
+
+	make_argv(&argc, vect, line);
+	if ((cmdargs = encode_xml_arg_list(1, argc, vect)) != NULL) {
+		set_attr(&attrib, ATTR_submit_arguments, cmdargs);
+		free(cmdargs);
+	}
+#if defined(linux) || defined(WIN32)
+	optind = 0; /* prime getopt's starting point */
+#else
+	optind = 1; /* prime getopt's starting point */
+#endif
+	if (process_opts(argc, vect, CMDLINE) != 0) {
+		fprintf(stderr, "qsub: line %d: illegal options\n", lineno);
+		return 1;
+	}
+	if (Interact_opt || block_opt) {
+		fprintf(stderr, "qsub: line %d: interactive and blocking jobs "
+			"cannot be submitted with --batch\n", lineno);
+		return 1;
+	}
+
+	command_flag = process_special_args(argc, vect, script);
+	if (command_flag == 0) {
+		/* the standard input is the batch file, a script must be named */
+		if ((script[0] == '\0') || (strcmp(script, "-") == 0)) {
+			fprintf(stderr, "qsub: line %d: no job script\n", lineno);
+			return 1;
+		}
+		if ((stat(script, &statbuf) < 0) || !S_ISREG(statbuf.st_mode)) {
+			fprintf(stderr, "qsub: line %d: cannot read script %s\n",
+				lineno, script);
+			return 1;
+		}
+		read_job_script(script);
+	}
+	set_opt_defaults();
+
+	if ((dfltqsubargs != NULL) &&
+		(do_dir(dfltqsubargs, CMDLINE - 2, msg, sizeof(msg)) != 0)) {
+		fprintf(stderr, "qsub: line %d: %s", lineno, msg);
+		goto err;
+	}
+	if (V_opt && (qsub_envlist == NULL))
+		qsub_envlist = env_array_to_varlist(environ);
+	if (!set_job_env(basic_envlist, qsub_envlist)) {
+		fprintf(stderr, "qsub: line %d: cannot send environment with the job\n",
+			lineno);
+		goto err;
+	}
+
+	batch_jobs[batch_njobs].attrib = (struct attropl *) dup_attrl(attrib);
+	batch_jobs[batch_njobs].script = (script_tmp[0] != '\0') ? strdup(script_tmp) : NULL;
+	batch_jobs[batch_njobs].destination = strdup(destination);
+	if ((batch_jobs[batch_njobs].attrib == NULL) ||
+		(batch_jobs[batch_njobs].destination == NULL) ||
+		((script_tmp[0] != '\0') && (batch_jobs[batch_njobs].script == NULL))) {
+		fprintf(stderr, "qsub: out of memory\n");
+		exit_qsub(2);
+	}
+	batch_lines[batch_njobs++] = lineno;
+	return 0;
+
+err:
+	if (script_tmp[0] != '\0')
+		(void)unlink(script_tmp);
+	return 1;
+}
+
+/**
+ * @brief
+ *	qsub --batch <file>: submit one job per line of file ("-" for the
+ *	standard input) to the default server, over one connection.  Blank
+ *	lines and lines starting with '#' are skipped.  The id of each job is
+ *	printed in the order of the lines, errors name the line of the job.
+ *
+ * @param[in] file - the batch file
+ *
+ * @return int
+ * @retval 0 - all the jobs were submitted
+ * @retval 1 - some jobs were not submitted
+ */
+static int
+batch_submit_file(char *file)
+{
+	char line[MAX_LINE_LEN + 1];
+	char *pc;
+	FILE *fp;
+	int lineno = 0;
+	int errs = 0;
+
+	if (strcmp(file, "-") == 0)
+		fp = stdin;
+	else if ((fp = fopen(file, "r")) == NULL) {
+		perror("qsub: opening batch file");
+		exit_qsub(2);
+	}
+
+	server_out[0] = '\0';
+	if (do_connect(server_out, retmsg) != 0) {
+		fprintf(stderr, "%s", retmsg);
+		exit_qsub(2);
+	}
+	if ((basic_envlist = job_env_basic()) == NULL)
+		exit_qsub(3);
+	save_opts();
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		lineno++;
+		if ((pc = strchr(line, '\n')) != NULL)
+			*pc = '\0';
+		for (pc = line; isspace((int)*pc); pc++)
+			;
+		if ((*pc == '\0') || (*pc == '#'))
+			continue;
+
+		errs |= batch_parse(pc, lineno);
+		if (batch_njobs == QSUB_BATCH_CHUNK)
+			errs |= batch_flush();
+	}
+	errs |= batch_flush();
+
+	if (fp != stdin)
+		fclose(fp);
+	return errs;
+}
+
+/* End of "Batch Submission" functions. */
+
 int
 main(int argc, char **argv, char **envp) /* qsub */
 {
@@ -5738,6 +6010,10 @@ main(int argc, char **argv, char **envp) /* qsub */
 		exit_qsub(2);
 	}
 
+	/* submit the jobs listed in a file, see batch_submit_file() */
+	if ((argc == 3) && (strcmp(argv[1], "--batch") == 0))
+		exit_qsub(batch_submit_file(argv[2]));
+
 #ifdef WIN32
 	/*
 	 * In windows, the foreground qsub process does a createprocess of the
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+#ifndef	_ACCT_BIN_H
+#define	_ACCT_BIN_H
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Binary accounting log.
+ *
+ * Written next to the text accounting file of the same day (with the
+ * ACCT_BIN_SUFFIX appended) when PBS_ACCT_FORMAT in pbs.conf asks for it.
+ * The file starts with ACCT_BIN_MAGIC and is followed by records, all
+ * integers in network byte order:
+ *
+ *	uint32	length of the rest of the record
+ *	uint8	record kind, ACCT_BIN_KEYDEF or ACCT_BIN_DATA
+ *
+ * ACCT_BIN_KEYDEF defines the next key of the file's dictionary:
+ *	uint32	key id (0, 1, 2 ... in order)
+ *	string	key name, e.g. "resources_used.walltime"
+ *
+ * ACCT_BIN_DATA is one accounting record:
+ *	uint32	high word, uint32 low word of the record time (epoch)
+ *	uint8	record type, PBS_ACCT_* from acct.h
+ *	string	job or reservation id
+ *	uint32	number of fields
+ *	fields:	uint32 key id, string value
+ *
+ * A string is a uint32 length followed by that many bytes and a NUL.  A
+ * text token that is not of the form key=value is stored under key id
+ * ACCT_BIN_NOKEY.  Readers compare key ids rather than names, and skip
+ * unwanted records by their length without looking at their contents.
+ */
+
+#define ACCT_BIN_MAGIC		"PBSACB01"
+#define ACCT_BIN_MAGIC_LEN	8
+#define ACCT_BIN_SUFFIX		".bin"
+#define ACCT_BIN_KEYDEF		1
+#define ACCT_BIN_DATA		2
+#define ACCT_BIN_NOKEY		0xffffffff
+
+struct acct_bin_file {
+	FILE	 *abf_fp;
+	char	**abf_keys;	/* key dictionary of the file */
+	int	  abf_nkeys;
+	int	  abf_keyslots;
+	char	 *abf_buf;	/* record being read or built */
+	size_t	  abf_bufsize;
+	long	  abf_end;	/* offset just past the last complete record */
+
+	/* the data record last returned by acct_bin_read() */
+	time_t	  abf_time;
+	int	  abf_type;
+	char	 *abf_id;
+	int	  abf_nkv;
+	unsigned int *abf_kid;	/* key id of each field */
+	char	**abf_val;	/* value of each field */
+	int	  abf_kvslots;
+};
+
+extern struct acct_bin_file *acct_bin_open(char *path, int forwrite);
+extern void  acct_bin_close(struct acct_bin_file *abf);
+extern int   acct_bin_write(struct acct_bin_file *abf, time_t when, int acctype, char *id, char *text);
+extern int   acct_bin_read(struct acct_bin_file *abf);
+extern int   acct_bin_keyid(struct acct_bin_file *abf, char *key);
+extern char *acct_bin_value(struct acct_bin_file *abf, int keyid);
+extern int   acct_bin_text(struct acct_bin_file *abf, char *buf, size_t len);
+
+#ifdef	__cplusplus
+}
+#endif
+#endif	/* _ACCT_BIN_H */
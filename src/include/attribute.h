@@ -314,6 +314,10 @@ extern void free_none  (attribute *attr);
 extern svrattrl *attrlist_alloc(int szname, int szresc, int szval);
 extern svrattrl *attrlist_create(char *aname, char *rname, int szval);
 extern void free_svrattrl(svrattrl *pal);
+extern int  attrlist_intern_names;
+extern char *attr_intern(char *name);
+extern char *attr_intern_find(char *name);
+extern int  attr_intern_defs(attribute_def *padef, int limit);
 extern void free_attrlist(pbs_list_head *attrhead);
 extern void free_svrcache(struct attribute *attr);
 extern int  attr_atomic_set(svrattrl *plist, attribute *old,
@@ -126,6 +126,14 @@ struct rq_hookfile {
 	char	*rq_data;
 };
 
+/* Hook Bundle */
+
+struct rq_hookbundle {
+	char	 rq_hash[HOOK_BUNDLE_HASH_SIZE+1];
+	int	 rq_count;
+	struct hook_bundle_file *rq_files;
+};
+
 /*
  * job or destination id - used by RdyToCommit, Commit, RerunJob,
  * status ..., and locate job - is just a char *
@@ -201,6 +209,17 @@ struct rq_signal {
 	char	rq_signame[PBS_SIGNAMESZ+1];
 };
 
+/* JobList - one Delete, Hold, Release or Signal request for many jobs */
+
+struct rq_joblist {
+	int	 rq_op;		/* PBS_BATCH_* request applied to each job */
+	char	*rq_arg;	/* hold types or signal name */
+	int	 rq_count;
+	char   **rq_jobs;
+	pbs_list_head rq_attr;	/* hold types as svrattrl, shared by the jobs */
+	struct batch_jobresult *rq_last; /* tail of the reply's result list */
+};
+
 /* Status (job, queue, server, hook) */
 
 struct rq_status {
@@ -323,6 +342,7 @@ struct batch_request {
 	char	  rq_host[PBS_MAXHOSTNAME+1]; /* name of host sending request */
 	void  	 *rq_extra;	/* optional ptr to extra info		*/
 	char	 *rq_extend;	/* request "extension" data		*/
+	char	 *rq_trace;	/* trace id sent with the request	*/
 	int		 isrpp; /* is this message from rpp stream      */
 	int		 rpp_ack; /* send acks for this? */
 	char	 *rppcmd_msgid; /* msg id with rpp commands */
@@ -355,6 +375,7 @@ struct batch_request {
 		struct rq_selstat       rq_select;
 		int			rq_shutdown;
 		struct rq_signal	rq_signal;
+		struct rq_joblist	rq_joblist;
 		struct rq_status        rq_status;
 		struct rq_track		rq_track;
 		struct rq_cpyfile	rq_cpyfile;
@@ -364,6 +385,7 @@ struct batch_request {
 		struct rq_user_migrate  rq_user_migrate;
 		struct rq_defschrpy     rq_defrpy;
 		struct rq_hookfile	rq_hookfile;
+		struct rq_hookbundle	rq_hookbundle;
 		struct rq_momrestart	rq_momrestart;
 	} rq_ind;
 };
@@ -379,6 +401,7 @@ extern int   reply_text(struct batch_request *, int code, char *text);
 extern int   reply_send(struct batch_request *);
 extern int   reply_jobid(struct batch_request *, char *, int);
 extern int   reply_jobid_msg(struct batch_request *, char *, int, int);
+extern int   reply_jobresult(struct batch_request *, char *, int, char *);
 extern void  reply_free(struct batch_reply *);
 extern void  dispatch_request(int, struct batch_request *);
 extern void  free_br(struct batch_request *);
@@ -398,6 +421,7 @@ extern void  req_authenResvPort(struct batch_request *req);
 extern void  req_confirmresv(struct batch_request *req);
 extern void  req_connect(struct batch_request *req);
 extern void  req_defschedreply(struct batch_request *req);
+extern void  req_joblist(struct batch_request *req);
 extern void  req_locatejob(struct batch_request *req);
 extern void  req_manager(struct batch_request *req);
 extern void  req_movejob(struct batch_request *req);
@@ -411,10 +435,14 @@ extern void  req_stat_svr(struct batch_request *req);
 extern void  req_stat_sched(struct batch_request *req);
 extern void  req_trackjob(struct batch_request *req);
 extern void  req_stat_rsc(struct batch_request *req);
+extern void  req_submitbatch(struct batch_request *req);
+extern void  process_submitbatch(int sfds);
+extern int   submitbatch_hold(struct batch_request *req);
 #else
 extern void  req_cpyfile(struct batch_request *req);
 extern void  req_delfile(struct batch_request *req);
 extern void  req_copy_hookfile(struct batch_request *req);
+extern void  req_copy_hookbundle(struct batch_request *req);
 extern void  req_del_hookfile(struct batch_request *req);
 #endif
 
@@ -428,8 +456,10 @@ extern int decode_DIS_JobCred(int socket, struct batch_request *);
 extern int decode_DIS_UserCred(int socket, struct batch_request *);
 extern int decode_DIS_UserMigrate(int socket, struct batch_request *);
 extern int decode_DIS_JobFile(int socket, struct batch_request *);
+extern int decode_DIS_JobList(int socket, struct batch_request *);
 extern int decode_DIS_CopyHookFile(int socket, struct batch_request *);
 extern int decode_DIS_DelHookFile(int socket, struct batch_request *);
+extern int decode_DIS_CopyHookBundle(int socket, struct batch_request *);
 extern int decode_DIS_JobObit(int socket, struct batch_request *);
 extern int decode_DIS_Manage(int socket, struct batch_request *);
 extern int decode_DIS_MoveJob(int socket, struct batch_request *);
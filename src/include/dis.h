@@ -203,6 +203,8 @@ extern void     DIS_tcparray_init(void);
 
 extern void DIS_tcp_funcs(void);
 extern void DIS_tcp_reset(int fd, int rw);
+extern int  DIS_tcp_rpending(int fd);
+extern int  DIS_tcp_set_binary(int fd, int on);
 extern void DIS_tcp_setup(int fd);
 extern int  DIS_tcp_wflush(int fd);
 
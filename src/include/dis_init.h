@@ -43,4 +43,5 @@ extern int (*dis_gets)(int stream, char *string, size_t count);
 extern int (*disr_skip)(int stream, size_t nskips);
 extern int (*disw_commit)(int stream, int commit);
 extern int (*disr_commit)(int stream, int commit);
+extern int (*dis_binary)(int stream);
 
@@ -102,6 +102,43 @@ typedef enum hook_user hook_user;
 #define HOOK_EVENT_EXECJOB_ATTACH	0x4000
 #define HOOK_EVENT_EXECJOB_RESIZE	0x20000
 
+/*
+ * Execution profile kept for each hook by the daemon running it.  A run is
+ * split into phases, each timed in wall clock and CPU seconds:
+ *	HOOK_STAT_SETUP  - building the pbs.event() objects and loading the script
+ *	HOOK_STAT_RUN    - executing the hook script
+ *	HOOK_STAT_RESULT - applying the hook's changes back to the request
+ * The total wall time of each run is also counted in a latency histogram
+ * whose bucket upper bounds (in milliseconds) are HOOK_STAT_BUCKET_BOUNDS;
+ * the last bucket holds everything slower.
+ */
+#define	HOOK_STAT_SETUP		0
+#define	HOOK_STAT_RUN		1
+#define	HOOK_STAT_RESULT	2
+#define	HOOK_STAT_NPHASES	3
+#define	HOOK_STAT_NBUCKETS	12
+#define	HOOK_STAT_BUCKET_BOUNDS	{1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 5000}
+#define	HOOK_STATS_LOG_INTERVAL	600	/* secs between hook stats log lines */
+
+/*
+ * Events whose hooks only observe server state: their accept/reject and
+ * changes are not acted upon, so the server runs them in a forked child
+ * and carries on.  At most HOOK_ASYNC_MAX_CHILDREN such children run at
+ * a time; past that the hooks run in the server itself, which slows the
+ * server down to the rate the hooks can keep up with.
+ */
+#define	HOOK_ASYNC_EVENTS	HOOK_EVENT_RESV_END
+#define	HOOK_ASYNC_MAX_CHILDREN	4
+
+struct hook_stats {
+	unsigned long	hs_runs;			/* # of completed runs */
+	unsigned long	hs_runs_logged;			/* hs_runs at last log */
+	double		hs_wall[HOOK_STAT_NPHASES];	/* wall secs per phase */
+	double		hs_cpu[HOOK_STAT_NPHASES];	/* cpu secs per phase */
+	double		hs_max;				/* slowest run, wall secs */
+	unsigned long	hs_hist[HOOK_STAT_NBUCKETS];	/* runs by wall time */
+};
+
 #define MOM_EVENTS	(HOOK_EVENT_EXECJOB_BEGIN|HOOK_EVENT_EXECJOB_PROLOGUE|HOOK_EVENT_EXECJOB_EPILOGUE|HOOK_EVENT_EXECJOB_END|HOOK_EVENT_EXECJOB_PRETERM|HOOK_EVENT_EXECHOST_PERIODIC|HOOK_EVENT_EXECJOB_LAUNCH|HOOK_EVENT_EXECHOST_STARTUP|HOOK_EVENT_EXECJOB_ATTACH|HOOK_EVENT_EXECJOB_RESIZE)
 #define USER_MOM_EVENTS	(HOOK_EVENT_EXECJOB_PROLOGUE|HOOK_EVENT_EXECJOB_EPILOGUE|HOOK_EVENT_EXECJOB_PRETERM)
 #define FAIL_ACTION_EVENTS (HOOK_EVENT_EXECJOB_BEGIN|HOOK_EVENT_EXECHOST_STARTUP|HOOK_EVENT_EXECJOB_PROLOGUE)
@@ -146,6 +183,7 @@ struct hook {
 	pbs_list_link	hi_execjob_attach_hooks;
 	pbs_list_link	hi_execjob_resize_hooks;
 	struct work_task *ptask;		    /* work task pointer, used in periodic hooks */
+	struct hook_stats run_stats;	/* execution profile, not saved */
 };
 
 typedef struct hook hook;
@@ -197,6 +235,7 @@ typedef struct hook hook;
 #define	HOOKATT_FREQ		"freq"
 #define	HOOKATT_FAIL_ACTION	"fail_action"
 #define	HOOKATT_PENDING_DELETE  "pending_delete"
+#define	HOOKATT_STATS		"run_stats"	/* read-only, listed on request */
 
 #define	HOOK_PBS_PREFIX		"PBS"  /* valid Hook name prefix for PBS hook */
 
@@ -267,6 +306,22 @@ typedef struct hook hook;
 
 #define	PBS_HOOK_CONFIG_FILE	"PBS_HOOK_CONFIG_FILE"
 
+/*
+ * pbs_python hook worker, started by pbs_mom (see mom_hook_pool.c).
+ * A request is a socket passed over the worker's control socket.  On it
+ * MoM first writes a hook_worker_hdr followed by hw_nstr NUL terminated
+ * strings: the working directory, the PBS_HOOK_CONFIG_FILE value (may be
+ * empty) and the "pbs_python --hook" argument vector.  The worker answers
+ * with the pid of the process running the hook, then its wait status.
+ */
+#define	HOOK_WORKER_MODE	"--hook-worker"
+#define	HOOK_WORKER_MAXREQ	65536
+
+struct hook_worker_hdr {
+	int	hw_nstr;	/* number of strings that follow */
+	int	hw_len;		/* total length of the strings */
+};
+
 /* default import statement printed out on a "print hook" request */
 #define PRINT_HOOK_IMPORT_CALL  "import hook %s application/x-python base64 -\n"
 #define PRINT_HOOK_IMPORT_CONFIG  "import hook %s application/x-config base64 -\n"
@@ -367,6 +422,8 @@ extern char *hook_freq_as_string(int);
 extern char *hook_order_as_string(short);
 extern char *hook_user_as_string(hook_user);
 extern char *hook_fail_action_as_string(unsigned int);
+extern char *hook_stats_as_string(hook *);
+extern void hook_stats_add(hook *, double *, double *);
 
 #ifdef	_WORK_TASK_H
 extern void cleanup_hooks_workdir(struct work_task *);
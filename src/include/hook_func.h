@@ -137,6 +137,9 @@ extern int recreate_request(struct batch_request *);
 /* Server periodic hook call-back */
 extern void run_periodic_hook (struct work_task *ptask);
 
+/* Periodic hook execution profile logger */
+extern void log_hook_stats(struct work_task *ptask);
+
 extern int get_server_hook_results(char *input_file, int *accept_flag, int *reject_flag,
 	char *reject_msg, int reject_msg_size, job *pjob, hook *phook, hook_output_param_t *hook_output);
 #endif
@@ -57,12 +57,16 @@ extern char *__pbs_default(void);
 
 extern int __pbs_deljob(int, char *, char *);
 
+extern int __pbs_deljoblist(int, char **, int, char *, struct batch_jobresult **);
+
 extern int __pbs_disconnect(int);
 
 extern char *__pbs_geterrmsg(int);
 
 extern int __pbs_holdjob(int, char *, char *, char *);
 
+extern int __pbs_holdjoblist(int, char **, int, char *, char *, struct batch_jobresult **);
+
 extern char *__pbs_locjob(int, char *, char *);
 
 extern int __pbs_manager(int, int, int, char *, struct attropl *, char *);
@@ -77,12 +81,18 @@ extern int __pbs_rerunjob(int, char *, char *);
 
 extern int __pbs_rlsjob(int, char *, char *, char *);
 
+extern int __pbs_rlsjoblist(int, char **, int, char *, char *, struct batch_jobresult **);
+
 extern int __pbs_runjob(int, char *, char *, char *);
 
 extern char **__pbs_selectjob(int, struct attropl *, char *);
 
 extern int __pbs_sigjob(int, char *, char *, char *);
 
+extern int __pbs_sigjoblist(int, char **, int, char *, char *, struct batch_jobresult **);
+
+extern void __pbs_jobresultfree(struct batch_jobresult *);
+
 extern void __pbs_statfree(struct batch_status *);
 
 extern struct batch_status *__pbs_statrsc(int, char *, struct attrl *, char *);
@@ -111,6 +121,12 @@ extern struct ecl_attribute_errors * __pbs_get_attributes_in_error(int);
 
 extern char *__pbs_submit(int, struct attropl *, char *, char *, char *);
 
+extern int __pbs_submit_batch(int, struct batch_submit *, int, char *, struct batch_jobresult **);
+
+extern int __pbs_async(char *, int (*)(int, void *), void (*)(int, void *), void *);
+
+extern int __pbs_async_wait(void);
+
 extern char *__pbs_submit_resv(int, struct attropl *, char *);
 
 extern int __pbs_delresv(int, char *, char *);
@@ -498,6 +498,16 @@ struct jbdscrd {
 #define ji_taskid  ji_extended.ji_ext.ji_taskidx
 #define ji_nodeid  ji_extended.ji_ext.ji_nodeidx
 
+/*
+ * Stages of a multi-node job launch timed by Mother Superior,
+ * indices into ji_launch_ts; see launch_stage() in mom_comm.c
+ */
+#define	LAUNCH_JOIN_SENT	0	/* JOIN_JOB sent to the sisterhood */
+#define	LAUNCH_JOIN_FIRST	1	/* first sister accepted the job */
+#define	LAUNCH_JOIN_DONE	2	/* all sisters accepted the job */
+#define	LAUNCH_STARTED		3	/* job shell started on MS */
+#define	LAUNCH_NSTAGES		4
+
 struct job {
 
 	/* 
@@ -516,6 +526,7 @@ struct job {
 	struct batch_request *ji_rerun_preq;	/* outstanding rerun request */
 	int		ji_licneed;	/* # of cpu licenses needed by job */
 	int		ji_licalloc;	/* actual # of cpu licenses allocated */
+	char		*ji_trace;	/* trace id of the submission, see pbs_trace.h */
 #ifdef	PBS_MOM				/* MOM ONLY */
 	struct batch_request *ji_preq;	/* outstanding request */
 	struct grpcache *ji_grpcache;	/* cache of user's groups */
@@ -538,6 +549,10 @@ struct job {
 	int		ji_parent2child_moms_status_pipe;	/* write pipe for parent mom to send sister moms status to child starter process */
 	int		ji_updated;	/* set to 1 if job's node assignment was updated */
 	time_t		ji_walltime_stamp;	/* time stamp for accumulating walltime */
+	pbs_list_head	ji_rused_sent;	/* resources_used last sent to server */
+	int		ji_rused_gen;	/* svr_rused_gen of ji_rused_sent */
+	int		ji_join_pending; /* JOIN_JOB events still awaiting reply */
+	double		ji_launch_ts[LAUNCH_NSTAGES]; /* launch stage times */
 #ifdef WIN32
 	HANDLE		ji_momsubt;	/* process HANDLE to mom subtask */
 #else	/* not WIN32 */
@@ -579,6 +594,9 @@ struct job {
 	struct batch_request *ji_prunreq; /* outstanding runjob request */
 	pbs_list_head	ji_svrtask;	/* links to svr work_task list */
 	struct pbs_queue  *ji_qhdr;	/* current queue header */
+	pbs_list_link	ji_jobque_state; /* links to jobs in same queue and state */
+	pbs_list_link	ji_jobowner;	/* links to queued jobs of same owner */
+	struct job_owner *ji_ownerent;	/* owner index entry, see svr_jobidx_link */
 	struct resc_resv  *ji_resvp;	/* !=0 reservation job;see job_purge */
 	struct resc_resv  *ji_myResv;	/* !=0 job belongs to a reservation */
 	/* see also, attribute JOB_ATR_myResv */
@@ -1114,6 +1132,7 @@ extern void  svr_dequejob(job *);
 extern int   svr_enquejob(job *);
 extern void  svr_evaljobstate(job *, int *, int *, int);
 extern void  set_statechar(job *);
+extern void  svr_jobidx_state(job *);
 extern int   svr_setjobstate(job *, int, int);
 extern int   state_char2int(char);
 extern int   uniq_nameANDfile(char*, char*, char*);
@@ -1150,6 +1169,10 @@ void*	job_or_resv_recov_fs(char *, int);
 #else
 
 extern job  *job_recov_db(char *);
+extern int   job_recov_db_all(void *, int, void (*)(job *, char *, void *), void *);
+struct pbs_db_job_info;
+extern void  svr_to_db_job(job *, struct pbs_db_job_info *);
+extern void  db_to_svr_job(job *, struct pbs_db_job_info *);
 extern void *job_or_resv_recov_db(char *, int);
 extern int  job_save_db(job *, int);
 extern int   job_or_resv_save_db(void *, int, int);
@@ -1159,6 +1182,19 @@ extern int   job_or_resv_save_db(void *, int, int);
 #define job_or_resv_recov job_or_resv_recov_db
 /* server uses the db versions so just redefine - saves lots of code changes */
 
+/*
+ * Jobs in the queues, by owner name without the @host suffix.
+ * Together with the per state lists of each queue (qu_jobstate) these
+ * index the jobs for req_selectjobs(), see svr_jobidx_link().
+ */
+struct job_owner {
+	pbs_list_head	jo_jobs;	/* the jobs, linked by ji_jobowner */
+	int		jo_count;	/* number of jobs in jo_jobs */
+	char		jo_name[PBS_MAXUSER + 1];
+};
+extern int   svr_jobidx_owners;	/* the owner index is usable */
+extern struct job_owner *find_job_owner(char *);
+
 #endif
 
 
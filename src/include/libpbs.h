@@ -121,6 +121,13 @@ extern time_t * __pbs_tcptimeout_location(void);
 #define pbs_tcp_timeout (*__pbs_tcptimeout_location ())
 #endif
 
+/* trace id encoded into the extension of each request, NULL for none */
+#ifndef __PBS_CURRENT_TRACE
+#define __PBS_CURRENT_TRACE
+extern char ** __pbs_trace_location(void);
+#define pbs_current_trace (*__pbs_trace_location ())
+#endif
+
 #ifndef __PBS_TCP_INTERRUPT
 #define __PBS_TCP_INTERRUPT
 extern int * __pbs_tcpinterrupt_location(void);
@@ -143,6 +150,11 @@ struct connect_handle {
 	int		ch_errno;  /* last error on this connection */
 	char		*ch_errtxt;/* pointer to last server error text	*/
 	pthread_mutex_t ch_mutex;  /* serialize connection between threads */
+	char		*ch_server;/* server name the pooled connection is for */
+	unsigned int	ch_port;   /* server port the pooled connection is for */
+	int		ch_pooled; /* 1 if idle in the connection pool */
+	time_t		ch_idle;   /* when the connection was put in the pool */
+	int		ch_stateful; /* 1 if the server keeps state for it, not pooled */
 };
 extern struct connect_handle connection[];
 #define PBS_MAX_CONNECTIONS        5000  /* Max connections in the connections array */
@@ -191,6 +203,7 @@ struct brp_rescq {            /* reply to Resource Query Request */
 #define BATCH_REPLY_CHOICE_Text		7	/* text,   see brp_txt	  */
 #define BATCH_REPLY_CHOICE_Locate	8	/* locate, see brp_locate */
 #define BATCH_REPLY_CHOICE_RescQuery	9	/* Resource Query         */
+#define BATCH_REPLY_CHOICE_JobList	10	/* job list, see brp_jobres */
 
 struct batch_reply {
 	int	brp_code;
@@ -207,6 +220,7 @@ struct batch_reply {
 		} brp_txt;		/* text and credential reply */
 		char	  brp_locate[PBS_MAXDEST+1];
 		struct brp_rescq brp_rescq;	/* query resource reply */
+		struct batch_jobresult *brp_jobres; /* job list (failures) */
 	} brp_un;
 };
 
@@ -282,6 +296,9 @@ struct batch_reply {
 #define PBS_BATCH_RelnodesJob	90
 #define PBS_BATCH_ModifyResv	91
 #define PBS_BATCH_ResvOccurEnd	92
+#define PBS_BATCH_JobList	93
+#define PBS_BATCH_SubmitBatch	94
+#define PBS_BATCH_CopyHookBundle	95
 
 #define PBS_BATCH_FileOpt_Default	0
 #define PBS_BATCH_FileOpt_OFlg		1
@@ -305,6 +322,19 @@ struct batch_reply {
 #define FAILOVER_SecdGoInactive  4  /* Primary down, secondary go inactive    */
 #define FAILOVER_SecdTakeOver    5  /* Primary down, secondary take over      */
 
+/*
+ * One hook-related file of a hook bundle (PBS_BATCH_CopyHookBundle): the
+ * control, config and script files of a hook travel together, named by the
+ * SHA-256 of their contents (see pbs_hook_bundle_hash()).
+ */
+#define HOOK_BUNDLE_HASH_SIZE	64	/* SHA-256 digest, in hex */
+
+struct hook_bundle_file {
+	char	 hbf_name[MAXPATHLEN+1];	/* basename, with suffix */
+	long	 hbf_size;
+	char	*hbf_data;
+};
+
 extern int is_compose(int stream, int command);
 extern int is_compose_cmd(int stream, int command, char **msgid);
 extern void PBS_free_aopl(struct attropl * aoplp);
@@ -317,6 +347,9 @@ extern int PBSD_jscript(int connect, char *script_file, int rpp, char **msgid);
 extern int PBSD_jscript_direct(int connect, char *script, int rpp, char **msgid);
 extern int PBSD_copyhookfile(int connect, char *hook_filepath, int rpp, char **msgid);
 extern int PBSD_delhookfile(int connect, char *hook_filename, int rpp, char **msgid);
+extern int PBSD_copyhookbundle(int connect, struct hook_bundle_file *files,
+	int count, char *hash, int rpp, char **msgid);
+extern int pbs_hook_bundle_hash(struct hook_bundle_file *files, int count, char *hash);
 extern int PBSD_mgr_put(int connect, int func, int cmd, int objtype,
 	char *objname, struct attropl *al, char *extend, int rpp, char **msgid);
 extern int PBSD_manager  (int connect, int func, int cmd,
@@ -328,6 +361,7 @@ extern int PBSD_relnodes_put(int connect, char *jobid,
 extern int PBSD_py_spawn_put(int connect, char *jobid,
 	char **argv, char **envp, int rpp, char **msgid);
 extern int PBSD_sig_put(int connect, char *jobid, char *signal, char *extend, int rpp, char **msgid);
+extern int PBSD_joblist(int connect, int op, char **jobids, int count, char *arg, char *extend, struct batch_jobresult **results);
 extern int PBSD_term_put(int connect, int manner, char *extend);
 extern int PBSD_jobfile(int connect, int req_type, char *path,
 	char *jobid, enum job_file which, int rpp, char **msgid);
@@ -366,17 +400,23 @@ extern int encode_DIS_QueueJob(int socket, char *jid,
 extern int encode_DIS_SubmitResv(int sock, char *resv_id, struct attropl *aoplp);
 extern int encode_DIS_JobCredential(int sock, int type, char *buf, int len);
 extern int encode_DIS_ReqExtend(int socket, char *extend);
+
+/* bits of the first word of a request extension */
+#define PBS_REQEXT_EXTEND	0x1	/* the extension string follows */
+#define PBS_REQEXT_TRACE	0x2	/* a trace id follows */
 extern int encode_DIS_ReqHdr(int socket, int reqt, char *user);
 extern int encode_DIS_Rescq(int socket, char **rlist, int num);
 extern int encode_DIS_Run(int socket, char *jid, char *where,
 	unsigned long resch);
 extern int encode_DIS_ShutDown(int socket, int manner);
 extern int encode_DIS_SignalJob(int socket, char *jid, char *sig);
+extern int encode_DIS_JobList(int socket, int op, char **jobids, int count, char *arg);
 extern int encode_DIS_Status(int socket, char *objid, struct attrl *);
 extern int encode_DIS_attrl(int socket, struct attrl *);
 extern int encode_DIS_attropl(int socket, struct attropl *);
 extern int encode_DIS_CopyHookFile(int, int, char *, int, char *);
 extern int encode_DIS_DelHookFile(int, char *);
+extern int encode_DIS_CopyHookBundle(int, struct hook_bundle_file *, int, char *);
 
 extern char *PBSD_submit_resv(int connect, char *resv_id,
 	struct attropl *attrib, char *extend);
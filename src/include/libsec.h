@@ -66,6 +66,10 @@ extern "C" {
 
 extern int CS_read(int sd, char *buf, size_t len);
 extern int CS_write(int sd, char *buf, size_t len);
+#ifndef WIN32
+struct iovec;
+extern int CS_writev(int sd, struct iovec *iov, int iovcnt);
+#endif
 extern int CS_client_auth(int sd);
 extern int CS_server_auth(int	sd);
 extern int CS_close_socket(int sd);
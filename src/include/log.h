@@ -67,6 +67,16 @@
  */
 #define LOG_BUF_SIZE 4352
 
+/*
+ * With PBS_LOG_INDEX set, each line written with an object name (a job,
+ * reservation, node, ...) is also recorded as "<offset> <id>" in a file named after the log file
+ * with this suffix, for tracejob.  Each time a daemon opens the index it
+ * first writes "#start <offset>", the size of the log at that time, so
+ * that lines logged while the log was not indexed can be found.
+ */
+#define LOG_INDEX_SUFFIX ".idx"
+#define LOG_INDEX_START "#start"
+
 /* The following macro assist in sharing code between the Server and Mom */
 #define LOG_EVENT log_event
 
@@ -101,6 +111,7 @@ extern struct log_net_info *get_if_info(char *msg);
 extern void free_if_info(struct log_net_info *ni);
 
 extern void log_close(int close_msg);
+extern int  log_async_start(void);
 extern void log_err(int err, const char *func, const char *text);
 extern void log_joberr(int err, const char *func, const char *text, const char *pjid);
 extern void log_event(int type, int objclass, int severity, const char *objname, const char *text);
@@ -108,6 +119,7 @@ extern int will_log_event(int type);
 extern void log_suspect_file(const char *func, const char *text, const char *file, struct stat *sb);
 extern int  log_open(char *name, char *directory);
 extern int  log_open_main(char *name, char *directory, int silent);
+extern FILE *log_index_open(char *idxname, FILE *logfp);
 extern void log_record(int type, int objclass, int severity, const char *objname, const char *text);
 extern char log_buffer[LOG_BUF_SIZE];
 extern int log_level_2_etype(int level);
@@ -254,6 +254,7 @@ extern int	message_job(job *pjob, enum job_file jft, char *text);
 extern void	term_job(job *pjob);
 extern int	start_process(pbs_task *pt, char **argv, char **envp, bool nodemux);
 extern pre_finish_results_t pre_finish_exec(job *pjob, int do_job_setup_send);
+extern void	launch_stage(job *pjob, int stage);
 extern void	finish_exec(job *pjob);
 extern void	exec_bail(job *pjob, int code, char *txt);
 extern int	generate_pbs_nodefile(job *pjob, char *nodefile,
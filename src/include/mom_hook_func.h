@@ -176,6 +176,11 @@ extern void python_script_free(struct python_script *py_script);
 
 extern void run_periodic_hook_bg(hook *phook);
 
+extern int hook_pool_size;
+extern void hook_pool_check(void);
+extern void hook_pool_stop(void);
+extern int hook_pool_exec(char **argv, char *config);
+
 extern int
 num_eligible_hooks(unsigned int hook_event);
 
@@ -68,6 +68,9 @@ typedef unsigned long pbs_net_t;        /* for holding host addresses */
 
 #define	QSUB_DAEMON	"qsub-daemon"
 
+/* Connect extend asking for binary DIS integers, echoed back if agreed */
+#define	DIS_BINARY_EXT	"dis-binary"
+
 /*
  **	Protocol numbers and versions for PBS communications.
  */
@@ -114,6 +114,11 @@ struct pbs_client_thread_context {
 	int			th_pbs_tcp_interrupt;
 	int			th_pbs_tcp_errno;
 	int			th_pbs_mode;
+	/** trace id sent with each request, see pbs_trace.h */
+	char			*th_pbs_trace;
+	/** fd last set up for DIS by this thread and its tcp channel */
+	int			th_dis_fd;
+	void			*th_dis_chan;
 };
 
 
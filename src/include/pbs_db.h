@@ -306,6 +306,13 @@ struct pbs_db_query_options {
 };
 typedef struct pbs_db_query_options pbs_db_query_options_t;
 
+/*
+ * query option flag for PBS_DB_ATTR cursors: return the attributes of every
+ * object of the parent type, ordered by parent id, and set parent_id of each
+ * row returned by pbs_db_cursor_next (valid until the cursor is closed)
+ */
+#define PBS_DB_ATTR_ALL_PARENTS	0x100
+
 #define PBS_DB_JOB 			0
 #define PBS_DB_RESV			1
 #define PBS_DB_SVR			2
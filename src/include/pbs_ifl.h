@@ -317,6 +317,7 @@ extern "C" {
 #define ATTR_python_restart_min_interval "python_restart_min_interval"
 #define ATTR_power_provisioning "power_provisioning"
 #define ATTR_sync_mom_hookfiles_timeout "sync_mom_hookfiles_timeout"
+#define ATTR_sync_mom_hookfiles_batch "sync_mom_hookfiles_batch"
 #define ATTR_max_job_sequence_id "max_job_sequence_id"
 
 /**
@@ -486,6 +487,13 @@ enum pbs_auth_method {
 #define NOMAIL  			"nomail"
 #define SUPPRESS_EMAIL  		"suppress_email"
 #define DELETEHISTORY		"deletehist"
+
+/*
+ * sort and paging options of pbs_statjob() and pbs_selstat(), given in the
+ * extend parameter after the flags and STAT_ORDER_SEP, comma separated:
+ * "sort=[-]attribute[.resource]", "offset=n" and "limit=n"
+ */
+#define STAT_ORDER_SEP			':'
 /*
  ** This structure is identical to attropl so they can be used
  ** interchangably.  The op field is not used.
@@ -513,6 +521,24 @@ struct batch_status {
 	char		    *text;
 };
 
+/*
+ * result of one job of a job list request, only failures are returned,
+ * or of one job of a batch submission, where every job is returned
+ */
+struct batch_jobresult {
+	struct batch_jobresult *next;
+	char		       *name;	/* job id */
+	int			code;	/* PBS error code */
+	char		       *text;	/* error message, may be NULL */
+};
+
+/* one job of a batch submission, see pbs_submit_batch() */
+struct batch_submit {
+	struct attropl	*attrib;	/* job attributes */
+	char		*script;	/* path of the job script, may be NULL */
+	char		*destination;	/* queue, may be NULL or empty */
+};
+
 /* structure to hold an attribute that failed verification at ECL
  * and the associated errcode and errmsg
  */
@@ -576,12 +602,16 @@ DECLDIR char *pbs_default(void);
 
 DECLDIR int pbs_deljob(int, char *, char *);
 
+DECLDIR int pbs_deljoblist(int, char **, int, char *, struct batch_jobresult **);
+
 DECLDIR int pbs_disconnect(int);
 
 DECLDIR char *pbs_geterrmsg(int);
 
 DECLDIR int pbs_holdjob(int, char *, char *, char *);
 
+DECLDIR int pbs_holdjoblist(int, char **, int, char *, char *, struct batch_jobresult **);
+
 DECLDIR char *pbs_locjob(int, char *, char *);
 
 DECLDIR int pbs_manager(int, int, int, char *, struct attropl *, char *);
@@ -598,12 +628,18 @@ DECLDIR int pbs_rerunjob(int, char *, char *);
 
 DECLDIR int pbs_rlsjob(int, char *, char *, char *);
 
+DECLDIR int pbs_rlsjoblist(int, char **, int, char *, char *, struct batch_jobresult **);
+
 DECLDIR int pbs_runjob(int, char *, char *, char *);
 
 DECLDIR char **pbs_selectjob(int, struct attropl *, char *);
 
 DECLDIR int pbs_sigjob(int, char *, char *, char *);
 
+DECLDIR int pbs_sigjoblist(int, char **, int, char *, char *, struct batch_jobresult **);
+
+DECLDIR void pbs_jobresultfree(struct batch_jobresult *);
+
 DECLDIR void pbs_statfree(struct batch_status *);
 
 DECLDIR struct batch_status *pbs_statrsc(int, char *, struct attrl *, char *);
@@ -632,6 +668,12 @@ DECLDIR struct ecl_attribute_errors * pbs_get_attributes_in_error(int);
 
 DECLDIR char *pbs_submit(int, struct attropl *, char *, char *, char *);
 
+DECLDIR int pbs_submit_batch(int, struct batch_submit *, int, char *, struct batch_jobresult **);
+
+DECLDIR int pbs_async(char *, int (*)(int, void *), void (*)(int, void *), void *);
+
+DECLDIR int pbs_async_wait(void);
+
 DECLDIR char *pbs_submit_resv(int, struct attropl *, char *);
 
 DECLDIR int pbs_delresv(int, char *, char *);
@@ -671,10 +713,14 @@ extern char *pbs_default(void);
 
 extern int pbs_deljob(int, char *, char *);
 
+extern int pbs_deljoblist(int, char **, int, char *, struct batch_jobresult **);
+
 extern char *pbs_geterrmsg(int);
 
 extern int pbs_holdjob(int, char *, char *, char *);
 
+extern int pbs_holdjoblist(int, char **, int, char *, char *, struct batch_jobresult **);
+
 extern char *pbs_locjob(int, char *, char *);
 
 extern int pbs_movejob(int, char *, char *, char *);
@@ -689,12 +735,18 @@ extern int pbs_rerunjob(int, char *, char *);
 
 extern int pbs_rlsjob(int, char *, char *, char *);
 
+extern int pbs_rlsjoblist(int, char **, int, char *, char *, struct batch_jobresult **);
+
 extern int pbs_runjob(int, char *, char *, char *);
 
 extern char **pbs_selectjob(int, struct attropl *, char *);
 
 extern int pbs_sigjob(int, char *, char *, char *);
 
+extern int pbs_sigjoblist(int, char **, int, char *, char *, struct batch_jobresult **);
+
+extern void pbs_jobresultfree(struct batch_jobresult *);
+
 extern void pbs_statfree(struct batch_status *);
 
 extern struct batch_status *pbs_statrsc(int, char *, struct attrl *, char *);
@@ -723,6 +775,12 @@ extern struct ecl_attribute_errors * pbs_get_attributes_in_error(int);
 
 extern char *pbs_submit(int, struct attropl *, char *, char *, char *);
 
+extern int pbs_submit_batch(int, struct batch_submit *, int, char *, struct batch_jobresult **);
+
+extern int pbs_async(char *, int (*)(int, void *), void (*)(int, void *), void *);
+
+extern int pbs_async_wait(void);
+
 extern char *pbs_submit_resv(int, struct attropl *, char *);
 
 extern int pbs_delresv(int, char *, char *);
@@ -234,6 +234,16 @@ struct pbs_config
 	unsigned int pbs_comm_threads;	/* number of threads for router, default 4 */
 	char *pbs_mom_node_name;	/* mom short name used for natural node, default NULL */
 	unsigned int pbs_log_highres_timestamp; /* high resolution logging */
+	unsigned int pbs_log_async_queue;	/* async log queue depth in records, 0 = synchronous logging */
+	unsigned int pbs_log_async_drop;	/* on a full async log queue: 0 = block the caller, 1 = drop */
+	unsigned int pbs_acct_format;	/* accounting log formats, PBS_ACCT_FORMAT_* bits */
+	unsigned int pbs_log_index;	/* keep a job id index next to each log file */
+	unsigned int pbs_trace;		/* record request tracing spans, see pbs_trace.h */
+	unsigned int pbs_trace_ring;	/* spans held in memory between trace file writes */
+	unsigned int pbs_recov_threads;	/* job recovery decode threads, 0 = recover jobs one at a time */
+	unsigned int pbs_snapshot_interval; /* seconds between server snapshots, 0 = no snapshot */
+	unsigned int pbs_conn_pool;	/* idle client connections kept per server, 0 = no pooling */
+	unsigned int pbs_dis_binary;	/* ask the server for binary DIS integers */
 #ifdef WIN32
 	char *pbs_conf_remote_viewer; /* Remote viewer client executable for PBS GUI jobs, along with launch options */
 #endif
@@ -297,6 +307,21 @@ extern struct pbs_config pbs_conf;
 #define PBS_CONF_SCHEDULER_MODIFY_EVENT	"PBS_SCHEDULER_MODIFY_EVENT"
 #define PBS_CONF_MOM_NODE_NAME	"PBS_MOM_NODE_NAME"
 #define PBS_CONF_LOG_HIGHRES_TIMESTAMP	"PBS_LOG_HIGHRES_TIMESTAMP"
+#define PBS_CONF_LOG_ASYNC_QUEUE	"PBS_LOG_ASYNC_QUEUE"
+#define PBS_CONF_LOG_ASYNC_DROP	"PBS_LOG_ASYNC_DROP"
+#define PBS_CONF_ACCT_FORMAT	"PBS_ACCT_FORMAT"	/* text, binary or both */
+#define PBS_CONF_LOG_INDEX	"PBS_LOG_INDEX"
+#define PBS_CONF_TRACE		"PBS_TRACE"
+#define PBS_CONF_TRACE_RING	"PBS_TRACE_RING"
+#define PBS_CONF_RECOV_THREADS	"PBS_RECOV_THREADS"
+#define PBS_RECOV_THREADS_DEFAULT	4
+#define PBS_CONF_SNAPSHOT_INTERVAL	"PBS_SNAPSHOT_INTERVAL"
+#define PBS_CONF_CONN_POOL	"PBS_CONN_POOL"
+#define PBS_CONF_DIS_BINARY	"PBS_DIS_BINARY"
+
+/* accounting log formats, see PBS_CONF_ACCT_FORMAT */
+#define PBS_ACCT_FORMAT_TEXT	0x1
+#define PBS_ACCT_FORMAT_BINARY	0x2
 #ifdef WIN32
 #define PBS_CONF_REMOTE_VIEWER "PBS_REMOTE_VIEWER"	/* Executable for remote viewer application alongwith its launch options, for PBS GUI jobs */
 #endif
@@ -459,6 +484,7 @@ DECLDIR int      parse_depend_list(char *, char **, int);
 DECLDIR int      parse_stage_list(char *);
 DECLDIR int      prepare_path(char *, char*);
 DECLDIR void     prt_job_err(char *, int, char *);
+DECLDIR void     prt_job_result(char *, struct batch_jobresult *);
 DECLDIR void     set_attr(struct attrl **, char *, char *);
 DECLDIR int      set_resources(struct attrl **, char *, int, char **);
 DECLDIR int      cnt2server(char *);
@@ -543,6 +569,7 @@ extern int      parse_destination_id(char *, char **, char **);
 extern int      parse_stage_list(char *);
 extern int      prepare_path(char *, char*);
 extern void     prt_job_err(char *, int, char *);
+extern void     prt_job_result(char *, struct batch_jobresult *);
 extern void     set_attr(struct attrl **, char *, char *);
 extern char*    pbs_get_dataservice_usr(char *, int);
 extern char*	get_attr(struct attrl *, char *, char *);
@@ -206,6 +206,11 @@ extern char *pbs_python_daemon_name;  /* pbs_python_external.c */
 
 
 /* -- BEGIN pbs_python_external.c implementations -- */
+
+/* a hook script "<hook>.PY" has its compiled bytecode cached in "<hook>.PC" */
+#define PY_HOOK_SCRIPT_SUFFIX	".PY"
+#define PY_BYTECODE_SUFFIX	".PC"
+
 extern void pbs_python_ext_start_interpreter(
 	struct python_interpreter_data *interp_data);
 extern void pbs_python_ext_shutdown_interpreter(
@@ -256,6 +261,9 @@ extern void pbs_python_ext_quick_shutdown_interpreter(void);
 #define PY_READONLY_FLAG	"_readonly"	/* an object is read-only */
 #define PY_RERUNJOB_FLAG	"_rerun"	/* flag some job to rerun */
 #define PY_DELETEJOB_FLAG	"_delete"	/* flag some job to be deleted*/
+#define PY_LOAD_FROM		"_load_from"	/* object whose attribute */
+/* values are loaded on */
+/* first access */
 
 /* List of attributes appearing in a Python job, resv, server, queue,	*/
 /* resource, and other PBS-related objects,  that are only defined in	*/
@@ -368,6 +376,7 @@ extern void pbs_python_ext_quick_shutdown_interpreter(void);
 #define PY_SIZE_TO_KBYTES_METHOD "size_to_kbytes"
 #define PY_MARK_VNODE_SET_METHOD "mark_vnode_set"
 #define PY_LOAD_RESOURCE_VALUE_METHOD "load_resource_value"
+#define PY_LOAD_OBJECT_VALUE_METHOD "load_object_value"
 #define PY_RESOURCE_STR_VALUE_METHOD "resource_str_value"
 #define PY_SET_C_MODE_METHOD 	"set_c_mode"
 #define PY_SET_PYTHON_MODE_METHOD "set_python_mode"
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+#ifndef	_PBS_TRACE_H
+#define	_PBS_TRACE_H
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/*
+ * Request tracing.
+ *
+ * With PBS_TRACE set in pbs.conf, pbs_submit() gives each submission a
+ * trace id which travels to the server in the request extension (see
+ * encode_DIS_ReqExtend()).  The server keeps the id with the job and
+ * passes it on to the MoM when the job is sent for execution.
+ *
+ * pbs_server, pbs_sched and pbs_mom record a span, a time stamp plus the
+ * trace id, job id and stage name, at each step of a job's way from
+ * submission to execution.  Spans collect in a ring held in memory and
+ * are appended to PBS_TRACE_FILE in the daemon's log directory whenever
+ * the ring fills or the daemon calls trace_flush() from its main loop.
+ * One line is written per span:
+ *
+ *	<sec>.<usec> <daemon> <trace id|-> <job id|-> <stage>
+ *
+ * pbs_tracereport joins the trace files of all daemons into per job
+ * latency breakdowns.
+ */
+
+#define PBS_TRACE_IDLEN		40	/* max length of a trace id */
+#define PBS_TRACE_STAGELEN	31	/* max length of a stage name */
+#define PBS_TRACE_FILE		"trace"
+#define PBS_TRACE_NONE		"-"	/* written for a missing id */
+#define PBS_TRACE_RING_DEFAULT	1024	/* spans held before a flush */
+
+extern int  trace_open(char *directory, char *daemon);
+extern int  trace_active(void);
+extern void trace_span(char *trace, char *objid, char *stage);
+extern void trace_flush(void);
+extern void trace_close(void);
+
+#ifdef	__cplusplus
+}
+#endif
+#endif	/* _PBS_TRACE_H */
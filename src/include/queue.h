@@ -158,6 +158,7 @@ struct pbs_queue {
 
 	int	qu_numjobs;			/* current numb jobs in queue */
 	int	qu_njstate[PBS_NUMJOBSTATE];	/* # of jobs per state */
+	pbs_list_head qu_jobstate[PBS_NUMJOBSTATE]; /* jobs in queue per state */
 	char	qu_jobstbuf[150];
 
 	/* the queue attributes */
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+#ifndef	_SVR_SNAPSHOT_H
+#define	_SVR_SNAPSHOT_H
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/*
+ * Server snapshot and journal.
+ *
+ * With PBS_SNAPSHOT_INTERVAL set in pbs.conf, a forked child of the server
+ * periodically writes an image of every job to SNAP_FILE in SNAP_DIR under
+ * server_priv, in the format of svr_snapshot.c, and the server appends to
+ * SNAP_JOURNAL.<generation> a record of each job save and purge made since.
+ * At a warm or hot start, pbsd_init() maps the snapshot and the journals
+ * and rebuilds each job from its latest image instead of the database,
+ * for the jobs whose database row agrees with the image.  The database
+ * stays the source of truth: jobs without a usable image are recovered
+ * from it.
+ */
+
+#define SNAP_DIR	"snapshot"	/* under server_priv */
+#define SNAP_FILE	"snapshot"
+#define SNAP_JOURNAL	"journal"	/* journal.<generation> */
+#define SNAP_VERSION	1		/* of the snapshot and journal format */
+
+struct pbs_db_job_info;
+
+extern int  snap_init(int type);
+extern job *snap_recov_job(struct pbs_db_job_info *dbjob);
+extern void snap_recov_done(void);
+extern void snap_journal_intent(char *jobid);
+extern void snap_journal_job(job *pjob);
+extern void snap_journal_quick(struct pbs_db_job_info *dbjob);
+extern void snap_journal_delete(char *jobid);
+extern void snap_shutdown(void);
+
+#ifdef	__cplusplus
+}
+#endif
+#endif	/* _SVR_SNAPSHOT_H */
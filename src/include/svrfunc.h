@@ -121,6 +121,11 @@ extern int node_delete_db(struct pbsnode *);
 extern int node_recov_db_raw(void *, pbs_list_head *);
 extern int save_attr_db(pbs_db_conn_t *, pbs_db_attr_info_t *,	struct attribute_def *, struct attribute *, int , int);
 extern int recov_attr_db(pbs_db_conn_t *, void *, pbs_db_attr_info_t *, struct attribute_def *, struct attribute *, int , int);
+extern struct svrattrl *make_attr(char *, char *, char *, int);
+extern int recov_attr_db_index(struct attribute_def *, void **, struct svrattrl *, int, int);
+extern void recov_attr_db_decode(void *, struct attribute_def *, struct attribute *, void **, int);
+extern int recov_attr_db_plain(struct attribute_def *);
+extern int recov_attr_db_predecode(struct attribute_def *, struct attribute *, void **, int);
 extern int svr_migrate_data_from_fs(void);
 extern int pbsd_init(int);
 extern int setup_nodes_fs(int);
@@ -405,9 +410,22 @@ struct	stat_cntl { /* used in req_stat_job */
 	char		      sc_jobid[PBS_MAXSVRJOBID+1];
 };
 
+/* sort and paging options of a Status Job or Select-Status request */
+struct stat_order {
+	int		     so_set;	/* options were given */
+	int		     so_index;	/* job attribute to sort on, -1 none */
+	struct resource_def *so_rdef;	/* resource to sort on, if a list */
+	int		     so_desc;	/* sort in descending order */
+	long		     so_offset;	/* number of jobs to skip */
+	long		     so_limit;	/* most jobs to return, -1 all */
+};
+
 extern  int 	status_job(job *, struct batch_request *, svrattrl  *, pbs_list_head *, int *);
 extern  int 	status_subjob(job *, struct batch_request *, svrattrl  *, int, pbs_list_head *, int *);
 extern	int	stat_to_mom(job *, struct stat_cntl *);
+extern	int	stat_extend_flag(char *, int);
+extern	int	parse_stat_order(struct batch_request *, struct stat_order *);
+extern	int	order_stat_jobs(job **, int, struct stat_order *, int *);
 
 #endif	/* STAT_CNTL */
 #ifdef	__cplusplus
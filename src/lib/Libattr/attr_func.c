@@ -316,7 +316,10 @@ attrlist_alloc(int szname, int szresc, int szval)
  * 	attrlist_create - create an svrattrl structure entry
  *
  *	The space required for the entry is calculated and allocated.
- * 	The attribute and resource name is copied into the entry.
+ * 	The attribute and resource name is copied into the entry, unless
+ *	attrlist_intern_names is set and both names are in the table of
+ *	attr_intern.c: the entry then points at the shared names and al_tsize
+ *	covers only the value, so it must not be saved or copied by al_tsize.
  * 	Note, the value string should be inserted by the caller after this returns.
  *
  * @param[in] aname - attribute name
@@ -335,6 +338,8 @@ attrlist_create(char  *aname, char  *rname, int vsize)
 	svrattrl *pal;
 	size_t	     asz;
 	size_t	     rsz;
+	char	    *iname;
+	char	    *iresc = NULL;
 
 	asz = strlen(aname) + 1;     /* attribute name,allow for null term */
 
@@ -343,6 +348,21 @@ attrlist_create(char  *aname, char  *rname, int vsize)
 	else
 		rsz = strlen(rname) + 1;
 
+	if (attrlist_intern_names &&
+		((iname = attr_intern_find(aname)) != NULL) &&
+		((rname == NULL) || ((iresc = attr_intern_find(rname)) != NULL))) {
+		/* share the names, only the value follows the struct */
+		pal = attrlist_alloc(0, 0, vsize);
+		if (pal != NULL) {
+			pal->al_name = iname;
+			pal->al_resc = iresc;
+			pal->al_nameln = asz;
+			pal->al_rescln = rsz;
+			pal->al_refct++;
+		}
+		return (pal);
+	}
+
 	pal = attrlist_alloc(asz, rsz, vsize);
 	if (pal != NULL) {
 		strcpy(pal->al_name, aname);    /* copy name right after struct */
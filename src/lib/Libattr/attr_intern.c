@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdlib.h>
+#include <string.h>
+#include "pbs_ifl.h"
+#include "list_link.h"
+#include "attribute.h"
+
+/**
+ * @file	attr_intern.c
+ * @brief
+ * 	A table of attribute and resource names shared by svrattrl entries.
+ *
+ *	Status replies and hook events encode every attribute of every object,
+ *	each entry with its own copy of the attribute and resource name.  The
+ *	daemon enters the names of its attribute and resource definitions here
+ *	once, and while attrlist_intern_names is set attrlist_create() points
+ *	al_name and al_resc of a new entry at the entered name instead of
+ *	copying it.  Two entries built that way have the same name if and only
+ *	if the pointers are equal.
+ *
+ *	Names are never removed, so a pointer returned remains valid for the
+ *	life of the process.  The table is not MT-safe, names are entered and
+ *	looked up by the main thread of the daemon.
+ *
+ * @par Included are:
+ *	attr_intern()
+ *	attr_intern_find()
+ *	attr_intern_defs()
+ */
+
+#define ATTR_INTERN_INIT 512	/* initial number of slots, a power of 2 */
+
+/* set while svrattrl entries should share the names of this table */
+int attrlist_intern_names = 0;
+
+static char	**intern_tbl = NULL;
+static unsigned	  intern_size = 0;
+static unsigned	  intern_count = 0;
+
+/**
+ * @brief
+ *	intern_hash - hash a name for the table
+ *
+ * @param[in] name - the name
+ *
+ * @return	unsigned
+ * @retval	hash value of name
+ */
+static unsigned
+intern_hash(char *name)
+{
+	unsigned h = 5381;
+
+	while (*name)
+		h = (h * 33) ^ (unsigned char)*name++;
+	return h;
+}
+
+/**
+ * @brief
+ *	intern_slot - find the slot of a name, or the empty slot where it
+ *	would be entered
+ *
+ * @param[in] tbl  - the table
+ * @param[in] size - number of slots in tbl, a power of 2
+ * @param[in] name - the name
+ *
+ * @return	char **
+ * @retval	the slot
+ */
+static char **
+intern_slot(char **tbl, unsigned size, char *name)
+{
+	unsigned i;
+
+	i = intern_hash(name) & (size - 1);
+	while ((tbl[i] != NULL) && (strcmp(tbl[i], name) != 0))
+		i = (i + 1) & (size - 1);
+	return (&tbl[i]);
+}
+
+/**
+ * @brief
+ *	intern_add - enter a name in the table, the table keeps the pointer
+ *
+ * @param[in] name - the name, must not be freed or changed afterwards
+ *
+ * @return	char *
+ * @retval	the entered name, or the equal name entered before
+ * @retval	NULL	if the table could not be allocated or grown
+ */
+static char *
+intern_add(char *name)
+{
+	char	**slot;
+	char	**ntbl;
+	unsigned  nsize;
+	unsigned  i;
+
+	if ((intern_count + 1) * 2 > intern_size) {
+		nsize = (intern_size == 0) ? ATTR_INTERN_INIT : intern_size * 2;
+		ntbl = (char **)calloc(nsize, sizeof(char *));
+		if (ntbl == NULL)
+			return NULL;
+		for (i = 0; i < intern_size; i++) {
+			if (intern_tbl[i] != NULL)
+				*intern_slot(ntbl, nsize, intern_tbl[i]) = intern_tbl[i];
+		}
+		free(intern_tbl);
+		intern_tbl = ntbl;
+		intern_size = nsize;
+	}
+
+	slot = intern_slot(intern_tbl, intern_size, name);
+	if (*slot == NULL) {
+		*slot = name;
+		intern_count++;
+	}
+	return (*slot);
+}
+
+/**
+ * @brief
+ *	attr_intern_find - look up a name in the table
+ *
+ * @param[in] name - the name
+ *
+ * @return	char *
+ * @retval	the shared copy of name
+ * @retval	NULL	if name was not entered
+ */
+char *
+attr_intern_find(char *name)
+{
+	if ((intern_tbl == NULL) || (name == NULL))
+		return NULL;
+	return (*intern_slot(intern_tbl, intern_size, name));
+}
+
+/**
+ * @brief
+ *	attr_intern - enter a copy of a name in the table, as for a resource
+ *	defined while the daemon runs
+ *
+ * @param[in] name - the name
+ *
+ * @return	char *
+ * @retval	the shared copy of name
+ * @retval	NULL	on memory allocation failure
+ */
+char *
+attr_intern(char *name)
+{
+	char *p;
+
+	if ((p = attr_intern_find(name)) != NULL)
+		return p;
+	if ((p = strdup(name)) == NULL)
+		return NULL;
+	if (intern_add(p) != p) {
+		free(p);
+		return NULL;
+	}
+	return p;
+}
+
+/**
+ * @brief
+ *	attr_intern_defs - enter the names of an attribute definition array
+ *
+ *	The names are entered without copying them, the definition arrays
+ *	are static.
+ *
+ * @param[in] padef - attribute definition array
+ * @param[in] limit - number of entries in padef
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	on memory allocation failure
+ */
+int
+attr_intern_defs(attribute_def *padef, int limit)
+{
+	int i;
+
+	for (i = 0; i < limit; i++) {
+		if (intern_add((padef + i)->at_name) == NULL)
+			return -1;
+	}
+	return 0;
+}
@@ -48,26 +48,24 @@
 
 /**
  * @brief
- *	Print the error message returned by the server, if supplied. Otherwise,
- * 	print a default error message.
+ *	Print an error message for a job, or a default one if errmsg is NULL.
  *
- * @param[in] cmd - error msg
- * @param[in] connect - fd
- * @param[in] id - error id
+ * @param[in] cmd - command name
+ * @param[in] errmsg - message returned by the server, may be NULL
+ * @param[in] errcode - PBS error code
+ * @param[in] id - job id
  *
  * @return	Void
  *
  */
 
-void
-prt_job_err(char *cmd, int connect, char *id)
+static void
+prt_err_msg(char *cmd, char *errmsg, int errcode, char *id)
 {
-	char *errmsg;
 	char *histerrmsg = NULL;
 
-	errmsg = pbs_geterrmsg(connect);
 	if (errmsg != NULL) {
-		if (pbs_geterrno() == PBSE_HISTJOBID) {
+		if (errcode == PBSE_HISTJOBID) {
 			histerrmsg = malloc(strlen(errmsg) + strlen(id) + 1);
 			if (histerrmsg) {
 				sprintf(histerrmsg, errmsg, id);
@@ -77,13 +75,51 @@ prt_job_err(char *cmd, int connect, char *id)
 			} else {
 				fprintf(stderr,
 					"%s: Server returned error %d for job %s\n",
-					cmd, pbs_errno, id);
+					cmd, errcode, id);
 			}
 			return;
 		}
 		fprintf(stderr, "%s: %s ", cmd, errmsg);
 	} else {
-		fprintf(stderr, "%s: Server returned error %d for job ", cmd, pbs_errno);
+		fprintf(stderr, "%s: Server returned error %d for job ", cmd, errcode);
 	}
 	fprintf(stderr, "%s\n", id);
 }
+
+/**
+ * @brief
+ *	Print the error message returned by the server, if supplied. Otherwise,
+ * 	print a default error message.
+ *
+ * @param[in] cmd - error msg
+ * @param[in] connect - fd
+ * @param[in] id - error id
+ *
+ * @return	Void
+ *
+ */
+
+void
+prt_job_err(char *cmd, int connect, char *id)
+{
+	prt_err_msg(cmd, pbs_geterrmsg(connect), pbs_geterrno(), id);
+}
+
+/**
+ * @brief
+ *	Print the error returned for one job of a job list request, see
+ *	pbs_deljoblist().  pbs_errno is set to the error of the job.
+ *
+ * @param[in] cmd - command name
+ * @param[in] pres - result of the job
+ *
+ * @return	Void
+ *
+ */
+
+void
+prt_job_result(char *cmd, struct batch_jobresult *pres)
+{
+	pbs_errno = pres->code;
+	prt_err_msg(cmd, pres->text, pres->code, pres->name);
+}
@@ -78,6 +78,8 @@ load_attr(PGresult *res, pbs_db_attr_info_t *pattr, int row)
 		PQfnumber(res, "attr_value")); /* value */
 	pattr->attr_flags = strtol(PQgetvalue(res, row,
 		PQfnumber(res, "attr_flags")), NULL, 10); /* flags */
+	if (PQnfields(res) > 4)
+		pattr->parent_id = PQgetvalue(res, row, 0); /* all parents query */
 }
 
 /**
@@ -476,6 +478,16 @@ pg_db_find_attr(pbs_db_conn_t *conn, void* st,
 	if (!state)
 		return -1;
 
+	if (pattr->parent_obj_type == PARENT_TYPE_JOB &&
+		opts != NULL && (opts->flags & PBS_DB_ATTR_ALL_PARENTS)) {
+		if ((rc = pg_db_query(conn, STMT_SELECT_JOBATTR_ALL, 0, &res)) != 0)
+			return rc;
+		state->row = 0;
+		state->res = res;
+		state->count = PQntuples(res);
+		return 0;
+	}
+
 	if (pattr->parent_obj_type == PARENT_TYPE_JOB)
 		strcpy(conn->conn_sql, STMT_SELECT_JOBATTR);
 	else if (pattr->parent_obj_type == PARENT_TYPE_SERVER)
@@ -188,6 +188,13 @@ pg_db_prepare_job_sqls(pbs_db_conn_t *conn)
 	if (pg_prepare_stmt(conn, STMT_SELECT_JOBATTR, conn->conn_sql, 1) != 0)
 		return -1;
 
+	sprintf(conn->conn_sql, "select "
+		"ji_jobid, attr_name, attr_resource, attr_value, attr_flags "
+		"from pbs.job_attr "
+		"order by ji_jobid");
+	if (pg_prepare_stmt(conn, STMT_SELECT_JOBATTR_ALL, conn->conn_sql, 0) != 0)
+		return -1;
+
 	/*
 	 * Use the sql encode function to encode the $2 parameter. Encode using
 	 * 'escape' mode. Encode considers $2 as a bytea and returns a escaped
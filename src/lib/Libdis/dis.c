@@ -51,6 +51,7 @@ int (*dis_gets)(int stream, char *string, size_t count)	= NULL;
 int (*disr_skip)(int stream, size_t nskips)			= NULL;
 int (*disw_commit)(int stream, int commit)			= NULL;
 int (*disr_commit)(int stream, int commit)			= NULL;
+int (*dis_binary)(int stream)					= NULL;
 
 const char *dis_emsg[] = {"No error",
 	"Input value too large to convert to this type",
@@ -65,6 +65,11 @@ disrsl_(int stream, int *negate, unsigned long *value,
 	unsigned long count, int recursv);
 int disrsll_(int stream,  int  *negate,  u_Long *value, unsigned long count, int recursv);
 int diswui_(int stream, unsigned value);
+int diswbin_(int stream, int negate, u_Long value);
+int disrbin_(int stream, int *negate, u_Long *value);
+
+/* true if integers on stream use the binary framing of disbin_.c */
+#define DIS_BINARY(stream) ((dis_binary != NULL) && (*dis_binary)(stream))
 
 extern unsigned dis_dmx10;
 extern double *dis_dp10;
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+
+/**
+ * @file	dis_codec_test.c
+ *
+ * @brief	Round trip check of the two DIS integer codecs
+ *
+ * @par		Functionality:
+ *
+ *		Writes edge values of every DIS integer, float and string type
+ *		over a socket pair, once with Data-is-Strings and once with the
+ *		binary framing of disbin_.c, and reads them back.  Every value
+ *		must come back as it was sent, and both codecs must give the
+ *		same result.  Only the writing end is the fd last set up by the
+ *		process, so both ways tcp_binary() finds the mode are used.
+ *
+ *		Not installed, build with "make dis_codec_test".
+ *
+ * Usage: dis_codec_test
+ */
+
+#include <pbs_config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "libpbs.h"
+#include "pbs_client_thread.h"
+#include "dis.h"
+
+static long slongs[] = {
+	0, 1, -1, 9, -9, 10, -10, 31, 32, -32, -33, 63, 64, -64, -65,
+	8191, 8192, -8192, -8193, INT_MAX, INT_MIN, INT_MAX + 1L,
+	INT_MIN - 1L, LONG_MAX, LONG_MAX - 1, LONG_MIN + 1, LONG_MIN
+};
+
+static unsigned long ulongs[] = {
+	0, 1, 9, 10, 63, 64, 127, 128, 16383, 16384, UINT_MAX - 1,
+	UINT_MAX, UINT_MAX + 1UL, ULONG_MAX - 1, ULONG_MAX
+};
+
+static u_Long ulls[] = {
+	0, 1, 99, 100, UINT_MAX, UINT_MAX + 1ULL, ULLONG_MAX - 1, ULLONG_MAX
+};
+
+static double doubles[] = {
+	0.0, 1.0, -1.0, 0.5, -0.25, 0.1, 10.0, 123456789.0, -2.5e10,
+	3.0e-5, 1.0e-300, -1.0e300, 1.0e300
+};
+
+static float floats[] = {
+	0.0, 1.0, -1.0, 0.5, -3.25, 1.0e-30, -1.0e30, 3.0e38
+};
+
+/* results of a round, one per codec */
+struct round {
+	long		slongs[sizeof(slongs) / sizeof(slongs[0])];
+	unsigned long	ulongs[sizeof(ulongs) / sizeof(ulongs[0])];
+	u_Long		ulls[sizeof(ulls) / sizeof(ulls[0])];
+	double		doubles[sizeof(doubles) / sizeof(doubles[0])];
+	float		floats[sizeof(floats) / sizeof(floats[0])];
+	char		*strs[3];
+};
+
+#define NELEM(a)	(sizeof(a) / sizeof((a)[0]))
+
+static char *strs[3];
+
+/**
+ * @brief
+ *	Check that a floating point value read back is the one written, to
+ *	the digits DIS sends for it
+ *
+ * @param[in] sent - value written
+ * @param[in] got - value read
+ * @param[in] ndigs - significant digits sent
+ *
+ * @return	int
+ * @retval	1 - the same value
+ * @retval	0 - a different value
+ */
+static int
+same_float(double sent, double got, int ndigs)
+{
+	if (sent == 0.0)
+		return (got == 0.0);
+	return (fabs((got - sent) / sent) <= pow(10.0, 1 - ndigs));
+}
+
+/**
+ * @brief
+ *	Send every value from wfd to rfd with the given codec and read them
+ *	back into res
+ *
+ * @param[in] wfd - writing end, DIS set up
+ * @param[in] rfd - reading end, DIS set up
+ * @param[in] binary - 1 for the binary framing
+ * @param[out] res - values read
+ *
+ * @return	int
+ * @retval	0 - all values read back as written
+ * @retval	1 - an error or a different value
+ */
+static int
+run_round(int wfd, int rfd, int binary, struct round *res)
+{
+	const char *name = binary ? "binary" : "classic";
+	size_t	i;
+	size_t	len;
+	int	rc = DIS_SUCCESS;
+	int	bad = 0;
+
+	if ((DIS_tcp_set_binary(wfd, binary) != 0) ||
+		(DIS_tcp_set_binary(rfd, binary) != 0)) {
+		fprintf(stderr, "%s: cannot set the codec\n", name);
+		return 1;
+	}
+
+	for (i = 0; (i < NELEM(slongs)) && (rc == DIS_SUCCESS); i++)
+		rc = diswsl(wfd, slongs[i]);
+	for (i = 0; (i < NELEM(slongs)) && (rc == DIS_SUCCESS); i++)
+		rc = diswsi(wfd, (int)slongs[i]);
+	for (i = 0; (i < NELEM(ulongs)) && (rc == DIS_SUCCESS); i++)
+		rc = diswul(wfd, ulongs[i]);
+	for (i = 0; (i < NELEM(ulongs)) && (rc == DIS_SUCCESS); i++)
+		rc = diswui(wfd, (unsigned)ulongs[i]);
+	for (i = 0; (i < NELEM(ulls)) && (rc == DIS_SUCCESS); i++)
+		rc = diswull(wfd, ulls[i]);
+	for (i = 0; (i < NELEM(doubles)) && (rc == DIS_SUCCESS); i++)
+		rc = diswd(wfd, doubles[i]);
+	for (i = 0; (i < NELEM(floats)) && (rc == DIS_SUCCESS); i++)
+		rc = diswf(wfd, floats[i]);
+	for (i = 0; (i < NELEM(strs)) && (rc == DIS_SUCCESS); i++)
+		rc = diswst(wfd, strs[i]);
+	if ((rc != DIS_SUCCESS) || (DIS_tcp_wflush(wfd) != 0)) {
+		fprintf(stderr, "%s: write failed: %s\n", name, dis_emsg[rc]);
+		return 1;
+	}
+
+	for (i = 0; i < NELEM(slongs); i++) {
+		res->slongs[i] = disrsl(rfd, &rc);
+		if ((rc != DIS_SUCCESS) || (res->slongs[i] != slongs[i])) {
+			fprintf(stderr, "%s: long %ld read as %ld: %s\n", name,
+				slongs[i], res->slongs[i], dis_emsg[rc]);
+			bad = 1;
+		}
+	}
+	for (i = 0; i < NELEM(slongs); i++) {
+		int v = disrsi(rfd, &rc);
+
+		if ((rc != DIS_SUCCESS) || (v != (int)slongs[i])) {
+			fprintf(stderr, "%s: int %d read as %d: %s\n", name,
+				(int)slongs[i], v, dis_emsg[rc]);
+			bad = 1;
+		}
+	}
+	for (i = 0; i < NELEM(ulongs); i++) {
+		res->ulongs[i] = disrul(rfd, &rc);
+		if ((rc != DIS_SUCCESS) || (res->ulongs[i] != ulongs[i])) {
+			fprintf(stderr, "%s: unsigned long %lu read as %lu: %s\n",
+				name, ulongs[i], res->ulongs[i], dis_emsg[rc]);
+			bad = 1;
+		}
+	}
+	for (i = 0; i < NELEM(ulongs); i++) {
+		unsigned v = disrui(rfd, &rc);
+
+		if ((rc != DIS_SUCCESS) || (v != (unsigned)ulongs[i])) {
+			fprintf(stderr, "%s: unsigned %u read as %u: %s\n", name,
+				(unsigned)ulongs[i], v, dis_emsg[rc]);
+			bad = 1;
+		}
+	}
+	for (i = 0; i < NELEM(ulls); i++) {
+		res->ulls[i] = disrull(rfd, &rc);
+		if ((rc != DIS_SUCCESS) || (res->ulls[i] != ulls[i])) {
+			fprintf(stderr, "%s: u_Long %llu read as %llu: %s\n", name,
+				ulls[i], res->ulls[i], dis_emsg[rc]);
+			bad = 1;
+		}
+	}
+	for (i = 0; i < NELEM(doubles); i++) {
+		res->doubles[i] = disrd(rfd, &rc);
+		if ((rc != DIS_SUCCESS) ||
+			!same_float(doubles[i], res->doubles[i], DBL_DIG)) {
+			fprintf(stderr, "%s: double %g read as %g: %s\n", name,
+				doubles[i], res->doubles[i], dis_emsg[rc]);
+			bad = 1;
+		}
+	}
+	for (i = 0; i < NELEM(floats); i++) {
+		res->floats[i] = disrf(rfd, &rc);
+		if ((rc != DIS_SUCCESS) ||
+			!same_float(floats[i], res->floats[i], FLT_DIG)) {
+			fprintf(stderr, "%s: float %g read as %g: %s\n", name,
+				floats[i], res->floats[i], dis_emsg[rc]);
+			bad = 1;
+		}
+	}
+	for (i = 0; i < NELEM(strs); i++) {
+		res->strs[i] = disrcs(rfd, &len, &rc);
+		if ((rc != DIS_SUCCESS) || (len != strlen(strs[i])) ||
+			(memcmp(res->strs[i], strs[i], len) != 0)) {
+			fprintf(stderr, "%s: string of %lu chars read back wrong: %s\n",
+				name, (unsigned long)strlen(strs[i]), dis_emsg[rc]);
+			bad = 1;
+		}
+	}
+	if (DIS_tcp_rpending(rfd)) {
+		fprintf(stderr, "%s: data left unread\n", name);
+		bad = 1;
+	}
+
+	printf("%-8s %s\n", name, bad ? "FAILED" : "ok");
+	return bad;
+}
+
+/**
+ * @brief
+ *	main - entry point of dis_codec_test
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	1 - failure
+ */
+int
+main(int argc, char *argv[])
+{
+	struct round	classic;
+	struct round	binary;
+	int		sv[2];
+	int		rc = 0;
+	size_t		i;
+
+	if (pbs_client_thread_init_thread_context() != 0) {
+		fprintf(stderr, "cannot initialize the thread context\n");
+		return 1;
+	}
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == -1) {
+		perror("socketpair");
+		return 1;
+	}
+	strs[0] = "";
+	strs[1] = "x";
+	if ((strs[2] = malloc(70000)) == NULL)
+		return 1;
+	for (i = 0; i < 69999; i++)
+		strs[2][i] = (char)(1 + i % 255);
+	strs[2][i] = '\0';
+
+	DIS_tcp_setup(sv[1]);
+	DIS_tcp_setup(sv[0]);
+	memset(&classic, 0, sizeof(classic));
+	memset(&binary, 0, sizeof(binary));
+
+	/* write on the end set up last, read on the other */
+	rc |= run_round(sv[0], sv[1], 0, &classic);
+	rc |= run_round(sv[0], sv[1], 1, &binary);
+
+	if ((memcmp(classic.slongs, binary.slongs, sizeof(classic.slongs)) != 0) ||
+		(memcmp(classic.ulongs, binary.ulongs, sizeof(classic.ulongs)) != 0) ||
+		(memcmp(classic.ulls, binary.ulls, sizeof(classic.ulls)) != 0) ||
+		(memcmp(classic.doubles, binary.doubles, sizeof(classic.doubles)) != 0) ||
+		(memcmp(classic.floats, binary.floats, sizeof(classic.floats)) != 0)) {
+		fprintf(stderr, "the codecs read different values\n");
+		rc = 1;
+	}
+	for (i = 0; i < NELEM(strs); i++) {
+		free(classic.strs[i]);
+		free(binary.strs[i]);
+	}
+	free(strs[2]);
+	close(sv[0]);
+	close(sv[1]);
+	return rc;
+}
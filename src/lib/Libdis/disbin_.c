@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "dis.h"
+#include "dis_.h"
+/**
+ * @file	disbin_.c
+ * @brief
+ *	Binary framing of DIS integers, used instead of the Data-is-Strings
+ *	digit counts on streams for which dis_binary says so, see
+ *	DIS_tcp_set_binary().
+ *
+ *	An integer is sent as its magnitude in groups of bits, least
+ *	significant first.  The first byte holds the sign in bit 6 and the
+ *	low 6 bits of the magnitude, the following bytes 7 bits each.  Bit 7
+ *	of a byte is set when another byte follows.  Strings keep their
+ *	count followed by the characters as they are.
+ */
+
+/* bytes of the longest binary integer, a 64 bit magnitude */
+#define DIS_BIN_MAXLEN	10
+
+/**
+ * @brief
+ *	Write an integer in binary framing to <stream>, without committing it.
+ *
+ * @param[in] stream    socket fd
+ * @param[in] negate    non zero for a negative value
+ * @param[in] value     magnitude of the value
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS     success
+ * @retval      DIS_PROTO       error
+ *
+ */
+int
+diswbin_(int stream, int negate, u_Long value)
+{
+	char		buf[DIS_BIN_MAXLEN];
+	size_t		n = 0;
+
+	assert(stream >= 0);
+	assert(dis_puts != NULL);
+
+	buf[n] = (char)((value & 0x3f) | (negate ? 0x40 : 0));
+	value >>= 6;
+	while (value != 0) {
+		buf[n++] |= (char)0x80;
+		buf[n] = (char)(value & 0x7f);
+		value >>= 7;
+	}
+	n++;
+
+	if ((*dis_puts)(stream, buf, n) < 0)
+		return (DIS_PROTO);
+	return (DIS_SUCCESS);
+}
+
+/**
+ * @brief
+ *	Read an integer in binary framing from <stream>, without committing it.
+ *
+ * @param[in]  stream    socket fd
+ * @param[out] negate    set to TRUE for a negative value
+ * @param[out] value     magnitude of the value
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS     success
+ * @retval      DIS_OVERFLOW    value does not fit in a u_Long
+ * @retval      DIS_PROTO       overlong encoding
+ * @retval      DIS_EOD         premature end of message
+ * @retval      DIS_EOF         end of file
+ *
+ */
+int
+disrbin_(int stream, int *negate, u_Long *value)
+{
+	int		c;
+	int		n;
+	unsigned	shift;
+	u_Long		locval;
+
+	assert(negate != NULL);
+	assert(value != NULL);
+	assert(stream >= 0);
+	assert(dis_getc != NULL);
+
+	*value = 0;
+	*negate = FALSE;
+	if ((c = (*dis_getc)(stream)) < 0)
+		return (c == -2 ? DIS_EOF : DIS_EOD);
+	c &= 0xff;
+	*negate = (c & 0x40) != 0;
+	locval = c & 0x3f;
+	shift = 6;
+	for (n = 1; c & 0x80; n++) {
+		if (n >= DIS_BIN_MAXLEN)
+			return (DIS_PROTO);
+		if ((c = (*dis_getc)(stream)) < 0)
+			return (c == -2 ? DIS_EOF : DIS_EOD);
+		c &= 0xff;
+		if ((shift >= sizeof(u_Long) * CHAR_BIT) ||
+			((u_Long)(c & 0x7f) >
+			(~(u_Long)0 >> shift))) {
+			*value = ~(u_Long)0;
+			return (DIS_OVERFLOW);
+		}
+		locval |= (u_Long)(c & 0x7f) << shift;
+		shift += 7;
+	}
+	*value = locval;
+	return (DIS_SUCCESS);
+}
@@ -73,6 +73,19 @@ disrsi_(int stream, int *negate, unsigned *value, unsigned count, int recursv)
 	assert(dis_getc != NULL);
 	assert(dis_gets != NULL);
 
+	if (DIS_BINARY(stream)) {
+		u_Long	bval;
+
+		c = disrbin_(stream, negate, &bval);
+		if ((c == DIS_OVERFLOW) ||
+			((c == DIS_SUCCESS) && (bval > UINT_MAX))) {
+			*value = UINT_MAX;
+			return (DIS_OVERFLOW);
+		}
+		*value = (unsigned)bval;
+		return (c);
+	}
+
 	if (++recursv > DIS_RECURSIVE_LIMIT)
 		return (DIS_PROTO);
 	/* dis_umaxd would be initialized by prior call to dis_init_tables */
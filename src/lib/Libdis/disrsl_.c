@@ -75,6 +75,19 @@ disrsl_(int stream, int *negate, unsigned long *value, unsigned long count, int
 	assert(dis_getc != NULL);
 	assert(dis_gets != NULL);
 
+	if (DIS_BINARY(stream)) {
+		u_Long	bval;
+
+		c = disrbin_(stream, negate, &bval);
+		if ((c == DIS_OVERFLOW) ||
+			((c == DIS_SUCCESS) && (bval > ULONG_MAX))) {
+			*value = ULONG_MAX;
+			return (DIS_OVERFLOW);
+		}
+		*value = (unsigned long)bval;
+		return (c);
+	}
+
 	if (++recursv > DIS_RECURSIVE_LIMIT)
 		return (DIS_PROTO);
 
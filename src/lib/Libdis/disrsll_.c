@@ -92,6 +92,9 @@ disrsll_(int stream, int *negate, u_Long *value, unsigned long count, int recurs
 	assert(dis_getc != NULL);
 	assert(dis_gets != NULL);
 
+	if (DIS_BINARY(stream))
+		return (disrbin_(stream, negate, value));
+
 	if (++recursv > DIS_RECURSIVE_LIMIT)
 		return (DIS_PROTO);
 
@@ -96,11 +96,12 @@ diswl_(int stream, dis_long_double_t value, unsigned ndigs)
 
 	/* Make zero a special case.  If we don't it will blow exponent		*/
 	/* calculation.								*/
+	/* The exponent is written as any integer, see diswsi.		*/
 	if (value == 0.0L) {
-		retval = (*dis_puts)(stream, "+0+0", 4) < 0 ?
-			DIS_PROTO : DIS_SUCCESS;
-		return (((*disw_commit)(stream, retval == DIS_SUCCESS) < 0) ?
-			DIS_NOCOMMIT : retval);
+		if ((*dis_puts)(stream, "+0", 2) < 0)
+			return (((*disw_commit)(stream, FALSE) < 0) ?
+				DIS_NOCOMMIT : DIS_PROTO);
+		return (diswsi(stream, 0));
 	}
 	/* Extract the sign from the coefficient.				*/
 	ldval = (negate = value < 0.0L) ? -value : value;
@@ -103,6 +103,11 @@ diswsi(int stream, int value)
 		uval = value;
 		c = '+';
 	}
+	if (DIS_BINARY(stream)) {
+		retval = diswbin_(stream, c == '-', (u_Long)uval);
+		return (((*disw_commit)(stream, retval == DIS_SUCCESS) < 0) ?
+			DIS_NOCOMMIT : retval);
+	}
 	cp = discui_(&dis_buffer[DIS_BUFSIZ], uval, &ndigs);
 	*--cp = c;
 	while (ndigs > 1)
@@ -103,6 +103,11 @@ diswsl(int stream, long value)
 		ulval = value;
 		c = '+';
 	}
+	if (DIS_BINARY(stream)) {
+		retval = diswbin_(stream, c == '-', (u_Long)ulval);
+		return (((*disw_commit)(stream, retval == DIS_SUCCESS) < 0) ?
+			DIS_NOCOMMIT : retval);
+	}
 	cp = discul_(&dis_buffer[DIS_BUFSIZ], ulval, &ndigs);
 	*--cp = c;
 	while (ndigs > 1)
@@ -68,6 +68,9 @@ diswui_(int stream, unsigned value)
 	assert(stream >= 0);
 	assert(dis_puts != NULL);
 
+	if (DIS_BINARY(stream))
+		return (diswbin_(stream, FALSE, (u_Long)value));
+
 	cp = discui_(&dis_buffer[DIS_BUFSIZ], value, &ndigs);
 	*--cp = '+';
 	while (ndigs > 1)
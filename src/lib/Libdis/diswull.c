@@ -96,6 +96,11 @@ diswull(int stream, u_Long value)
 	assert(dis_puts != NULL);
 	assert(disw_commit != NULL);
 
+	if (DIS_BINARY(stream)) {
+		retval = diswbin_(stream, FALSE, value);
+		return (((*disw_commit)(stream, retval == DIS_SUCCESS) < 0) ?
+			DIS_NOCOMMIT : retval);
+	}
 
 	cp = discull_(&dis_buffer[DIS_BUFSIZ], value, &ndigs);
 	*--cp = '+';
@@ -1425,6 +1425,31 @@ __pbs_tcptimeout_location(void)
 	return (&p->th_pbs_tcp_timeout);
 }
 
+/**
+ * @brief
+ *	Returns the address of pbs_current_trace.
+ *
+ * @par Functionality:
+ *	This function returns address of the per thread location of
+ *	pbs_current_trace from the TLS by calling
+ *	@see __pbs_client_thread_get_context_data
+ *
+ * @retval	Address of the pbs_current_trace from TLS (success)
+ *
+ * @par Side-effects:
+ *	None
+ *
+ * @par Reentrancy:
+ *	Reentrant
+ */
+char **
+__pbs_trace_location(void)
+{
+	struct pbs_client_thread_context *p =
+		pbs_client_thread_get_context_data();
+	return (&p->th_pbs_trace);
+}
+
 
 /**
  * @brief
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+/**
+ * @file	dec_CopyHookBundle.c
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <sys/types.h>
+#include <stdlib.h>
+#include "libpbs.h"
+#include "list_link.h"
+#include "server_limits.h"
+#include "attribute.h"
+#include "credential.h"
+#include "batch_request.h"
+#include "dis.h"
+
+/**
+ *
+ * @brief
+ *	Decode the data items needed for a Copy Hook Bundle request as:
+ *			string	bundle hash
+ *			u int	number of files
+ *		then for each file:
+ *			string	hook file name
+ *			u int	size of file data
+ *			cnt str	file data contents
+ *
+ * @param[in]	sock	- the connection to get data from.
+ * @param[in]	preq	- a request structure
+ *
+ * @return	int
+ * @retval	0 for success
+ *		non-zero otherwise
+ *
+ * @note
+ *	On failure the files decoded so far are left in
+ *	preq->rq_ind.rq_hookbundle for free_br() to release.
+ */
+
+int
+decode_DIS_CopyHookBundle(int sock, struct batch_request *preq)
+{
+	int   rc = 0;
+	int   count;
+	int   i;
+	size_t amt;
+	struct hook_bundle_file *pf;
+
+	if (preq == NULL)
+		return 0;
+
+	preq->rq_ind.rq_hookbundle.rq_count = 0;
+	preq->rq_ind.rq_hookbundle.rq_files = NULL;
+
+	if ((rc = disrfst(sock, HOOK_BUNDLE_HASH_SIZE+1,
+		preq->rq_ind.rq_hookbundle.rq_hash)) != 0)
+		return rc;
+
+	count = disrui(sock, &rc);
+	if (rc) return rc;
+	if (count == 0)
+		return 0;
+
+	preq->rq_ind.rq_hookbundle.rq_files =
+		calloc(count, sizeof(struct hook_bundle_file));
+	if (preq->rq_ind.rq_hookbundle.rq_files == NULL)
+		return DIS_NOMALLOC;
+
+	for (i = 0; i < count; i++) {
+		pf = &preq->rq_ind.rq_hookbundle.rq_files[i];
+		preq->rq_ind.rq_hookbundle.rq_count++;
+
+		if ((rc = disrfst(sock, MAXPATHLEN+1, pf->hbf_name)) != 0)
+			return rc;
+
+		pf->hbf_size = disrui(sock, &rc);
+		if (rc) return rc;
+
+		pf->hbf_data = disrcs(sock, &amt, &rc);
+		if ((amt != pf->hbf_size) && (rc == 0))
+			rc = DIS_EOD;
+		if (rc)
+			return rc;
+	}
+
+	return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+
+
+/**
+ * @file	dec_JobList.c
+ * @brief
+ * 	decode_DIS_JobList() - decode a Job List batch request
+ *
+ *	The batch_request structure must already exist (be allocated by the
+ *	caller.   It is assumed that the header fields (protocol type,
+ *	protocol version, request type, and user name) have already be decoded.
+ *
+ * @par Data items are:
+ * 			unsigned int	request type of the operation
+ *			string		argument (hold types or signal name)
+ *			unsigned int	count of job ids
+ * 			string		job id (count times)
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <sys/types.h>
+#include <stdlib.h>
+#include "libpbs.h"
+#include "list_link.h"
+#include "server_limits.h"
+#include "attribute.h"
+#include "credential.h"
+#include "batch_request.h"
+#include "dis.h"
+
+/**
+ * @brief-
+ *	decode a Job List batch request
+ *
+ * @par	Functionality:
+ *		The job ids are read into a malloc-ed array which, with the
+ *		argument string, is freed by free_br().
+ *
+ * @param[in] sock - socket descriptor
+ * @param[out] preq - pointer to batch_request structure
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+decode_DIS_JobList(int sock, struct batch_request *preq)
+{
+	int rc;
+	int ct;
+	struct rq_joblist *plist = &preq->rq_ind.rq_joblist;
+
+	plist->rq_arg = NULL;
+	plist->rq_count = 0;
+	plist->rq_jobs = NULL;
+	plist->rq_last = NULL;
+	CLEAR_HEAD(plist->rq_attr);
+
+	plist->rq_op = disrui(sock, &rc);
+	if (rc) return rc;
+
+	plist->rq_arg = disrst(sock, &rc);
+	if (rc) return rc;
+
+	ct = disrui(sock, &rc);
+	if (rc) return rc;
+	if (ct <= 0)
+		return DIS_PROTO;
+
+	plist->rq_jobs = (char **)calloc(ct, sizeof(char *));
+	if (plist->rq_jobs == NULL)
+		return DIS_NOMALLOC;
+
+	while (plist->rq_count < ct) {
+		plist->rq_jobs[plist->rq_count] = disrst(sock, &rc);
+		if (rc) return rc;
+		plist->rq_count++;
+	}
+	return 0;
+}
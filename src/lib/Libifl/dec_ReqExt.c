@@ -47,8 +47,8 @@
  *	protocol version, request type, and user name) and the request body
  *	have already be decoded.
  *
- *	The next field is an unsigned integer which is 1 if there is an
- *	extension string and zero if not.
+ *	The next field is an unsigned integer of PBS_REQEXT_* bits telling
+ *	whether an extension string and a trace id string follow.
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -72,8 +72,9 @@
  *		protocol version, request type, and user name) and the request body
  *		have already be decoded.
  *
- * Note:The next field is an unsigned integer which is 1 if there is an
- *      extension string and zero if not.
+ * Note:The next field is an unsigned integer of PBS_REQEXT_* bits, the
+ *      extension string follows if PBS_REQEXT_EXTEND is set and then the
+ *      trace id if PBS_REQEXT_TRACE is set.
  *
  * @param[in] sock - socket descriptor
  * @param[out] preq - pointer to batch_request structure
@@ -92,10 +93,9 @@ decode_DIS_ReqExtend(int sock, struct batch_request *preq)
 
 	i = disrui(sock, &rc);	/* indicates if an extension exists */
 
-	if (rc == 0) {
-		if (i != 0) {
-			preq->rq_extend = disrst(sock, &rc);
-		}
-	}
+	if ((rc == 0) && (i & PBS_REQEXT_EXTEND))
+		preq->rq_extend = disrst(sock, &rc);
+	if ((rc == 0) && (i & PBS_REQEXT_TRACE))
+		preq->rq_trace = disrst(sock, &rc);
 	return (rc);
 }
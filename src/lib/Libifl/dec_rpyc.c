@@ -89,6 +89,8 @@ decode_DIS_replyCmd(int sock, struct batch_reply *reply)
 	struct brp_select   **pselx;
 	struct brp_cmdstat   *pstcmd;
 	struct brp_cmdstat  **pstcx;
+	struct batch_jobresult *pres;
+	struct batch_jobresult **presx;
 	int		      rc = 0;
 	size_t		      txtlen;
 
@@ -237,6 +239,35 @@ decode_DIS_replyCmd(int sock, struct batch_reply *reply)
 				*(reply->brp_un.brp_rescq.brq_down+i)  = disrui(sock, &rc);
 			break;
 
+		case BATCH_REPLY_CHOICE_JobList:
+
+			/* have to get count of number of failed jobs first */
+
+			reply->brp_un.brp_jobres = NULL;
+			presx = &reply->brp_un.brp_jobres;
+			ct = disrui(sock, &rc);
+			if (rc) return rc;
+
+			while (ct--) {
+				pres = (struct batch_jobresult *)calloc(1, sizeof(struct batch_jobresult));
+				if (pres == NULL) return DIS_NOMALLOC;
+				*presx = pres;
+				presx  = &pres->next;
+
+				pres->name = disrst(sock, &rc);
+				if (rc == 0)
+					pres->code = disrsi(sock, &rc);
+				if (rc == 0)
+					pres->text = disrst(sock, &rc);
+				if (rc)
+					return rc;
+				if (*pres->text == '\0') {
+					(void)free(pres->text);
+					pres->text = NULL;
+				}
+			}
+			break;
+
 		default:
 			return -1;
 	}
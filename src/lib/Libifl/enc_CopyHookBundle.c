@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+/**
+ * @file	enc_CopyHookBundle.c
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include "libpbs.h"
+#include "pbs_error.h"
+#include "dis.h"
+
+/**
+ *
+ * @brief
+ *	Encode a Copy Hook Bundle request.
+ *	Send over 'sock' the data items:
+ *			string	bundle hash
+ *			u int	number of files
+ *		then for each file:
+ *			string	hook file name
+ *			u int	size of file data
+ *			cnt str	file data
+ *
+ * @param[in]	sock -  the communication end point.
+ * @param[in]	files - the files of the bundle
+ * @param[in]	count - # of entries in 'files'
+ * @param[in]	hash - bundle hash, as returned by pbs_hook_bundle_hash()
+ *
+ * @return 	int
+ * @retval 	0 for success
+ * @retval	non-zero otherwise
+ */
+
+int
+encode_DIS_CopyHookBundle(int sock, struct hook_bundle_file *files, int count,
+	char *hash)
+{
+	int   rc;
+	int   i;
+
+	if ((rc = diswst(sock, hash)) != 0 ||
+		(rc = diswui(sock, count)) != 0)
+			return rc;
+
+	for (i = 0; i < count; i++) {
+		if ((rc = diswst(sock, files[i].hbf_name)) != 0 ||
+			(rc = diswui(sock, files[i].hbf_size)) != 0 ||
+			(rc = diswcs(sock, files[i].hbf_data,
+				files[i].hbf_size)) != 0)
+			return rc;
+	}
+
+	return 0;
+}
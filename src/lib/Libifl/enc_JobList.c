@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+
+
+/**
+ * @file	enc_JobList.c
+ * @brief
+ * encode_DIS_JobList() - encode a Job List Batch Request
+ *
+ * @par Data items are:
+ * 			unsigned int	request type of the operation
+ *			string		argument (hold types or signal name)
+ *			unsigned int	count of job ids
+ * 			string		job id (count times)
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include "libpbs.h"
+#include "pbs_error.h"
+#include "dis.h"
+
+/**
+ * @brief
+ *	-encode a Job List Batch Request
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] op - request type applied to each job
+ * @param[in] jobids - job ids
+ * @param[in] count - number of job ids
+ * @param[in] arg - hold types or signal name, may be NULL
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+encode_DIS_JobList(int sock, int op, char **jobids, int count, char *arg)
+{
+	int   i;
+	int   rc;
+
+	if (arg == NULL)
+		arg = "";
+
+	if ((rc = diswui(sock, op)) != 0 ||
+		(rc = diswst(sock, arg)) != 0 ||
+		(rc = diswui(sock, count)) != 0)
+			return rc;
+
+	for (i = 0; i < count; i++) {
+		if ((rc = diswst(sock, jobids[i])) != 0)
+			return rc;
+	}
+
+	return 0;
+}
@@ -41,22 +41,29 @@
  * @file	enc_ReqExt.c
  * @brief
  * encode_DIS_ReqExtend() - write an extension to a Batch Request
- *	The extension is in two parts:
- *		unsigned integer - 1 if an extension string follows, 0 if not
- *		character string - if 1 above
+ *	The extension is in up to three parts:
+ *		unsigned integer - PBS_REQEXT_* bits, 0 if nothing follows
+ *		character string - if PBS_REQEXT_EXTEND is set
+ *		character string - the trace id, if PBS_REQEXT_TRACE is set
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
+#include "libpbs.h"
 #include "dis.h"
 
 /**
  * @brief
  *	-write an extension to a Batch Request
  *
- * @par	The extension is in two parts:
- *		unsigned integer - 1 if an extension string follows, 0 if not\n
- *		character string - if 1 above
+ * @par	The extension is in up to three parts:
+ *		unsigned integer - PBS_REQEXT_* bits, 0 if nothing follows\n
+ *		character string - if PBS_REQEXT_EXTEND is set\n
+ *		character string - the trace id, if PBS_REQEXT_TRACE is set
+ *
+ * @par	The trace id is taken from pbs_current_trace.  A receiver that
+ *	predates request tracing only knows the value 1, so tracing must not
+ *	be turned on until all daemons understand PBS_REQEXT_TRACE.
  *
  * @param[in] sock - socket descriptor
  * @param[in] extend - string which used as extension for req
@@ -71,13 +78,18 @@ int
 encode_DIS_ReqExtend(int sock, char *extend)
 {
 	int rc;
+	unsigned int flags = 0;
+	char *trace = pbs_current_trace;
+
+	if ((extend != NULL) && (*extend != '\0'))
+		flags |= PBS_REQEXT_EXTEND;
+	if ((trace != NULL) && (*trace != '\0'))
+		flags |= PBS_REQEXT_TRACE;
 
-	if ((extend == NULL) || (*extend == '\0')) {
-		rc = diswui(sock, 0);
-	} else {
-		if ((rc = diswui(sock, 1)) == 0) {
-			rc = diswst(sock, extend);
-		}
-	}
+	rc = diswui(sock, flags);
+	if ((rc == 0) && (flags & PBS_REQEXT_EXTEND))
+		rc = diswst(sock, extend);
+	if ((rc == 0) && (flags & PBS_REQEXT_TRACE))
+		rc = diswst(sock, trace);
 	return rc;
 }
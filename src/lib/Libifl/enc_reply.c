@@ -80,6 +80,7 @@ encode_DIS_reply_inner(int sock, struct batch_reply *reply)
 	int		    i;
 	struct brp_select  *psel;
 	struct brp_status  *pstat;
+	struct batch_jobresult *pres;
 	svrattrl	   *psvrl;
 
 	int rc;
@@ -201,6 +202,24 @@ encode_DIS_reply_inner(int sock, struct batch_reply *reply)
 			if (rc) return rc;
 			break;
 
+		case BATCH_REPLY_CHOICE_JobList:
+
+			/* Job List Reply, count of the failed jobs first */
+
+			ct = 0;
+			for (pres = reply->brp_un.brp_jobres; pres; pres = pres->next)
+				++ct;
+			if ((rc = diswui(sock, ct)) != 0)
+				return rc;
+
+			for (pres = reply->brp_un.brp_jobres; pres; pres = pres->next) {
+				if ((rc = diswst(sock, pres->name))	||
+					(rc = diswsi(sock, pres->code))	||
+					(rc = diswst(sock, pres->text ? pres->text : "")))
+						return rc;
+			}
+			break;
+
 		default:
 			return -1;
 	}
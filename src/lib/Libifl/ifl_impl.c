@@ -151,6 +151,26 @@ pbs_deljob(int c, char *jobid, char *extend) {
 	return __pbs_deljob(c, jobid, extend);
 }
 
+/**
+ * @brief
+ *	Pass-through call to send the delete Job request for a list of jobs
+ *
+ * @param[in] c - connection handler
+ * @param[in] jobids - job identifiers
+ * @param[in] count - number of job identifiers
+ * @param[in] extend - string to encode req
+ * @param[out] results - jobs that could not be deleted
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error
+ *
+ */
+int
+pbs_deljoblist(int c, char **jobids, int count, char *extend, struct batch_jobresult **results) {
+	return __pbs_deljoblist(c, jobids, count, extend, results);
+}
+
 
 /**
  * @brief
@@ -207,6 +227,27 @@ pbs_holdjob(int c, char *jobid, char *holdtype, char *extend) {
 	return __pbs_holdjob(c, jobid, holdtype, extend);
 }
 
+/**
+ * @brief
+ *	Pass-through call to send the Hold Job request for a list of jobs
+ *
+ * @param[in] c - connection handler
+ * @param[in] jobids - job identifiers
+ * @param[in] count - number of job identifiers
+ * @param[in] holdtype - value for holdtype
+ * @param[in] extend - string to encode req
+ * @param[out] results - jobs that could not be held
+ *
+ * @return      int
+ * @retval      0       success
+ * @retval      !0      error
+ *
+ */
+int
+pbs_holdjoblist(int c, char **jobids, int count, char *holdtype, char *extend, struct batch_jobresult **results) {
+	return __pbs_holdjoblist(c, jobids, count, holdtype, extend, results);
+}
+
 /**
 * @brief
 *      Pass-through call to send LocateJob request.
@@ -345,6 +386,27 @@ pbs_rlsjob(int c, char *jobid, char *holdtype, char *extend) {
 	return __pbs_rlsjob(c, jobid, holdtype, extend);
 }
 
+/**
+ * @brief
+ *	Pass-through call to send the Release Job request for a list of jobs
+ *
+ * @param[in] c - connection handler
+ * @param[in] jobids - job identifiers
+ * @param[in] count - number of job identifiers
+ * @param[in] holdtype - type of hold to release
+ * @param[in] extend - string to encode req
+ * @param[out] results - jobs that could not be released
+ *
+ * @return      int
+ * @retval      0       success
+ * @retval      !0      error
+ *
+ */
+int
+pbs_rlsjoblist(int c, char **jobids, int count, char *holdtype, char *extend, struct batch_jobresult **results) {
+	return __pbs_rlsjoblist(c, jobids, count, holdtype, extend, results);
+}
+
 /**
  * @brief
  *	-Pass-through call to send runjob batch request
@@ -402,6 +464,41 @@ pbs_sigjob(int c, char *jobid, char *signal, char *extend) {
 	return __pbs_sigjob(c, jobid, signal, extend);
 }
 
+/**
+ * @brief
+ *	Pass-through call to send the signal job request for a list of jobs
+ *
+ * @param[in] c - communication handle
+ * @param[in] jobids - job identifiers
+ * @param[in] count - number of job identifiers
+ * @param[in] signal - signal
+ * @param[in] extend - extend string for request
+ * @param[out] results - jobs that could not be signaled
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error
+ *
+ */
+int
+pbs_sigjoblist(int c, char **jobids, int count, char *signal, char *extend, struct batch_jobresult **results) {
+	return __pbs_sigjoblist(c, jobids, count, signal, extend, results);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to deallocate the results of a job list request
+ *
+ * @param[in] pres - list of job results
+ *
+ * @return	Void
+ *
+ */
+void
+pbs_jobresultfree(struct batch_jobresult *pres) {
+	__pbs_jobresultfree(pres);
+}
+
 
 /**
  * @brief
@@ -663,6 +760,58 @@ pbs_submit(int c, struct attropl  *attrib, char *script, char *destination, char
 	return __pbs_submit(c, attrib, script, destination, extend);
 }
 
+/**
+ * @brief
+ *	-Pass-through call to submit many jobs over one connection
+ *
+ * @param[in] c - communication handle
+ * @param[in] jobs - the jobs to submit
+ * @param[in] count - number of jobs
+ * @param[in] extend - extend string for the Queue Job requests
+ * @param[out] results - one result per job, in the order of jobs
+ *
+ * @return      int
+ * @retval      0       success, even if some jobs were not submitted
+ * @retval      !0      error
+ *
+ */
+int
+pbs_submit_batch(int c, struct batch_submit *jobs, int count, char *extend, struct batch_jobresult **results) {
+	return __pbs_submit_batch(c, jobs, count, extend, results);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to run a batch request on a worker thread
+ *
+ * @param[in] server - server to send the request to
+ * @param[in] request - makes the request over the connection it is given
+ * @param[in] done - completion callback
+ * @param[in] arg - passed to request and done
+ *
+ * @return      int
+ * @retval      0       the request is queued
+ * @retval      -1      error
+ *
+ */
+int
+pbs_async(char *server, int (*request)(int, void *), void (*done)(int, void *), void *arg) {
+	return __pbs_async(server, request, done, arg);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to wait for the requests queued by pbs_async
+ *
+ * @return      int
+ * @retval      0       success
+ *
+ */
+int
+pbs_async_wait(void) {
+	return __pbs_async_wait();
+}
+
 /**
  * @brief
  *	Pass-through call to submit reservation request
@@ -46,6 +46,7 @@
 #include "dis.h"
 #include "net_connect.h"
 #include "rpp.h"
+#include <openssl/evp.h>
 
 /**
  * @file	int_hook.c
@@ -239,3 +240,119 @@ PBSD_delhookfile(int c, char *hook_filename, int rpp, char **msgid)
 
 	return connection[c].ch_errno;
 }
+
+/**
+ *
+ * @brief
+ *	Compute the hash that names a hook bundle: the SHA-256, in lowercase
+ *	hex, over the name, size and contents of each file in order.  Sender
+ *	and receiver compute it independently, so a MoM acknowledging a
+ *	bundle by its hash confirms it got every byte of every file.
+ *
+ * @param[in]	files - the files of the bundle
+ * @param[in]	count - # of entries in 'files'
+ * @param[out]	hash - buffer of at least HOOK_BUNDLE_HASH_SIZE+1 bytes
+ *
+ * @return 	int
+ * @retval	0 for success
+ * @retval	-1 if the digest could not be computed
+ */
+int
+pbs_hook_bundle_hash(struct hook_bundle_file *files, int count, char *hash)
+{
+	EVP_MD_CTX	*ctx;
+	unsigned char	md[EVP_MAX_MD_SIZE];
+	unsigned int	mdlen = 0;
+	char		sizebuf[32];
+	int		i;
+	int		ok;
+
+	if ((ctx = EVP_MD_CTX_create()) == NULL)
+		return -1;
+
+	ok = EVP_DigestInit_ex(ctx, EVP_sha256(), NULL);
+	for (i = 0; ok && (i < count); i++) {
+		snprintf(sizebuf, sizeof(sizebuf), "%ld", files[i].hbf_size);
+		ok = EVP_DigestUpdate(ctx, files[i].hbf_name,
+				strlen(files[i].hbf_name) + 1) &&
+			EVP_DigestUpdate(ctx, sizebuf, strlen(sizebuf) + 1) &&
+			EVP_DigestUpdate(ctx, files[i].hbf_data,
+				files[i].hbf_size);
+	}
+	if (ok)
+		ok = EVP_DigestFinal_ex(ctx, md, &mdlen);
+	EVP_MD_CTX_destroy(ctx);
+
+	if (!ok || (mdlen * 2 > HOOK_BUNDLE_HASH_SIZE))
+		return -1;
+
+	for (i = 0; i < (int)mdlen; i++)
+		sprintf(hash + (i * 2), "%02x", md[i]);
+	hash[mdlen * 2] = '\0';
+
+	return 0;
+}
+
+/**
+ *
+ * @brief
+ *	Send the files of a hook bundle, named by 'hash', as one Copy Hook
+ *	Bundle request over the network connection handle 'c'.
+ *
+ * @param[in]	c - connection channel
+ * @param[in]	files - the files of the bundle
+ * @param[in]	count - # of entries in 'files'
+ * @param[in]	hash - bundle hash, as returned by pbs_hook_bundle_hash()
+ * @param[in]	rpp - indication for rpp
+ * @param[in]	msgid - msg
+ *
+ * @return 	int
+ * @retval	0 for success
+ * @retval	non-zero otherwise.
+ */
+int
+PBSD_copyhookbundle(int c, struct hook_bundle_file *files, int count,
+	char *hash, int rpp, char **msgid)
+{
+	struct batch_reply   *reply;
+	int	rc;
+	int	sock;
+
+	if (!rpp) {
+		sock = connection[c].ch_socket;
+		DIS_tcp_setup(sock);
+	} else {
+		sock = c;
+		if ((rc = is_compose_cmd(sock, IS_CMD, msgid)) != DIS_SUCCESS)
+			return rc;
+	}
+
+	if ((rc = encode_DIS_ReqHdr(sock, PBS_BATCH_CopyHookBundle,
+		pbs_current_user)) ||
+		(rc = encode_DIS_CopyHookBundle(sock, files, count, hash)) ||
+		(rc = encode_DIS_ReqExtend(sock, NULL))) {
+
+		if (!rpp)
+			connection[c].ch_errtxt = strdup(dis_emsg[rc]);
+		return (pbs_errno = PBSE_PROTOCOL);
+	}
+
+	if (rpp) {
+		pbs_errno = PBSE_NONE;
+		if (rpp_flush(sock))
+			pbs_errno = PBSE_PROTOCOL;
+		return pbs_errno;
+	}
+
+	if (DIS_tcp_wflush(sock)) {
+		return (pbs_errno = PBSE_PROTOCOL);
+	}
+
+	/* read reply */
+
+	reply = PBSD_rdrpy(c);
+
+	PBSD_FreeReply(reply);
+
+	return connection[c].ch_errno;
+}
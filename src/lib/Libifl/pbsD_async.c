@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+/**
+ * @file	pbsD_async.c
+ * @brief
+ *	Run batch requests asynchronously.  Each request is run on one of a
+ *	few worker threads over its own connection to the server, so several
+ *	requests are in flight at once, and the caller is told of the outcome
+ *	through a completion callback.  With PBS_CONN_POOL set, the workers
+ *	reuse the server connections instead of connecting for every request.
+ *
+ * Functions included are:
+ *	pbs_async()
+ *	pbs_async_wait()
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "libpbs.h"
+#include "pbs_ecl.h"
+
+/* number of worker threads when PBS_CONN_POOL is not set */
+#define PBS_ASYNC_WORKERS	4
+
+/* a request waiting for a worker */
+struct async_req {
+	struct async_req *ar_next;
+	char	*ar_server;
+	int	(*ar_request)(int, void *);
+	void	(*ar_done)(int, void *);
+	void	*ar_arg;
+};
+
+static pthread_mutex_t async_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_idle = PTHREAD_COND_INITIALIZER;
+static struct async_req *async_head = NULL;
+static struct async_req *async_tail = NULL;
+static int async_workers = 0;	/* worker threads running */
+static int async_pending = 0;	/* requests queued or running */
+
+/**
+ * @brief
+ *	Worker thread: run queued requests until there are none left.
+ *
+ * @param[in]	arg - unused
+ *
+ * @return void *
+ * @retval NULL always
+ */
+static void *
+async_worker(void *arg)
+{
+	struct async_req *ar;
+	int c;
+	int rc;
+	int err;
+
+	for (;;) {
+		pthread_mutex_lock(&async_mutex);
+		ar = async_head;
+		if (ar == NULL) {
+			async_workers--;
+			pthread_mutex_unlock(&async_mutex);
+			return NULL;
+		}
+		async_head = ar->ar_next;
+		if (async_head == NULL)
+			async_tail = NULL;
+		pthread_mutex_unlock(&async_mutex);
+
+		c = pbs_connect(ar->ar_server);
+		if (c >= 0) {
+			rc = ar->ar_request(c, ar->ar_arg);
+			/* keep the outcome of the request over the disconnect */
+			err = pbs_errno;
+			(void)pbs_disconnect(c);
+			pbs_errno = err;
+		} else
+			rc = -1;
+		if (ar->ar_done != NULL)
+			ar->ar_done(rc, ar->ar_arg);
+
+		free(ar->ar_server);
+		free(ar);
+
+		pthread_mutex_lock(&async_mutex);
+		if (--async_pending == 0)
+			pthread_cond_broadcast(&async_idle);
+		pthread_mutex_unlock(&async_mutex);
+	}
+}
+
+/**
+ * @brief
+ *	Queue a batch request to be run on a worker thread.
+ *
+ * @par Functionality:
+ *	A worker connects to server, calls request with the connection and
+ *	arg, disconnects and calls done with the return value of request and
+ *	arg.  If the connection fails, request is not called and done gets -1.
+ *	done runs on the worker thread, where pbs_errno holds the error of the
+ *	request.  Requests may run in any order and at the same time as each
+ *	other, up to PBS_CONN_POOL of them, or 4 if it is not set.
+ *
+ * @param[in]	server - server to send the request to, NULL for the default
+ * @param[in]	request - makes the request, e.g. calls pbs_deljob()
+ * @param[in]	done - completion callback, may be NULL
+ * @param[in]	arg - passed to request and done
+ *
+ * @return int
+ * @retval 0	the request is queued
+ * @retval -1	error, pbs_errno is set
+ */
+int
+__pbs_async(char *server, int (*request)(int, void *),
+	void (*done)(int, void *), void *arg)
+{
+	struct async_req *ar;
+	pthread_t tid;
+	pthread_attr_t attr;
+	int max;
+
+	if (request == NULL) {
+		pbs_errno = PBSE_IVALREQ;
+		return -1;
+	}
+
+	if (pbs_loadconf(0) == 0)
+		return -1;
+
+	ar = malloc(sizeof(struct async_req));
+	if (ar == NULL) {
+		pbs_errno = PBSE_SYSTEM;
+		return -1;
+	}
+	ar->ar_next = NULL;
+	ar->ar_server = NULL;
+	if ((server != NULL) && ((ar->ar_server = strdup(server)) == NULL)) {
+		free(ar);
+		pbs_errno = PBSE_SYSTEM;
+		return -1;
+	}
+	ar->ar_request = request;
+	ar->ar_done = done;
+	ar->ar_arg = arg;
+
+	max = pbs_conf.pbs_conn_pool > 0 ? pbs_conf.pbs_conn_pool : PBS_ASYNC_WORKERS;
+
+	pthread_mutex_lock(&async_mutex);
+	if (async_tail != NULL)
+		async_tail->ar_next = ar;
+	else
+		async_head = ar;
+	async_tail = ar;
+	async_pending++;
+
+	if (async_workers < max) {
+		pthread_attr_init(&attr);
+		pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+		if (pthread_create(&tid, &attr, async_worker, NULL) == 0)
+			async_workers++;
+		pthread_attr_destroy(&attr);
+	}
+
+	/* without any worker the request would never run */
+	if (async_workers == 0) {
+		async_head = async_tail = NULL;
+		async_pending--;
+		pthread_mutex_unlock(&async_mutex);
+		free(ar->ar_server);
+		free(ar);
+		pbs_errno = PBSE_SYSTEM;
+		return -1;
+	}
+	pthread_mutex_unlock(&async_mutex);
+
+	return 0;
+}
+
+/**
+ * @brief
+ *	Wait until every request queued by pbs_async() has completed, that is
+ *	its completion callback has returned.
+ *
+ * @return int
+ * @retval 0	always
+ */
+int
+__pbs_async_wait(void)
+{
+	pthread_mutex_lock(&async_mutex);
+	while (async_pending > 0)
+		pthread_cond_wait(&async_idle, &async_mutex);
+	pthread_mutex_unlock(&async_mutex);
+
+	return 0;
+}
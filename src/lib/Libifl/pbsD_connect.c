@@ -58,6 +58,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <poll.h>
 #include <netinet/in.h>
 #ifndef WIN32
 #include <netinet/tcp.h>
@@ -76,6 +77,155 @@ extern struct connect_handle connection[NCONNECTS];
 
 #define ERR_BUF_SIZE 4096
 
+/*
+ * a pooled connection idle for longer than this is closed rather than
+ * reused, well before the server drops it, see PBS_NET_MAXCONNECTIDLE
+ */
+#define PBS_CONN_POOL_IDLE	(PBS_NET_MAXCONNECTIDLE / 2)
+
+/**
+ * @brief
+ *	Close a connection without sending a Disconnect request and release
+ *	its slot in the connection table.
+ *
+ * @param[in]	connect - connection index
+ *
+ * @return void
+ */
+static void
+pool_close(int connect)
+{
+	(void)DIS_tcp_set_binary(connection[connect].ch_socket, 0);
+	CS_close_socket(connection[connect].ch_socket);
+	CLOSESOCKET(connection[connect].ch_socket);
+	if (connection[connect].ch_server != NULL) {
+		free(connection[connect].ch_server);
+		connection[connect].ch_server = NULL;
+	}
+	connection[connect].ch_pooled = 0;
+	connection[connect].ch_stateful = 0;
+	connection[connect].ch_inuse = 0;
+}
+
+/**
+ * @brief
+ *	Check that an idle connection can carry another request: the server
+ *	has not closed it and there is nothing left unread on it.
+ *
+ * @param[in]	connect - connection index
+ *
+ * @return int
+ * @retval 1	the connection is usable
+ * @retval 0	the connection must be closed
+ */
+static int
+pool_usable(int connect)
+{
+	struct pollfd	pfd;
+
+	pfd.fd = connection[connect].ch_socket;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	return (poll(&pfd, 1, 0) == 0);
+}
+
+/**
+ * @brief
+ *	Take an idle connection to server out of the connection pool.
+ *	Stale connections met on the way are closed.
+ *
+ * @param[in]	server - server name as given to pbs_connect
+ * @param[in]	port - server port
+ *
+ * @return int
+ * @retval >0	index of the connection taken from the pool
+ * @retval -1	no usable pooled connection
+ */
+static int
+pool_get(char *server, unsigned int port)
+{
+	int	i;
+	int	out = -1;
+	time_t	now = time(NULL);
+
+	if (pbs_client_thread_lock_conntable() != 0)
+		return -1;
+
+	for (i = 1; i < NCONNECTS; i++) {
+		if (!connection[i].ch_pooled)
+			continue;
+		if ((now - connection[i].ch_idle) > PBS_CONN_POOL_IDLE ||
+			!pool_usable(i)) {
+			pool_close(i);
+			continue;
+		}
+		if ((connection[i].ch_port != port) ||
+			(strcmp(connection[i].ch_server, server) != 0))
+			continue;
+		connection[i].ch_pooled = 0;
+		out = i;
+		break;
+	}
+
+	if (pbs_client_thread_unlock_conntable() != 0)
+		return -1;
+	return out;
+}
+
+/**
+ * @brief
+ *	Put a connection the caller is done with in the connection pool
+ *	instead of closing it, if it was opened for pooling, is still usable
+ *	and the pool is not full for its server.  A connection opened with
+ *	extend data is not opened for pooling, and one the server keeps
+ *	state for (ch_stateful, e.g. after pbs_submit_batch) is not pooled.
+ *
+ * @param[in]	connect - connection index, locked by the caller
+ *
+ * @return int
+ * @retval 0	the connection is in the pool
+ * @retval -1	the connection must be closed
+ */
+static int
+pool_put(int connect)
+{
+	int		i;
+	unsigned int	n = 0;
+	int		rc = -1;
+
+	if ((pbs_conf.pbs_conn_pool == 0) ||
+		(connection[connect].ch_server == NULL) ||
+		connection[connect].ch_stateful ||
+		(connection[connect].ch_errno == PBSE_PROTOCOL) ||
+		!pool_usable(connect))
+		return -1;
+
+	if (pbs_client_thread_lock_conntable() != 0)
+		return -1;
+
+	for (i = 1; i < NCONNECTS; i++) {
+		if (connection[i].ch_pooled &&
+			(connection[i].ch_port == connection[connect].ch_port) &&
+			(strcmp(connection[i].ch_server,
+			connection[connect].ch_server) == 0))
+			n++;
+	}
+	if (n < pbs_conf.pbs_conn_pool) {
+		if (connection[connect].ch_errtxt != NULL) {
+			free(connection[connect].ch_errtxt);
+			connection[connect].ch_errtxt = NULL;
+		}
+		connection[connect].ch_errno = 0;
+		connection[connect].ch_idle = time(NULL);
+		connection[connect].ch_pooled = 1;
+		rc = 0;
+	}
+
+	if (pbs_client_thread_unlock_conntable() != 0)
+		return -1;
+	return rc;
+}
+
 /**
  * @brief
  *	-returns the default server name.
@@ -538,7 +688,9 @@ get_hostsockaddr(char *host, struct sockaddr_in *sap)
 
 /**
  * @brief
- *	Makes a PBS_BATCH_Connect request to 'server'.
+ *	Makes a PBS_BATCH_Connect request to 'server'.  When PBS_CONN_POOL is
+ *	set and there is no extend data, an idle connection to 'server' left
+ *	by pbs_disconnect is reused instead.
  *
  * @param[in]   server - the hostname of the pbs server to connect to.
  * @param[in]   extend_data - a string to send as "extend" data.
@@ -561,6 +713,7 @@ __pbs_connect_extend(char *server, char *extend_data)
 	struct batch_reply	*reply;
 	char server_name[PBS_MAXSERVERNAME+1];
 	unsigned int server_port;
+	char *pool_key = NULL;
 	struct sockaddr_in sockname;
 	pbs_socklen_t	 socknamelen;
 #ifdef WIN32
@@ -589,6 +742,22 @@ __pbs_connect_extend(char *server, char *extend_data)
 		return -1;
 	}
 
+	/* reuse an idle connection to the same server if pooling */
+	if ((pbs_conf.pbs_conn_pool > 0) && (extend_data == NULL)) {
+		out = pool_get(server, server_port);
+		if (out > 0) {
+			if (pbs_client_thread_init_connect_context(out) != 0) {
+				pool_close(out);
+				return -1;
+			}
+			strcpy(pbs_server, server);
+			DIS_tcp_setup(connection[out].ch_socket);
+			pbs_tcp_timeout = PBS_DIS_TCP_TIMEOUT_VLONG;
+			return out;
+		}
+		pool_key = server;
+	}
+
 	if (pbs_conf.pbs_primary && pbs_conf.pbs_secondary) {
 		/* failover configuered ...   */
 		if (hostnmcmp(server, pbs_conf.pbs_primary) == 0) {
@@ -638,6 +807,9 @@ __pbs_connect_extend(char *server, char *extend_data)
 		connection[out].ch_errno = 0;
 		connection[out].ch_socket= -1;
 		connection[out].ch_errtxt = NULL;
+		connection[out].ch_server = NULL;
+		connection[out].ch_pooled = 0;
+		connection[out].ch_stateful = 0;
 		connection[out].ch_inuse = 1; /* reserve the socket */
 		break;
 	}
@@ -764,6 +936,12 @@ __pbs_connect_extend(char *server, char *extend_data)
 #if !defined(PBS_SECURITY ) || (PBS_SECURITY == STD )
 
 	DIS_tcp_setup(connection[out].ch_socket);
+	(void)DIS_tcp_set_binary(connection[out].ch_socket, 0);
+#ifndef WIN32
+	/* a plain connection may ask for binary integers, see req_connect */
+	if ((extend_data == NULL) && pbs_conf.pbs_dis_binary)
+		extend_data = DIS_BINARY_EXT;
+#endif
 	if ((i = encode_DIS_ReqHdr(connection[out].ch_socket,
 		PBS_BATCH_Connect, pbs_current_user)) ||
 		(i = encode_DIS_ReqExtend(connection[out].ch_socket,
@@ -777,6 +955,16 @@ __pbs_connect_extend(char *server, char *extend_data)
 	}
 
 	reply = PBSD_rdrpy(out);
+	/* the server switched right after its reply if it agreed */
+	if ((reply != NULL) && (reply->brp_code == 0) &&
+		(reply->brp_choice == BATCH_REPLY_CHOICE_Text) &&
+		(reply->brp_un.brp_txt.brp_str != NULL) &&
+		(strcmp(reply->brp_un.brp_txt.brp_str, DIS_BINARY_EXT) == 0)) {
+		(void)DIS_tcp_set_binary(connection[out].ch_socket, 1);
+		/* not an error message */
+		free(connection[out].ch_errtxt);
+		connection[out].ch_errtxt = NULL;
+	}
 	PBSD_FreeReply(reply);
 
 #endif	/* PBS_SECURITY ... */
@@ -803,6 +991,12 @@ __pbs_connect_extend(char *server, char *extend_data)
 	DIS_tcp_setup(connection[out].ch_socket);
 	pbs_tcp_timeout = PBS_DIS_TCP_TIMEOUT_VLONG;	/* set for 3 hours */
 
+	/* remember the server so pbs_disconnect can pool the connection */
+	if (pool_key != NULL) {
+		connection[out].ch_server = strdup(pool_key);
+		connection[out].ch_port = server_port;
+	}
+
 	return out;
 }
 
@@ -859,7 +1053,8 @@ __pbs_connect(char *server)
 
 /**
  * @brief
- *	-send close connection batch request
+ *	-send close connection batch request, or put the connection in the
+ *	connection pool when PBS_CONN_POOL is set
  *
  * @param[in] connect - socket descriptor
  *
@@ -893,13 +1088,22 @@ __pbs_disconnect(int connect)
 
 	/*
 	 * check again to ensure that another racing thread
-	 * had not already closed the connection
+	 * had not already closed or pooled the connection
 	 */
-	if (!connection[connect].ch_inuse) {
+	if (!connection[connect].ch_inuse || connection[connect].ch_pooled) {
 		(void)pbs_client_thread_unlock_connection(connect);
 		return 0;
 	}
 
+	/* keep the connection open for the next pbs_connect if pooling */
+	if (pool_put(connect) == 0) {
+		if (pbs_client_thread_unlock_connection(connect) != 0)
+			return -1;
+		if (pbs_client_thread_destroy_connect_context(connect) != 0)
+			return -1;
+		return 0;
+	}
+
 	/* send close-connection message */
 
 	sock = connection[connect].ch_socket;
@@ -918,6 +1122,7 @@ __pbs_disconnect(int connect)
 		}
 	}
 
+	(void)DIS_tcp_set_binary(sock, 0);
 	CS_close_socket(sock);
 	CLOSESOCKET(sock);
 
@@ -925,6 +1130,10 @@ __pbs_disconnect(int connect)
 		free(connection[connect].ch_errtxt);
 		connection[connect].ch_errtxt = NULL;
 	}
+	if (connection[connect].ch_server != NULL) {
+		free(connection[connect].ch_server);
+		connection[connect].ch_server = NULL;
+	}
 	connection[connect].ch_errno = 0;
 	connection[connect].ch_inuse = 0;
 
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+
+
+/**
+ * @file	pbsD_joblist.c
+ * @brief
+ *	Send a Delete, Hold, Release or Signal request for a list of jobs in
+ *	one Job List batch request.  Only the jobs the request failed for are
+ *	returned, each with its own error code and message.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <string.h>
+#include <stdio.h>
+#include "libpbs.h"
+#include "dis.h"
+#include "pbs_ecl.h"
+
+
+/**
+ * @brief
+ *	-send a Job List batch request and read its reply
+ *
+ * @param[in] c - communication handle
+ * @param[in] op - request type applied to each job
+ * @param[in] jobids - job identifiers
+ * @param[in] count - number of job identifiers
+ * @param[in] arg - hold types or signal name, may be NULL
+ * @param[in] extend - extend string for request
+ * @param[out] results - the jobs the request failed for, to be freed
+ *			 with pbs_jobresultfree()
+ *
+ * @return	int
+ * @retval	0	success, even if the request failed for some jobs
+ * @retval	!0	error, the request was not processed
+ *
+ */
+int
+PBSD_joblist(int c, int op, char **jobids, int count, char *arg, char *extend, struct batch_jobresult **results)
+{
+	int rc;
+	int i;
+	int sock;
+	struct attropl aopl;
+	struct batch_reply *reply;
+
+	if (results == NULL)
+		return (pbs_errno = PBSE_IVALREQ);
+	*results = NULL;
+	if ((jobids == NULL) || (count <= 0))
+		return (pbs_errno = PBSE_IVALREQ);
+	for (i = 0; i < count; i++) {
+		if ((jobids[i] == NULL) || (*jobids[i] == '\0'))
+			return (pbs_errno = PBSE_IVALREQ);
+	}
+
+	/* initialize the thread context data, if not already initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return pbs_errno;
+
+	/* verify the hold types as pbs_holdjob() does, if verification is enabled */
+	if ((op == PBS_BATCH_HoldJob) || (op == PBS_BATCH_ReleaseJob)) {
+		aopl.name = ATTR_h;
+		aopl.resource = NULL;
+		aopl.value = arg;
+		aopl.op = SET;
+		aopl.next = NULL;
+		if (pbs_verify_attributes(c, op, MGR_OBJ_JOB, MGR_CMD_SET, &aopl) != 0)
+			return pbs_errno;
+	}
+
+	/* lock pthread mutex here for this connection */
+	/* blocking call, waits for mutex release */
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return pbs_errno;
+
+	/* send request */
+
+	sock = connection[c].ch_socket;
+	DIS_tcp_setup(sock);
+
+	if ((rc = encode_DIS_ReqHdr(sock, PBS_BATCH_JobList, pbs_current_user)) ||
+		(rc = encode_DIS_JobList(sock, op, jobids, count, arg)) ||
+		(rc = encode_DIS_ReqExtend(sock, extend))) {
+		connection[c].ch_errtxt = strdup(dis_emsg[rc]);
+		if (connection[c].ch_errtxt == NULL)
+			pbs_errno = PBSE_SYSTEM;
+		else
+			pbs_errno = PBSE_PROTOCOL;
+		(void)pbs_client_thread_unlock_connection(c);
+		return pbs_errno;
+	}
+	if (DIS_wflush(sock, 0)) {
+		pbs_errno = PBSE_PROTOCOL;
+		(void)pbs_client_thread_unlock_connection(c);
+		return pbs_errno;
+	}
+
+	/* read reply, keep the list of results */
+
+	reply = PBSD_rdrpy(c);
+
+	rc = connection[c].ch_errno;
+	if ((rc == 0) && (reply != NULL) &&
+		(reply->brp_choice == BATCH_REPLY_CHOICE_JobList)) {
+		*results = reply->brp_un.brp_jobres;
+		reply->brp_un.brp_jobres = NULL;
+	}
+
+	PBSD_FreeReply(reply);
+
+	/* unlock the thread lock and update the thread context data */
+	if (pbs_client_thread_unlock_connection(c) != 0)
+		return pbs_errno;
+
+	return (rc);
+}
+
+/**
+ * @brief
+ *	-delete a list of jobs
+ *
+ * @param[in] c - communication handle
+ * @param[in] jobids - job identifiers
+ * @param[in] count - number of job identifiers
+ * @param[in] extend - extend string for request
+ * @param[out] results - the jobs that could not be deleted
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error
+ *
+ */
+int
+__pbs_deljoblist(int c, char **jobids, int count, char *extend, struct batch_jobresult **results)
+{
+	return (PBSD_joblist(c, PBS_BATCH_DeleteJob, jobids, count, NULL, extend, results));
+}
+
+/**
+ * @brief
+ *	-place holds on a list of jobs
+ *
+ * @param[in] c - communication handle
+ * @param[in] jobids - job identifiers
+ * @param[in] count - number of job identifiers
+ * @param[in] holdtype - hold types, default is user hold
+ * @param[in] extend - extend string for request
+ * @param[out] results - the jobs that could not be held
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error
+ *
+ */
+int
+__pbs_holdjoblist(int c, char **jobids, int count, char *holdtype, char *extend, struct batch_jobresult **results)
+{
+	if ((holdtype == NULL) || (*holdtype == '\0'))
+		holdtype = "u";
+	return (PBSD_joblist(c, PBS_BATCH_HoldJob, jobids, count, holdtype, extend, results));
+}
+
+/**
+ * @brief
+ *	-release holds on a list of jobs
+ *
+ * @param[in] c - communication handle
+ * @param[in] jobids - job identifiers
+ * @param[in] count - number of job identifiers
+ * @param[in] holdtype - hold types, default is user hold
+ * @param[in] extend - extend string for request
+ * @param[out] results - the jobs that could not be released
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error
+ *
+ */
+int
+__pbs_rlsjoblist(int c, char **jobids, int count, char *holdtype, char *extend, struct batch_jobresult **results)
+{
+	if ((holdtype == NULL) || (*holdtype == '\0'))
+		holdtype = "u";
+	return (PBSD_joblist(c, PBS_BATCH_ReleaseJob, jobids, count, holdtype, extend, results));
+}
+
+/**
+ * @brief
+ *	-send a signal to a list of jobs
+ *
+ * @param[in] c - communication handle
+ * @param[in] jobids - job identifiers
+ * @param[in] count - number of job identifiers
+ * @param[in] signal - signal
+ * @param[in] extend - extend string for request
+ * @param[out] results - the jobs that could not be signaled
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error
+ *
+ */
+int
+__pbs_sigjoblist(int c, char **jobids, int count, char *signal, char *extend, struct batch_jobresult **results)
+{
+	if ((signal == NULL) || (*signal == '\0')) {
+		if (results != NULL)
+			*results = NULL;
+		return (pbs_errno = PBSE_IVALREQ);
+	}
+	return (PBSD_joblist(c, PBS_BATCH_SignalJob, jobids, count, signal, extend, results));
+}
+
+/**
+ * @brief
+ *	-deallocate the results of a job list request
+ *
+ * @param[in] pres - list of job results
+ *
+ * @return	Void
+ *
+ */
+void
+__pbs_jobresultfree(struct batch_jobresult *pres)
+{
+	struct batch_jobresult *pnxt;
+
+	while (pres != NULL) {
+		pnxt = pres->next;
+		if (pres->name != NULL)
+			(void)free(pres->name);
+		if (pres->text != NULL)
+			(void)free(pres->text);
+		(void)free(pres);
+		pres = pnxt;
+	}
+}
@@ -44,11 +44,16 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <assert.h>
+#include <sys/time.h>
 #include "libpbs.h"
+#include "dis.h"
+#include "pbs_trace.h"
 #include "credential.h"
 #include "pbs_ecl.h"
 #include "pbs_client_thread.h"
@@ -137,6 +142,33 @@ pbs_submit_with_cred(int c, struct attropl  *attrib, char *script,
 	return ret;
 }
 
+/**
+ * @brief
+ *	Make up a trace id for a new submission, unique enough to tell the
+ *	submissions of all clients apart: time, pid, a count and the short
+ *	host name.
+ *
+ * @param[out] buf - receives the trace id
+ * @param[in] len - size of buf, at least PBS_TRACE_IDLEN + 1
+ */
+static void
+pbs_trace_newid(char *buf, size_t len)
+{
+	static unsigned int seq = 0;
+	struct timeval tv;
+	char host[PBS_MAXHOSTNAME + 1];
+	char *p;
+
+	(void)gettimeofday(&tv, NULL);
+	if (gethostname(host, sizeof(host)) != 0)
+		host[0] = '\0';
+	host[sizeof(host) - 1] = '\0';
+	if ((p = strchr(host, '.')) != NULL)
+		*p = '\0';
+	snprintf(buf, len, "%lx%05lx.%x.%x@%s", (unsigned long)tv.tv_sec,
+		(unsigned long)tv.tv_usec, (unsigned int)getpid(), ++seq, host);
+}
+
 /**
  * @brief
  *	-submit job request
@@ -160,6 +192,7 @@ __pbs_submit(int c, struct attropl  *attrib, char *script, char *destination, ch
 	int			rc;
 	struct pbs_client_thread_context *ptr;
 	struct cred_info	*cred_info = NULL;
+	char			 trace_id[PBS_TRACE_IDLEN + 1];
 
 	/* initialize the thread context data, if not already initialized */
 	if (pbs_client_thread_init_thread_context() != 0)
@@ -199,6 +232,12 @@ __pbs_submit(int c, struct attropl  *attrib, char *script, char *destination, ch
 	for (pal = attrib; pal; pal = pal->next)
 		pal->op = SET;		/* force operator to SET */
 
+	/* tag every request of this submission with one trace id */
+	if (pbs_conf.pbs_trace) {
+		pbs_trace_newid(trace_id, sizeof(trace_id));
+		ptr->th_pbs_trace = trace_id;
+	}
+
 	/* Queue job with null string for job id */
 	return_jobid = PBSD_queuejob(c, "", destination, attrib, extend, 0, NULL);
 	if (return_jobid == NULL)
@@ -234,12 +273,354 @@ __pbs_submit(int c, struct attropl  *attrib, char *script, char *destination, ch
 	if (PBSD_commit(c, return_jobid, 0, NULL) != 0)
 		goto error;
 
+	ptr->th_pbs_trace = NULL;
+
 	/* unlock the thread lock and update the thread context data */
 	if (pbs_client_thread_unlock_connection(c) != 0)
 		return NULL;
 
 	return return_jobid;
 error:
+	ptr->th_pbs_trace = NULL;
 	(void)pbs_client_thread_unlock_connection(c);
 	return NULL;
 }
+
+/* number of jobs written before their replies are read by pbs_submit_batch */
+#define SUBMIT_BATCH_WINDOW	64
+
+/**
+ * @brief
+ *	-read a job script into memory
+ *
+ * @param[in] script - path of the job script
+ * @param[out] len - length of the script
+ *
+ * @return	string
+ * @retval	script	success, to be freed by the caller
+ * @retval	NULL	error
+ *
+ */
+static char *
+submit_batch_script(char *script, int *len)
+{
+	int	 fd;
+	int	 cc;
+	int	 size = SCRIPT_CHUNK_Z;
+	char	*buf;
+	char	*tmp;
+
+	*len = 0;
+	if ((fd = open(script, O_RDONLY, 0)) < 0)
+		return NULL;
+	if ((buf = malloc(size)) == NULL) {
+		close(fd);
+		return NULL;
+	}
+	while ((cc = read(fd, buf + *len, size - *len)) > 0) {
+		*len += cc;
+		if (*len == size) {
+			size += SCRIPT_CHUNK_Z;
+			if ((tmp = realloc(buf, size)) == NULL) {
+				cc = -1;
+				break;
+			}
+			buf = tmp;
+		}
+	}
+	close(fd);
+	if (cc < 0) {
+		free(buf);
+		return NULL;
+	}
+	return buf;
+}
+
+/**
+ * @brief
+ *	-write the Queue Job, Job Script and Commit requests of one job of a
+ *	batch submission without waiting for the replies.  The Commit request
+ *	carries no job id, the server commits the job queued on the connection.
+ *
+ * @param[in] sock - socket of the connection
+ * @param[in] pjob - the job
+ * @param[in] extend - extend string for the Queue Job request
+ *
+ * @return	int
+ * @retval	>0	number of replies the server sends for the job
+ * @retval	0	the job was not sent, pbs_errno is set
+ * @retval	-1	the requests could not be encoded
+ *
+ */
+static int
+submit_batch_put(int sock, struct batch_submit *pjob, char *extend)
+{
+	struct attropl	*pal;
+	char		*script = NULL;
+	char		*destination;
+	int		 len = 0;
+	int		 off;
+	int		 seq;
+	int		 tosend;
+	int		 nreply = 0;
+
+	if ((pjob->script != NULL) && (*pjob->script != '\0')) {
+		script = submit_batch_script(pjob->script, &len);
+		if (script == NULL) {
+			pbs_errno = PBSE_BADSCRIPT;
+			return 0;
+		}
+	}
+
+	for (pal = pjob->attrib; pal; pal = pal->next)
+		pal->op = SET;		/* force operator to SET */
+	destination = (pjob->destination != NULL) ? pjob->destination : "";
+
+	if (encode_DIS_ReqHdr(sock, PBS_BATCH_QueueJob, pbs_current_user) ||
+		encode_DIS_QueueJob(sock, "", destination, pjob->attrib) ||
+		encode_DIS_ReqExtend(sock, extend))
+		goto err;
+	nreply++;
+
+	for (off = 0, seq = 0; off < len; off += tosend, seq++) {
+		tosend = ((len - off) > SCRIPT_CHUNK_Z) ? SCRIPT_CHUNK_Z : (len - off);
+		if (encode_DIS_ReqHdr(sock, PBS_BATCH_jobscript, pbs_current_user) ||
+			encode_DIS_JobFile(sock, seq, script + off, tosend, "", JScript) ||
+			encode_DIS_ReqExtend(sock, NULL))
+			goto err;
+		nreply++;
+	}
+
+	if (encode_DIS_ReqHdr(sock, PBS_BATCH_Commit, pbs_current_user) ||
+		encode_DIS_JobId(sock, "") ||
+		encode_DIS_ReqExtend(sock, NULL))
+		goto err;
+	nreply++;
+
+	free(script);
+	return nreply;
+err:
+	free(script);
+	return -1;
+}
+
+/**
+ * @brief
+ *	-read the replies to the requests of one job of a batch submission.
+ *	The job takes the id of the first reply carrying one, and the error
+ *	code and message of the first reply that failed.
+ *
+ * @param[in] sock - socket of the connection
+ * @param[in] nreply - number of replies to read
+ * @param[in,out] pres - result of the job
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	DIS error, the replies could not be read
+ *
+ */
+static int
+submit_batch_get(int sock, int nreply, struct batch_jobresult *pres)
+{
+	struct batch_reply	*reply;
+	int			 rc = 0;
+	int			 i;
+
+	for (i = 0; i < nreply; i++) {
+		reply = (struct batch_reply *)calloc(1, sizeof(struct batch_reply));
+		if (reply == NULL)
+			return DIS_NOMALLOC;
+
+		/* replies of later jobs may already be in the buffer, keep it */
+		if ((rc = decode_DIS_replyCmd(sock, reply)) != 0) {
+			free(reply);
+			return rc;
+		}
+		if ((pres->name == NULL) &&
+			((reply->brp_choice == BATCH_REPLY_CHOICE_Queue) ||
+			(reply->brp_choice == BATCH_REPLY_CHOICE_Commit)) &&
+			(reply->brp_un.brp_jid[0] != '\0'))
+			pres->name = strdup(reply->brp_un.brp_jid);
+		if ((reply->brp_code != PBSE_NONE) && (pres->code == PBSE_NONE)) {
+			pres->code = reply->brp_code;
+			if ((reply->brp_choice == BATCH_REPLY_CHOICE_Text) &&
+				(reply->brp_un.brp_txt.brp_str != NULL))
+				pres->text = strdup(reply->brp_un.brp_txt.brp_str);
+		}
+		PBSD_FreeReply(reply);
+	}
+
+	/* a job that was not committed has no id */
+	if ((pres->code != PBSE_NONE) && (pres->name != NULL)) {
+		free(pres->name);
+		pres->name = NULL;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	-submit many jobs over one connection.  The requests of a number of
+ *	jobs are written before the replies to them are read, so the jobs do
+ *	not wait for one round trip per request.  Credentials are not sent,
+ *	use pbs_submit_with_cred() for jobs that need them.
+ *
+ * @param[in] c - communication handle
+ * @param[in] jobs - the jobs to submit
+ * @param[in] count - number of jobs
+ * @param[in] extend - extend string for the Queue Job requests
+ * @param[out] results - one result per job, in the order of jobs, to be
+ *			 freed with pbs_jobresultfree().  The name of a
+ *			 result is the id of the job, NULL if the job was
+ *			 not submitted.  On error, the list stops at the
+ *			 last job sent, and the jobs without a reply have
+ *			 the code PBSE_PROTOCOL.
+ *
+ * @return	int
+ * @retval	0		success, even if some jobs were not submitted
+ * @retval	PBSE_UNKREQ	the server does not take batch submissions
+ *				and has closed the connection
+ * @retval	!0		other error
+ *
+ */
+int
+__pbs_submit_batch(int c, struct batch_submit *jobs, int count, char *extend, struct batch_jobresult **results)
+{
+	struct pbs_client_thread_context *ptr;
+	struct batch_jobresult	 *head = NULL;
+	struct batch_jobresult	**tail = &head;
+	struct batch_jobresult	 *pres;
+	struct batch_jobresult	 *window[SUBMIT_BATCH_WINDOW];
+	int			  nreply[SUBMIT_BATCH_WINDOW];
+	struct batch_reply	 *reply;
+	char			  trace_id[PBS_TRACE_IDLEN + 1];
+	char			 *msg;
+	int			  sock;
+	int			  next;
+	int			  nwin = 0;
+	int			  done = 0;
+	int			  rc;
+
+	if (results == NULL)
+		return (pbs_errno = PBSE_IVALREQ);
+	*results = NULL;
+	if ((jobs == NULL) || (count <= 0))
+		return (pbs_errno = PBSE_IVALREQ);
+
+	/* initialize the thread context data, if not already initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return pbs_errno;
+
+	ptr = (struct pbs_client_thread_context *)
+		pbs_client_thread_get_context_data();
+	if (!ptr)
+		return (pbs_errno = PBSE_INTERNAL);
+
+	/* lock pthread mutex here for this connection */
+	/* blocking call, waits for mutex release */
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return pbs_errno;
+
+	/* tell the server the requests are pipelined, older ones refuse */
+
+	sock = connection[c].ch_socket;
+	/* the server reads the connection as a batch from now on, never pool it */
+	connection[c].ch_stateful = 1;
+	DIS_tcp_setup(sock);
+	if ((rc = encode_DIS_ReqHdr(sock, PBS_BATCH_SubmitBatch, pbs_current_user)) ||
+		(rc = encode_DIS_ReqExtend(sock, NULL))) {
+		connection[c].ch_errtxt = strdup(dis_emsg[rc]);
+		if (connection[c].ch_errtxt == NULL)
+			pbs_errno = PBSE_SYSTEM;
+		else
+			pbs_errno = PBSE_PROTOCOL;
+		goto error;
+	}
+	if (DIS_tcp_wflush(sock)) {
+		pbs_errno = PBSE_PROTOCOL;
+		goto error;
+	}
+	reply = PBSD_rdrpy(c);
+	PBSD_FreeReply(reply);
+	if (connection[c].ch_errno != PBSE_NONE) {
+		pbs_errno = connection[c].ch_errno;
+		goto error;
+	}
+
+	for (next = 0; next < count; ) {
+
+		/* write the requests of the next jobs ... */
+
+		DIS_tcp_setup(sock);
+		done = 0;
+		for (nwin = 0; (nwin < SUBMIT_BATCH_WINDOW) && (next < count); next++) {
+			if ((pres = calloc(1, sizeof(struct batch_jobresult))) == NULL) {
+				pbs_errno = PBSE_SYSTEM;
+				goto error;
+			}
+			*tail = pres;
+			tail = &pres->next;
+
+			/* verify the attributes, if verification is enabled */
+			if (pbs_verify_attributes(c, PBS_BATCH_QueueJob,
+				MGR_OBJ_JOB, MGR_CMD_NONE, jobs[next].attrib)) {
+				pres->code = pbs_errno;
+				if ((msg = pbs_geterrmsg(c)) != NULL)
+					pres->text = strdup(msg);
+				continue;
+			}
+
+			/* tag the requests of each job with its own trace id */
+			if (pbs_conf.pbs_trace) {
+				pbs_trace_newid(trace_id, sizeof(trace_id));
+				ptr->th_pbs_trace = trace_id;
+			}
+			rc = submit_batch_put(sock, &jobs[next], extend);
+			ptr->th_pbs_trace = NULL;
+			if (rc < 0) {
+				pres->code = PBSE_PROTOCOL;
+				pbs_errno = PBSE_PROTOCOL;
+				goto error;
+			} else if (rc == 0) {
+				pres->code = pbs_errno;
+				continue;
+			}
+			window[nwin] = pres;
+			nreply[nwin++] = rc;
+		}
+		if (DIS_tcp_wflush(sock)) {
+			pbs_errno = PBSE_PROTOCOL;
+			goto error;
+		}
+
+		/* ... then read their replies, in the same order */
+
+		for (; done < nwin; done++) {
+			if ((rc = submit_batch_get(sock, nreply[done], window[done])) != 0) {
+				connection[c].ch_errtxt = strdup(dis_emsg[rc]);
+				pbs_errno = PBSE_PROTOCOL;
+				goto error;
+			}
+		}
+		nwin = 0;
+	}
+
+	*results = head;
+	pbs_errno = PBSE_NONE;
+
+	/* unlock the thread lock and update the thread context data */
+	if (pbs_client_thread_unlock_connection(c) != 0)
+		return pbs_errno;
+	return PBSE_NONE;
+
+error:
+	/* the jobs in the window without a reply may or may not be queued */
+	for (; done < nwin; done++) {
+		if (window[done]->code == PBSE_NONE)
+			window[done]->code = PBSE_PROTOCOL;
+	}
+	*results = head;
+	rc = pbs_errno;
+	(void)pbs_client_thread_unlock_connection(c);
+	return (pbs_errno = rc);
+}
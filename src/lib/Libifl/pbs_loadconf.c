@@ -122,7 +122,17 @@ struct pbs_config pbs_conf = {
 	0,					/* default comm logevent mask */
 	4,					/* default number of threads */
 	NULL,					/* mom short name override */
-	0					/* high resolution timestamp logging */
+	0,					/* high resolution timestamp logging */
+	0,					/* async log queue depth, synchronous by default */
+	0,					/* block on a full async log queue */
+	PBS_ACCT_FORMAT_TEXT,			/* text accounting log */
+	0,					/* no log index files */
+	0,					/* request tracing off */
+	0,					/* default trace ring size */
+	PBS_RECOV_THREADS_DEFAULT,		/* bulk job recovery at server start */
+	0,					/* no server snapshot */
+	0,					/* no client connection pool */
+	0					/* Data-is-Strings integers */
 #ifdef WIN32
 	,NULL					/* remote viewer launcher executable along with launch options */
 #endif
@@ -249,6 +259,25 @@ parse_config_line(FILE *fp, char **key, char **val)
 	return ret;
 }
 
+/**
+ * @brief
+ *	parse_acct_format - Map a PBS_ACCT_FORMAT value to PBS_ACCT_FORMAT_* bits
+ *
+ * @param[in] value	"text", "binary" or "both"
+ *
+ * @return unsigned int
+ * @retval PBS_ACCT_FORMAT_* bits, text for an unknown value
+ */
+static unsigned int
+parse_acct_format(char *value)
+{
+	if (strcasecmp(value, "binary") == 0)
+		return PBS_ACCT_FORMAT_BINARY;
+	if (strcasecmp(value, "both") == 0)
+		return (PBS_ACCT_FORMAT_TEXT | PBS_ACCT_FORMAT_BINARY);
+	return PBS_ACCT_FORMAT_TEXT;
+}
+
 /**
  * @brief
  *	pbs_loadconf - Populate the pbs_conf structure
@@ -570,6 +599,45 @@ pbs_loadconf(int reload)
 				if (sscanf(conf_value, "%u", &uvalue) == 1)
 					pbs_conf.pbs_log_highres_timestamp = ((uvalue > 0) ? 1 : 0);
 			}
+			else if (!strcmp(conf_name, PBS_CONF_LOG_ASYNC_QUEUE)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_log_async_queue = uvalue;
+			}
+			else if (!strcmp(conf_name, PBS_CONF_LOG_ASYNC_DROP)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_log_async_drop = ((uvalue > 0) ? 1 : 0);
+			}
+			else if (!strcmp(conf_name, PBS_CONF_ACCT_FORMAT)) {
+				pbs_conf.pbs_acct_format = parse_acct_format(conf_value);
+			}
+			else if (!strcmp(conf_name, PBS_CONF_LOG_INDEX)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_log_index = ((uvalue > 0) ? 1 : 0);
+			}
+			else if (!strcmp(conf_name, PBS_CONF_TRACE)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_trace = ((uvalue > 0) ? 1 : 0);
+			}
+			else if (!strcmp(conf_name, PBS_CONF_TRACE_RING)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_trace_ring = uvalue;
+			}
+			else if (!strcmp(conf_name, PBS_CONF_RECOV_THREADS)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_recov_threads = uvalue;
+			}
+			else if (!strcmp(conf_name, PBS_CONF_SNAPSHOT_INTERVAL)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_snapshot_interval = uvalue;
+			}
+			else if (!strcmp(conf_name, PBS_CONF_CONN_POOL)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_conn_pool = uvalue;
+			}
+			else if (!strcmp(conf_name, PBS_CONF_DIS_BINARY)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_dis_binary = ((uvalue > 0) ? 1 : 0);
+			}
 #ifdef WIN32
 			else if (!strcmp(conf_name, PBS_CONF_REMOTE_VIEWER)) {
 				free(pbs_conf.pbs_conf_remote_viewer);
@@ -801,6 +869,44 @@ pbs_loadconf(int reload)
 		if (sscanf(gvalue, "%u", &uvalue) == 1)
 			pbs_conf.pbs_log_highres_timestamp = ((uvalue > 0) ? 1 : 0);
 	}
+	if ((gvalue = getenv(PBS_CONF_LOG_ASYNC_QUEUE)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_log_async_queue = uvalue;
+	}
+	if ((gvalue = getenv(PBS_CONF_LOG_ASYNC_DROP)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_log_async_drop = ((uvalue > 0) ? 1 : 0);
+	}
+	if ((gvalue = getenv(PBS_CONF_ACCT_FORMAT)) != NULL)
+		pbs_conf.pbs_acct_format = parse_acct_format(gvalue);
+	if ((gvalue = getenv(PBS_CONF_LOG_INDEX)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_log_index = ((uvalue > 0) ? 1 : 0);
+	}
+	if ((gvalue = getenv(PBS_CONF_TRACE)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_trace = ((uvalue > 0) ? 1 : 0);
+	}
+	if ((gvalue = getenv(PBS_CONF_TRACE_RING)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_trace_ring = uvalue;
+	}
+	if ((gvalue = getenv(PBS_CONF_RECOV_THREADS)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_recov_threads = uvalue;
+	}
+	if ((gvalue = getenv(PBS_CONF_SNAPSHOT_INTERVAL)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_snapshot_interval = uvalue;
+	}
+	if ((gvalue = getenv(PBS_CONF_CONN_POOL)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_conn_pool = uvalue;
+	}
+	if ((gvalue = getenv(PBS_CONF_DIS_BINARY)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_dis_binary = ((uvalue > 0) ? 1 : 0);
+	}
 
 #ifdef WIN32
 	if ((gvalue = getenv(PBS_CONF_REMOTE_VIEWER)) != NULL) {
@@ -75,6 +75,8 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <stdlib.h>
 #include <assert.h>
 #include "libpbs.h"
@@ -88,6 +90,20 @@
 
 #define THE_BUF_SIZE 1024
 
+/*
+ * Buffers grow by doubling, so a large reply is not copied once for every
+ * THE_BUF_SIZE bytes of it.  A buffer that grew beyond TCP_BUF_KEEP is put
+ * back to THE_BUF_SIZE when DIS is set up again for its fd, buffers up to
+ * that size are kept and reused by the following requests.
+ */
+#define TCP_BUF_KEEP	(256 * 1024)
+
+/* data queued on the socket is read at once up to this much */
+#define TCP_READ_AHEAD	(4 * 1024 * 1024)
+
+/* strings this long are written straight from the caller, see tcp_puts */
+#define TCP_WRITEV_MIN	(16 * 1024)
+
 struct tcpdisbuf {
 	size_t	tdis_lead;
 	size_t	tdis_trail;
@@ -99,6 +115,7 @@ struct tcpdisbuf {
 struct	tcp_chan {
 	struct	tcpdisbuf	readbuf;
 	struct	tcpdisbuf	writebuf;
+	int			binary;	/* integers in binary framing */
 };
 
 /* resize of following global variables are protected by a mutex */
@@ -195,7 +212,6 @@ struct tcpdisbuf * tcp_get_writebuf(int fd)
  * 	-tcp_pack_buff - pack existing data into front of buffer
  *
  *	Moves "uncommited" data to front of buffer and adjusts pointers.
- *	Does a character by character move since data may over lap.
  * 
  * @param[in] tp - tcp data buffer
  *
@@ -208,21 +224,55 @@ tcp_pack_buff(struct tcpdisbuf *tp)
 {
 	size_t amt;
 	size_t start;
-	size_t i;
 
 	start = tp->tdis_trail;
 	if (start != 0) {
 		amt  = tp->tdis_eod - start;
-		for (i=0; i<amt; ++i) {
-			*(tp->tdis_thebuf + i) =
-				*(tp->tdis_thebuf + i + start);
-		}
+		if (amt > 0)
+			memmove(tp->tdis_thebuf, tp->tdis_thebuf + start, amt);
 		tp->tdis_lead  -= start;
 		tp->tdis_trail -= start;
 		tp->tdis_eod   -= start;
 	}
 }
 
+/**
+ * @brief
+ * 	-tcp_buf_grow - make room for at least need bytes in a buffer
+ *
+ *	The size is at least doubled, in multiples of THE_BUF_SIZE.
+ *
+ * @param[in] tp - tcp data buffer
+ * @param[in] need - size the buffer must have
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	realloc failed
+ *
+ */
+
+static int
+tcp_buf_grow(struct tcpdisbuf *tp, size_t need)
+{
+	size_t	size;
+	char	*tmcp;
+
+	if (tp->tdis_bufsize >= need)
+		return 0;
+
+	size = tp->tdis_bufsize * 2;
+	if (size < need)
+		size = ((need / THE_BUF_SIZE) + 1) * THE_BUF_SIZE;
+
+	/* no need to lock mutex here, this is per fd resize */
+	tmcp = (char *)realloc(tp->tdis_thebuf, sizeof(char) * size);
+	if (tmcp == NULL)
+		return -1;
+	tp->tdis_thebuf = tmcp;
+	tp->tdis_bufsize = size;
+	return 0;
+}
+
 /**
  * @brief
  * 	-tcp_read - read data from tcp stream to "fill" the buffer
@@ -243,8 +293,8 @@ tcp_read(int fd)
 	int i;
 	struct	pollfd pollfds[1];
 	int	timeout;
+	int	avail;
 	struct	tcpdisbuf	*tp;
-	char   *tmcp;
 
 	tp = tcp_get_readbuf(fd);
 
@@ -253,19 +303,9 @@ tcp_read(int fd)
 	tcp_pack_buff(tp);
 
 	if ((tp->tdis_bufsize - tp->tdis_eod) < 20) {
-
-		/* no need to lock mutex here, this is per fd resize */
 		/* needing a larger buffer area for the data */
-
-		tp->tdis_bufsize += THE_BUF_SIZE;
-		tmcp = (char *)realloc(tp->tdis_thebuf,
-			sizeof(char)*tp->tdis_bufsize);
-		if (tmcp != NULL) {
-			tp->tdis_thebuf = tmcp;
-		} else {
-			/* realloc failed */
+		if (tcp_buf_grow(tp, tp->tdis_eod + THE_BUF_SIZE) != 0)
 			return -1;
-		}
 	}
 
 	/*
@@ -288,6 +328,14 @@ tcp_read(int fd)
 	if ((i == 0) || (i < 0))
 		return i;
 
+	/* make room for what is already queued on the socket, up to a limit */
+	if ((ioctl(fd, FIONREAD, &avail) == 0) &&
+		(avail > (int)(tp->tdis_bufsize - tp->tdis_eod))) {
+		if (avail > TCP_READ_AHEAD)
+			avail = TCP_READ_AHEAD;
+		(void)tcp_buf_grow(tp, tp->tdis_eod + avail);
+	}
+
 	while ((i = CS_read(fd, &tp->tdis_thebuf[tp->tdis_eod],
 		tp->tdis_bufsize - tp->tdis_eod)) == CS_IO_FAIL) {
 
@@ -326,36 +374,35 @@ DIS_wflush(int sock, int rpp)
 
 /**
  * @brief
- * 	-DIS_tcp_wflush - flush tcp/dis write buffer
+ * 	-tcp_send - write the data of several buffers to the socket, in order,
+ *	with as few system calls as the socket allows.
  *
- * @par Functionality:
- *	Writes "committed" data in buffer to file discriptor,
- *	packs remaining data (if any), resets pointers
+ * @param[in] fd - socket descriptor
+ * @param[in] iov - the buffers, updated as they are written
+ * @param[in] cnt - number of buffers
  *
  * @return	int
  * @retval	0	success
- * @retval	-1	error
+ * @retval	-1	error, pbs_tcp_errno is set
  *
  */
-int
-DIS_tcp_wflush(int fd)
+static int
+tcp_send(int fd, struct iovec *iov, int cnt)
 {
-	size_t	ct;
-	int	i;
+	ssize_t	i;
 	int	j;
-	char	*pb;
-	struct	tcpdisbuf	*tp;
 	struct	pollfd pollfds[1];
 
-	pbs_tcp_errno = 0;
-	tp = tcp_get_writebuf(fd);
-	pb = tp->tdis_thebuf;
-
-	ct = tp->tdis_trail;
-	if (ct == 0)
-		return 0;
-
-	while ((i = CS_write(fd, pb, ct)) != ct) {
+	while (cnt > 0) {
+		if (iov->iov_len == 0) {
+			iov++;
+			cnt--;
+			continue;
+		}
+		if (cnt == 1)
+			i = CS_write(fd, iov->iov_base, iov->iov_len);
+		else
+			i = CS_writev(fd, iov, cnt);
 		if (i == CS_IO_FAIL) {
 			if (errno == EINTR) {
 				continue;
@@ -389,10 +436,50 @@ DIS_tcp_wflush(int fd)
 			}
 			continue;	/* socket ready, retry write */
 		}
-		/* write succeeded, do more if needed */
-		ct -= i;
-		pb += i;
+		/* write succeeded, skip what was written and do more if needed */
+		while ((cnt > 0) && ((size_t)i >= iov->iov_len)) {
+			i -= iov->iov_len;
+			iov++;
+			cnt--;
+		}
+		if (cnt > 0) {
+			iov->iov_base = (char *)iov->iov_base + i;
+			iov->iov_len -= i;
+		}
 	}
+	return 0;
+}
+
+/**
+ * @brief
+ * 	-DIS_tcp_wflush - flush tcp/dis write buffer
+ *
+ * @par Functionality:
+ *	Writes "committed" data in buffer to file discriptor,
+ *	packs remaining data (if any), resets pointers
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	error
+ *
+ */
+int
+DIS_tcp_wflush(int fd)
+{
+	struct	tcpdisbuf	*tp;
+	struct	iovec		iov[1];
+
+	pbs_tcp_errno = 0;
+	tp = tcp_get_writebuf(fd);
+
+	if (tp->tdis_trail == 0)
+		return 0;
+
+	iov[0].iov_base = tp->tdis_thebuf;
+	iov[0].iov_len = tp->tdis_trail;
+	if (tcp_send(fd, iov, 1) != 0)
+		return (-1);
+
 	tp->tdis_eod = tp->tdis_lead;
 	tcp_pack_buff(tp);
 	return 0;
@@ -432,6 +519,38 @@ DIS_tcp_reset(int fd, int i)
 	DIS_tcp_clear(i==0 ? tcp_get_readbuf(fd) : tcp_get_writebuf(fd));
 }
 
+/**
+ * @brief
+ * 	-DIS_tcp_rpending - number of bytes read from the stream but not yet
+ *	decoded, such as the requests a client pipelined behind the last one.
+ *
+ * @param[in] fd - file descriptor
+ *
+ * @return	int
+ * @retval	number of bytes, 0 if DIS was never set up for fd
+ *
+ */
+int
+DIS_tcp_rpending(int fd)
+{
+	struct	tcpdisbuf	*tp = NULL;
+	int rc;
+
+	if (fd < 0)
+		return 0;
+
+	rc = pbs_client_thread_lock_tcp();
+	assert(rc == 0);
+	if ((fd < tcparraymax) && (tcparray[fd] != NULL))
+		tp = &tcparray[fd]->readbuf;
+	rc = pbs_client_thread_unlock_tcp();
+	assert(rc == 0);
+
+	if (tp == NULL)
+		return 0;
+	return ((int)(tp->tdis_eod - tp->tdis_trail));
+}
+
 /**
  * @brief
  * 	-tcp_rskip - tcp/dis suport routine to skip over data in read buffer
@@ -482,7 +601,7 @@ tcp_getc(int fd)
 		if (x <= 0)
 			return ((x == -2) ? -2 : -1);	/* Error or EOF */
 	}
-	return ((int)tp->tdis_thebuf[tp->tdis_lead++]);
+	return ((int)(unsigned char)tp->tdis_thebuf[tp->tdis_lead++]);
 }
 
 /**
@@ -536,27 +655,34 @@ static int
 tcp_puts(int fd, const char *str, size_t ct)
 {
 	struct	tcpdisbuf	*tp;
-	char			*tmcp;
+	struct	iovec		iov[2];
 
 	tp = tcp_get_writebuf(fd);
 	if ((tp->tdis_bufsize - tp->tdis_lead) < ct) {
+		if (ct >= TCP_WRITEV_MIN) {
+			/*
+			 * rather than copy a long string into the buffer, write
+			 * what is buffered and the string together; the data
+			 * not yet committed goes too, as it leads the string
+			 */
+			pbs_tcp_errno = 0;
+			iov[0].iov_base = tp->tdis_thebuf;
+			iov[0].iov_len = tp->tdis_lead;
+			iov[1].iov_base = (char *)str;
+			iov[1].iov_len = ct;
+			if (tcp_send(fd, iov, 2) != 0)
+				return -1;	/* error */
+			DIS_tcp_clear(tp);
+			return ct;
+		}
+
 		/* not enough room, try to flush committed data */
 		if (DIS_tcp_wflush(fd) < 0)
 			return -1;		/* error */
 
-		if ((tp->tdis_bufsize - tp->tdis_lead) < ct) {	/* add room */
-
-			/* no need to lock mutex here, per fd resize */
-			size_t	ru = (ct + tp->tdis_lead) / THE_BUF_SIZE;
-
-			tp->tdis_bufsize = (ru + 1) * THE_BUF_SIZE;
-			tmcp = (char *)realloc(tp->tdis_thebuf,
-				sizeof(char)*tp->tdis_bufsize);
-			if (tmcp != NULL)
-				tp->tdis_thebuf = tmcp;
-			else
-				return -1;	/* realloc failed */
-		}
+		/* add room */
+		if (tcp_buf_grow(tp, tp->tdis_lead + ct) != 0)
+			return -1;	/* realloc failed */
 	}
 	(void)memcpy(&tp->tdis_thebuf[tp->tdis_lead], str, ct);
 	tp->tdis_lead += ct;
@@ -618,6 +744,82 @@ tcp_wcommit(int fd, int commit_flag)
 	return 0;
 }
 
+/**
+ * @brief
+ * 	-tcp_binary - tcp/dis support routine telling whether integers on the
+ *	stream use binary framing
+ *
+ * @par Functionality:
+ *	Called for every integer, so the channel of the fd the thread last set
+ *	up with DIS_tcp_setup is taken from the thread context without the tcp
+ *	lock.  A channel is never freed or moved once allocated, only the array
+ *	pointing to it is, so the cached pointer stays valid.  Other fds are
+ *	looked up in the array under the lock.
+ *
+ * @param[in] fd - file descriptor
+ *
+ * @return	int
+ * @retval	1	binary framing
+ * @retval	0	Data-is-Strings
+ */
+
+static int
+tcp_binary(int fd)
+{
+	struct	pbs_client_thread_context	*ptr;
+	struct	tcp_chan	*tcp = NULL;
+	int rc;
+
+	ptr = (struct pbs_client_thread_context *)
+		pbs_client_thread_get_context_data();
+	if ((ptr != NULL) && (ptr->th_dis_chan != NULL) && (ptr->th_dis_fd == fd))
+		return (((struct tcp_chan *)ptr->th_dis_chan)->binary);
+
+	rc = pbs_client_thread_lock_tcp();
+	assert(rc == 0);
+	if ((fd < tcparraymax) && (tcparray[fd] != NULL))
+		tcp = tcparray[fd];
+	rc = pbs_client_thread_unlock_tcp();
+	assert(rc == 0);
+
+	return ((tcp != NULL) && tcp->binary);
+}
+
+/**
+ * @brief
+ * 	-DIS_tcp_set_binary - switch the integers sent and received on fd to
+ *	or from the binary framing of disbin_.c.  Both ends switch at the same
+ *	point of the stream once they agreed to, see req_connect().  The mode
+ *	outlives DIS_tcp_setup and is to be turned off when fd is closed.
+ *
+ * @param[in] fd - socket descriptor, set up for DIS
+ * @param[in] on - 1 for binary framing, 0 for Data-is-Strings
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	DIS was never set up for fd
+ */
+int
+DIS_tcp_set_binary(int fd, int on)
+{
+	int rc;
+	int ret = -1;
+
+	if (fd < 0)
+		return -1;
+
+	rc = pbs_client_thread_lock_tcp();
+	assert(rc == 0);
+	if ((fd < tcparraymax) && (tcparray[fd] != NULL)) {
+		tcparray[fd]->binary = on;
+		ret = 0;
+	}
+	rc = pbs_client_thread_unlock_tcp();
+	assert(rc == 0);
+
+	return ret;
+}
+
 /**
  * @brief
  *	-sets tcp related functions.
@@ -633,9 +835,36 @@ DIS_tcp_funcs()
 		disr_skip = tcp_rskip;
 		disr_commit = tcp_rcommit;
 		disw_commit = tcp_wcommit;
+		dis_binary = tcp_binary;
 	}
 }
 
+/**
+ * @brief
+ * 	-tcp_buf_trim - put a buffer larger than TCP_BUF_KEEP back to its
+ *	initial size.  Its data is about to be cleared.
+ *
+ * @param[in] tp - tcp data buffer
+ *
+ * @return	Void
+ *
+ */
+
+static void
+tcp_buf_trim(struct tcpdisbuf *tp)
+{
+	char	*tmcp;
+
+	if (tp->tdis_bufsize <= TCP_BUF_KEEP)
+		return;
+	tmcp = (char *)malloc(THE_BUF_SIZE);
+	if (tmcp == NULL)
+		return;
+	free(tp->tdis_thebuf);
+	tp->tdis_thebuf = tmcp;
+	tp->tdis_bufsize = THE_BUF_SIZE;
+}
+
 /**
  * @brief
  * 	-DIS_tcp_setup - setup supports routines for dis, "data is strings", to
@@ -651,6 +880,7 @@ DIS_tcp_funcs()
 void
 DIS_tcp_setup(int fd)
 {
+	struct	pbs_client_thread_context	*ptr;
 	struct	tcp_chan	*tcp;
 	struct  tcp_chan	**tmpa;
 	int	rc;
@@ -696,12 +926,25 @@ DIS_tcp_setup(int fd)
 		tcp->writebuf.tdis_thebuf = malloc(THE_BUF_SIZE);
 		assert(tcp->writebuf.tdis_thebuf != NULL);
 		tcp->writebuf.tdis_bufsize = THE_BUF_SIZE;
+		tcp->binary = 0;
 	}
 
+	/* give back the memory of buffers a large message left very big */
+	tcp_buf_trim(&tcp->readbuf);
+	tcp_buf_trim(&tcp->writebuf);
+
 	/* initialize read and write buffers */
 	DIS_tcp_clear(&tcp->readbuf);
 	DIS_tcp_clear(&tcp->writebuf);
 
 	rc = pbs_client_thread_unlock_tcp();
 	assert(rc == 0);
+
+	/* the channel of the request this thread is about to do, see tcp_binary */
+	ptr = (struct pbs_client_thread_context *)
+		pbs_client_thread_get_context_data();
+	if (ptr != NULL) {
+		ptr->th_dis_fd = fd;
+		ptr->th_dis_chan = tcp;
+	}
 }
@@ -601,6 +601,41 @@ DIS_tcp_reset(int fd, int i)
 	DIS_tcp_clear(i==0 ? tcp_get_readbuf(fd) : tcp_get_writebuf(fd));
 }
 
+/**
+ * @brief
+ *	-number of bytes read from the stream but not yet decoded
+ *
+ * @param[in] fd - file descriptor
+ *
+ * @return	int
+ * @retval	number of bytes, 0 if DIS was never set up for fd
+ *
+ */
+int
+DIS_tcp_rpending(int fd)
+{
+	struct	tcp_chan	*tcp = NULL;
+	int rc;
+
+	if (fd < 0)
+		return 0;
+
+	rc = pbs_client_thread_lock_tcp();
+	assert(rc == 0);
+#ifdef WIN32
+	tcp = DIS_find_tcp_chan(fd);
+#else
+	if (fd < tcparraymax)
+		tcp = tcparray[fd];
+#endif
+	rc = pbs_client_thread_unlock_tcp();
+	assert(rc == 0);
+
+	if (tcp == NULL)
+		return 0;
+	return ((int)(tcp->readbuf.tdis_eod - tcp->readbuf.tdis_trail));
+}
+
 /**
  * @brief
  * 	tcp_rskip - tcp/dis suport routine to skip over data in read buffer
@@ -791,9 +826,28 @@ DIS_tcp_funcs()
 		disr_skip = tcp_rskip;
 		disr_commit = tcp_rcommit;
 		disw_commit = tcp_wcommit;
+		dis_binary = NULL;
 	}
 }
 
+/**
+ * @brief
+ * 	-DIS_tcp_set_binary - binary framing of integers is not supported on
+ *	Windows, streams stay Data-is-Strings
+ *
+ * @param[in] fd - socket descriptor
+ * @param[in] on - 1 for binary framing, 0 for Data-is-Strings
+ *
+ * @return	int
+ * @retval	0	on is 0
+ * @retval	-1	on is 1
+ */
+int
+DIS_tcp_set_binary(int fd, int on)
+{
+	return (on ? -1 : 0);
+}
+
 /**
  * @breif
  * 	-DIS_tcp_setup - setup supports routines for dis, "data is strings", to
@@ -43,11 +43,13 @@
  *
  * @par Functions included are:
  *	log_open()
+ *	log_index_open()
  *	log_open_main()
  *	log_err()
  *	log_joberr()
  *	log_record()
  *	log_close()
+ *	log_async_start()
  *	log_add_debug_info()
  *	log_add_if_info()
  */
@@ -71,6 +73,7 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <signal.h>
 #include "log.h"
 #include "pbs_ifl.h"
 #include "pbs_internal.h"
@@ -106,11 +109,53 @@ char *msg_daemonname;
 static int	     log_auto_switch = 0;
 static int	     log_open_day;
 static FILE	    *logfile;		/* open stream for log file */
+static FILE	    *logindex;		/* job id index of the log file */
 static volatile int  log_opened = 0;
 #if SYSLOG
 static int	     syslogopen = 0;
 #endif	/* SYSLOG */
 
+/* format of a line in the log file */
+#define LOG_LINE_FMT	"%02d/%02d/%04d %02d:%02d:%02d%s;%04x;%s;%s;%s;%s\n"
+
+#ifndef WIN32
+/*
+ * Asynchronous logging.  Once a daemon calls log_async_start() with
+ * PBS_LOG_ASYNC_QUEUE set, log_record() formats and timestamps each
+ * message in the calling thread and appends it to a bounded queue.  A
+ * single writer thread drains the queue in arrival order, does the daily
+ * log switch, and writes each batch with one fwrite/fflush.  A forked
+ * child does not inherit the writer and always logs synchronously.
+ */
+struct log_async_rec {
+	int	lar_yday;	/* day of the year of the timestamp */
+	int	lar_name;	/* offset of the object name in lar_line */
+	int	lar_namelen;	/* its length, 0 if not indexed */
+	char	lar_line[1];	/* formatted log line, newline terminated */
+};
+
+static pthread_mutex_t	log_async_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	log_async_notempty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t	log_async_notfull = PTHREAD_COND_INITIALIZER;
+static pthread_t	log_async_tid;
+static struct log_async_rec **log_async_ring;	/* queued records */
+static struct log_async_rec **log_async_batch;	/* records being written */
+static int		log_async_size;		/* capacity of the ring */
+static int		log_async_head;		/* oldest queued record */
+static int		log_async_count;	/* number of queued records */
+static int		log_async_stop;		/* writer to drain and exit */
+static volatile int	log_async_running = 0;	/* writer thread exists */
+static int		log_async_wanted = 0;	/* restart writer on log reopen */
+static int		log_async_atexit_set = 0;
+static unsigned long	log_async_dropped;	/* records dropped, queue full */
+static unsigned long	log_async_blocked;	/* callers that waited for room */
+static unsigned long	log_async_records;	/* records written by writer */
+static unsigned long	log_async_batches;	/* batches written by writer */
+
+static int  log_async_begin(void);
+static void log_async_end(void);
+#endif	/* WIN32 */
+
 /*
  * the order of these names MUST match the defintions of
  * PBS_EVENTCLASS_* in log.h
@@ -338,6 +383,7 @@ void
 log_atfork_prepare()
 {
 	log_mutex_lock();
+	pthread_mutex_lock(&log_async_mutex);
 }
 
 /**
@@ -348,6 +394,7 @@ log_atfork_prepare()
 void
 log_atfork_parent()
 {
+	pthread_mutex_unlock(&log_async_mutex);
 	log_mutex_unlock();
 }
 
@@ -355,10 +402,27 @@ log_atfork_parent()
  * @brief
  *	wrapper function for log_mutex_unlock().
  *
+ * @par
+ *	The asynchronous log writer thread is not duplicated by fork(), so
+ *	the child forgets the queue (the parent still writes those records)
+ *	and logs synchronously from here on.
+ *
  */
 void
 log_atfork_child()
 {
+	if (log_async_running) {
+		free(log_async_ring);
+		free(log_async_batch);
+		log_async_ring = NULL;
+		log_async_batch = NULL;
+		log_async_size = 0;
+		log_async_head = 0;
+		log_async_count = 0;
+		log_async_running = 0;
+		log_async_wanted = 0;
+	}
+	pthread_mutex_unlock(&log_async_mutex);
 	log_mutex_unlock();
 }
 #endif
@@ -499,6 +563,36 @@ log_open(char *filename, char *directory)
 	return (log_open_main(filename, directory, 0));
 }
 
+/**
+ * @brief
+ *	Open the index of a log file for appending, see LOG_INDEX_SUFFIX, and
+ *	write the LOG_INDEX_START header with the current size of the log.
+ *
+ * @param[in]	idxname - name of the index file
+ * @param[in]	logfp - the log file, open for appending
+ *
+ * @return	FILE *
+ * @retval	the open index
+ * @retval	NULL	on error, errno is set
+ */
+FILE *
+log_index_open(char *idxname, FILE *logfp)
+{
+	FILE *idx;
+	long  start;
+
+	if ((fseek(logfp, 0L, SEEK_END) != 0) || ((start = ftell(logfp)) < 0))
+		return NULL;
+	if ((idx = fopen(idxname, "a")) == NULL)
+		return NULL;
+	if ((fprintf(idx, "%s %ld\n", LOG_INDEX_START, start) < 0) ||
+		(fflush(idx) != 0)) {
+		(void)fclose(idx);
+		return NULL;
+	}
+	return idx;
+}
+
 /**
  *
  * @brief
@@ -530,6 +624,7 @@ int
 log_open_main(char *filename, char *directory, int silent)
 {
 	char  buf[_POSIX_PATH_MAX];
+	char  idxname[_POSIX_PATH_MAX + sizeof(LOG_INDEX_SUFFIX)];
 	int   fds;
 
 	/*providing temporary buffer, tbuf, for forming pbs_version
@@ -605,6 +700,12 @@ log_open_main(char *filename, char *directory, int silent)
 #endif
 		log_opened = 1;			/* note that file is open */
 
+		if (pbs_conf.pbs_log_index && (strcmp(filename, "/dev/console") != 0)) {
+			snprintf(idxname, sizeof(idxname), "%s%s", filename, LOG_INDEX_SUFFIX);
+			if ((logindex = log_index_open(idxname, logfile)) == NULL)
+				log_err(errno, "log_open", idxname);
+		}
+
 		if (!silent) {
 			log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, "Log", "Log opened");
 			snprintf(tbuf, LOG_BUF_SIZE, "pbs_version=%s", pbs_version);
@@ -662,6 +763,10 @@ log_open_main(char *filename, char *directory, int silent)
 	}
 #endif
 
+#ifndef WIN32
+	if (log_async_wanted && !log_async_running)
+		(void)log_async_begin();
+#endif
 
 	return (0);
 }
@@ -839,6 +944,377 @@ log_suspect_file(const char *func, const char *text, const char *file, struct st
 	log_record(PBSEVENT_SECURITY, PBS_EVENTCLASS_FILE, LOG_CRIT, buf, file);
 }
 
+#ifndef WIN32
+/**
+ * @brief
+ *	Write out a batch of log lines collected by the async log writer.
+ *
+ * @param[in]	buf - concatenated log lines
+ * @param[in]	len - length of buf
+ * @param[in]	ibuf - index entries for the lines in buf
+ * @param[in]	ilen - length of ibuf
+ *
+ * @par MT-safe: No, called by the writer thread with the log mutex held
+ *
+ */
+static void
+log_async_flush(char *buf, size_t len, char *ibuf, size_t ilen)
+{
+	int   rc;
+	FILE *savlog;
+
+	if ((len == 0) || (log_opened != 1))
+		return;
+
+	if ((fwrite(buf, 1, len, logfile) != len) || (fflush(logfile) != 0)) {
+		rc = errno;
+		clearerr(logfile);
+		savlog = logfile;
+		logfile = fopen("/dev/console", "w");
+		if (logfile != NULL) {
+			log_err(rc, "log_async_flush", "PBS cannot write to its log");
+			fclose(logfile);
+		}
+		logfile = savlog;
+	} else if ((logindex != NULL) && (ilen > 0)) {
+		/* index entries only ever point at lines already written */
+		(void)fwrite(ibuf, 1, ilen, logindex);
+		(void)fflush(logindex);
+	}
+	log_async_batches++;
+}
+
+/**
+ * @brief
+ *	Body of the asynchronous log writer thread.
+ *
+ * @par
+ *	Waits for queued records, takes everything queued so far in one go,
+ *	and writes it to the log with a single flush.  The log switch at
+ *	midnight is done here, between the records that straddle it.  The
+ *	thread drains the queue and exits once log_async_end() sets
+ *	log_async_stop.
+ *
+ * @param[in]	arg - unused
+ *
+ * @return	NULL
+ *
+ */
+static void *
+log_async_writer(void *arg)
+{
+	struct log_async_rec **batch = log_async_batch;
+	struct log_async_rec  *rec;
+	char   *buf = NULL;
+	char   *ibuf = NULL;
+	char   *tmp;
+	size_t  buflen = 0;
+	size_t  bufsize = 0;
+	size_t  ilen = 0;
+	size_t  isize = 0;
+	size_t  linelen;
+	long	base = 0;
+	unsigned long dropped;
+	unsigned long dropped_reported = 0;
+	int     stop;
+	int     n;
+	int     i;
+	char    msg[LOG_BUF_SIZE];
+
+	do {
+		pthread_mutex_lock(&log_async_mutex);
+		while ((log_async_count == 0) && !log_async_stop)
+			pthread_cond_wait(&log_async_notempty, &log_async_mutex);
+		n = log_async_count;
+		for (i = 0; i < n; i++) {
+			batch[i] = log_async_ring[log_async_head];
+			log_async_head = (log_async_head + 1) % log_async_size;
+		}
+		log_async_count = 0;
+		dropped = log_async_dropped;
+		stop = log_async_stop;
+		pthread_cond_broadcast(&log_async_notfull);
+		pthread_mutex_unlock(&log_async_mutex);
+
+		if ((n == 0) && (dropped == dropped_reported))
+			continue;
+
+		log_mutex_lock();
+		if (dropped != dropped_reported) {
+			snprintf(msg, sizeof(msg),
+				"async log queue full, %lu messages dropped (%lu total)",
+				dropped - dropped_reported, dropped);
+			log_record(PBSEVENT_ERROR | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER,
+				LOG_WARNING, "Log", msg);
+			dropped_reported = dropped;
+		}
+		for (i = 0; i < n; i++) {
+			rec = batch[i];
+			if (log_auto_switch && (rec->lar_yday != log_open_day)) {
+				log_async_flush(buf, buflen, ibuf, ilen);
+				buflen = 0;
+				ilen = 0;
+				log_close(1);
+				log_open(NULL, log_directory);
+			}
+			linelen = strlen(rec->lar_line);
+			if (buflen + linelen > bufsize) {
+				tmp = realloc(buf, buflen + linelen + LOG_BUF_SIZE);
+				if (tmp == NULL) {
+					log_async_flush(buf, buflen, ibuf, ilen);
+					buflen = 0;
+					ilen = 0;
+					if (log_opened == 1)
+						(void)fputs(rec->lar_line, logfile);
+					free(rec);
+					continue;
+				}
+				buf = tmp;
+				bufsize = buflen + linelen + LOG_BUF_SIZE;
+			}
+			if ((buflen == 0) && (logindex != NULL))
+				base = ftell(logfile);
+			if ((logindex != NULL) && (rec->lar_namelen > 0) && (base >= 0)) {
+				if ((ilen + rec->lar_namelen + 32 > isize) &&
+					((tmp = realloc(ibuf, ilen + rec->lar_namelen + LOG_BUF_SIZE)) != NULL)) {
+					ibuf = tmp;
+					isize = ilen + rec->lar_namelen + LOG_BUF_SIZE;
+				}
+				if (ilen + rec->lar_namelen + 32 <= isize)
+					ilen += sprintf(ibuf + ilen, "%ld %.*s\n", base + (long)buflen,
+						rec->lar_namelen, rec->lar_line + rec->lar_name);
+			}
+			memcpy(buf + buflen, rec->lar_line, linelen);
+			buflen += linelen;
+			free(rec);
+		}
+		log_async_flush(buf, buflen, ibuf, ilen);
+		buflen = 0;
+		ilen = 0;
+		log_async_records += n;
+		log_mutex_unlock();
+	} while (!stop);
+
+	free(buf);
+	free(ibuf);
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Start the asynchronous log writer thread for the open log.
+ *
+ * @return	int
+ * @retval	0	writer started, or not applicable
+ * @retval	-1	could not start, logging stays synchronous
+ *
+ */
+static int
+log_async_begin(void)
+{
+	char	 msg[LOG_BUF_SIZE];
+	sigset_t allsigs;
+	sigset_t oldsigs;
+	int	 rc;
+
+	if (log_async_running || (log_opened != 1) || (pbs_conf.pbs_log_async_queue == 0))
+		return 0;
+
+	log_async_ring = calloc(pbs_conf.pbs_log_async_queue, sizeof(struct log_async_rec *));
+	log_async_batch = calloc(pbs_conf.pbs_log_async_queue, sizeof(struct log_async_rec *));
+	if ((log_async_ring == NULL) || (log_async_batch == NULL)) {
+		free(log_async_ring);
+		free(log_async_batch);
+		log_async_ring = NULL;
+		log_async_batch = NULL;
+		return -1;
+	}
+	log_async_size = pbs_conf.pbs_log_async_queue;
+	log_async_head = 0;
+	log_async_count = 0;
+	log_async_stop = 0;
+
+	/* the daemon's signal handlers must run in its own threads, not the writer */
+	sigfillset(&allsigs);
+	pthread_sigmask(SIG_SETMASK, &allsigs, &oldsigs);
+	rc = pthread_create(&log_async_tid, NULL, log_async_writer, NULL);
+	pthread_sigmask(SIG_SETMASK, &oldsigs, NULL);
+	if (rc != 0) {
+		free(log_async_ring);
+		free(log_async_batch);
+		log_async_ring = NULL;
+		log_async_batch = NULL;
+		log_async_size = 0;
+		log_record(PBSEVENT_ERROR | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER,
+			LOG_ERR, "Log", "async log writer thread not started, logging synchronously");
+		return -1;
+	}
+	log_async_running = 1;
+
+	snprintf(msg, sizeof(msg), "async logging enabled, queue=%d on_full=%s",
+		log_async_size, pbs_conf.pbs_log_async_drop ? "drop" : "block");
+	log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, "Log", msg);
+	return 0;
+}
+
+/**
+ * @brief
+ *	Stop the asynchronous log writer: let it write out everything that is
+ *	queued, wait for it to exit, and report its counters.
+ *
+ */
+static void
+log_async_end(void)
+{
+	char msg[LOG_BUF_SIZE];
+
+	if (!log_async_running || pthread_equal(pthread_self(), log_async_tid))
+		return;
+
+	pthread_mutex_lock(&log_async_mutex);
+	log_async_stop = 1;
+	pthread_cond_signal(&log_async_notempty);
+	pthread_cond_broadcast(&log_async_notfull);
+	pthread_mutex_unlock(&log_async_mutex);
+	(void)pthread_join(log_async_tid, NULL);
+
+	log_async_running = 0;
+	free(log_async_ring);
+	free(log_async_batch);
+	log_async_ring = NULL;
+	log_async_batch = NULL;
+	log_async_size = 0;
+
+	snprintf(msg, sizeof(msg),
+		"async log writer stopped, records=%lu batches=%lu dropped=%lu blocked=%lu",
+		log_async_records, log_async_batches, log_async_dropped, log_async_blocked);
+	log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, "Log", msg);
+}
+
+/**
+ * @brief
+ *	atexit() handler, makes sure queued log records reach the log file
+ *	when a daemon exits without calling log_close().
+ *
+ */
+static void
+log_async_atexit(void)
+{
+	log_async_end();
+}
+
+/**
+ * @brief
+ *	Format a log line and append it to the asynchronous log queue.
+ *
+ * @par
+ *	When the queue is full the caller waits for the writer, or, with
+ *	PBS_LOG_ASYNC_DROP set, the record is dropped and counted; the
+ *	writer reports the count in the log.
+ *
+ * @param[in] ptm - broken down time stamp of the record
+ * @param[in] microsec - high resolution part of the time stamp, may be ""
+ * @param[in] eventtype - event type
+ * @param[in] objclass - event object class
+ * @param[in] objname - object name
+ * @param[in] text - log msg
+ *
+ * @return	int
+ * @retval	0	record queued, or dropped by policy
+ * @retval	-1	not queued, caller must write the record itself
+ *
+ */
+static int
+log_async_put(struct tm *ptm, char *microsec, int eventtype, int objclass,
+	const char *objname, const char *text)
+{
+	struct log_async_rec *rec;
+	struct pbs_log_lock  *log_lock;
+	int    len;
+
+	/* a thread holding the log mutex must not wait on the writer */
+	log_lock = pthread_getspecific(pbs_log_tls_key);
+	if ((log_lock != NULL) && (log_lock->locked > 0))
+		return -1;
+
+	len = snprintf(NULL, 0, LOG_LINE_FMT,
+		ptm->tm_mon + 1, ptm->tm_mday, ptm->tm_year + 1900,
+		ptm->tm_hour, ptm->tm_min, ptm->tm_sec, microsec,
+		eventtype & ~PBSEVENT_FORCE, msg_daemonname,
+		class_names[objclass], objname, text);
+	if (len < 0)
+		return -1;
+	rec = malloc(sizeof(struct log_async_rec) + len);
+	if (rec == NULL)
+		return -1;
+	rec->lar_yday = ptm->tm_yday;
+	rec->lar_namelen = 0;
+	if ((objname != NULL) && (*objname != '\0')) {
+		/* the line ends in "<objname>;<text>\n" */
+		rec->lar_namelen = strlen(objname);
+		rec->lar_name = len - 1 - strlen(text) - 1 - rec->lar_namelen;
+	}
+	(void)snprintf(rec->lar_line, len + 1, LOG_LINE_FMT,
+		ptm->tm_mon + 1, ptm->tm_mday, ptm->tm_year + 1900,
+		ptm->tm_hour, ptm->tm_min, ptm->tm_sec, microsec,
+		eventtype & ~PBSEVENT_FORCE, msg_daemonname,
+		class_names[objclass], objname, text);
+
+	pthread_mutex_lock(&log_async_mutex);
+	while ((log_async_count == log_async_size) && !log_async_stop) {
+		if (pbs_conf.pbs_log_async_drop) {
+			log_async_dropped++;
+			pthread_mutex_unlock(&log_async_mutex);
+			free(rec);
+			return 0;
+		}
+		log_async_blocked++;
+		pthread_cond_wait(&log_async_notfull, &log_async_mutex);
+	}
+	if (log_async_stop || !log_async_running) {
+		pthread_mutex_unlock(&log_async_mutex);
+		free(rec);
+		return -1;
+	}
+	log_async_ring[(log_async_head + log_async_count) % log_async_size] = rec;
+	if (log_async_count++ == 0)
+		pthread_cond_signal(&log_async_notempty);
+	pthread_mutex_unlock(&log_async_mutex);
+
+	return 0;
+}
+#endif	/* WIN32 */
+
+/**
+ * @brief
+ *	Switch a daemon to asynchronous logging if PBS_LOG_ASYNC_QUEUE is
+ *	set in pbs.conf.  Call once the daemon has gone to the background;
+ *	log_close() drains the queue and stops the writer, and a later
+ *	log_open() starts it again.
+ *
+ * @return	int
+ * @retval	0	success, or asynchronous logging not configured
+ * @retval	-1	writer could not be started, logging stays synchronous
+ *
+ */
+int
+log_async_start(void)
+{
+#ifndef WIN32
+	if (pbs_conf.pbs_log_async_queue == 0)
+		return 0;
+
+	log_async_wanted = 1;
+	if (!log_async_atexit_set) {
+		(void)atexit(log_async_atexit);
+		log_async_atexit_set = 1;
+	}
+	return (log_async_begin());
+#else
+	return 0;
+#endif
+}
+
 /**
  * @brief
  * 	log_record - log a message to the log file
@@ -866,10 +1342,12 @@ log_record(int eventtype, int objclass, int sev, const char *objname, const char
 	struct tm ltm;
 #endif
 	int    rc = 0;
+	int    switch_ok;
 	FILE  *savlog;
 	static char slogbuf[LOG_BUF_SIZE];
 	struct timeval tp;
 	char microsec_buf[8] = {0};
+	long offset = -1;
 
 #if SYSLOG
 	if (syslogopen != 0) {
@@ -882,8 +1360,13 @@ log_record(int eventtype, int objclass, int sev, const char *objname, const char
 	}
 #endif  /* SYSLOG */
 
+#ifndef WIN32
+	if ((log_opened <= 0) && !log_async_running)
+		return;
+#else
 	if (log_opened <= 0)
 		return;
+#endif
 
 	if ((text == NULL) || (objname == NULL))
 		return;
@@ -900,14 +1383,32 @@ log_record(int eventtype, int objclass, int sev, const char *objname, const char
 	ptm = localtime(&now);
 #else
 	ptm = localtime_r(&now, &ltm);
+
+	/* hand the record to the writer thread unless we are the writer */
+	if (log_async_running && !pthread_equal(pthread_self(), log_async_tid) &&
+		(pbs_conf.locallog != 0 || pbs_conf.syslogfac == 0)) {
+		if (log_async_put(ptm, microsec_buf, eventtype, objclass, objname, text) == 0)
+			return;
+	}
 #endif
 
 	/* lock the log mutex */
 	if (log_mutex_lock() != 0)
 		return;
 
+	switch_ok = log_auto_switch;
+#ifndef WIN32
+	/*
+	 * While the writer thread runs only it switches the log: stopping it
+	 * from here, with log_mutex held, would wait on a writer waiting on
+	 * log_mutex.
+	 */
+	if (log_async_running && !pthread_equal(pthread_self(), log_async_tid))
+		switch_ok = 0;
+#endif
+
 	/* Do we need to switch the log? */
-	if (log_auto_switch && (ptm->tm_yday != log_open_day)) {
+	if (switch_ok && (ptm->tm_yday != log_open_day)) {
 		log_close(1);
 		log_open(NULL, log_directory);
 	}
@@ -924,8 +1425,10 @@ log_record(int eventtype, int objclass, int sev, const char *objname, const char
 	}
 
 	if (pbs_conf.locallog != 0 || pbs_conf.syslogfac == 0) {
-		rc = fprintf(logfile,
-			     "%02d/%02d/%04d %02d:%02d:%02d%s;%04x;%s;%s;%s;%s\n",
+		/* any class may name a job, e.g. node or scheduler messages */
+		if ((logindex != NULL) && (objname != NULL) && (*objname != '\0'))
+			offset = ftell(logfile);
+		rc = fprintf(logfile, LOG_LINE_FMT,
 			     ptm->tm_mon + 1, ptm->tm_mday, ptm->tm_year + 1900,
 			     ptm->tm_hour, ptm->tm_min, ptm->tm_sec, microsec_buf,
 			     eventtype & ~PBSEVENT_FORCE, msg_daemonname,
@@ -943,6 +1446,9 @@ log_record(int eventtype, int objclass, int sev, const char *objname, const char
 				fclose(logfile);
 			}
 			logfile = savlog;
+		} else if (offset >= 0) {
+			(void)fprintf(logindex, "%ld %s\n", offset, objname);
+			(void)fflush(logindex);
 		}
 	}
 
@@ -974,6 +1480,9 @@ log_record(int eventtype, int objclass, int sev, const char *objname, const char
 void
 log_close(int msg)
 {
+#ifndef WIN32
+	log_async_end();
+#endif
 	if (log_opened == 1) {
 		log_auto_switch = 0;
 		if (msg) {
@@ -981,6 +1490,10 @@ log_close(int msg)
 				LOG_INFO, "Log", "Log closed");
 		}
 		(void)fclose(logfile);
+		if (logindex != NULL) {
+			(void)fclose(logindex);
+			logindex = NULL;
+		}
 		log_opened = 0;
 	}
 #if SYSLOG
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+/**
+ * @file	pbs_trace.c
+ * @brief
+ * pbs_trace.c - record request tracing spans, see pbs_trace.h.
+ *
+ * @par Functions included are:
+ *	trace_open()
+ *	trace_active()
+ *	trace_span()
+ *	trace_flush()
+ *	trace_close()
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include "portability.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/param.h>
+#include <sys/time.h>
+#include "pbs_ifl.h"
+#include "pbs_internal.h"
+#include "log.h"
+#include "pbs_trace.h"
+
+struct trace_rec {
+	struct timeval	tr_time;
+	char		tr_trace[PBS_TRACE_IDLEN + 1];
+	char		tr_obj[PBS_MAXSVRJOBID + 1];
+	char		tr_stage[PBS_TRACE_STAGELEN + 1];
+};
+
+static pthread_mutex_t	 trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int		 trace_atfork_done = 0;
+static FILE		*trace_fp;		/* open trace file */
+static char		 trace_daemon[32];	/* name written with each span */
+static struct trace_rec	*trace_ring;		/* spans not yet written */
+static int		 trace_size;		/* capacity of the ring */
+static int		 trace_head;		/* oldest unwritten span */
+static int		 trace_count;		/* number of unwritten spans */
+
+/**
+ * @brief
+ *	Write out and forget the spans held in the ring.
+ *
+ * @par MT-safe: No - caller holds trace_mutex
+ */
+static void
+trace_write(void)
+{
+	struct trace_rec *tr;
+
+	while (trace_count > 0) {
+		tr = &trace_ring[trace_head];
+		fprintf(trace_fp, "%ld.%06ld %s %s %s %s\n",
+			(long)tr->tr_time.tv_sec, (long)tr->tr_time.tv_usec,
+			trace_daemon, tr->tr_trace, tr->tr_obj, tr->tr_stage);
+		trace_head = (trace_head + 1) % trace_size;
+		trace_count--;
+	}
+	trace_head = 0;
+	(void)fflush(trace_fp);
+}
+
+/**
+ * @brief
+ *	Hold the ring across fork() so that the child sees it, and the stdio
+ *	buffer of the trace file, in a consistent state.
+ */
+static void
+trace_atfork_prepare(void)
+{
+	(void)pthread_mutex_lock(&trace_mutex);
+}
+
+/**
+ * @brief
+ *	Release the ring in the parent after fork().
+ */
+static void
+trace_atfork_parent(void)
+{
+	(void)pthread_mutex_unlock(&trace_mutex);
+}
+
+/**
+ * @brief
+ *	Stop tracing in a forked child, the parent still owns the ring and
+ *	the spans in it.  The stdio buffer is empty, trace_write() flushes.
+ */
+static void
+trace_atfork_child(void)
+{
+	(void)pthread_mutex_init(&trace_mutex, NULL);
+	if (trace_fp != NULL) {
+		(void)fclose(trace_fp);
+		trace_fp = NULL;
+	}
+	free(trace_ring);
+	trace_ring = NULL;
+	trace_count = 0;
+	trace_head = 0;
+}
+
+/**
+ * @brief
+ *	Start recording spans into PBS_TRACE_FILE of the given directory.
+ *
+ * @par
+ *	Does nothing unless PBS_TRACE is set in pbs.conf, pbs_loadconf() must
+ *	have been called.  The ring holds PBS_TRACE_RING spans.
+ *
+ * @param[in]	directory - the daemon's log directory
+ * @param[in]	daemon - name written with each span, e.g. "server"
+ *
+ * @return	int
+ * @retval	0	tracing on, or not asked for
+ * @retval	-1	the trace file could not be opened
+ */
+int
+trace_open(char *directory, char *daemon)
+{
+	char	path[MAXPATHLEN + 1];
+	int	size;
+
+	if (!pbs_conf.pbs_trace || (directory == NULL))
+		return 0;
+
+	trace_close();
+
+	size = (pbs_conf.pbs_trace_ring > 0) ? (int)pbs_conf.pbs_trace_ring :
+		PBS_TRACE_RING_DEFAULT;
+	snprintf(path, sizeof(path), "%s/%s", directory, PBS_TRACE_FILE);
+
+	(void)pthread_mutex_lock(&trace_mutex);
+	if ((trace_ring = calloc(size, sizeof(struct trace_rec))) == NULL) {
+		(void)pthread_mutex_unlock(&trace_mutex);
+		log_err(errno, __func__, "out of memory");
+		return -1;
+	}
+	if ((trace_fp = fopen(path, "a")) == NULL) {
+		free(trace_ring);
+		trace_ring = NULL;
+		(void)pthread_mutex_unlock(&trace_mutex);
+		log_err(errno, __func__, path);
+		return -1;
+	}
+	trace_size = size;
+	trace_head = 0;
+	trace_count = 0;
+	snprintf(trace_daemon, sizeof(trace_daemon), "%s", daemon);
+	if (!trace_atfork_done) {
+		(void)pthread_atfork(trace_atfork_prepare, trace_atfork_parent,
+			trace_atfork_child);
+		trace_atfork_done = 1;
+	}
+	(void)pthread_mutex_unlock(&trace_mutex);
+
+	snprintf(log_buffer, sizeof(log_buffer),
+		"request tracing enabled, file=%s ring=%d", path, size);
+	log_event(PBSEVENT_SYSTEM | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER,
+		LOG_INFO, msg_daemonname, log_buffer);
+	return 0;
+}
+
+/**
+ * @brief
+ *	Is tracing on in this process?
+ *
+ * @return	int
+ * @retval	1	spans are being recorded
+ * @retval	0	trace_span() is a no-op
+ */
+int
+trace_active(void)
+{
+	return (trace_fp != NULL);
+}
+
+/**
+ * @brief
+ *	Record a span.  Cheap when tracing is off.
+ *
+ * @param[in]	trace - trace id of the request, may be NULL
+ * @param[in]	objid - job id the span belongs to, may be NULL
+ * @param[in]	stage - name of the stage reached
+ */
+void
+trace_span(char *trace, char *objid, char *stage)
+{
+	struct trace_rec *tr;
+
+	if (trace_fp == NULL)
+		return;
+
+	(void)pthread_mutex_lock(&trace_mutex);
+	if (trace_fp == NULL) {
+		(void)pthread_mutex_unlock(&trace_mutex);
+		return;
+	}
+	if (trace_count == trace_size)
+		trace_write();
+	tr = &trace_ring[(trace_head + trace_count) % trace_size];
+	(void)gettimeofday(&tr->tr_time, NULL);
+	snprintf(tr->tr_trace, sizeof(tr->tr_trace), "%s",
+		((trace != NULL) && (*trace != '\0')) ? trace : PBS_TRACE_NONE);
+	snprintf(tr->tr_obj, sizeof(tr->tr_obj), "%s",
+		((objid != NULL) && (*objid != '\0')) ? objid : PBS_TRACE_NONE);
+	snprintf(tr->tr_stage, sizeof(tr->tr_stage), "%s", stage);
+	trace_count++;
+	(void)pthread_mutex_unlock(&trace_mutex);
+}
+
+/**
+ * @brief
+ *	Append the spans held in the ring to the trace file.
+ */
+void
+trace_flush(void)
+{
+	if (trace_fp == NULL)
+		return;
+
+	(void)pthread_mutex_lock(&trace_mutex);
+	if ((trace_fp != NULL) && (trace_count > 0))
+		trace_write();
+	(void)pthread_mutex_unlock(&trace_mutex);
+}
+
+/**
+ * @brief
+ *	Flush the ring and close the trace file.
+ */
+void
+trace_close(void)
+{
+	(void)pthread_mutex_lock(&trace_mutex);
+	if (trace_fp != NULL) {
+		trace_write();
+		(void)fclose(trace_fp);
+		trace_fp = NULL;
+	}
+	free(trace_ring);
+	trace_ring = NULL;
+	trace_count = 0;
+	trace_head = 0;
+	(void)pthread_mutex_unlock(&trace_mutex);
+}
@@ -75,6 +75,7 @@
 #include "svrfunc.h"
 #include "rpp.h"
 #include "tpp_common.h"
+#include "dis.h"
 
 /**
  * @file	net_server.c
@@ -794,6 +795,13 @@ close_conn(int sd)
 	if (idx == -1)
 		return;
 
+	/* drop requests read ahead but never processed, see dis_request_read() */
+	if (DIS_tcp_rpending(sd) > 0)
+		DIS_tcp_reset(sd, 0);
+
+	/* the next connection on this descriptor starts Data-is-Strings */
+	(void)DIS_tcp_set_binary(sd, 0);
+
 	if (svr_conn[idx]->cn_active != ChildPipe) {
 		if (CS_close_socket(sd) != CS_SUCCESS) {
 			char ebuf[PBS_MAXHOSTNAME + 1] = {'\0'};
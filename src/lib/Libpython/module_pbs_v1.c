@@ -111,6 +111,10 @@ extern char pbsv1mod_meth_load_resource_value_doc[];
 extern PyObject * pbsv1mod_meth_load_resource_value(PyObject *self,
 	PyObject *args, PyObject *kwds);
 
+extern char pbsv1mod_meth_load_object_value_doc[];
+extern PyObject * pbsv1mod_meth_load_object_value(PyObject *self,
+	PyObject *args, PyObject *kwds);
+
 extern char pbsv1mod_meth_resource_str_value_doc[];
 extern PyObject * pbsv1mod_meth_resource_str_value(PyObject *self,
 	PyObject *args, PyObject *kwds);
@@ -466,6 +470,9 @@ static PyMethodDef pbs_v1_module_methods[] = {
 	{PY_LOAD_RESOURCE_VALUE_METHOD,
 		(PyCFunction) pbsv1mod_meth_load_resource_value,
 		METH_KEYWORDS, pbsv1mod_meth_load_resource_value_doc},
+	{PY_LOAD_OBJECT_VALUE_METHOD,
+		(PyCFunction) pbsv1mod_meth_load_object_value,
+		METH_KEYWORDS, pbsv1mod_meth_load_object_value_doc},
 	{PY_RESOURCE_STR_VALUE_METHOD,
 		(PyCFunction) pbsv1mod_meth_resource_str_value,
 		METH_KEYWORDS, pbsv1mod_meth_resource_str_value_doc},
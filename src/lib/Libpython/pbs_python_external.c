@@ -55,11 +55,14 @@
 #include <pbs_python_private.h> /* private python file  */
 #include <eval.h>               /* For PyEval_EvalCode  */
 #include <pythonrun.h>          /* For Py_SetPythonHome */
+#include <marshal.h>            /* For PyMarshal_*       */
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <fcntl.h>
 
 extern void init_pbs_ifl(void);
+extern unsigned long crc(unsigned char *buf, unsigned long clen);
 
 static struct _inittab pbs_python_inittab_modules[] = {
 	{PBS_PYTHON_V1_MODULE_EXTENSION_NAME, pbs_v1_module_inittab},
@@ -774,6 +777,184 @@ pbs_python_run_code_in_namespace(struct python_interpreter_data *interp_data,
 
 #ifdef PYTHON               /*  === BEGIN ALL FUNCTIONS REQUIRING PYTHON HEADERS === */
 
+/*
+ * Header of a hook bytecode cache file; the marshalled code object follows.
+ * The cache is used only if all of these match the running interpreter and
+ * the script source being compiled.
+ */
+struct py_bytecode_hdr {
+	long		bc_magic;	/* PyImport_GetMagicNumber() */
+	int		bc_optimize;	/* Py_OptimizeFlag at compile time */
+	unsigned long	bc_cksum;	/* crc() of the script source */
+	unsigned long	bc_srclen;	/* length of the script source */
+};
+
+/**
+ * @brief
+ *	Get the bytecode cache file name of the hook script 'file_name', by
+ *	replacing its PY_HOOK_SCRIPT_SUFFIX with PY_BYTECODE_SUFFIX.
+ *
+ * @param[in]	file_name - the script file name
+ * @param[out]	path - buffer for the cache file name
+ * @param[in]	len - size of 'path'
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	'file_name' is not a hook script, or is too long
+ */
+static int
+_pbs_python_bytecode_path(const char *file_name, char *path, size_t len)
+{
+	size_t	nlen = strlen(file_name);
+	size_t	slen = strlen(PY_HOOK_SCRIPT_SUFFIX);
+
+	if ((nlen <= slen) ||
+		(strcmp(file_name + nlen - slen, PY_HOOK_SCRIPT_SUFFIX) != 0) ||
+		((nlen - slen + strlen(PY_BYTECODE_SUFFIX)) >= len))
+		return -1;
+
+	memcpy(path, file_name, nlen - slen);
+	strcpy(path + nlen - slen, PY_BYTECODE_SUFFIX);
+	return 0;
+}
+
+/**
+ * @brief
+ *	Load the code object cached for the hook script 'file_name', if the
+ *	cache was written by this interpreter for the same source.
+ *
+ * @param[in]	file_name - the script file name
+ * @param[in]	cksum - crc() of the current script source
+ * @param[in]	srclen - length of the current script source
+ *
+ * @return	PyObject *
+ * @retval	code object	cache hit (NEW reference)
+ * @retval	NULL		no usable cache; no Python exception is set
+ */
+static PyObject *
+_pbs_python_read_bytecode(const char *file_name, unsigned long cksum,
+	unsigned long srclen)
+{
+	char			path[MAXPATHLEN+1];
+	struct py_bytecode_hdr	hdr;
+	struct stat		sbuf;
+	char			*buf = NULL;
+	PyObject		*code = NULL;
+	size_t			len;
+	size_t			got;
+	ssize_t			n;
+	int			fd;
+
+	if (_pbs_python_bytecode_path(file_name, path, sizeof(path)) != 0)
+		return NULL;
+
+	if ((fd = open(path, O_RDONLY)) == -1)
+		return NULL;
+#ifdef WIN32
+	setmode(fd, O_BINARY);
+#endif
+
+	/* only trust a cache written by us that nobody else can modify */
+	if ((fstat(fd, &sbuf) == -1) ||
+#ifndef WIN32
+		(sbuf.st_uid != geteuid()) ||
+		((sbuf.st_mode & (S_IWGRP|S_IWOTH)) != 0) ||
+#endif
+		(sbuf.st_size <= (off_t)sizeof(hdr)) ||
+		(read(fd, &hdr, sizeof(hdr)) != sizeof(hdr)) ||
+		(hdr.bc_magic != PyImport_GetMagicNumber()) ||
+		(hdr.bc_optimize != Py_OptimizeFlag) ||
+		(hdr.bc_cksum != cksum) ||
+		(hdr.bc_srclen != srclen))
+		goto read_bytecode_exit;
+
+	len = sbuf.st_size - sizeof(hdr);
+	if ((buf = malloc(len)) == NULL)
+		goto read_bytecode_exit;
+	for (got = 0; got < len; got += n) {
+		n = read(fd, buf + got, len - got);
+		if (n <= 0)
+			goto read_bytecode_exit;
+	}
+
+	code = PyMarshal_ReadObjectFromString(buf, len);
+	if ((code != NULL) && !PyCode_Check(code))
+		Py_CLEAR(code);
+	if (code == NULL)
+		PyErr_Clear();
+
+read_bytecode_exit:
+	close(fd);
+	free(buf);
+	return code;
+}
+
+/**
+ * @brief
+ *	Cache the code object compiled from the hook script 'file_name'.
+ *
+ * @par
+ *	The cache is written to a temporary file that is renamed into place,
+ *	so concurrent pbs_python processes never see a partial file. Failing
+ *	to write it (e.g. a hook running as the job owner) is not an error.
+ *
+ * @param[in]	file_name - the script file name
+ * @param[in]	cksum - crc() of the script source
+ * @param[in]	srclen - length of the script source
+ * @param[in]	code - the compiled code object
+ *
+ * @return	void
+ */
+static void
+_pbs_python_write_bytecode(const char *file_name, unsigned long cksum,
+	unsigned long srclen, PyObject *code)
+{
+	char			path[MAXPATHLEN+1];
+	char			tmp_path[MAXPATHLEN+16];	/* path, "." and a pid */
+	struct py_bytecode_hdr	hdr;
+	PyObject		*py_data = NULL;
+	int			fd;
+	int			ok;
+
+	if (_pbs_python_bytecode_path(file_name, path, sizeof(path)) != 0)
+		return;
+
+	if ((py_data = PyMarshal_WriteObjectToString(code,
+		Py_MARSHAL_VERSION)) == NULL) {
+		PyErr_Clear();
+		return;
+	}
+
+	snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int)getpid());
+	if ((fd = open(tmp_path, O_WRONLY|O_CREAT|O_TRUNC, 0600)) == -1) {
+		Py_DECREF(py_data);
+		return;
+	}
+#ifdef WIN32
+	setmode(fd, O_BINARY);
+#endif
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.bc_magic = PyImport_GetMagicNumber();
+	hdr.bc_optimize = Py_OptimizeFlag;
+	hdr.bc_cksum = cksum;
+	hdr.bc_srclen = srclen;
+
+	ok = (write(fd, &hdr, sizeof(hdr)) == sizeof(hdr)) &&
+		(write(fd, PyString_AS_STRING(py_data),
+		PyString_GET_SIZE(py_data)) == PyString_GET_SIZE(py_data));
+	if (close(fd) != 0)
+		ok = 0;
+#ifdef WIN32
+	if (ok)
+		(void)unlink(path);	/* rename() does not replace on Windows */
+#endif
+	if (!ok || (rename(tmp_path, path) != 0))
+		(void)unlink(tmp_path);
+
+	Py_DECREF(py_data);
+}
+
 /**
  * @brief
  *	only compile the python script.
@@ -797,6 +978,7 @@ _pbs_python_compile_file(const char *file_name,
 	char *file_buffer = NULL; /* buffer to hold the python script file */
 	char *cp = NULL; /* useful character pointer */
 	PyObject *rv = NULL;
+	unsigned long cksum;
 
 	fp = fopen(file_name, "rb");
 	if (!fp) {
@@ -861,8 +1043,20 @@ _pbs_python_compile_file(const char *file_name,
 	}
 
 	fclose(fp);
+
+	/* reuse the bytecode cached for exactly this source, if any */
+	cksum = crc((unsigned char *)file_buffer, (unsigned long)file_sz);
+	if ((rv = _pbs_python_read_bytecode(file_name, cksum,
+		(unsigned long)file_sz)) != NULL) {
+		PyMem_Free(file_buffer);
+		return rv;
+	}
+
 	/* compile the string to a code object,NEW reference caller must DECREF */
 	rv = Py_CompileString(file_buffer, compiled_code_file_name, Py_file_input);
+	if (rv != NULL)
+		_pbs_python_write_bytecode(file_name, cksum,
+			(unsigned long)file_sz, rv);
 	PyMem_Free(file_buffer);
 	return rv;
 
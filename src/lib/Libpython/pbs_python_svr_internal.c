@@ -2009,6 +2009,7 @@ pbs_python_populate_attributes_to_python_class(PyObject *py_instance,
 		CLEAR_HEAD(pheadp);
 
 		svrattr_val = NULL;
+		attrlist_intern_names = 1;
 		encode_rv = attr_def_p->at_encode(attr_p,
 		/* linked list */          &pheadp,
 		/* name        */          attr_def_p->at_name,
@@ -2016,6 +2017,7 @@ pbs_python_populate_attributes_to_python_class(PyObject *py_instance,
 		/* Encoding type */        ATR_ENCODE_HOOK,
 		/* returned svrattrl */    &svrattr_val
 			);
+		attrlist_intern_names = 0;
 
 		if ((encode_rv == 0) && (svrattr_val != NULL)) {
 			encode_rv = 1;
@@ -3217,6 +3219,106 @@ mark_readonly_exit:
  * --------------------- MODULE HELPER METHODS  ----------------------------
  */
 
+/**
+ * @brief
+ *	Defer populating the attributes of the PBS Python object 'py_obj'
+ *	until the hook script first accesses one of them.
+ *
+ * @par
+ *	The object is tagged with the '(kind, name)' pair needed to look up
+ *	its C structure again, and the attribute descriptors in _base_types.py
+ *	call load_object_value() when they see the tag. Only the object itself
+ *	is marked read-only here; its resources are marked once they are
+ *	loaded. Nothing is deferred while a hook debug data file is being
+ *	written, as that file must list every attribute value.
+ *
+ * @param[in]	py_obj - the PBS Python job, queue, or server object
+ * @param[in]	kind - one of PY_TYPE_JOB, PY_TYPE_QUEUE, PY_TYPE_SERVER
+ * @param[in]	name - the job id, queue name, or server name
+ *
+ * @return int
+ * @retval 0	loading deferred
+ * @retval -1	not deferred, the caller must populate 'py_obj' now
+ */
+static int
+_pps_helper_defer_load(PyObject *py_obj, const char *kind, const char *name)
+{
+	PyObject *py_key = NULL;
+	PyObject *py_from = NULL;
+	int rc = -1;
+
+	if (hook_debug.data_fp != NULL)
+		return (-1);
+
+	py_key = PyString_FromString(PY_LOAD_FROM); /* NEW */
+	py_from = Py_BuildValue("(ss)", kind, name); /* NEW */
+	if ((py_key == NULL) || (py_from == NULL))
+		goto defer_load_exit;
+
+	/* bypass the class' __setattr__, which only takes PBS attribute names */
+	if (PyObject_GenericSetAttr(py_obj, py_key, py_from) == -1)
+		goto defer_load_exit;
+
+	if (pbs_python_object_set_attr_integral_value(py_obj,
+		PY_READONLY_FLAG, TRUE) == -1) {
+		(void)PyObject_GenericSetAttr(py_obj, py_key, NULL);
+		goto defer_load_exit;
+	}
+	rc = 0;
+
+defer_load_exit:
+	if (PyErr_Occurred())
+		PyErr_Clear();
+	Py_CLEAR(py_key);
+	Py_CLEAR(py_from);
+	return (rc);
+}
+
+/**
+ * @brief
+ *	Populate the PBS Python queue object 'py_que' with the attribute
+ *	values of 'que', and mark it read-only.
+ *
+ * @param[in]	py_que - the PBS Python queue object
+ * @param[in]	que - the queue to take the values from
+ *
+ * @return int
+ * @retval 0	success
+ * @retval -1	failed to mark the queue read-only
+ */
+static int
+_pps_helper_load_queue(PyObject *py_que, pbs_queue *que)
+{
+	/* As done is statque update the state count */
+	if (!svr_chk_history_conf()) {
+		que->qu_attr[(int)QA_ATR_TotalJobs].at_val.at_long = que->qu_numjobs;
+	} else {
+		que->qu_attr[(int)QA_ATR_TotalJobs].at_val.at_long = que->qu_numjobs -
+			(que->qu_njstate[JOB_STATE_MOVED] + que->qu_njstate[JOB_STATE_FINISHED]);
+	}
+	que->qu_attr[(int)QA_ATR_TotalJobs].at_flags |= ATR_VFLAG_SET|ATR_VFLAG_MODCACHE;
+
+	update_state_ct(&que->qu_attr[(int)QA_ATR_JobsByState],
+		que->qu_njstate,
+		que->qu_jobstbuf);
+	/* stuff all the attributes */
+	snprintf((char *)hook_debug.objname, HOOK_BUF_SIZE-1, "%s(%s)", SERVER_QUEUE_OBJECT, que->qu_qs.qu_name);
+	if (pbs_python_populate_attributes_to_python_class(py_que,
+		py_que_attr_types,
+		que->qu_attr,
+		que_attr_def,
+		QA_ATR_LAST) == -1) {
+		log_err(PBSE_INTERNAL, __func__,
+			"partially populated python queue object");
+	}
+
+	if (pbs_python_mark_object_readonly(py_que) == -1) {
+		log_err(PBSE_INTERNAL, __func__, "Failed to mark queue readonly!");
+		return (-1);
+	}
+	return (0);
+}
+
 /**
  *
  * @brief
@@ -3245,7 +3347,6 @@ _pps_helper_get_queue(pbs_queue *pque, const char *que_name)
 	PyObject *py_que = NULL;
 	PyObject *py_qargs = NULL;
 	pbs_queue *que;
-	int tmp_rc = -1;
 	int i;
 
 	if (pque != NULL) {
@@ -3306,36 +3407,10 @@ _pps_helper_get_queue(pbs_queue *pque, const char *que_name)
 	/*
 	 * OK, At this point we need to start populating the que class.
 	 */
-	/* As done is statque update the state count */
-	if (!svr_chk_history_conf()) {
-		que->qu_attr[(int)QA_ATR_TotalJobs].at_val.at_long = que->qu_numjobs;
-	} else {
-		que->qu_attr[(int)QA_ATR_TotalJobs].at_val.at_long = que->qu_numjobs -
-			(que->qu_njstate[JOB_STATE_MOVED] + que->qu_njstate[JOB_STATE_FINISHED]);
-	}
-	que->qu_attr[(int)QA_ATR_TotalJobs].at_flags |= ATR_VFLAG_SET|ATR_VFLAG_MODCACHE;
-
-	update_state_ct(&que->qu_attr[(int)QA_ATR_JobsByState],
-		que->qu_njstate,
-		que->qu_jobstbuf);
-	/* stuff all the attributes */
-	snprintf((char *)hook_debug.objname, HOOK_BUF_SIZE-1, "%s(%s)", SERVER_QUEUE_OBJECT, que->qu_qs.qu_name);
-	tmp_rc = pbs_python_populate_attributes_to_python_class(py_que,
-		py_que_attr_types,
-		que->qu_attr,
-		que_attr_def,
-		QA_ATR_LAST);
-	if (tmp_rc == -1) {
-		log_err(PBSE_INTERNAL, __func__,
-			"partially populated python queue object");
-	}
-
-	tmp_rc = pbs_python_mark_object_readonly(py_que);
-
-	if (tmp_rc == -1) {
-		log_err(PBSE_INTERNAL, __func__, "Failed to mark queue readonly!");
+	if ((_pps_helper_defer_load(py_que, PY_TYPE_QUEUE,
+		que->qu_qs.qu_name) != 0) &&
+		(_pps_helper_load_queue(py_que, que) == -1))
 		goto ERROR_EXIT;
-	}
 
 	object_counter++;
 
@@ -3398,6 +3473,53 @@ ERROR_EXIT:
 	return NULL;
 }
 
+/**
+ * @brief
+ *	Populate the PBS Python server object 'py_svr' with the attribute
+ *	values of the local server, and mark it read-only.
+ *
+ * @param[in]	py_svr - the PBS Python server object
+ *
+ * @return int
+ * @retval 0	success
+ * @retval -1	failed to mark the server read-only
+ */
+static int
+_pps_helper_load_server(PyObject *py_svr)
+{
+	/* As done is stat_svr update the state count */
+
+	/* update count and state counts from sv_numjobs and sv_jobstates */
+
+	server.sv_attr[(int)SRV_ATR_TotalJobs].at_val.at_long = \
+					server.sv_qs.sv_numjobs;
+	server.sv_attr[(int)SRV_ATR_TotalJobs].at_flags |= \
+					ATR_VFLAG_SET|ATR_VFLAG_MODCACHE;
+	update_state_ct(&server.sv_attr[(int)SRV_ATR_JobsByState],
+		server.sv_jobstates,
+		server.sv_jobstbuf);
+
+	update_license_ct(&server.sv_attr[(int)SRV_ATR_license_count],
+		server.sv_license_ct_buf);
+
+	/* stuff all the attributes */
+	strncpy((char *)hook_debug.objname, SERVER_OBJECT, HOOK_BUF_SIZE-1);
+	if (pbs_python_populate_attributes_to_python_class(py_svr,
+		py_svr_attr_types,
+		server.sv_attr,
+		svr_attr_def,
+		SRV_ATR_LAST) == -1) {
+		log_err(PBSE_INTERNAL, __func__,
+			"partially populated python server object");
+	}
+
+	if (pbs_python_mark_object_readonly(py_svr) == -1) {
+		log_err(PBSE_INTERNAL, __func__, "Failed to mark server readonly!");
+		return (-1);
+	}
+	return (0);
+}
+
 /**
  *
  * @brief
@@ -3418,7 +3540,6 @@ _pps_helper_get_server(void)
 	PyObject *py_svr_class = NULL;
 	PyObject *py_svr = NULL;
 	PyObject *py_sargs = NULL;
-	int tmp_rc = -1;
 
 	if (py_hook_pbsserver != NULL) {
 		Py_INCREF(py_hook_pbsserver);
@@ -3448,40 +3569,9 @@ _pps_helper_get_server(void)
 	/*
 	 * OK, At this point we need to start populating the server class.
 	 */
-	/* As done is stat_svr update the state count */
-
-	/* update count and state counts from sv_numjobs and sv_jobstates */
-
-	server.sv_attr[(int)SRV_ATR_TotalJobs].at_val.at_long = \
-					server.sv_qs.sv_numjobs;
-	server.sv_attr[(int)SRV_ATR_TotalJobs].at_flags |= \
-					ATR_VFLAG_SET|ATR_VFLAG_MODCACHE;
-	update_state_ct(&server.sv_attr[(int)SRV_ATR_JobsByState],
-		server.sv_jobstates,
-		server.sv_jobstbuf);
-
-	update_license_ct(&server.sv_attr[(int)SRV_ATR_license_count],
-		server.sv_license_ct_buf);
-
-	/* stuff all the attributes */
-	strncpy((char *)hook_debug.objname, SERVER_OBJECT, HOOK_BUF_SIZE-1);
-	tmp_rc = pbs_python_populate_attributes_to_python_class(py_svr,
-		py_svr_attr_types,
-		server.sv_attr,
-		svr_attr_def,
-		SRV_ATR_LAST);
-
-	if (tmp_rc == -1) {
-		log_err(PBSE_INTERNAL, __func__,
-			"partially populated python server object");
-	}
-
-	tmp_rc = pbs_python_mark_object_readonly(py_svr);
-
-	if (tmp_rc == -1) {
-		log_err(PBSE_INTERNAL, __func__, "Failed to mark server readonly!");
+	if ((_pps_helper_defer_load(py_svr, PY_TYPE_SERVER, server_name) != 0) &&
+		(_pps_helper_load_server(py_svr) == -1))
 		goto ERROR_EXIT;
-	}
 
 	object_counter++;
 	Py_INCREF(py_svr);
@@ -3500,6 +3590,65 @@ ERROR_EXIT:
 	return NULL;
 }
 
+/**
+ * @brief
+ *	Populate the PBS Python job object 'py_job' with the attribute
+ *	values of 'pjob', point its queue and server attributes to the
+ *	matching Python objects, and mark it read-only.
+ *
+ * @param[in]	py_job - the PBS Python job object
+ * @param[in]	pjob - the job to take the values from
+ *
+ * @return int
+ * @retval 0	success
+ * @retval -1	failed to mark the job read-only
+ */
+static int
+_pps_helper_load_job(PyObject *py_job, job *pjob)
+{
+	PyObject *py_que = NULL;
+	PyObject *py_server = NULL;
+
+	snprintf((char *)hook_debug.objname, HOOK_BUF_SIZE-1, "%s(%s)", SERVER_JOB_OBJECT, pjob->ji_qs.ji_jobid);
+	if (pbs_python_populate_attributes_to_python_class(py_job,
+		py_job_attr_types,
+		pjob->ji_wattr,
+		job_attr_def,
+		JOB_ATR_LAST) == -1) {
+		log_err(PBSE_INTERNAL, __func__,
+			"partially populated python job object");
+	}
+
+	/* set job.queue to actual queue object */
+	if (pjob->ji_qs.ji_queue) {
+		py_que = _pps_helper_get_queue(NULL, pjob->ji_qs.ji_queue);/* NEW ref */
+		if (py_que) {
+			if (PyObject_HasAttrString(py_job, ATTR_queue)) {
+				/* py_que ref ct incremented as part of py_job */
+				(void)PyObject_SetAttrString(py_job, ATTR_queue, py_que);
+			}
+			Py_DECREF(py_que);	/* we no longer need to reference */
+		}
+	}
+
+	/* set job.server to actual server object */
+	py_server = _pps_helper_get_server(); /* NEW Ref */
+
+	if (py_server) {
+		if (PyObject_HasAttrString(py_job, ATTR_server)) {
+			/* py_server ref ct incremented as part of py_job */
+			(void)PyObject_SetAttrString(py_job, ATTR_server, py_server);
+		}
+		Py_DECREF(py_server);
+	}
+
+	if (pbs_python_mark_object_readonly(py_job) == -1) {
+		log_err(PBSE_INTERNAL, __func__, "Failed to mark job readonly!");
+		return (-1);
+	}
+	return (0);
+}
+
 /**
  * @brief
  * 	Helper method returning a job Python Object from a job struct
@@ -3522,10 +3671,7 @@ _pps_helper_get_job(job *pjob_o, const char *jobid, const char *qname)
 	PyObject *py_job_class = NULL;
 	PyObject *py_job = NULL;
 	PyObject *py_jargs = NULL;
-	PyObject *py_que = NULL;
-	PyObject *py_server = NULL;
 	job *pjob;
-	int tmp_rc = -1;
 	int t;
 
 	if (pjob_o != NULL) {
@@ -3587,47 +3733,10 @@ _pps_helper_get_job(job *pjob_o, const char *jobid, const char *qname)
 	/*
 	 * OK, At this point we need to start populating the job class.
 	 */
-	snprintf((char *)hook_debug.objname, HOOK_BUF_SIZE-1, "%s(%s)", SERVER_JOB_OBJECT, pjob->ji_qs.ji_jobid);
-	tmp_rc = pbs_python_populate_attributes_to_python_class(py_job,
-		py_job_attr_types,
-		pjob->ji_wattr,
-		job_attr_def,
-		JOB_ATR_LAST);
-
-	if (tmp_rc == -1) {
-		log_err(PBSE_INTERNAL, __func__,
-			"partially populated python job object");
-	}
-
-	/* set job.queue to actual queue object */
-	if (pjob->ji_qs.ji_queue) {
-		py_que = _pps_helper_get_queue(NULL, pjob->ji_qs.ji_queue);/* NEW ref */
-		if (py_que) {
-			if (PyObject_HasAttrString(py_job, ATTR_queue)) {
-				/* py_que ref ct incremented as part of py_job */
-				(void)PyObject_SetAttrString(py_job, ATTR_queue, py_que);
-			}
-			Py_DECREF(py_que);	/* we no longer need to reference */
-		}
-	}
-
-	/* set job.server to actual server object */
-	py_server = _pps_helper_get_server(); /* NEW Ref */
-
-	if (py_server) {
-		if (PyObject_HasAttrString(py_job, ATTR_server)) {
-			/* py_server ref ct incremented as part of py_job */
-			(void)PyObject_SetAttrString(py_job, ATTR_server, py_server);
-		}
-		Py_DECREF(py_server);
-	}
-
-	tmp_rc = pbs_python_mark_object_readonly(py_job);
-
-	if (tmp_rc == -1) {
-		log_err(PBSE_INTERNAL, __func__, "Failed to mark job readonly!");
+	if ((_pps_helper_defer_load(py_job, PY_TYPE_JOB,
+		pjob->ji_qs.ji_jobid) != 0) &&
+		(_pps_helper_load_job(py_job, pjob) == -1))
 		goto ERROR_EXIT;
-	}
 
 	object_counter++;
 	return py_job;
@@ -11876,6 +11985,105 @@ pbsv1mod_meth_load_resource_value(PyObject *self, PyObject *args, PyObject *kwds
 	Py_RETURN_NONE;
 }
 
+const char pbsv1mod_meth_load_object_value_doc[] =
+"load_object_value(object)\n\
+\n\
+   object:  job, queue, or server object whose values are to be set\n\
+\n\
+   Load the attribute values deferred for 'object'.\n\
+";
+
+/**
+ * @brief
+ *	This is callable in a Python script, for populating a job, queue,
+ *	or server object whose attribute values were deferred by
+ *	_pps_helper_defer_load(). The values are taken from the C structure
+ *	as it is at the time of the call. If that structure is gone, the
+ *	object keeps its default (unset) values.
+ *
+ * @param[in]	args[1]	- the PBS Python object.
+ *
+ * @return	PyObject *
+ * @retval	NULL	- with an accompanying AssertionError Python exception.
+ * @retval	Py_None - successful execution.
+ *
+ */
+PyObject *
+pbsv1mod_meth_load_object_value(PyObject *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = {"object", NULL};
+	PyObject *py_obj = NULL;
+	PyObject *py_key = NULL;
+	PyObject *py_from = NULL;
+	char *kind = NULL;
+	char *name = NULL;
+	pbs_queue *que;
+	job *pjob;
+	int readonly;
+	int hook_set_mode_orig;
+	int rc = 0;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds,
+		"O:load_object_value",
+		kwlist,
+		&py_obj)) {
+		return NULL;
+	}
+
+	py_key = PyString_FromString(PY_LOAD_FROM); /* NEW */
+	if (py_key == NULL)
+		return NULL;
+
+	py_from = PyObject_GenericGetAttr(py_obj, py_key); /* NEW */
+	if (py_from == NULL) {
+		/* already loaded */
+		PyErr_Clear();
+		Py_DECREF(py_key);
+		Py_RETURN_NONE;
+	}
+
+	/* untag first, as the values get set through the same descriptors */
+	if ((PyObject_GenericSetAttr(py_obj, py_key, NULL) == -1) ||
+		!PyArg_ParseTuple(py_from, "ss", &kind, &name)) {
+		rc = -1;
+		goto load_object_exit;
+	}
+
+	readonly = pbs_python_object_get_attr_integral_value(py_obj,
+		PY_READONLY_FLAG);
+
+	hook_set_mode_orig = hook_set_mode;
+	hook_set_mode = C_MODE;
+	if (strcmp(kind, PY_TYPE_JOB) == 0) {
+		if ((pjob = find_job(name)) != NULL)
+			rc = _pps_helper_load_job(py_obj, pjob);
+	} else if (strcmp(kind, PY_TYPE_QUEUE) == 0) {
+		if ((que = find_queuebyname(name)) != NULL)
+			rc = _pps_helper_load_queue(py_obj, que);
+	} else if (strcmp(kind, PY_TYPE_SERVER) == 0) {
+		rc = _pps_helper_load_server(py_obj);
+	}
+
+	/* loading marks the object read-only; keep what the event set up */
+	if ((rc == 0) && (readonly != -1))
+		rc = pbs_python_object_set_attr_integral_value(py_obj,
+			PY_READONLY_FLAG, readonly);
+	hook_set_mode = hook_set_mode_orig;
+
+load_object_exit:
+	Py_DECREF(py_key);
+	Py_DECREF(py_from);
+	if (rc != 0) {
+		snprintf(log_buffer, LOG_BUF_SIZE-1,
+			"Failed to load values of %s %s",
+			kind ? kind : "object", name ? name : "");
+		log_buffer[LOG_BUF_SIZE-1] = '\0';
+		PyErr_SetString(PyExc_AssertionError, log_buffer);
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
 const char pbsv1mod_meth_resource_str_value_doc[] =
 "str_resource_value(resc_object)\n\
 \n\
@@ -168,6 +168,31 @@ CS_write(int sd, char *buf, size_t len)
 
 }
 
+#ifndef WIN32
+/**
+ * @brief
+ * 	CS_writev - write data gathered from several buffers
+ *
+ * @par	call:
+ *      r = CS_writev ( fid, iov, iovcnt )
+ *
+ * @param[in]	fid     - file id to write to
+ * @param[in]	iov     - the buffers to write, in order
+ * @param[in]	iovcnt  - number of buffers
+ *
+ * @returns	int
+ * @retval	- number of bytes written
+ * @retval	CS_IO_FAIL (-1) on error
+ *------------------------------------------------------------------------
+ */
+
+int
+CS_writev(int sd, struct iovec *iov, int iovcnt)
+{
+	return (writev(sd, iov, iovcnt));
+}
+#endif
+
 /**
  * @brief
  * 	CS_client_auth - stub interface for STD authentication to a remote
@@ -350,12 +350,15 @@ typedef struct {
 
 /*
  * The cmd structure is used to package the
- * command messages passed between threads
+ * command messages passed between threads.
+ * The next pointer links the cmd into the mbox
+ * lists, so posting a cmd needs no extra allocation
  */
-typedef struct {
+typedef struct tpp_cmd {
 	unsigned int tfd;
 	int cmdval;
 	void *data;
+	struct tpp_cmd *next;
 } tpp_cmd_t;
 
 /*
@@ -364,10 +367,23 @@ typedef struct {
  * thread, it posts a message to that threads mbox.
  * That wakes up the thread from a poll/select
  * and allows to act on the message
+ *
+ * Posting is lock free: producers push cmds onto the
+ * mbox_inbox stack with a compare-and-swap. The reader
+ * detaches the whole stack in one exchange and moves it,
+ * in posting order, to the private mbox_head/mbox_tail
+ * list, from which cmds are then read without touching
+ * the shared inbox. The wakeup fd is written only by the
+ * producer that flips mbox_signalled from 0 to 1, so a
+ * burst of posts costs a single eventfd/pipe write.
+ * The mbox_mutex is taken only on the reader side.
  */
 typedef struct {
 	pthread_mutex_t mbox_mutex;
-	tpp_que_t mbox_queue;
+	tpp_cmd_t *mbox_inbox;	/* lock free LIFO of newly posted cmds */
+	tpp_cmd_t *mbox_head;	/* reader private FIFO of cmds */
+	tpp_cmd_t *mbox_tail;
+	int mbox_signalled;	/* wakeup already sent, not yet consumed */
 #ifdef HAVE_SYS_EVENTFD_H
 	int mbox_eventfd;
 #else
@@ -649,7 +665,7 @@ int tpp_mbox_init(tpp_mbox_t *mbox);
 void tpp_mbox_destroy(tpp_mbox_t *mbox, int destroy_lock);
 int tpp_mbox_monitor(void *em_ctx, tpp_mbox_t *mbox);
 int tpp_mbox_read(tpp_mbox_t *mbox, unsigned int *tfd, int *cmdval, void **data);
-int tpp_mbox_clear(tpp_mbox_t *mbox, tpp_que_elem_t **n, unsigned int tfd, int *cmdval, void **data);
+int tpp_mbox_clear(tpp_mbox_t *mbox, tpp_cmd_t **n, unsigned int tfd, int *cmdval, void **data);
 int tpp_mbox_post(tpp_mbox_t *mbox, unsigned int tfd, int cmdval, void *data);
 int tpp_mbox_getfd(tpp_mbox_t *mbox);
 void tpp_mbox_drain_unsafe(tpp_mbox_t *mbox);
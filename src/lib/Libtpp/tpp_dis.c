@@ -584,6 +584,7 @@ DIS_tpp_reset()
 		disr_skip = tppdis_rskip;
 		disr_commit = tppdis_rcommit;
 		disw_commit = tppdis_wcommit;
+		dis_binary = NULL;
 	}
 }
 
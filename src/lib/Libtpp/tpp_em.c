@@ -928,7 +928,10 @@ int
 tpp_mbox_init(tpp_mbox_t *mbox)
 {
 	tpp_init_lock(&mbox->mbox_mutex);
-	TPP_QUE_CLEAR(&mbox->mbox_queue);
+	mbox->mbox_inbox = NULL;
+	mbox->mbox_head = NULL;
+	mbox->mbox_tail = NULL;
+	mbox->mbox_signalled = 0;
 
 #ifdef HAVE_SYS_EVENTFD_H
 	if ((mbox->mbox_eventfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) == -1) {
@@ -1053,6 +1056,89 @@ tpp_mbox_monitor(void *em_ctx, tpp_mbox_t *mbox)
 	return 0;
 }
 
+/**
+ * @brief
+ *	Move all cmds posted to the shared inbox of the mbox
+ *	to the reader private list, preserving the posting order.
+ *	The inbox is detached in a single atomic exchange, so the
+ *	producers are never blocked by the reader.
+ *
+ * @param[in] - mbox   - The mbox to collect from
+ *
+ * @return Number of cmds moved
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: No, caller must hold mbox_mutex
+ *
+ */
+static int
+mbox_collect(tpp_mbox_t *mbox)
+{
+	tpp_cmd_t *batch;
+	tpp_cmd_t *first = NULL;
+	tpp_cmd_t *last;
+	tpp_cmd_t *nxt;
+	int count = 0;
+
+	batch = tpp_atomic_xchg_ptr(&mbox->mbox_inbox, NULL);
+	if (batch == NULL)
+		return 0;
+
+	/* inbox is a LIFO, reverse it to get the posting order */
+	last = batch;
+	while (batch) {
+		nxt = batch->next;
+		batch->next = first;
+		first = batch;
+		batch = nxt;
+		count++;
+	}
+
+	if (mbox->mbox_tail)
+		mbox->mbox_tail->next = first;
+	else
+		mbox->mbox_head = first;
+	mbox->mbox_tail = last;
+
+	return count;
+}
+
+/**
+ * @brief
+ *	Consume the wakeup notification of the mbox, so that
+ *	the next post signals the reader again
+ *
+ * @param[in] - mbox   - The mbox to reset
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: No, caller must hold mbox_mutex
+ *
+ */
+static void
+mbox_reset_signal(tpp_mbox_t *mbox)
+{
+#ifdef HAVE_SYS_EVENTFD_H
+	uint64_t u;
+
+	read(mbox->mbox_eventfd, &u, sizeof(uint64_t));
+#else
+	char b;
+
+	while (tpp_pipe_read(mbox->mbox_pipe[0], &b, sizeof(char)) == sizeof(char));
+#endif
+	/*
+	 * clear the flag only after draining the fd; a post that
+	 * raced with us either sees the flag cleared and signals
+	 * again, or its cmd is found by the caller's re-check of
+	 * the inbox
+	 */
+	tpp_atomic_store_int(&mbox->mbox_signalled, 0);
+}
+
 /**
  * @brief
  *	Read a command from the msg box.
@@ -1075,11 +1161,6 @@ tpp_mbox_monitor(void *em_ctx, tpp_mbox_t *mbox)
 int
 tpp_mbox_read(tpp_mbox_t *mbox, unsigned int *tfd, int *cmdval, void **data)
 {
-#ifdef HAVE_SYS_EVENTFD_H
-	uint64_t u;
-#else
-	char b;
-#endif
 	tpp_cmd_t *cmd = NULL;
 
 	*cmdval = -1;
@@ -1087,16 +1168,17 @@ tpp_mbox_read(tpp_mbox_t *mbox, unsigned int *tfd, int *cmdval, void **data)
 
 	tpp_lock(&mbox->mbox_mutex);
 
-	/* read the data from the mbox cmd queue head */
-	cmd = (tpp_cmd_t *) tpp_deque(&mbox->mbox_queue);
+	/* refill the private list from the inbox in one batch */
+	if (mbox->mbox_head == NULL && mbox_collect(mbox) == 0) {
+		/* if no more data, clear all notifications and look once more */
+		mbox_reset_signal(mbox);
+		mbox_collect(mbox);
+	}
 
-	/* if no more data, clear all notifications */
-	if (cmd == NULL) {
-#ifdef HAVE_SYS_EVENTFD_H
-		read(mbox->mbox_eventfd, &u, sizeof(uint64_t));
-#else
-		while (tpp_pipe_read(mbox->mbox_pipe[0], &b, sizeof(char)) == sizeof(char));
-#endif
+	if ((cmd = mbox->mbox_head)) {
+		mbox->mbox_head = cmd->next;
+		if (mbox->mbox_head == NULL)
+			mbox->mbox_tail = NULL;
 	}
 
 	tpp_unlock(&mbox->mbox_mutex);
@@ -1130,15 +1212,15 @@ tpp_mbox_read(tpp_mbox_t *mbox, unsigned int *tfd, int *cmdval, void **data)
 void
 tpp_mbox_drain_unsafe(tpp_mbox_t *mbox)
 {
-	tpp_que_elem_t *n = NULL;
+	tpp_cmd_t *cmd;
 
-	while ((n = TPP_QUE_NEXT(&mbox->mbox_queue, n))) {
-		tpp_cmd_t *cmd;
-		if ((cmd = TPP_QUE_DATA(n)))
-			free(cmd->data);
+	mbox_collect(mbox);
+	while ((cmd = mbox->mbox_head)) {
+		mbox->mbox_head = cmd->next;
+		free(cmd->data);
 		free(cmd);
-		n = tpp_que_del_elem(&mbox->mbox_queue, n);
 	}
+	mbox->mbox_tail = NULL;
 }
 
 /**
@@ -1150,7 +1232,8 @@ tpp_mbox_drain_unsafe(tpp_mbox_t *mbox)
  *	that connection from this thread mbox
  *
  * @param[in] - mbox   - The mbox to read from
- * @param[in] - n      - The node/position to start searching from
+ * @param[in,out] - n  - The last retained cmd to continue searching after,
+ *			 NULL to start from the head of the mbox
  * @param[in] - tfd    - The Virtual file descriptor
  * @param[out] - cmdval - Return the cmdval
  * @param[out] - data - Any data associated
@@ -1162,7 +1245,7 @@ tpp_mbox_drain_unsafe(tpp_mbox_t *mbox)
  *
  */
 int
-tpp_mbox_clear(tpp_mbox_t *mbox, tpp_que_elem_t **n, unsigned int tfd, int *cmdval, void **data)
+tpp_mbox_clear(tpp_mbox_t *mbox, tpp_cmd_t **n, unsigned int tfd, int *cmdval, void **data)
 {
 	tpp_cmd_t *cmd;
 	int ret = -1;
@@ -1170,16 +1253,25 @@ tpp_mbox_clear(tpp_mbox_t *mbox, tpp_que_elem_t **n, unsigned int tfd, int *cmdv
 
 	tpp_lock(&mbox->mbox_mutex);
 
-	while ((*n = TPP_QUE_NEXT(&mbox->mbox_queue, *n))) {
-		cmd = TPP_QUE_DATA(*n);
-		if (cmd && cmd->tfd == tfd) {
-			*n = tpp_que_del_elem(&mbox->mbox_queue, *n);
+	/* pull in whatever was posted so far, so it is searched as well */
+	mbox_collect(mbox);
+
+	while ((cmd = ((*n == NULL) ? mbox->mbox_head : (*n)->next))) {
+		if (cmd->tfd == tfd) {
+			/* unlink cmd, *n stays as the predecessor */
+			if (*n == NULL)
+				mbox->mbox_head = cmd->next;
+			else
+				(*n)->next = cmd->next;
+			if (mbox->mbox_tail == cmd)
+				mbox->mbox_tail = *n;
 			*cmdval = cmd->cmdval;
 			*data = cmd->data;
 			free(cmd);
 			ret = 0;
 			break;
 		}
+		*n = cmd;
 	}
 
 	tpp_unlock(&mbox->mbox_mutex);
@@ -1191,6 +1283,10 @@ tpp_mbox_clear(tpp_mbox_t *mbox, tpp_que_elem_t **n, unsigned int tfd, int *cmdv
  * @brief
  *	Send a command to the threads msg queue
  *
+ *	The cmd is pushed to the mbox inbox without taking any lock,
+ *	and the reading thread is notified only if no notification is
+ *	already pending, so a burst of posts results in one wakeup.
+ *
  * @param[in] - mbox   - The mbox to post to
  * @param[in] - cmdval - The command or operation
  * @param[in] - tfd    - The Virtual file descriptor
@@ -1210,6 +1306,7 @@ int
 tpp_mbox_post(tpp_mbox_t *mbox, unsigned int tfd, int cmdval, void *data)
 {
 	tpp_cmd_t *cmd;
+	tpp_cmd_t *top;
 	ssize_t s;
 #ifdef HAVE_SYS_EVENTFD_H
 	uint64_t u;
@@ -1228,15 +1325,15 @@ tpp_mbox_post(tpp_mbox_t *mbox, unsigned int tfd, int cmdval, void *data)
 	cmd->tfd = tfd;
 	cmd->data = data;
 
-	/* add the cmd to the threads queue */
-	tpp_lock(&mbox->mbox_mutex);
-	if (tpp_enque(&mbox->mbox_queue, cmd) == NULL) {
-		tpp_unlock(&mbox->mbox_mutex);
-		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory in em_mbox_post");
-		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
-		return -1;
-	}
-	tpp_unlock(&mbox->mbox_mutex);
+	/* add the cmd to the threads inbox */
+	do {
+		top = mbox->mbox_inbox;
+		cmd->next = top;
+	} while (!tpp_atomic_cas_ptr(&mbox->mbox_inbox, top, cmd));
+
+	/* a wakeup is already pending, reader will pick this cmd up too */
+	if (tpp_atomic_xchg_int(&mbox->mbox_signalled, 1) != 0)
+		return 0;
 
 	while (1) {
 		/* send a notification to the thread */
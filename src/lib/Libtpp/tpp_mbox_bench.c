@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+
+/**
+ * @file	tpp_mbox_bench.c
+ *
+ * @brief	Micro benchmark for the TPP thread mbox
+ *
+ * @par		Functionality:
+ *
+ *		Starts 1..64 producer threads that post commands to a single
+ *		mbox, while the main thread waits on the mbox fd and drains it
+ *		the way the TPP worker threads do. For each producer count it
+ *		reports the post/drain throughput and the number of wakeups the
+ *		reader needed, and verifies that every producer's commands were
+ *		read in posting order.
+ *
+ *		Not installed, build with "make tpp_mbox_bench".
+ *
+ * Usage: tpp_mbox_bench [-n posts_per_producer] [-p max_producers]
+ */
+
+#include <pbs_config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <errno.h>
+#include <sys/time.h>
+
+#include "rpp.h"
+#include "tpp_common.h"
+#include "tpp_platform.h"
+
+#define MAX_PRODUCERS 64
+
+static tpp_mbox_t bench_mbox;
+static int posts_per_producer = 200000;
+static volatile int go = 0;
+
+/**
+ * @brief
+ *	Log function handed to the tpp layer, prints to stderr
+ */
+static void
+bench_log(int level, const char *id, char *mess)
+{
+	fprintf(stderr, "%s: %s\n", id ? id : "", mess);
+}
+
+/**
+ * @brief
+ *	Producer thread, posts posts_per_producer commands, tfd is
+ *	the producer index and cmdval the sequence number
+ *
+ * @param[in] arg - producer index
+ */
+static void *
+producer(void *arg)
+{
+	unsigned int id = (unsigned int)(long) arg;
+	int i;
+
+	while (!go)
+		;
+	for (i = 0; i < posts_per_producer; i++) {
+		if (tpp_mbox_post(&bench_mbox, id, i, NULL) != 0) {
+			fprintf(stderr, "post failed, errno=%d\n", errno);
+			exit(1);
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Run one round with nprod producers and print the results
+ *
+ * @param[in] nprod - number of producer threads
+ *
+ * @return	int
+ * @retval	0 - all commands read in order
+ * @retval	1 - lost or out of order commands
+ */
+static int
+run_round(int nprod)
+{
+	pthread_t thrds[MAX_PRODUCERS];
+	int next_seq[MAX_PRODUCERS];
+	long total = (long) nprod * posts_per_producer;
+	long got = 0;
+	long wakeups = 0;
+	struct pollfd pfd;
+	struct timeval t1, t2;
+	double secs;
+	unsigned int tfd;
+	int cmd;
+	void *data;
+	int i;
+	int bad = 0;
+
+	if (tpp_mbox_init(&bench_mbox) != 0)
+		return 1;
+
+	memset(next_seq, 0, sizeof(next_seq));
+	go = 0;
+	for (i = 0; i < nprod; i++)
+		pthread_create(&thrds[i], NULL, producer, (void *)(long) i);
+
+	pfd.fd = tpp_mbox_getfd(&bench_mbox);
+	pfd.events = POLLIN;
+
+	gettimeofday(&t1, NULL);
+	go = 1;
+	while (got < total) {
+		if (poll(&pfd, 1, 1000) <= 0)
+			continue;
+		wakeups++;
+		while (tpp_mbox_read(&bench_mbox, &tfd, &cmd, &data) == 0) {
+			if (tfd >= (unsigned int) nprod || cmd != next_seq[tfd]) {
+				bad = 1;
+			} else
+				next_seq[tfd]++;
+			got++;
+		}
+	}
+	gettimeofday(&t2, NULL);
+
+	for (i = 0; i < nprod; i++)
+		pthread_join(thrds[i], NULL);
+	tpp_mbox_destroy(&bench_mbox, 1);
+
+	secs = (t2.tv_sec - t1.tv_sec) + (t2.tv_usec - t1.tv_usec) / 1000000.0;
+	printf("%9d %12ld %10.3f %14.0f %10ld %12.1f %s\n",
+		nprod, total, secs, total / secs, wakeups,
+		(double) total / (wakeups ? wakeups : 1),
+		bad ? "ORDER ERROR" : "ok");
+	return bad;
+}
+
+/**
+ * @brief
+ *	main - entry point of tpp_mbox_bench
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	1 - failure
+ */
+int
+main(int argc, char *argv[])
+{
+	int c;
+	int max_prod = MAX_PRODUCERS;
+	int nprod;
+	int rc = 0;
+
+	while ((c = getopt(argc, argv, "n:p:")) != -1) {
+		switch (c) {
+			case 'n':
+				posts_per_producer = atoi(optarg);
+				break;
+			case 'p':
+				max_prod = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n posts_per_producer] [-p max_producers]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (posts_per_producer <= 0 || max_prod <= 0 || max_prod > MAX_PRODUCERS) {
+		fprintf(stderr, "invalid arguments\n");
+		return 1;
+	}
+
+	tpp_log_func = bench_log;
+	if (tpp_init_tls_key() != 0)
+		return 1;
+
+	printf("%9s %12s %10s %14s %10s %12s\n", "producers", "commands",
+		"seconds", "commands/sec", "wakeups", "cmds/wakeup");
+	for (nprod = 1; nprod <= max_prod; nprod *= 2)
+		rc |= run_round(nprod);
+
+	return rc;
+}
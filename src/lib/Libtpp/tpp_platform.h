@@ -71,6 +71,12 @@ extern "C" {
 #define tpp_sock_getsockopt(a, b, c, d, e)   getsockopt(a, b, c, d, e)
 #define tpp_sock_setsockopt(a, b, c, d, e)   setsockopt(a, b, c, d, e)
 
+/* atomic primitives, all act as full memory barriers */
+#define tpp_atomic_cas_ptr(p, o, n)    __sync_bool_compare_and_swap(p, o, n)
+#define tpp_atomic_xchg_ptr(p, v)      __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST)
+#define tpp_atomic_xchg_int(p, v)      __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST)
+#define tpp_atomic_store_int(p, v)     __atomic_store_n(p, v, __ATOMIC_SEQ_CST)
+
 #else
 
 #define EINPROGRESS   EAGAIN
@@ -92,6 +98,11 @@ int tpp_sock_close(int s);
 int tpp_sock_getsockopt(int s, int level, int optname, int *optval, int *optlen);
 int tpp_sock_setsockopt(int s, int level, int optname, const int *optval, int optlen);
 
+#define tpp_atomic_cas_ptr(p, o, n)    (InterlockedCompareExchangePointer((PVOID volatile *)(p), n, o) == (o))
+#define tpp_atomic_xchg_ptr(p, v)      InterlockedExchangePointer((PVOID volatile *)(p), v)
+#define tpp_atomic_xchg_int(p, v)      InterlockedExchange((LONG volatile *)(p), v)
+#define tpp_atomic_store_int(p, v)     InterlockedExchange((LONG volatile *)(p), v)
+
 #endif
 
 int tpp_sock_layer_init();
@@ -1834,7 +1834,7 @@ handle_disconnect(phy_conn_t *conn)
 	int cmd;
 	void *data;
 	pbs_socklen_t len = sizeof(error);
-	tpp_que_elem_t *n;
+	tpp_cmd_t *n;
 
 	if (conn == NULL || conn->net_state == TPP_CONN_DISCONNECTED)
 		return;
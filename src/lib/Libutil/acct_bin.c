@@ -0,0 +1,658 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+/**
+ * @file	acct_bin.c
+ * @brief
+ * acct_bin.c - write and read the binary accounting log, see acct_bin.h
+ *	for the file format.
+ *
+ * @par Functions included are:
+ *	acct_bin_open()
+ *	acct_bin_close()
+ *	acct_bin_write()
+ *	acct_bin_read()
+ *	acct_bin_keyid()
+ *	acct_bin_value()
+ *	acct_bin_text()
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include "portability.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "acct_bin.h"
+
+/* a record larger than this is taken as a corrupt length */
+#define ACCT_BIN_MAX_RCD	(64 * 1024 * 1024)
+
+/**
+ * @brief
+ *	Make sure the record buffer can hold need bytes.
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	out of memory
+ */
+static int
+abf_reserve(struct acct_bin_file *abf, size_t need)
+{
+	char   *tmp;
+	size_t  size;
+
+	if (need <= abf->abf_bufsize)
+		return 0;
+	size = (abf->abf_bufsize > 0) ? abf->abf_bufsize : 1024;
+	while (size < need)
+		size *= 2;
+	if ((tmp = realloc(abf->abf_buf, size)) == NULL)
+		return -1;
+	abf->abf_buf = tmp;
+	abf->abf_bufsize = size;
+	return 0;
+}
+
+static int
+put_u8(struct acct_bin_file *abf, size_t *used, unsigned int v)
+{
+	if (abf_reserve(abf, *used + 1) != 0)
+		return -1;
+	abf->abf_buf[(*used)++] = (char)(v & 0xff);
+	return 0;
+}
+
+static int
+put_u32(struct acct_bin_file *abf, size_t *used, unsigned long v)
+{
+	unsigned char *b;
+
+	if (abf_reserve(abf, *used + 4) != 0)
+		return -1;
+	b = (unsigned char *)abf->abf_buf + *used;
+	b[0] = (v >> 24) & 0xff;
+	b[1] = (v >> 16) & 0xff;
+	b[2] = (v >> 8) & 0xff;
+	b[3] = v & 0xff;
+	*used += 4;
+	return 0;
+}
+
+static int
+put_str(struct acct_bin_file *abf, size_t *used, const char *s, size_t len)
+{
+	if (put_u32(abf, used, len) != 0)
+		return -1;
+	if (abf_reserve(abf, *used + len + 1) != 0)
+		return -1;
+	memcpy(abf->abf_buf + *used, s, len);
+	abf->abf_buf[*used + len] = '\0';
+	*used += len + 1;
+	return 0;
+}
+
+static unsigned long
+get_u32(const unsigned char *b)
+{
+	return (((unsigned long)b[0] << 24) | ((unsigned long)b[1] << 16) |
+		((unsigned long)b[2] << 8) | (unsigned long)b[3]);
+}
+
+/**
+ * @brief
+ *	Take a string off a record being parsed.
+ *
+ * @param[in,out] pp - parse position, advanced past the string
+ * @param[in]	end - end of the record
+ *
+ * @return	char *
+ * @retval	the NUL terminated string, inside the record buffer
+ * @retval	NULL	the record is malformed
+ */
+static char *
+get_str(unsigned char **pp, unsigned char *end)
+{
+	unsigned long len;
+	char *s;
+
+	if (end - *pp < 4)
+		return NULL;
+	len = get_u32(*pp);
+	if ((unsigned long)(end - *pp - 4) < len + 1)
+		return NULL;
+	s = (char *)*pp + 4;
+	if (s[len] != '\0')
+		return NULL;
+	*pp += 4 + len + 1;
+	return s;
+}
+
+/**
+ * @brief
+ *	Find a key, given by pointer and length, in the file's dictionary.
+ *
+ * @return	int
+ * @retval	key id
+ * @retval	-1	not in the dictionary
+ */
+static int
+find_key(struct acct_bin_file *abf, const char *key, size_t len)
+{
+	int i;
+
+	for (i = 0; i < abf->abf_nkeys; i++) {
+		if ((strncmp(abf->abf_keys[i], key, len) == 0) &&
+			(abf->abf_keys[i][len] == '\0'))
+			return i;
+	}
+	return -1;
+}
+
+/**
+ * @brief
+ *	Add a key to the file's dictionary.
+ *
+ * @return	int
+ * @retval	the new key id
+ * @retval	-1	out of memory
+ */
+static int
+add_key(struct acct_bin_file *abf, const char *key, size_t len)
+{
+	char **tmp;
+	char  *name;
+
+	if (abf->abf_nkeys == abf->abf_keyslots) {
+		tmp = realloc(abf->abf_keys, (abf->abf_keyslots + 64) * sizeof(char *));
+		if (tmp == NULL)
+			return -1;
+		abf->abf_keys = tmp;
+		abf->abf_keyslots += 64;
+	}
+	if ((name = malloc(len + 1)) == NULL)
+		return -1;
+	memcpy(name, key, len);
+	name[len] = '\0';
+	abf->abf_keys[abf->abf_nkeys] = name;
+	return (abf->abf_nkeys++);
+}
+
+/**
+ * @brief
+ *	Split the next "key=value" token off an accounting record text.
+ *	A value may be quoted, see cpy_quote_value() in the server, and
+ *	the quotes are kept as part of the value.
+ *
+ * @param[in]	p - where to start
+ * @param[out]	key - start of the key, NULL if the token has no '='
+ * @param[out]	klen - length of the key
+ * @param[out]	val - start of the value, or of the whole token
+ * @param[out]	vlen - length of the value
+ *
+ * @return	char *
+ * @retval	where to continue
+ * @retval	NULL	no more tokens
+ */
+static char *
+next_token(char *p, char **key, size_t *klen, char **val, size_t *vlen)
+{
+	char *start;
+	char *eq = NULL;
+	char  quote = '\0';
+
+	while (*p == ' ')
+		p++;
+	if (*p == '\0')
+		return NULL;
+
+	for (start = p; *p != '\0'; p++) {
+		if (quote != '\0') {
+			if (*p == quote)
+				quote = '\0';
+			continue;
+		}
+		if (*p == ' ')
+			break;
+		if ((*p == '=') && (eq == NULL)) {
+			eq = p;
+			if ((p[1] == '"') || (p[1] == '\'')) {
+				quote = p[1];
+				p++;
+			}
+		}
+	}
+
+	if (eq != NULL) {
+		*key = start;
+		*klen = eq - start;
+		*val = eq + 1;
+		*vlen = p - eq - 1;
+	} else {
+		*key = NULL;
+		*klen = 0;
+		*val = start;
+		*vlen = p - start;
+	}
+	return p;
+}
+
+/**
+ * @brief
+ *	Open a binary accounting file.
+ *
+ * @par
+ *	For writing, the file is created if need be and opened for append.
+ *	The key dictionary of an existing file is read back so that new
+ *	records continue to use it, and a record left incomplete by a crash
+ *	is cut off.  For reading, the file must already exist.
+ *
+ * @param[in]	path - file name
+ * @param[in]	forwrite - non-zero to open for append
+ *
+ * @return	struct acct_bin_file *
+ * @retval	open file handle
+ * @retval	NULL	error, errno is set
+ */
+struct acct_bin_file *
+acct_bin_open(char *path, int forwrite)
+{
+	struct acct_bin_file *abf;
+	char   magic[ACCT_BIN_MAGIC_LEN];
+	size_t n;
+	int    rc;
+
+	if ((abf = calloc(1, sizeof(struct acct_bin_file))) == NULL)
+		return NULL;
+
+	abf->abf_fp = fopen(path, forwrite ? "a+b" : "rb");
+	if (abf->abf_fp == NULL)
+		goto err;
+	rewind(abf->abf_fp);
+
+	n = fread(magic, 1, ACCT_BIN_MAGIC_LEN, abf->abf_fp);
+	if ((n == 0) && forwrite) {
+		/* new file */
+		if ((fseek(abf->abf_fp, 0L, SEEK_END) != 0) ||
+			(fwrite(ACCT_BIN_MAGIC, 1, ACCT_BIN_MAGIC_LEN, abf->abf_fp) != ACCT_BIN_MAGIC_LEN) ||
+			(fflush(abf->abf_fp) != 0))
+			goto err;
+		abf->abf_end = ACCT_BIN_MAGIC_LEN;
+		return abf;
+	}
+	if ((n != ACCT_BIN_MAGIC_LEN) || (memcmp(magic, ACCT_BIN_MAGIC, ACCT_BIN_MAGIC_LEN) != 0)) {
+		errno = EINVAL;
+		goto err;
+	}
+	abf->abf_end = ACCT_BIN_MAGIC_LEN;
+	if (!forwrite)
+		return abf;
+
+	/* pick up the dictionary, drop a partly written last record */
+	while ((rc = acct_bin_read(abf)) == 1)
+		;
+	if (rc == -1) {
+		(void)fflush(abf->abf_fp);
+#ifdef WIN32
+		if (_chsize(_fileno(abf->abf_fp), abf->abf_end) != 0)
+#else
+		if (ftruncate(fileno(abf->abf_fp), (off_t)abf->abf_end) != 0)
+#endif
+			goto err;
+	}
+	if (fseek(abf->abf_fp, 0L, SEEK_END) != 0)
+		goto err;
+	return abf;
+
+err:
+	rc = errno;
+	acct_bin_close(abf);
+	errno = rc;
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Close a binary accounting file and free its handle.
+ *
+ * @param[in]	abf - file handle, may be NULL
+ */
+void
+acct_bin_close(struct acct_bin_file *abf)
+{
+	int i;
+
+	if (abf == NULL)
+		return;
+	if (abf->abf_fp != NULL)
+		(void)fclose(abf->abf_fp);
+	for (i = 0; i < abf->abf_nkeys; i++)
+		free(abf->abf_keys[i]);
+	free(abf->abf_keys);
+	free(abf->abf_buf);
+	free(abf->abf_kid);
+	free(abf->abf_val);
+	free(abf);
+}
+
+/**
+ * @brief
+ *	Append an accounting record to a binary accounting file.
+ *
+ * @par
+ *	The record text is split into its key=value fields.  Keys not yet
+ *	in the file's dictionary are defined just ahead of the record, and
+ *	the whole lot is written with one fwrite so that a reader never
+ *	sees a record without its keys.  On failure the file is cut back
+ *	to the end of the last record and the new keys are dropped.
+ *
+ * @param[in]	abf - file opened by acct_bin_open() for writing
+ * @param[in]	when - time of the record
+ * @param[in]	acctype - record type, PBS_ACCT_*
+ * @param[in]	id - job or reservation id
+ * @param[in]	text - record text, may be NULL
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	error
+ */
+int
+acct_bin_write(struct acct_bin_file *abf, time_t when, int acctype, char *id, char *text)
+{
+	unsigned long long t = (unsigned long long)when;
+	size_t	used = 0;
+	size_t	start;
+	size_t	klen;
+	size_t	vlen;
+	char   *key;
+	char   *val;
+	char   *p;
+	int	kid;
+	int	nkv = 0;
+	int	nkeys = abf->abf_nkeys;
+
+	if (text == NULL)
+		text = "";
+	if (id == NULL)
+		id = "";
+
+	/* dictionary entries for keys this file has not seen yet */
+	for (p = text; (p = next_token(p, &key, &klen, &val, &vlen)) != NULL; nkv++) {
+		if ((key == NULL) || (find_key(abf, key, klen) != -1))
+			continue;
+		if ((kid = add_key(abf, key, klen)) == -1)
+			goto err;
+		start = used;
+		if ((put_u32(abf, &used, 0) != 0) ||
+			(put_u8(abf, &used, ACCT_BIN_KEYDEF) != 0) ||
+			(put_u32(abf, &used, kid) != 0) ||
+			(put_str(abf, &used, key, klen) != 0))
+			goto err;
+		(void)put_u32(abf, &start, used - start - 4);
+	}
+
+	start = used;
+	if ((put_u32(abf, &used, 0) != 0) ||
+		(put_u8(abf, &used, ACCT_BIN_DATA) != 0) ||
+		(put_u32(abf, &used, (unsigned long)(t >> 32)) != 0) ||
+		(put_u32(abf, &used, (unsigned long)(t & 0xffffffffUL)) != 0) ||
+		(put_u8(abf, &used, acctype) != 0) ||
+		(put_str(abf, &used, id, strlen(id)) != 0) ||
+		(put_u32(abf, &used, nkv) != 0))
+		goto err;
+	for (p = text; (p = next_token(p, &key, &klen, &val, &vlen)) != NULL; ) {
+		kid = (key == NULL) ? -1 : find_key(abf, key, klen);
+		if ((put_u32(abf, &used, (kid == -1) ? ACCT_BIN_NOKEY : (unsigned long)kid) != 0) ||
+			(put_str(abf, &used, val, vlen) != 0))
+			goto err;
+	}
+	(void)put_u32(abf, &start, used - start - 4);	/* record length */
+
+	if ((fwrite(abf->abf_buf, 1, used, abf->abf_fp) != used) ||
+		(fflush(abf->abf_fp) != 0)) {
+		/* cut off what was written of the record */
+		(void)fflush(abf->abf_fp);
+		clearerr(abf->abf_fp);
+#ifdef WIN32
+		(void)_chsize(_fileno(abf->abf_fp), abf->abf_end);
+#else
+		(void)ftruncate(fileno(abf->abf_fp), (off_t)abf->abf_end);
+#endif
+		(void)fseek(abf->abf_fp, 0L, SEEK_END);
+		goto err;
+	}
+	abf->abf_end += used;
+	return 0;
+
+err:
+	/* forget the keys whose definitions did not reach the file */
+	while (abf->abf_nkeys > nkeys)
+		free(abf->abf_keys[--abf->abf_nkeys]);
+	return -1;
+}
+
+/**
+ * @brief
+ *	Read the next data record of a binary accounting file into the
+ *	abf_time, abf_type, abf_id, abf_nkv, abf_kid and abf_val members.
+ *	Dictionary records are taken in along the way.  The strings stay
+ *	valid until the next call.
+ *
+ * @param[in]	abf - open file
+ *
+ * @return	int
+ * @retval	1	a record was read
+ * @retval	0	end of file
+ * @retval	-1	truncated or corrupt file, or out of memory
+ */
+int
+acct_bin_read(struct acct_bin_file *abf)
+{
+	unsigned char	hdr[4];
+	unsigned char  *p;
+	unsigned char  *end;
+	unsigned long	len;
+	unsigned long	kid;
+	unsigned long long t;
+	unsigned int   *tkid;
+	char	      **tval;
+	char	       *s;
+	size_t		n;
+	int		nkv;
+	int		i;
+
+	for (;;) {
+		n = fread(hdr, 1, 4, abf->abf_fp);
+		if (n == 0)
+			return 0;
+		if (n != 4)
+			return -1;
+		len = get_u32(hdr);
+		if ((len == 0) || (len > ACCT_BIN_MAX_RCD))
+			return -1;
+		if (abf_reserve(abf, len) != 0)
+			return -1;
+		if (fread(abf->abf_buf, 1, len, abf->abf_fp) != len)
+			return -1;
+		p = (unsigned char *)abf->abf_buf;
+		end = p + len;
+
+		switch (*p++) {
+			case ACCT_BIN_KEYDEF:
+				if (end - p < 4)
+					return -1;
+				kid = get_u32(p);
+				p += 4;
+				if ((kid != (unsigned long)abf->abf_nkeys) ||
+					((s = get_str(&p, end)) == NULL) ||
+					(add_key(abf, s, strlen(s)) == -1))
+					return -1;
+				abf->abf_end += 4 + len;
+				break;
+
+			case ACCT_BIN_DATA:
+				if (end - p < 9)
+					return -1;
+				t = ((unsigned long long)get_u32(p) << 32) | get_u32(p + 4);
+				abf->abf_time = (time_t)t;
+				abf->abf_type = p[8];
+				p += 9;
+				if ((abf->abf_id = get_str(&p, end)) == NULL)
+					return -1;
+				if (end - p < 4)
+					return -1;
+				nkv = (int)get_u32(p);
+				p += 4;
+				if ((nkv < 0) || ((unsigned long)nkv > len / 9))
+					return -1;
+				if (nkv > abf->abf_kvslots) {
+					tkid = realloc(abf->abf_kid, nkv * sizeof(unsigned int));
+					if (tkid == NULL)
+						return -1;
+					abf->abf_kid = tkid;
+					tval = realloc(abf->abf_val, nkv * sizeof(char *));
+					if (tval == NULL)
+						return -1;
+					abf->abf_val = tval;
+					abf->abf_kvslots = nkv;
+				}
+				for (i = 0; i < nkv; i++) {
+					if (end - p < 4)
+						return -1;
+					abf->abf_kid[i] = (unsigned int)get_u32(p);
+					p += 4;
+					if ((abf->abf_val[i] = get_str(&p, end)) == NULL)
+						return -1;
+				}
+				abf->abf_nkv = nkv;
+				abf->abf_end += 4 + len;
+				return 1;
+
+			default:
+				/* a record kind from a later version, skip it */
+				abf->abf_end += 4 + len;
+				break;
+		}
+	}
+}
+
+/**
+ * @brief
+ *	Look up the key id of a field name in the dictionary read so far.
+ *	The dictionary only grows, so a caller can keep the id.
+ *
+ * @return	int
+ * @retval	key id
+ * @retval	-1	key not seen in this file (yet)
+ */
+int
+acct_bin_keyid(struct acct_bin_file *abf, char *key)
+{
+	return (find_key(abf, key, strlen(key)));
+}
+
+/**
+ * @brief
+ *	Return the value of field keyid in the last record read.
+ *
+ * @return	char *
+ * @retval	value
+ * @retval	NULL	the record has no such field
+ */
+char *
+acct_bin_value(struct acct_bin_file *abf, int keyid)
+{
+	int i;
+
+	if (keyid < 0)
+		return NULL;
+	for (i = 0; i < abf->abf_nkv; i++) {
+		if (abf->abf_kid[i] == (unsigned int)keyid)
+			return (abf->abf_val[i]);
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Format the last record read the way the text accounting log has it,
+ *	without the trailing newline.
+ *
+ * @param[in]	abf - open file
+ * @param[out]	buf - output buffer
+ * @param[in]	len - size of buf
+ *
+ * @return	int
+ * @retval	length of the line
+ * @retval	-1	buf is too small
+ */
+int
+acct_bin_text(struct acct_bin_file *abf, char *buf, size_t len)
+{
+	struct tm *ptm;
+	size_t	used;
+	int	n;
+	int	i;
+	char   *key;
+
+	if ((ptm = localtime(&abf->abf_time)) == NULL)
+		return -1;
+	n = snprintf(buf, len, "%02d/%02d/%04d %02d:%02d:%02d;%c;%s;",
+		ptm->tm_mon + 1, ptm->tm_mday, ptm->tm_year + 1900,
+		ptm->tm_hour, ptm->tm_min, ptm->tm_sec,
+		(char)abf->abf_type, abf->abf_id);
+	if ((n < 0) || ((size_t)n >= len))
+		return -1;
+	used = n;
+	for (i = 0; i < abf->abf_nkv; i++) {
+		if (abf->abf_kid[i] < (unsigned int)abf->abf_nkeys)
+			key = abf->abf_keys[abf->abf_kid[i]];
+		else
+			key = NULL;
+		n = snprintf(buf + used, len - used, "%s%s%s%s",
+			(i > 0) ? " " : "",
+			key ? key : "", key ? "=" : "",
+			abf->abf_val[i]);
+		if ((n < 0) || ((size_t)n >= len - used))
+			return -1;
+		used += n;
+	}
+	return ((int)used);
+}
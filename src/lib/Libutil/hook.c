@@ -482,6 +482,94 @@ hook_fail_action_as_string(unsigned int fail_action)
 	return (fail_actionstr);
 }
 
+/**
+ * @brief
+ *	Records one completed run of hook 'phook' in its execution profile.
+ *
+ * @param[in]	phook - hook that ran.
+ * @param[in]	wall - wall clock seconds spent in each HOOK_STAT_* phase.
+ * @param[in]	cpu - cpu seconds spent in each HOOK_STAT_* phase.
+ *
+ * @return void
+ */
+void
+hook_stats_add(hook *phook, double *wall, double *cpu)
+{
+	static double	bounds[] = HOOK_STAT_BUCKET_BOUNDS;
+	struct hook_stats *hs;
+	double		total = 0;
+	int		i;
+
+	if (phook == NULL)
+		return;
+	hs = &phook->run_stats;
+
+	for (i = 0; i < HOOK_STAT_NPHASES; i++) {
+		hs->hs_wall[i] += wall[i];
+		hs->hs_cpu[i] += cpu[i];
+		total += wall[i];
+	}
+	if (total > hs->hs_max)
+		hs->hs_max = total;
+
+	for (i = 0; i < HOOK_STAT_NBUCKETS - 1; i++) {
+		if ((total * 1000) < bounds[i])
+			break;
+	}
+	hs->hs_hist[i]++;
+	hs->hs_runs++;
+}
+
+/**
+ * @brief
+ *	Returns the string representation of the execution profile of
+ *	'phook', of the form:
+ *	  runs=<n>,max_ms=<ms>,wall_ms=<setup>/<run>/<result>,
+ *	  cpu_ms=<setup>/<run>/<result>,hist=<bound>:<n>/.../inf:<n>
+ *	where the times are totals over all runs and each histogram entry
+ *	counts the runs that took less than <bound> milliseconds.
+ *
+ * @param[in]	phook - hook whose profile is returned.
+ *
+ * @return char *
+ *
+ * @note
+ *	This returns a static string that will get overwritten on the
+ *	next call to this function.
+ */
+char *
+hook_stats_as_string(hook *phook)
+{
+	static char	stats_str[HOOK_BUF_SIZE];
+	static int	bounds[] = HOOK_STAT_BUCKET_BOUNDS;
+	struct hook_stats *hs = &phook->run_stats;
+	size_t		len;
+	int		i;
+
+	snprintf(stats_str, sizeof(stats_str),
+		"runs=%lu,max_ms=%.1f,wall_ms=%.1f/%.1f/%.1f,"
+		"cpu_ms=%.1f/%.1f/%.1f,hist=",
+		hs->hs_runs, hs->hs_max * 1000,
+		hs->hs_wall[HOOK_STAT_SETUP] * 1000,
+		hs->hs_wall[HOOK_STAT_RUN] * 1000,
+		hs->hs_wall[HOOK_STAT_RESULT] * 1000,
+		hs->hs_cpu[HOOK_STAT_SETUP] * 1000,
+		hs->hs_cpu[HOOK_STAT_RUN] * 1000,
+		hs->hs_cpu[HOOK_STAT_RESULT] * 1000);
+
+	for (i = 0; i < HOOK_STAT_NBUCKETS; i++) {
+		len = strlen(stats_str);
+		if (i < HOOK_STAT_NBUCKETS - 1)
+			snprintf(stats_str + len, sizeof(stats_str) - len,
+				"%s%d:%lu", (i > 0) ? "/" : "", bounds[i],
+				hs->hs_hist[i]);
+		else
+			snprintf(stats_str + len, sizeof(stats_str) - len,
+				"/inf:%lu", hs->hs_hist[i]);
+	}
+	return (stats_str);
+}
+
 /*
  *	Returns the string representation of hook 'order' value.
  */
@@ -2565,6 +2653,11 @@ hook_purge(hook	*phook, void (*pyfree_func)(struct python_script *))
 			}
 		}
 
+		/* the bytecode cache is only an optimization */
+		snprintf(namebuf, MAXPATHLEN, "%s%s%s", path_hooks,
+			phook->hook_name, PY_BYTECODE_SUFFIX);
+		(void)unlink(namebuf);
+
 		snprintf(namebuf, MAXPATHLEN, "%s%s%s", path_hooks,
 			phook->hook_name, HOOK_FILE_SUFFIX);
 
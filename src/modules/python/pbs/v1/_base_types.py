@@ -100,6 +100,18 @@ _size = _pbs_v1.svr_types._size
 _LOG  = _pbs_v1.logmsg
 _IS_SETTABLE = _pbs_v1.is_attrib_val_settable
 
+#: Objects built by the server may carry their attribute values only in the
+#: C structures until first accessed; _LOAD_FROM in the instance dictionary
+#: marks such an object. The names below are set when the object is created
+#: and never trigger a load.
+_LOAD_FROM = '_load_from'
+_SET_AT_CREATION = ('id', 'name', '_connect_server')
+
+def _load_deferred(desc, obj):
+    """load obj's deferred attribute values before desc touches them"""
+    if (_LOAD_FROM in obj.__dict__) and (desc._name not in _SET_AT_CREATION):
+        _pbs_v1.load_object_value(obj)
+
 class PbsAttributeDescriptor(object):
     """This class wraps evey PBS attribute into a *DATA* descriptor AND is
     maintained per instance instead of the default per class.
@@ -166,6 +178,8 @@ class PbsAttributeDescriptor(object):
         #  caused pbs_resource to be instantiated every time. Probably due to
         #  _get_default_value() getting evaluatd every time.
 
+        _load_deferred(self, obj)
+
         if obj not in self.__per_instance:
              v = self._get_default_value()
              self.__per_instance[obj] = v
@@ -177,6 +191,8 @@ class PbsAttributeDescriptor(object):
         """__set___
         """
 
+        _load_deferred(self, obj)
+
         if not _IS_SETTABLE(self, obj, value):
             return
 
@@ -220,6 +236,7 @@ class PbsAttributeDescriptor(object):
     def __delete__(self, obj):
         """__delete__, we just set the attribute value to None"""
        
+        _load_deferred(self, obj)
         self.__per_instance[obj] = None
     #: m(__delete__)
 
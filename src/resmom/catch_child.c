@@ -97,6 +97,7 @@ extern pbs_list_head	svr_alljobs;
 extern int		exiting_tasks;
 extern char		*msg_daemonname;
 extern int		svr_hook_resend_job_attrs;
+extern int		svr_rused_gen;
 #ifdef	WIN32
 extern char		*mom_home;
 #endif
@@ -1128,11 +1129,80 @@ update_ajob_status(job *pjob)
 	update_ajob_status_using_cmd(pjob, IS_RESCUSED, 0);
 }
 
+/**
+ * @brief
+ *	Remove from an encoded update the resources_used values that were
+ *	already sent to the server, and remember the ones that remain.
+ *
+ * @par
+ *	The values last sent are kept in pjob->ji_rused_sent.  They are
+ *	forgotten, so everything is sent again, whenever svr_rused_gen
+ *	changes, i.e. the server (re)connected or an update may have been
+ *	lost.
+ *
+ * @param[in]	  pjob - job being updated
+ * @param[in,out] phead - attribute list of the update
+ *
+ * @return	int
+ * @retval	number of resources_used values left in the update
+ *
+ */
+static int
+rused_delta(job *pjob, pbs_list_head *phead)
+{
+	svrattrl	*pal;
+	svrattrl	*pnext;
+	svrattrl	*psent;
+	int		 nleft = 0;
+
+	if (pjob->ji_rused_gen != svr_rused_gen) {
+		free_attrlist(&pjob->ji_rused_sent);
+		pjob->ji_rused_gen = svr_rused_gen;
+	}
+
+	for (pal = (svrattrl *)GET_NEXT(*phead); pal != NULL; pal = pnext) {
+		pnext = (svrattrl *)GET_NEXT(pal->al_link);
+		if ((strcmp(pal->al_name, ATTR_used) != 0) ||
+			(pal->al_resc == NULL) || (pal->al_value == NULL))
+			continue;
+
+		for (psent = (svrattrl *)GET_NEXT(pjob->ji_rused_sent);
+			psent != NULL;
+			psent = (svrattrl *)GET_NEXT(psent->al_link)) {
+			if (strcmp(psent->al_resc, pal->al_resc) == 0)
+				break;
+		}
+		if (psent != NULL) {
+			if ((strcmp(psent->al_value, pal->al_value) == 0) &&
+				(pal->al_sister == NULL)) {
+				/* unchanged, the server has it */
+				delete_link(&pal->al_link);
+				free(pal);
+				continue;
+			}
+			delete_link(&psent->al_link);
+			free(psent);
+		}
+
+		psent = attrlist_create(pal->al_name, pal->al_resc,
+			strlen(pal->al_value) + 1);
+		if (psent != NULL) {
+			strcpy(psent->al_value, pal->al_value);
+			append_link(&pjob->ji_rused_sent, &psent->al_link, psent);
+		}
+		nleft++;
+	}
+	return (nleft);
+}
+
 /**
  * @brief
  * 	update_jobs_status - return the status of jobs to the server
  *
- *	Returns the updated resources_used for all running jobs.
+ *	Returns the updated resources_used for all running jobs in one
+ *	message.  Only the resources_used values which changed since the
+ *	last update are sent, see rused_delta(), and jobs with nothing
+ *	changed are left out.
  *	The special listed attrbutes are not returned because they are only
  *	modified when a job is first started and that case is covered by
  *	update_ajob_status() above.
@@ -1145,6 +1215,7 @@ void
 update_jobs_status(void)
 {
 	int			count = 0;
+	int			nsend;
 	job			*pjob;
 	struct resc_used_update	*prused;
 	struct resc_used_update	*prusedtop = NULL;
@@ -1163,7 +1234,6 @@ update_jobs_status(void)
 		if (pjob->ji_qs.ji_substate != JOB_SUBSTATE_RUNNING)
 			continue;
 
-		++count;
 		/* allocate reply structure and fill in header portion */
 		prused = (struct resc_used_update *)
 			malloc(sizeof(struct resc_used_update));
@@ -1177,9 +1247,7 @@ update_jobs_status(void)
 			prused->ru_hop    = pjob->ji_wattr[(int)JOB_ATR_runcount].at_val.at_long;
 		}
 		CLEAR_HEAD(prused->ru_attr);
-		*prusednext	  = prused;	/* make last on list */
 		prused->ru_next   = NULL;	/* terminate list */
-		prusednext	  = &prused->ru_next;	/* track last link */
 
 		/* now append the session id and resources used */
 		(void)job_attr_def[(int)JOB_ATR_session_id].at_encode(
@@ -1188,6 +1256,7 @@ update_jobs_status(void)
 			job_attr_def[(int)JOB_ATR_session_id].at_name,
 			NULL, ATR_ENCODE_CLIENT, NULL);
 		encode_used(pjob, &prused->ru_attr);
+		nsend = rused_delta(pjob, &prused->ru_attr);
 
 		if (svr_hook_resend_job_attrs != 0) {
 			int		 index;
@@ -1208,11 +1277,21 @@ update_jobs_status(void)
 						&prused->ru_attr,
 						ad->at_name, NULL,
 						ATR_ENCODE_CLIENT, NULL);
-
+					nsend++;
 				}
 			}
 
 		}
+
+		if (nsend == 0) {
+			/* nothing but the session id, skip the job */
+			free_attrlist(&prused->ru_attr);
+			free(prused);
+			continue;
+		}
+		++count;
+		*prusednext	  = prused;	/* make last on list */
+		prusednext	  = &prused->ru_next;	/* track last link */
 	}
 
 	/* now send info to server via rpp */
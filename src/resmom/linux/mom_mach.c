@@ -68,6 +68,10 @@
 #include <sys/wait.h>
 #include <syscall.h>
 #include <signal.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
 
 #include "pbs_error.h"
 #include "portability.h"
@@ -85,6 +89,7 @@
 #include "pbs_ifl.h"
 #include "placementsets.h"
 #include "mom_vnode.h"
+#include "net_connect.h"
 #ifndef NAS /* localmod 113 */
 #include "hwloc.h"
 #endif /* localmod 113 */
@@ -167,6 +172,8 @@ extern  pid_t	mom_pid;
 extern	int	num_acpus;
 extern	int	num_pcpus;
 extern	int	num_oscpus;
+extern	int	proc_sample_mode;
+extern	char	*proc_sample_cgroup_prefix;
 struct	config		*search(struct config *, char *);
 struct	rm_attribute	*momgetattr(char *);
 
@@ -5067,30 +5074,32 @@ end_proc(void)
 
 /**
  * @brief
- *	 Scan a list of tasks and return true if one of them matches sid
+ *	Return true if ptask is the first active task of the job with its
+ *	session id, so that processes of a session shared by several tasks
+ *	are only counted once.
  *
  * @param[in] pjob - job pointer
- * @param[in] sid - session id
+ * @param[in] ptask - task of the job
  *
  * @return	Bool
  * @retval	TRUE
- * @retval	FALSE	Error
+ * @retval	FALSE	task is dead or an earlier task has the same session
  *
  */
 static int
-injob(job *pjob, pid_t sid)
+first_task_of_sid(job *pjob, task *ptask)
 {
-	task	*ptask;
+	task	*ptk;
 
-	for (ptask = (task *)GET_NEXT(pjob->ji_tasks);
-		ptask;
-		ptask = (task *)GET_NEXT(ptask->ti_jobtask)) {
-		if (ptask->ti_qs.ti_sid <= 1)
-			continue;
-		if (ptask->ti_qs.ti_sid == sid)
-			return TRUE;
+	if (ptask->ti_qs.ti_sid <= 1)
+		return FALSE;
+	for (ptk = (task *)GET_NEXT(pjob->ji_tasks);
+		ptk != ptask;
+		ptk = (task *)GET_NEXT(ptk->ti_jobtask)) {
+		if (ptk->ti_qs.ti_sid == ptask->ti_qs.ti_sid)
+			return FALSE;
 	}
-	return FALSE;
+	return TRUE;
 }
 
 /**
@@ -5129,13 +5138,10 @@ cput_sum(job *pjob)
 		active_tasks++;
 		tcput = 0;
 		taskprocs = 0;
-		for (i=0; i<nproc; i++) {
+		for (i = proc_sid_first(ptask->ti_qs.ti_sid); i != -1;
+			i = proc_sid_next[i]) {
 			ps = &proc_info[i];
 
-			/* is this process part of the task? */
-			if (ptask->ti_qs.ti_sid != ps->session)
-				continue;
-
 			nps++;
 			taskprocs++;
 
@@ -5275,18 +5281,24 @@ mem_sum(job *pjob)
 	int		i;
 	ulong		segadd;
 	proc_stat_t	*ps;
+	task		*ptask;
 
 	segadd = 0;
 
-	for (i=0; i<nproc; i++) {
+	for (ptask = (task *)GET_NEXT(pjob->ji_tasks);
+		ptask != NULL;
+		ptask = (task *)GET_NEXT(ptask->ti_jobtask)) {
+		if (!first_task_of_sid(pjob, ptask))
+			continue;
+		for (i = proc_sid_first(ptask->ti_qs.ti_sid); i != -1;
+			i = proc_sid_next[i]) {
 
-		ps = &proc_info[i];
+			ps = &proc_info[i];
 
-		if (!injob(pjob, ps->session))
-			continue;
-		segadd += ps->vsize;
-		DBPRT(("%s: pid: %d  pr_size: %lu  total: %lu\n",
-			__func__, ps->pid, (ulong)ps->vsize, segadd))
+			segadd += ps->vsize;
+			DBPRT(("%s: pid: %d  pr_size: %lu  total: %lu\n",
+				__func__, ps->pid, (ulong)ps->vsize, segadd))
+		}
 	}
 
 	return (segadd);
@@ -5310,26 +5322,32 @@ resi_sum(job *pjob)
 	ulong		resisize;
 	long		wm;		/* Altix weighted RSS replacement */
 	proc_stat_t	*ps;
+	task		*ptask;
 
 	resisize = 0;
-	for (i=0; i<nproc; i++) {
-
-		ps = &proc_info[i];
-
-		if (!injob(pjob, ps->session))
+	for (ptask = (task *)GET_NEXT(pjob->ji_tasks);
+		ptask != NULL;
+		ptask = (task *)GET_NEXT(ptask->ti_jobtask)) {
+		if (!first_task_of_sid(pjob, ptask))
 			continue;
+		for (i = proc_sid_first(ptask->ti_qs.ti_sid); i != -1;
+			i = proc_sid_next[i]) {
 
-		/*
-		 *	Certain Altix ProPack releases (or patches) add an
-		 *	interface to replace the value reported by /proc via
-		 *	the RSS field in the process's stat file.  If the
-		 *	value is available, we use it;  if get_wm() returns
-		 *	-1 indicating an error, we proceed using the old rss
-		 *	value that we read from /proc/<pid>/stat.
-		 */
-		if ((wm = get_wm(ps->pid)) != -1)
-			ps->rss = wm;
-		resisize += ps->rss * pagesize;
+			ps = &proc_info[i];
+
+			/*
+			 *	Certain Altix ProPack releases (or patches) add
+			 *	an interface to replace the value reported by
+			 *	/proc via the RSS field in the process's stat
+			 *	file.  If the value is available, we use it;  if
+			 *	get_wm() returns -1 indicating an error, we
+			 *	proceed using the old rss value that we read
+			 *	from /proc/<pid>/stat.
+			 */
+			if ((wm = get_wm(ps->pid)) != -1)
+				ps->rss = wm;
+			resisize += ps->rss * pagesize;
+		}
 	}
 
 	return (resisize);
@@ -5536,24 +5554,669 @@ mom_open_poll(void)
 	return (PBSE_NONE);
 }
 
+/*
+ * Process tracking for $proc_sample_mode session and cgroup.
+ *
+ * Rather than reading every /proc/<pid>/stat on the node, mom_get_sample()
+ * reads only the processes belonging to job sessions.  That set is seeded
+ * by a full /proc scan and then kept current from the fork, exit and setsid
+ * events delivered by the kernel proc connector (netlink).  A full scan is
+ * done again whenever a job session shows up that was not known at the last
+ * scan, or when the kernel reports that events were dropped.
+ */
+static int	proc_conn_fd = -1;	/* netlink proc connector socket */
+static int	proc_conn_failed = 0;	/* connector not available, don't retry */
+static int	proc_track_valid = 0;	/* tracked set is in sync with the system */
+static int	proc_info_all = 0;	/* proc_info holds all processes */
+static pid_t	*proc_track_tbl = NULL;	/* open addressing hash of tracked pids */
+static int	proc_track_size = 0;	/* slots in proc_track_tbl, a power of 2 */
+static int	proc_track_count = 0;	/* pids in proc_track_tbl */
+static pid_t	*proc_track_sids = NULL; /* sorted job sessions at last full scan */
+static int	proc_track_nsids = 0;
+
+#define	PROC_TRACK_INIT_SIZE	1024
+#define	PROC_TRACK_SLOT(pid)	\
+	(((unsigned int)(pid) * 2654435761U) & (unsigned int)(proc_track_size - 1))
+
+/* cgroup mount points for the accounting controllers */
+static char	*cgroup_cpuacct_mnt = NULL;
+static char	*cgroup_memory_mnt = NULL;
+static int	cgroup_mnt_checked = 0;
+
 /**
  * @brief
- * 	Declare start of polling loop.
+ *	Find the slot of a pid in the tracked set.
+ *
+ * @param[in] pid - process id
+ *
+ * @return	int
+ * @retval	>= 0	slot index
+ * @retval	-1	pid is not tracked
+ *
+ */
+static int
+proc_track_find(pid_t pid)
+{
+	unsigned int	i;
+
+	if (proc_track_count == 0)
+		return -1;
+	for (i = PROC_TRACK_SLOT(pid); proc_track_tbl[i] != 0;
+		i = (i + 1) & (proc_track_size - 1)) {
+		if (proc_track_tbl[i] == pid)
+			return (int)i;
+	}
+	return -1;
+}
+
+/**
+ * @brief
+ *	Add a pid to the tracked set, growing the table as needed.
+ *
+ * @param[in] pid - process id
+ *
+ * @return	Void
+ *
+ */
+static void
+proc_track_add(pid_t pid)
+{
+	unsigned int	i;
+
+	if (pid <= 1)
+		return;
+	if ((proc_track_count + 1) * 2 > proc_track_size) {
+		pid_t	*old = proc_track_tbl;
+		int	oldsize = proc_track_size;
+		int	j;
+
+		proc_track_size = oldsize ? oldsize * 2 : PROC_TRACK_INIT_SIZE;
+		proc_track_tbl = (pid_t *)calloc(proc_track_size, sizeof(pid_t));
+		assert(proc_track_tbl != NULL);
+		proc_track_count = 0;
+		for (j = 0; j < oldsize; j++) {
+			if (old[j] != 0)
+				proc_track_add(old[j]);
+		}
+		free(old);
+	}
+	for (i = PROC_TRACK_SLOT(pid); proc_track_tbl[i] != 0;
+		i = (i + 1) & (proc_track_size - 1)) {
+		if (proc_track_tbl[i] == pid)
+			return;
+	}
+	proc_track_tbl[i] = pid;
+	proc_track_count++;
+}
+
+/**
+ * @brief
+ *	Remove a pid from the tracked set.  Entries following it in
+ *	the probe sequence are shifted back so lookups stay correct.
+ *
+ * @param[in] pid - process id
+ *
+ * @return	Void
+ *
+ */
+static void
+proc_track_del(pid_t pid)
+{
+	int		idx;
+	unsigned int	i, j, home;
+
+	if ((idx = proc_track_find(pid)) == -1)
+		return;
+	i = (unsigned int)idx;
+	proc_track_tbl[i] = 0;
+	proc_track_count--;
+	for (j = (i + 1) & (proc_track_size - 1); proc_track_tbl[j] != 0;
+		j = (j + 1) & (proc_track_size - 1)) {
+		home = PROC_TRACK_SLOT(proc_track_tbl[j]);
+		/* move the entry into the hole unless its home lies in (i, j] */
+		if ((j > i && (home <= i || home > j)) ||
+			(j < i && (home <= i && home > j))) {
+			proc_track_tbl[i] = proc_track_tbl[j];
+			proc_track_tbl[j] = 0;
+			i = j;
+		}
+	}
+}
+
+/**
+ * @brief
+ *	Compare two pids, for qsort() and bsearch().
+ */
+static int
+proc_track_pidcmp(const void *a, const void *b)
+{
+	pid_t	pa = *(const pid_t *)a;
+	pid_t	pb = *(const pid_t *)b;
+
+	return ((pa > pb) - (pa < pb));
+}
+
+/**
+ * @brief
+ *	Collect the session ids of all active tasks of all jobs.
+ *
+ * @param[out] sidsp - sorted, unique array of session ids, to be freed
+ *		       by the caller
+ *
+ * @return	int
+ * @retval	number of session ids in *sidsp
+ *
+ */
+static int
+proc_track_job_sids(pid_t **sidsp)
+{
+	extern pbs_list_head	svr_alljobs;
+	job		*pjob;
+	task		*ptask;
+	pid_t		*sids = NULL;
+	int		nsids = 0;
+	int		maxsids = 0;
+	int		i, n;
+
+	for (pjob = (job *)GET_NEXT(svr_alljobs); pjob != NULL;
+		pjob = (job *)GET_NEXT(pjob->ji_alljobs)) {
+		for (ptask = (task *)GET_NEXT(pjob->ji_tasks); ptask != NULL;
+			ptask = (task *)GET_NEXT(ptask->ti_jobtask)) {
+			if (ptask->ti_qs.ti_sid <= 1)
+				continue;
+			if (nsids == maxsids) {
+				void	*hold;
+
+				maxsids += TBL_INC;
+				hold = realloc(sids, maxsids * sizeof(pid_t));
+				assert(hold != NULL);
+				sids = (pid_t *)hold;
+			}
+			sids[nsids++] = ptask->ti_qs.ti_sid;
+		}
+	}
+	if (nsids > 1) {
+		qsort(sids, nsids, sizeof(pid_t), proc_track_pidcmp);
+		for (i = 1, n = 1; i < nsids; i++) {
+			if (sids[i] != sids[n - 1])
+				sids[n++] = sids[i];
+		}
+		nsids = n;
+	}
+	*sidsp = sids;
+	return nsids;
+}
+
+/**
+ * @brief
+ *	Read and apply all pending events from the proc connector.
+ *	Registered with add_conn() so events are consumed as they
+ *	arrive and the socket buffer does not overflow between samples.
+ *
+ * @param[in] fd - proc connector socket
+ *
+ * @return	Void
+ *
+ */
+static void
+proc_conn_read(int fd)
+{
+	char			buf[8192] __attribute__((aligned(NLMSG_ALIGNTO)));
+	int			len;
+	struct nlmsghdr		*nlh;
+	struct cn_msg		*cnm;
+	struct proc_event	*ev;
+
+	for (;;) {
+		len = recv(fd, buf, sizeof(buf), 0);
+		if (len == -1) {
+			if (errno == EINTR)
+				continue;
+			if (errno == ENOBUFS) {
+				/* kernel dropped events, tracked set is stale */
+				proc_track_valid = 0;
+				continue;
+			}
+			break;
+		}
+		if (len == 0)
+			break;
+
+		for (nlh = (struct nlmsghdr *)buf; NLMSG_OK(nlh, len);
+			nlh = NLMSG_NEXT(nlh, len)) {
+			if (nlh->nlmsg_type == NLMSG_NOOP)
+				continue;
+			if (nlh->nlmsg_type == NLMSG_ERROR ||
+				nlh->nlmsg_type == NLMSG_OVERRUN) {
+				proc_track_valid = 0;
+				continue;
+			}
+			if (!proc_track_valid)
+				continue;
+			cnm = (struct cn_msg *)NLMSG_DATA(nlh);
+			ev = (struct proc_event *)cnm->data;
+			switch (ev->what) {
+				case PROC_EVENT_FORK:
+					/* new processes only, threads are not tracked */
+					if (ev->event_data.fork.child_pid ==
+						ev->event_data.fork.child_tgid &&
+						proc_track_find(ev->event_data.fork.parent_tgid) != -1)
+						proc_track_add(ev->event_data.fork.child_tgid);
+					break;
+
+				case PROC_EVENT_EXIT:
+					if (ev->event_data.exit.process_pid ==
+						ev->event_data.exit.process_tgid)
+						proc_track_del(ev->event_data.exit.process_tgid);
+					break;
+
+				case PROC_EVENT_SID:
+					/* process started its own session, it left the job */
+					proc_track_del(ev->event_data.sid.process_tgid);
+					break;
+
+				default:
+					break;
+			}
+		}
+	}
+}
+
+/**
+ * @brief
+ *	Open the netlink proc connector and subscribe to process events.
+ *
+ * @return	int
+ * @retval	0	Success
+ * @retval	-1	Error, the connector is not available
+ *
+ */
+static int
+proc_conn_open(void)
+{
+	int			fd;
+	int			bufsz = 4 * 1024 * 1024;
+	struct sockaddr_nl	sa;
+	struct {
+		struct nlmsghdr	nlh;
+		struct {
+			struct cn_msg		cnm;
+			enum proc_cn_mcast_op	op;
+		} __attribute__((packed)) body;
+	} __attribute__((aligned(NLMSG_ALIGNTO))) msg;
+
+	fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+		NETLINK_CONNECTOR);
+	if (fd == -1) {
+		log_err(errno, __func__, "netlink socket");
+		return -1;
+	}
+	(void)setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &bufsz, sizeof(bufsz));
+
+	memset(&sa, 0, sizeof(sa));
+	sa.nl_family = AF_NETLINK;
+	sa.nl_groups = CN_IDX_PROC;
+	if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) == -1) {
+		log_err(errno, __func__, "netlink bind");
+		close(fd);
+		return -1;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	msg.nlh.nlmsg_len = sizeof(msg);
+	msg.nlh.nlmsg_type = NLMSG_DONE;
+	msg.nlh.nlmsg_pid = getpid();
+	msg.body.cnm.id.idx = CN_IDX_PROC;
+	msg.body.cnm.id.val = CN_VAL_PROC;
+	msg.body.cnm.len = sizeof(enum proc_cn_mcast_op);
+	msg.body.op = PROC_CN_MCAST_LISTEN;
+	if (send(fd, &msg, sizeof(msg), 0) == -1) {
+		log_err(errno, __func__, "netlink subscribe");
+		close(fd);
+		return -1;
+	}
+
+	if (add_conn(fd, ChildPipe, (pbs_net_t)0, 0, proc_conn_read) == NULL) {
+		log_err(errno, __func__, "add_conn");
+		close(fd);
+		return -1;
+	}
+
+	proc_conn_fd = fd;
+	proc_track_valid = 0;
+	log_event(PBSEVENT_DEBUG, 0, LOG_DEBUG, __func__,
+		"tracking job processes through the proc connector");
+	return 0;
+}
+
+/**
+ * @brief
+ *	Forget all tracked processes and stop using the proc connector.
+ *	Used in a forked child, the socket belongs to the parent MoM.
+ *
+ * @return	Void
+ *
+ */
+static void
+proc_track_close(void)
+{
+	if (proc_conn_fd != -1) {
+		close(proc_conn_fd);
+		proc_conn_fd = -1;
+	}
+	free(proc_track_tbl);
+	proc_track_tbl = NULL;
+	proc_track_size = 0;
+	proc_track_count = 0;
+	free(proc_track_sids);
+	proc_track_sids = NULL;
+	proc_track_nsids = 0;
+	proc_track_valid = 0;
+}
+
+/**
+ * @brief
+ *	Read /proc/<name>/stat into the next free entry of proc_info.
+ *
+ * @param[in] name  - /proc directory entry, normally the pid
+ * @param[in] nomem - don't count the memory of the entry (thread)
+ *
+ * @return	int
+ * @retval	0	Success, nproc was advanced
+ * @retval	-1	process could not be read
+ * @retval	-2	internal error
+ *
+ */
+static int
+proc_stat_read(char *name, int nomem)
+{
+	static char		path[MAXPATHLEN + 1];
+	char			procname[384]; /* space for name plus extra */
+	FILE			*fd;
+	struct stat		sb;
+	proc_stat_t		*ps;
+	unsigned long long	starttime;
+	char			*stat_str;
+
+	sprintf(procname, "/proc/%s/stat", name);
+
+	if ((fd = fopen(procname, "r")) == NULL)
+		return -1;
+
+	ps = &proc_info[nproc];
+	stat_str = choose_procflagsfmt();
+	if (stat_str == NULL) {
+		log_err(errno, __func__, "choose_procflagsfmt allocation failed");
+		fclose(fd);
+		return -2;
+	}
+	if (fscanf(fd, stat_str,
+		   &ps->pid,		/* "%d "	1  pid %d The process id */
+		   path,		/* "(%[^)]) "	2  comm %s The filename of the executable */
+		   &ps->state,		/* "%c "	3  state %c "RSDZTW" */
+		   &ps->ppid,		/* "%d "	4  ppid %d The PID of the parent */
+		   &ps->pgrp,		/* "%d "	5  pgrp %d The process group ID */
+		   &ps->session,	/* "%d "	6  session %d The session ID */
+			   		/* "%*d "	7  ignored:  tty_nr */
+ 		   			/* "%*d "	8  ignored:  tpgid */
+		   &ps->flags,		/* "%u or %lu"	9  flags */
+				   	/* "%*lu "	10 ignored:  minflt */
+				   	/* "%*lu "	11 ignored:  cminflt */
+				   	/* "%*lu "	12 ignored:  majflt */
+				   	/* "%*lu "	13 ignored:  cmajflt */
+		   &ps->utime,		/* "%lu "	14 utime %lu */
+		   &ps->stime,		/* "%lu "	15 stime %lu */
+		   &ps->cutime,		/* "%ld "	16 cutime %ld */
+		   &ps->cstime,		/* "%ld "	17 cstime %ld */
+			   		/* "%*ld "	18 ignored:  priority %ld */
+		   			/* "%*ld "	19 ignored:  nice %ld */
+		   			/* "%*ld "	20 ignored:  num_threads %ld */
+		   			/* "%*ld "	21 ignored:  itrealvalue %ld - no longer maintained */
+		   &starttime,		/* "%llu "	22 starttime (was %lu before Linux 2.6 - see proc(5) for conversion details */
+		   &ps->vsize,		/* "%lu "	23 vsize (bytes) */
+		   &ps->rss		/* "%ld "	24 rss (number of pages) */
+		) != 14) {
+		fclose(fd);
+		return -1;
+	}
+
+	if (fstat(fileno(fd), &sb) == -1) {
+		fclose(fd);
+		return -1;
+	}
+	ps->uid = sb.st_uid;
+	fclose(fd);
+
+	/*
+	 ** A .pid thread shows the memory of the process
+	 ** but we only want to count it once.
+	 */
+	if (nomem) {
+		ps->vsize = 0;
+		ps->rss = 0;
+	}
+
+	ps->start_time = linux_time + (starttime / hz);
+	snprintf(ps->comm, sizeof(ps->comm), "%.*s",
+		(int)(sizeof(ps->comm) - 1), path);
+
+	ps->utime = JTOS(ps->utime);
+	ps->stime = JTOS(ps->stime);
+	ps->cutime = JTOS(ps->cutime);
+	ps->cstime = JTOS(ps->cstime);
+	if (++nproc == max_proc) {
+		void	*hold;
+		DBPRT(("%s: alloc more proc table space %d\n", __func__, nproc))
+		max_proc += TBL_INC;
+		hold = realloc((void *)proc_info,
+			max_proc*sizeof(proc_stat_t));
+		assert(hold != NULL);
+		proc_info = (proc_stat_t *)hold;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Sample only the tracked job processes.
+ *
+ * @return	int
+ * @retval	0	proc_info was filled from the tracked set
+ * @retval	-1	a full scan of /proc is needed
+ *
+ */
+static int
+proc_track_sample(void)
+{
+	pid_t	*sids;
+	pid_t	*gone;
+	int	ngone = 0;
+	int	nsids;
+	int	i;
+	char	name[32];
+
+	if (proc_conn_fd == -1) {
+		if (proc_conn_failed)
+			return -1;
+		if (proc_conn_open() == -1) {
+			proc_conn_failed = 1;
+			log_event(PBSEVENT_ERROR, 0, LOG_WARNING, __func__,
+				"proc connector not available, using full /proc scans");
+			return -1;
+		}
+	}
+
+	proc_conn_read(proc_conn_fd);	/* catch up with pending events */
+	if (!proc_track_valid)
+		return -1;
+
+	/* a session that was not there at the last full scan needs seeding */
+	nsids = proc_track_job_sids(&sids);
+	for (i = 0; i < nsids; i++) {
+		if (bsearch(&sids[i], proc_track_sids, proc_track_nsids,
+			sizeof(pid_t), proc_track_pidcmp) == NULL)
+			break;
+	}
+	free(sids);
+	if (i < nsids)
+		return -1;
+
+	gone = (pid_t *)malloc((proc_track_count + 1) * sizeof(pid_t));
+	if (gone == NULL)
+		return -1;
+
+	nproc = 0;
+	for (i = 0; i < proc_track_size; i++) {
+		if (proc_track_tbl[i] == 0)
+			continue;
+		sprintf(name, "%d", (int)proc_track_tbl[i]);
+		switch (proc_stat_read(name, 0)) {
+			case 0:
+				break;
+			case -1:
+				/* exit event not seen yet */
+				gone[ngone++] = proc_track_tbl[i];
+				break;
+			default:
+				free(gone);
+				return -1;
+		}
+	}
+	for (i = 0; i < ngone; i++)
+		proc_track_del(gone[i]);
+	free(gone);
+
+	sprintf(log_buffer, "tracked procs:  %d, gone:  %d", nproc, ngone);
+	log_event(PBSEVENT_DEBUG4, 0, LOG_DEBUG, __func__, log_buffer);
+	return 0;
+}
+
+/**
+ * @brief
+ *	Locate the cgroup mount points of the cpuacct and memory
+ *	controllers, once.
+ *
+ * @return	Void
+ *
+ */
+static void
+cgroup_find_mounts(void)
+{
+	FILE		*fp;
+	struct mntent	*mnt;
+
+	if (cgroup_mnt_checked)
+		return;
+	cgroup_mnt_checked = 1;
+	if ((fp = setmntent("/proc/mounts", "r")) == NULL)
+		return;
+	while ((mnt = getmntent(fp)) != NULL) {
+		if (strcmp(mnt->mnt_type, "cgroup") != 0)
+			continue;
+		if (cgroup_cpuacct_mnt == NULL && hasmntopt(mnt, "cpuacct"))
+			cgroup_cpuacct_mnt = strdup(mnt->mnt_dir);
+		if (cgroup_memory_mnt == NULL && hasmntopt(mnt, "memory"))
+			cgroup_memory_mnt = strdup(mnt->mnt_dir);
+	}
+	endmntent(fp);
+}
+
+/**
+ * @brief
+ *	Escape a string the way systemd does for unit names, matching
+ *	the job cgroup names made by the cgroups hook.
+ *
+ * @param[in]  in  - string to escape
+ * @param[out] out - escaped string
+ * @param[in]  len - size of out
+ *
+ * @return	Void
+ *
+ */
+static void
+cgroup_systemd_escape(char *in, char *out, size_t len)
+{
+	size_t	n = 0;
+	int	i;
+
+	for (i = 0; in[i] != '\0' && n + 5 < len; i++) {
+		unsigned char	c = (unsigned char)in[i];
+
+		if ((isalnum(c) || c == '_' || c == '.') && !(i == 0 && c == '.'))
+			out[n++] = c;
+		else if (c == '/')
+			out[n++] = '-';
+		else
+			n += sprintf(out + n, "\\x%02x", c);
+	}
+	out[n] = '\0';
+}
+
+/**
+ * @brief
+ *	Read a numeric accounting file from the job's cgroup, looking
+ *	in both the plain and the systemd slice layout used by the
+ *	cgroups hook.
+ *
+ * @param[in]  pjob  - job pointer
+ * @param[in]  mnt   - controller mount point
+ * @param[in]  file  - accounting file name
+ * @param[out] value - value read
+ *
+ * @return	int
+ * @retval	0	Success
+ * @retval	-1	job has no cgroup or the file could not be read
+ *
+ */
+static int
+job_cgroup_value(job *pjob, char *mnt, char *file, unsigned long long *value)
+{
+	char	*prefix;
+	char	escaped[PBS_MAXSVRJOBID * 4 + 1];
+	char	path[MAXPATHLEN + 1];
+	FILE	*fp;
+	int	rc;
+
+	if (mnt == NULL)
+		return -1;
+	prefix = proc_sample_cgroup_prefix ? proc_sample_cgroup_prefix : "pbspro";
+
+	snprintf(path, sizeof(path), "%s/%s/%s/%s", mnt, prefix,
+		pjob->ji_qs.ji_jobid, file);
+	if ((fp = fopen(path, "r")) == NULL) {
+		cgroup_systemd_escape(pjob->ji_qs.ji_jobid, escaped, sizeof(escaped));
+		snprintf(path, sizeof(path), "%s/%s.slice/%s-%s.slice/%s", mnt,
+			prefix, prefix, escaped, file);
+		if ((fp = fopen(path, "r")) == NULL)
+			return -1;
+	}
+	rc = fscanf(fp, "%llu", value);
+	fclose(fp);
+	return ((rc == 1) ? 0 : -1);
+}
+
+/**
+ * @brief
+ *	Fill proc_info from /proc.
+ *
+ * @par
+ *	With $proc_sample_mode session or cgroup and full not set only the
+ *	processes of job sessions are read when the tracked set is current,
+ *	otherwise all of /proc is scanned and the tracked set is seeded from
+ *	the result.  proc_info_all tells which of the two proc_info holds.
+ *
+ * @param[in] full - scan all of /proc, for callers that look at processes
+ *		     outside of jobs
  *
  * @return	int
  * @retval	PBSE_INTERNAL	Dir pdir in NULL
  * @retval	PBSE_NONE	Success
  *
  */
-int
-mom_get_sample(void)
+static int
+proc_sample(int full)
 {
 	struct dirent		*dent = NULL;
-	FILE			*fd = NULL;
-	static char		path[MAXPATHLEN + 1];
-	char			procname[384]; /* space for dent->d_name plus extra */
-	struct stat		sb;
-	proc_stat_t		*ps = NULL;
 #if MOM_CPUSET
 	pidcachetype_t		*pidcache = NULL;
 #endif	/* MOM_CPUSET */
@@ -5561,15 +6224,38 @@ mom_get_sample(void)
 	int			ncached = 0;
 	int			ncantstat = 0;
 	int			nnomem = 0;
-	unsigned long long 	starttime;
 	int			nskipped = 0;
+	int			track = 0;
+	pid_t			*sids = NULL;
+	int			nsids = 0;
 	extern time_t		time_last_sample;
-	char			*stat_str = NULL;
 
 	DBPRT(("%s: entered\n", __func__))
 	if (pdir == NULL)
 		return PBSE_INTERNAL;
 
+	proc_sid_index_reset();
+	if (hz == 0)
+		hz = sysconf(_SC_CLK_TCK);
+	time_last_sample = time(0);
+	sampletime_floor = time_last_sample;
+
+	if (proc_sample_mode != PROC_SAMPLE_FULL) {
+		if (!full && (proc_track_sample() == 0)) {
+			proc_info_all = 0;
+			sampletime_ceil = time_last_sample;
+			return (PBSE_NONE);
+		}
+		if (proc_conn_fd != -1) {
+			/* reseed the tracked set from this scan */
+			track = 1;
+			nsids = proc_track_job_sids(&sids);
+			if (proc_track_tbl != NULL)
+				memset(proc_track_tbl, 0, proc_track_size * sizeof(pid_t));
+			proc_track_count = 0;
+		}
+	}
+
 #if MOM_CPUSET
 	if (((pidcache = pidcache_getarena()) == NULL) && pidcache_needed()) {
 		if ((pidcache = pidcache_create()) == NULL)
@@ -5582,11 +6268,6 @@ mom_get_sample(void)
 #endif /* MOM_CPUSET */
 	rewinddir(pdir);
 	nproc = 0;
-	fd = NULL;
-	if (hz == 0)
-		hz = sysconf(_SC_CLK_TCK);
-	time_last_sample = time(0);
-	sampletime_floor = time_last_sample;
 	while (errno = 0, (dent = readdir(pdir)) != NULL) {
 		int	nomem = 0;
 
@@ -5612,86 +6293,31 @@ mom_get_sample(void)
 			}
 		}
 #endif	/* MOM_CPUSET */
-		sprintf(procname, "/proc/%s/stat", dent->d_name);
-
-		if ((fd = fopen(procname, "r")) == NULL) {
-			ncantstat++;
-			continue;
-		}
-
-		ps = &proc_info[nproc];
-		stat_str = choose_procflagsfmt();
-		if (stat_str == NULL) {
-			log_err(errno, __func__, "choose_procflagsfmt allocation failed");
-			return PBSE_INTERNAL;
-		}
-		if (fscanf(fd, stat_str,
-			   &ps->pid,		/* "%d "	1  pid %d The process id */
-			   path,		/* "(%[^)]) "	2  comm %s The filename of the executable */
-			   &ps->state,		/* "%c "	3  state %c "RSDZTW" */
-			   &ps->ppid,		/* "%d "	4  ppid %d The PID of the parent */
-			   &ps->pgrp,		/* "%d "	5  pgrp %d The process group ID */
-			   &ps->session,	/* "%d "	6  session %d The session ID */
-				   		/* "%*d "	7  ignored:  tty_nr */
-	 		   			/* "%*d "	8  ignored:  tpgid */
-			   &ps->flags,		/* "%u or %lu"	9  flags */
-					   	/* "%*lu "	10 ignored:  minflt */
-					   	/* "%*lu "	11 ignored:  cminflt */
-					   	/* "%*lu "	12 ignored:  majflt */
-					   	/* "%*lu "	13 ignored:  cmajflt */
-			   &ps->utime,		/* "%lu "	14 utime %lu */
-			   &ps->stime,		/* "%lu "	15 stime %lu */
-			   &ps->cutime,		/* "%ld "	16 cutime %ld */
-			   &ps->cstime,		/* "%ld "	17 cstime %ld */
-				   		/* "%*ld "	18 ignored:  priority %ld */
-			   			/* "%*ld "	19 ignored:  nice %ld */
-			   			/* "%*ld "	20 ignored:  num_threads %ld */
-			   			/* "%*ld "	21 ignored:  itrealvalue %ld - no longer maintained */
-			   &starttime,		/* "%llu "	22 starttime (was %lu before Linux 2.6 - see proc(5) for conversion details */
-			   &ps->vsize,		/* "%lu "	23 vsize (bytes) */
-			   &ps->rss		/* "%ld "	24 rss (number of pages) */
-			) != 14) {
-			ncantstat++;
-			fclose(fd);
-			continue;
-		}
-
-		if (fstat(fileno(fd), &sb) == -1) {
-			fclose(fd);
-			continue;
+		switch (proc_stat_read(dent->d_name, nomem)) {
+			case 0:
+				break;
+			case -1:
+				ncantstat++;
+				continue;
+			default:
+				free(sids);
+				return PBSE_INTERNAL;
 		}
-		ps->uid = sb.st_uid;
-		fclose(fd);
 
-		/*
-		 ** A .pid thread shows the memory of the process
-		 ** but we only want to count it once.
-		 */
-		if (nomem) {
-			ps->vsize = 0;
-			ps->rss = 0;
-		}
-
-		ps->start_time = linux_time + (starttime / hz);
-		snprintf(ps->comm, sizeof(ps->comm), "%.*s",
-			(int)(sizeof(ps->comm) - 1), path);
-
-		ps->utime = JTOS(ps->utime);
-		ps->stime = JTOS(ps->stime);
-		ps->cutime = JTOS(ps->cutime);
-		ps->cstime = JTOS(ps->cstime);
-		if (++nproc == max_proc) {
-			void	*hold;
-			DBPRT(("%s: alloc more proc table space %d\n", __func__, nproc))
-			max_proc += TBL_INC;
-			hold = realloc((void *)proc_info,
-				max_proc*sizeof(proc_stat_t));
-			assert(hold != NULL);
-			proc_info = (proc_stat_t *)hold;
-		}
+		if (track && !nomem && nsids > 0 &&
+			bsearch(&proc_info[nproc - 1].session, sids, nsids,
+			sizeof(pid_t), proc_track_pidcmp) != NULL)
+			proc_track_add(proc_info[nproc - 1].pid);
 	}
 	if (errno != 0 && errno != ENOENT)
 		log_err(errno, __func__, "readdir");
+	if (track) {
+		free(proc_track_sids);
+		proc_track_sids = sids;
+		proc_track_nsids = nsids;
+		proc_track_valid = 1;
+	}
+	proc_info_all = 1;
 	sampletime_ceil = time_last_sample;
 	sprintf(log_buffer,
 		"nprocs:  %d, cantstat:  %d, nomem:  %d, skipped:  %d, "
@@ -5706,6 +6332,21 @@ mom_get_sample(void)
 	return (PBSE_NONE);
 }
 
+/**
+ * @brief
+ * 	Declare start of polling loop.
+ *
+ * @return	int
+ * @retval	PBSE_INTERNAL	Dir pdir in NULL
+ * @retval	PBSE_NONE	Success
+ *
+ */
+int
+mom_get_sample(void)
+{
+	return (proc_sample(0));
+}
+
 /**
  * @brief
  * 	Update the resources used.<attributes> of a job.
@@ -5734,6 +6375,8 @@ mom_set_use(job *pjob)
 	u_Long 		*lp_sz, lnum_sz;
 	ulong		*lp, lnum, oldcput;
 	long		ncpus_req;
+	unsigned long long	cgval;
+	int		use_cgroup;
 
 	assert(pjob != NULL);
 	at = &pjob->ji_wattr[(int)JOB_ATR_resc_used];
@@ -5746,6 +6389,10 @@ mom_set_use(job *pjob)
 
 	at->at_flags |= (ATR_VFLAG_MODIFY|ATR_VFLAG_SET);
 
+	use_cgroup = (proc_sample_mode == PROC_SAMPLE_CGROUP);
+	if (use_cgroup)
+		cgroup_find_mounts();
+
 	rd = find_resc_def(svr_resc_def, "ncpus", svr_resc_size);
 	assert(rd != NULL);
 	pres = find_resc_entry(at, rd);
@@ -5782,6 +6429,16 @@ mom_set_use(job *pjob)
 	lp = (ulong *)&pres->rs_value.at_val.at_long;
 	oldcput = *lp;
 	lnum = cput_sum(pjob);
+	/* the cgroup also counts processes that escaped the session */
+	if (use_cgroup) {
+		if (job_cgroup_value(pjob, cgroup_cpuacct_mnt,
+			"cpuacct.usage", &cgval) == 0)
+			lnum = MAX(lnum, (ulong)((double)cgval / 1.0e9 * cputfactor));
+		else if (pjob->ji_sampletim == 0)	/* first sample */
+			log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_JOB, LOG_DEBUG,
+				pjob->ji_qs.ji_jobid,
+				"no job cgroup, resources_used from process sums");
+	}
 	lnum = MAX(*lp, lnum);
 	if ((pres->rs_value.at_flags & ATR_VFLAG_HOOK) == 0) {
 		/* don't conflict with hook setting a value */
@@ -5815,7 +6472,11 @@ mom_set_use(job *pjob)
 		pres->rs_value.at_val.at_size.atsv_units = ATR_SV_BYTESZ;
 	} else if ((pres->rs_value.at_flags & ATR_VFLAG_HOOK) == 0) {
 		lp_sz = &pres->rs_value.at_val.at_size.atsv_num;
-		lnum_sz = (mem_sum(pjob) + 1023) >> 10;		/* as KB */
+		if (use_cgroup && job_cgroup_value(pjob, cgroup_memory_mnt,
+			"memory.memsw.max_usage_in_bytes", &cgval) == 0)
+			lnum_sz = (cgval + 1023) >> 10;
+		else
+			lnum_sz = (mem_sum(pjob) + 1023) >> 10;	/* as KB */
 		*lp_sz = MAX(*lp_sz, lnum_sz);
 	}
 
@@ -5833,7 +6494,11 @@ mom_set_use(job *pjob)
 		pres->rs_value.at_val.at_size.atsv_units = ATR_SV_BYTESZ;
 	} else if ((pres->rs_value.at_flags & ATR_VFLAG_HOOK) == 0) {
 		lp_sz = &pres->rs_value.at_val.at_size.atsv_num;
-		lnum_sz = (resi_sum(pjob) + 1023) >> 10; /* as KB */
+		if (use_cgroup && job_cgroup_value(pjob, cgroup_memory_mnt,
+			"memory.max_usage_in_bytes", &cgval) == 0)
+			lnum_sz = (cgval + 1023) >> 10;
+		else
+			lnum_sz = (resi_sum(pjob) + 1023) >> 10; /* as KB */
 		*lp_sz = MAX(*lp_sz, lnum_sz);
 	}
 
@@ -5874,25 +6539,23 @@ bld_ptree(pid_t sid)
 	 */
 
 	myproc_ct = 0;
-	for (i = 0; i < nproc; i++) {
+	for (i = proc_sid_first(sid); i != -1; i = proc_sid_next[i]) {
 		if (PBS_PROC_PID(i) <= 1)
 			continue;
-		if ((int)PBS_PROC_SID(i) == sid) {
-			Proc_lnks[myproc_ct].pl_pid = PBS_PROC_PID(i);
-			Proc_lnks[myproc_ct].pl_ppid = PBS_PROC_PPID(i);
-			Proc_lnks[myproc_ct].pl_parent = -1;
-			Proc_lnks[myproc_ct].pl_sib = -1;
-			Proc_lnks[myproc_ct].pl_child = -1;
-			Proc_lnks[myproc_ct].pl_done = 0;
-			if (++myproc_ct == myproc_max) {
-				void * hold;
-
-				myproc_max += TBL_INC;
-				hold = realloc((void *)Proc_lnks,
-					myproc_max*sizeof(pbs_plinks));
-				assert(hold != NULL);
-				Proc_lnks = (pbs_plinks *)hold;
-			}
+		Proc_lnks[myproc_ct].pl_pid = PBS_PROC_PID(i);
+		Proc_lnks[myproc_ct].pl_ppid = PBS_PROC_PPID(i);
+		Proc_lnks[myproc_ct].pl_parent = -1;
+		Proc_lnks[myproc_ct].pl_sib = -1;
+		Proc_lnks[myproc_ct].pl_child = -1;
+		Proc_lnks[myproc_ct].pl_done = 0;
+		if (++myproc_ct == myproc_max) {
+			void * hold;
+
+			myproc_max += TBL_INC;
+			hold = realloc((void *)Proc_lnks,
+				myproc_max*sizeof(pbs_plinks));
+			assert(hold != NULL);
+			Proc_lnks = (pbs_plinks *)hold;
 		}
 	}
 
@@ -6049,6 +6712,7 @@ mom_close_poll(void)
 		proc_info = NULL;
 		max_proc = 0;
 	}
+	proc_track_close();
 
 	return (PBSE_NONE);
 }
@@ -6091,17 +6755,18 @@ mach_restart(task *ptask, char *file)
 
 /**
  * @brief
- *	Return 1 if proc table can be read, 0 otherwise.
+ *	Return 1 if proc table can be read, 0 otherwise.  The table then
+ *	holds all processes, not only those of jobs.
  */
 int
 getprocs(void)
 {
 	static unsigned int	lastproc = 0;
 
-	if (lastproc == reqnum)		/* don't need new proc table */
+	if ((lastproc == reqnum) && proc_info_all)	/* don't need new proc table */
 		return 1;
 
-	if (mom_get_sample() != PBSE_NONE)
+	if (proc_sample(1) != PBSE_NONE)
 		return 0;
 
 	lastproc = reqnum;
@@ -6173,7 +6838,7 @@ cput_proc(pid_t pid)
 
 	cputime = 0.0;
 
-	mom_get_sample();
+	(void)proc_sample(1);	/* not only job processes */
 	for (i=0; i<nproc; i++) {
 		ps = &proc_info[i];
 		if (ps->pid == pid)
@@ -6289,7 +6954,7 @@ mem_proc(pid_t pid)
 	int		i;
 	proc_stat_t	*ps = NULL;
 
-	mom_get_sample();
+	(void)proc_sample(1);	/* not only job processes */
 	for (i=0; i<nproc; i++) {
 		ps = &proc_info[i];
 		if (ps->pid == pid)
@@ -6419,7 +7084,7 @@ resi_proc(pid_t pid)
 	proc_stat_t	*ps = NULL;
 
 
-	mom_get_sample();
+	(void)proc_sample(1);	/* not only job processes */
 	for (i=0; i<nproc; i++) {
 		ps = &proc_info[i];
 		if (ps->pid == pid)
@@ -6522,7 +7187,7 @@ sessions(struct rm_attribute *attrib)
 		return NULL;
 	}
 
-	mom_get_sample();
+	(void)proc_sample(1);	/* not only job processes */
 
 	/*
 	 ** Search for members of session
@@ -6637,7 +7302,7 @@ pids(struct rm_attribute *attrib)
 		return NULL;
 	}
 
-	mom_get_sample();
+	(void)proc_sample(1);	/* not only job processes */
 
 	/*
 	 ** Search for members of session
@@ -6697,7 +7362,7 @@ nusers(struct rm_attribute *attrib)
 		return NULL;
 	}
 
-	mom_get_sample();
+	(void)proc_sample(1);	/* not only job processes */
 	for (i=0; i<nproc; i++) {
 		ps = &proc_info[i];
 
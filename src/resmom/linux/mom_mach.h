@@ -59,6 +59,11 @@ extern "C" {
 #define	PBS_PROC_PPID(x) proc_info[x].ppid
 #define	CLR_SJR(sjr)	memset(&sjr, 0, sizeof(sjr));
 #define	PBS_SUPPORT_SUSPEND 1
+
+/* values of $proc_sample_mode */
+#define	PROC_SAMPLE_FULL	0	/* scan all of /proc every sample */
+#define	PROC_SAMPLE_SESSION	1	/* read only tracked job processes */
+#define	PROC_SAMPLE_CGROUP	2	/* as session, usage from job cgroups */
 #define	task	pbs_task
 
 #if	MOM_CPUSET
@@ -437,6 +442,11 @@ typedef struct proc_stat {
 	char		comm[COMSIZE];	/* command name */
 } proc_stat_t;
 
+/* index of proc_info by session id, see proc_index.c */
+extern int	*proc_sid_next;
+extern void	proc_sid_index_reset(void);
+extern int	proc_sid_first(pid_t sid);
+
 
 typedef	struct	proc_map {
 	unsigned long	vm_start;	/* start of vm for process */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+/**
+ * @file	proc_index.c
+ * @brief
+ *	Index of the process table filled by mom_get_sample() by session id.
+ *
+ *	The usage and signal routines need the processes of one session at a
+ *	time.  Scanning all of proc_info for each of them costs
+ *	O(jobs * processes) per polling cycle, the index makes it
+ *	O(processes) to build once per sample plus O(processes in session)
+ *	per lookup.
+ *
+ *	The index is a chain through proc_sid_next[] linking the entries of
+ *	each session in table order, and an open addressing hash from
+ *	session id to the first entry of its chain.
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "list_link.h"
+#include "server_limits.h"
+#include "attribute.h"
+#include "job.h"
+#include "mom_mach.h"
+
+extern proc_stat_t	*proc_info;
+extern int		nproc;
+
+typedef struct proc_sid_ent {
+	pid_t	se_sid;		/* session id, 0 for an empty slot */
+	int	se_first;	/* first proc_info index of the session */
+	int	se_last;	/* last index, used while building */
+} proc_sid_ent;
+
+int			*proc_sid_next = NULL;	/* next index in same session */
+static int		proc_sid_next_max = 0;
+static proc_sid_ent	*proc_sid_tbl = NULL;
+static int		proc_sid_tbl_size = 0;	/* a power of 2 */
+static int		proc_sid_nproc = -1;	/* nproc indexed, -1 if stale */
+
+#define	PROC_SID_SLOT(sid)	\
+	(((unsigned int)(sid) * 2654435761U) & (unsigned int)(proc_sid_tbl_size - 1))
+
+/**
+ * @brief
+ *	Mark the index stale.  Called whenever proc_info is refilled.
+ *
+ * @return	Void
+ *
+ */
+void
+proc_sid_index_reset(void)
+{
+	proc_sid_nproc = -1;
+}
+
+/**
+ * @brief
+ *	Build the session index over the current contents of proc_info.
+ *
+ * @return	Void
+ *
+ */
+static void
+proc_sid_index_build(void)
+{
+	int		i;
+	int		size;
+	unsigned int	slot;
+	pid_t		sid;
+
+	if (nproc > proc_sid_next_max) {
+		int	*hold;
+
+		hold = (int *)realloc(proc_sid_next, nproc * sizeof(int));
+		assert(hold != NULL);
+		proc_sid_next = hold;
+		proc_sid_next_max = nproc;
+	}
+
+	/* keep the load factor at or below one half */
+	for (size = 256; size < nproc * 2; size <<= 1)
+		;
+	if (size != proc_sid_tbl_size) {
+		proc_sid_ent	*hold;
+
+		hold = (proc_sid_ent *)malloc(size * sizeof(proc_sid_ent));
+		assert(hold != NULL);
+		free(proc_sid_tbl);
+		proc_sid_tbl = hold;
+		proc_sid_tbl_size = size;
+	}
+	memset(proc_sid_tbl, 0, proc_sid_tbl_size * sizeof(proc_sid_ent));
+
+	for (i = 0; i < nproc; i++) {
+		proc_sid_next[i] = -1;
+		sid = proc_info[i].session;
+		if (sid <= 0)
+			continue;	/* kernel threads, never in a job */
+		for (slot = PROC_SID_SLOT(sid); proc_sid_tbl[slot].se_sid != 0;
+			slot = (slot + 1) & (proc_sid_tbl_size - 1)) {
+			if (proc_sid_tbl[slot].se_sid == sid)
+				break;
+		}
+		if (proc_sid_tbl[slot].se_sid == 0) {
+			proc_sid_tbl[slot].se_sid = sid;
+			proc_sid_tbl[slot].se_first = i;
+		} else
+			proc_sid_next[proc_sid_tbl[slot].se_last] = i;
+		proc_sid_tbl[slot].se_last = i;
+	}
+	proc_sid_nproc = nproc;
+}
+
+/**
+ * @brief
+ *	Return the first proc_info entry of a session.  The remaining
+ *	entries follow through proc_sid_next[], ending with -1:
+ *
+ *	for (i = proc_sid_first(sid); i != -1; i = proc_sid_next[i])
+ *
+ * @param[in] sid - session id
+ *
+ * @return	int
+ * @retval	>= 0	index into proc_info
+ * @retval	-1	no process in the session
+ *
+ */
+int
+proc_sid_first(pid_t sid)
+{
+	unsigned int	slot;
+
+	if (proc_sid_nproc != nproc)
+		proc_sid_index_build();
+	if (sid <= 0 || nproc == 0)
+		return -1;
+	for (slot = PROC_SID_SLOT(sid); proc_sid_tbl[slot].se_sid != 0;
+		slot = (slot + 1) & (proc_sid_tbl_size - 1)) {
+		if (proc_sid_tbl[slot].se_sid == sid)
+			return proc_sid_tbl[slot].se_first;
+	}
+	return -1;
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+
+/**
+ * @file	proc_index_bench.c
+ *
+ * @brief	Micro benchmark for the MoM session index of proc_info
+ *
+ * @par		Functionality:
+ *
+ *		Fills proc_info with synthetic entries, njobs job sessions of
+ *		a few processes each and the rest spread over non-job sessions
+ *		as on a busy node, then times one polling cycle of per-job
+ *		usage collection two ways: scanning all of proc_info for every
+ *		job as cput_sum() and mem_sum() used to, and walking the
+ *		session index.  The index build is included in its time.  The
+ *		sums of both methods are compared.
+ *
+ *		Not installed, build with "make proc_index_bench".
+ *
+ * Usage: proc_index_bench [-n nprocs] [-j njobs] [-r rounds]
+ */
+
+#include <pbs_config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+#include "list_link.h"
+#include "server_limits.h"
+#include "attribute.h"
+#include "job.h"
+#include "mom_mach.h"
+
+proc_stat_t	*proc_info = NULL;
+int		nproc = 0;
+
+/**
+ * @brief
+ *	Return the time between two timevals in seconds
+ */
+static double
+elapsed(struct timeval *t1, struct timeval *t2)
+{
+	return ((t2->tv_sec - t1->tv_sec) + (t2->tv_usec - t1->tv_usec) / 1000000.0);
+}
+
+/**
+ * @brief
+ *	Fill proc_info with nprocs entries.  Job sessions are 100000 + job
+ *	index, other sessions are below 100000.  Entries are shuffled so
+ *	sessions are not contiguous, as in /proc.
+ *
+ * @param[in] nprocs - entries to create
+ * @param[in] njobs - number of job sessions
+ */
+static void
+fill_procs(int nprocs, int njobs)
+{
+	int	i, j;
+	int	per_job = 8;
+	proc_stat_t	tmp;
+
+	proc_info = (proc_stat_t *)calloc(nprocs, sizeof(proc_stat_t));
+	if (proc_info == NULL) {
+		perror("calloc");
+		exit(1);
+	}
+	srandom(1);
+	for (i = 0; i < nprocs; i++) {
+		proc_stat_t	*ps = &proc_info[i];
+
+		ps->pid = i + 2;
+		if (i < njobs * per_job)
+			ps->session = 100000 + (i % njobs);
+		else
+			ps->session = 1 + random() % 5000;
+		ps->ppid = ps->session;
+		ps->state = 'S';
+		ps->utime = random() % 1000;
+		ps->stime = random() % 100;
+		ps->vsize = random() % 1000000;
+	}
+	for (i = nprocs - 1; i > 0; i--) {
+		j = random() % (i + 1);
+		tmp = proc_info[i];
+		proc_info[i] = proc_info[j];
+		proc_info[j] = tmp;
+	}
+	nproc = nprocs;
+}
+
+/**
+ * @brief
+ *	main - entry point of proc_index_bench
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	1 - the two methods disagree
+ */
+int
+main(int argc, char *argv[])
+{
+	int		c;
+	int		nprocs = 100000;
+	int		njobs = 128;
+	int		rounds = 10;
+	int		r, j, i;
+	unsigned long	lin_sum = 0;
+	unsigned long	idx_sum = 0;
+	struct timeval	t1, t2;
+	double		lin_secs, idx_secs;
+
+	while ((c = getopt(argc, argv, "n:j:r:")) != -1) {
+		switch (c) {
+			case 'n':
+				nprocs = atoi(optarg);
+				break;
+			case 'j':
+				njobs = atoi(optarg);
+				break;
+			case 'r':
+				rounds = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n nprocs] [-j njobs] "
+					"[-r rounds]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (nprocs < 1 || njobs < 1 || rounds < 1) {
+		fprintf(stderr, "%s: arguments must be positive\n", argv[0]);
+		return 1;
+	}
+
+	fill_procs(nprocs, njobs);
+
+	gettimeofday(&t1, NULL);
+	for (r = 0; r < rounds; r++) {
+		for (j = 0; j < njobs; j++) {
+			pid_t	sid = 100000 + j;
+
+			for (i = 0; i < nproc; i++) {
+				if (proc_info[i].session != sid)
+					continue;
+				lin_sum += proc_info[i].utime + proc_info[i].stime +
+					proc_info[i].vsize;
+			}
+		}
+	}
+	gettimeofday(&t2, NULL);
+	lin_secs = elapsed(&t1, &t2) / rounds;
+
+	gettimeofday(&t1, NULL);
+	for (r = 0; r < rounds; r++) {
+		proc_sid_index_reset();		/* as mom_get_sample() does */
+		for (j = 0; j < njobs; j++) {
+			pid_t	sid = 100000 + j;
+
+			for (i = proc_sid_first(sid); i != -1; i = proc_sid_next[i])
+				idx_sum += proc_info[i].utime + proc_info[i].stime +
+					proc_info[i].vsize;
+		}
+	}
+	gettimeofday(&t2, NULL);
+	idx_secs = elapsed(&t1, &t2) / rounds;
+
+	printf("%8s %6s %14s %14s %9s %s\n",
+		"procs", "jobs", "linear(ms)", "indexed(ms)", "speedup", "sums");
+	printf("%8d %6d %14.3f %14.3f %8.1fx %s\n",
+		nprocs, njobs, lin_secs * 1000.0, idx_secs * 1000.0,
+		lin_secs / (idx_secs > 0 ? idx_secs : 1e-9),
+		lin_sum == idx_sum ? "ok" : "MISMATCH");
+
+	free(proc_info);
+	return (lin_sum == idx_sum ? 0 : 1);
+}
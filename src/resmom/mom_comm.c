@@ -2301,6 +2301,9 @@ node_bailout(job *pjob, hnodent *np)
 		/* this event in the list (keep_event==1) or delete it   */
 		nxtep = (eventent *)GET_NEXT(ep->ee_next);
 		if (keep_event == 0) {
+			if ((ep->ee_command == IM_JOIN_JOB) &&
+				(pjob->ji_join_pending > 0))
+				pjob->ji_join_pending--;
 			delete_link(&ep->ee_next);
 			free(ep);
 		} else {
@@ -2919,6 +2922,84 @@ recv_resc_used_from_sister(int stream, char *jobid, int nodeidx)
 	return (0);
 }
 
+/**
+ * @brief
+ *	Record the time a multi-node job reached a launch stage on
+ *	Mother Superior and log the stage latencies once the sisterhood
+ *	has joined and once the job has started.
+ *
+ * @param[in]	pjob	- job being launched
+ * @param[in]	stage	- LAUNCH_* stage just reached
+ *
+ * @return	void
+ */
+void
+launch_stage(job *pjob, int stage)
+{
+	double		*ts = pjob->ji_launch_ts;
+	struct timeval	tv;
+
+	if ((stage != LAUNCH_JOIN_SENT) && (ts[LAUNCH_JOIN_SENT] == 0.0))
+		return;		/* not a multi-node launch from this MoM */
+	if ((stage == LAUNCH_JOIN_FIRST) && (ts[LAUNCH_JOIN_FIRST] != 0.0))
+		return;
+
+	if (gettimeofday(&tv, NULL) == -1)
+		return;
+	ts[stage] = (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+
+	switch (stage) {
+		case LAUNCH_JOIN_DONE:
+			snprintf(log_buffer, sizeof(log_buffer),
+				"launch: %d sisters joined in %.3f secs, "
+				"first reply after %.3f secs",
+				pjob->ji_numnodes - 1,
+				ts[LAUNCH_JOIN_DONE] - ts[LAUNCH_JOIN_SENT],
+				ts[LAUNCH_JOIN_FIRST] - ts[LAUNCH_JOIN_SENT]);
+			log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_JOB, LOG_DEBUG,
+				pjob->ji_qs.ji_jobid, log_buffer);
+			break;
+
+		case LAUNCH_STARTED:
+			snprintf(log_buffer, sizeof(log_buffer),
+				"launch: job started %.3f secs after JOIN_JOB "
+				"was sent, %.3f secs after all sisters joined",
+				ts[LAUNCH_STARTED] - ts[LAUNCH_JOIN_SENT],
+				(ts[LAUNCH_JOIN_DONE] == 0.0) ? 0.0 :
+				ts[LAUNCH_STARTED] - ts[LAUNCH_JOIN_DONE]);
+			log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_JOB, LOG_DEBUG,
+				pjob->ji_qs.ji_jobid, log_buffer);
+			break;
+	}
+}
+
+/**
+ * @brief
+ *	Check whether Mother Superior is still waiting on any sister of
+ *	the job.  While JOIN_JOB replies are outstanding the answer comes
+ *	from ji_join_pending, so each reply during a large launch costs
+ *	O(1) rather than a walk over every host's event list.
+ *
+ * @param[in]	pjob	- job being launched
+ *
+ * @return	int
+ * @retval	1	- an event is outstanding
+ * @retval	0	- no events pending on any node
+ */
+static int
+sister_events_pending(job *pjob)
+{
+	int	i;
+
+	if (pjob->ji_join_pending > 0)
+		return 1;
+	for (i = 0; i < pjob->ji_numnodes; i++) {
+		if (GET_NEXT(pjob->ji_hosts[i].hn_events) != NULL)
+			return 1;
+	}
+	return 0;
+}
+
 /**
  * @brief
  *	General purpose function for executing actions that are done
@@ -3581,6 +3662,8 @@ join_err:
 		envp = ep->ee_envp;
 		delete_link(&ep->ee_next);
 		free(ep);
+		if ((event_com == IM_JOIN_JOB) && (pjob->ji_join_pending > 0))
+			pjob->ji_join_pending--;
 	}
 
 	switch (command) {
@@ -4434,25 +4517,21 @@ join_err:
 							goto err;
 					}
 
-					for (i=0; i<pjob->ji_numnodes; i++) {
-						hnodent *xp = &pjob->ji_hosts[i];
-						if ((ep = (eventent *)GET_NEXT(xp->hn_events))
-							!= NULL)
-							break;
-					}
+					launch_stage(pjob, LAUNCH_JOIN_FIRST);
 
 					if (do_tolerate_node_failures(pjob) &&
 					    (nodeidx > 0) && (nodeidx < pjob->ji_numnodes)) {
 						reliable_job_node_add(&pjob->ji_node_list, pjob->ji_hosts[nodeidx].hn_host);
 					}
 
-					if (ep == NULL) {	/* no events */
+					if (!sister_events_pending(pjob)) {	/* no events */
 						int rcode;
 						int do_break = 0;
 						/*
 						 * All the JOIN messages have come in.
 						 * Call job_join_extra for local MS setup.
 						 */
+						launch_stage(pjob, LAUNCH_JOIN_DONE);
 						rcode = pre_finish_exec(pjob, 1);
 						switch (rcode) {
 						  case PRE_FINISH_SUCCESS_JOB_SETUP_SEND:
@@ -4954,12 +5033,7 @@ join_err:
 					if (!do_tolerate_node_failures(pjob))
 						break;
 
-					for (i = 0; i < pjob->ji_numnodes; i++) {
-						hnodent *xp = &pjob->ji_hosts[i];
-						if ((ep = (eventent *)GET_NEXT(xp->hn_events)) != NULL)
-							break;
-					}
-					if (ep == NULL) {	/* no events */
+					if (!sister_events_pending(pjob)) {	/* no events */
 						int rcode;
 						int do_break = 0;
 
@@ -44,6 +44,7 @@
 #include <unistd.h>
 #include <sys/param.h>
 #include <dirent.h>
+#include <sys/time.h>
 #endif
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -120,6 +121,7 @@ extern	pbs_list_head	svr_alljobs;
 extern	int		svr_hook_resend_job_attrs;
 
 extern	char		*msg_err_malloc;
+extern	pid_t		mom_pid;
 
 extern	time_t		time_now;
 
@@ -682,6 +684,11 @@ run_hook(hook *phook, unsigned int event_type, mom_hook_input_t *hook_input,
 	char		pypath[MAXPATHLEN+1];
 	pid_t		child;
 	struct stat	sbuf;
+#ifndef WIN32
+	struct timeval	run_start;
+	struct timeval	run_end;
+	int		use_pool = 0; /* if 1, hand the hook to a pool worker */
+#endif
 	int		runas_jobuser = 0; /* if 1, run as job's euser */
 	struct	work_task *ptask;
 	vnl_t		*vnl = NULL;
@@ -788,6 +795,15 @@ run_hook(hook *phook, unsigned int event_type, mom_hook_input_t *hook_input,
 		runas_jobuser = 1;
 
 #ifndef WIN32
+	/*
+	 * The worker pool belongs to the main MoM.  run_hook() called from a
+	 * forked child, as for execjob_launch, execs pbs_python itself.
+	 */
+	if (!runas_jobuser && (getpid() == mom_pid)) {
+		use_pool = 1;
+		hook_pool_check();
+	}
+	(void)gettimeofday(&run_start, NULL);
 	child = fork();
 	if (child > 0) {	/* parent */
 
@@ -826,6 +842,14 @@ run_hook(hook *phook, unsigned int event_type, mom_hook_input_t *hook_input,
 			log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_HOOK, LOG_INFO,
 				phook->hook_name, log_buffer);
 		}
+		(void)gettimeofday(&run_end, NULL);
+		snprintf(log_buffer, sizeof(log_buffer),
+			"%s hook ran in %.3f secs",
+			hook_event_as_string(event_type),
+			(run_end.tv_sec - run_start.tv_sec) +
+			(run_end.tv_usec - run_start.tv_usec) / 1000000.0);
+		log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_HOOK, LOG_INFO,
+			phook->hook_name, log_buffer);
 
 	} else {		/* child */
 		(void)setsid();
@@ -1368,6 +1392,10 @@ run_hook(hook *phook, unsigned int event_type, mom_hook_input_t *hook_input,
 		}
 	}
 
+	/* hand the request to a pre-started pbs_python if one is up */
+	if (use_pool)
+		(void)hook_pool_exec(arg, hook_config_path);
+
 	execve(pypath, arg, environ);
 run_hook_exit:
 	if (fp != NULL) {
@@ -0,0 +1,423 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+
+/**
+ * @file	mom_hook_pool.c
+ *
+ * @brief
+ *	Pool of pre-started pbs_python hook workers.
+ *
+ *	Each worker is "pbs_python --hook-worker": it starts the Python
+ *	interpreter and loads the pbs module once, keeps hook scripts
+ *	compiled, and forks a copy of itself for every hook request.
+ *	The child of run_hook() hands its "pbs_python --hook" argument
+ *	vector to a worker instead of executing pbs_python, and exits
+ *	with the status of the hook process, so timeouts and background
+ *	hooks are handled by the caller exactly as before.  When no
+ *	worker can take a request the caller falls back to execve().
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pbs_ifl.h"
+#include "libpbs.h"
+#include "list_link.h"
+#include "work_task.h"
+#include "hook.h"
+#include "log.h"
+#include "server_limits.h"
+
+
+int		hook_pool_size = 0;	/* $hook_worker_pool */
+
+extern	char		*path_hooks;
+extern	char		*path_log;
+extern	char		**environ;
+extern	char		*msg_err_malloc;
+
+struct hook_worker {
+	pid_t	hw_pid;		/* worker process, -1 if none */
+	int	hw_ctl;		/* control socket to the worker */
+};
+
+static struct hook_worker *hook_pool = NULL;
+static int	hook_pool_nworkers = 0;
+static time_t	hook_pool_rescdef_mtime = 0;
+
+/**
+ * @brief
+ *	Return the modification time of the hooks resourcedef file,
+ *	0 if there is none.
+ */
+static time_t
+hook_pool_rescdef(char *path, size_t len)
+{
+	struct stat	sbuf;
+
+	snprintf(path, len, "%s%s", path_hooks, PBS_RESCDEF);
+	if (stat(path, &sbuf) != 0)
+		return 0;
+	return sbuf.st_mtime;
+}
+
+/**
+ * @brief
+ *	Work task run when a hook worker has exited: forget it so that
+ *	hook_pool_check() starts a new one.
+ *
+ * @param[in]	ptask	- work task, wt_event holds the worker pid
+ *
+ * @return	void
+ */
+static void
+hook_pool_reap(struct work_task *ptask)
+{
+	int	i;
+
+	for (i = 0; i < hook_pool_nworkers; i++) {
+		if (hook_pool[i].hw_pid == (pid_t)ptask->wt_event) {
+			sprintf(log_buffer, "hook worker %d exited, status %d",
+				hook_pool[i].hw_pid, ptask->wt_aux);
+			log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_HOOK,
+				LOG_INFO, __func__, log_buffer);
+			if (hook_pool[i].hw_ctl != -1)
+				close(hook_pool[i].hw_ctl);
+			hook_pool[i].hw_ctl = -1;
+			hook_pool[i].hw_pid = -1;
+			break;
+		}
+	}
+}
+
+/**
+ * @brief
+ *	Start one pbs_python hook worker in slot 'w'.
+ *
+ * @param[in]	w	- pool slot to fill
+ * @param[in]	rescdef	- hooks resourcedef file, NULL if none
+ *
+ * @return	int
+ * @retval	0	- worker started
+ * @retval	-1	- error, logged
+ */
+static int
+hook_pool_spawn(struct hook_worker *w, char *rescdef)
+{
+	int	sv[2];
+	int	fd;
+	pid_t	pid;
+	char	pypath[MAXPATHLEN+1];
+	char	logmask[32];
+	char	*arg[10];
+	int	n = 0;
+
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv) == -1) {
+		log_err(errno, __func__, "socketpair");
+		return -1;
+	}
+	snprintf(pypath, sizeof(pypath), "%s/bin/pbs_python",
+		pbs_conf.pbs_exec_path);
+	snprintf(logmask, sizeof(logmask), "%ld", *log_event_mask);
+
+	pid = fork();
+	if (pid == -1) {
+		log_err(errno, __func__, "fork");
+		close(sv[0]);
+		close(sv[1]);
+		return -1;
+	}
+	if (pid == 0) {		/* child, becomes the worker */
+		(void)setsid();
+		if (dup2(sv[1], 0) == -1)
+			exit(1);
+		fd = open("/dev/null", O_RDWR);
+		if (fd != -1) {
+			(void)dup2(fd, 1);
+			(void)dup2(fd, 2);
+		}
+		for (fd = sysconf(_SC_OPEN_MAX) - 1; fd > 2; fd--)
+			(void)close(fd);
+		if (pbs_conf.pbs_conf_file != NULL)
+			(void)setenv("PBS_CONF_FILE", pbs_conf.pbs_conf_file, 1);
+		if (chdir(path_hooks) == -1)
+			exit(1);
+
+		arg[n++] = pypath;
+		arg[n++] = HOOK_WORKER_MODE;
+		arg[n++] = "-L";
+		arg[n++] = path_log;
+		arg[n++] = "-e";
+		arg[n++] = logmask;
+		if (rescdef != NULL) {
+			arg[n++] = "-r";
+			arg[n++] = rescdef;
+		}
+		arg[n] = NULL;
+		execve(pypath, arg, environ);
+		exit(1);
+	}
+
+	close(sv[1]);
+	(void)fcntl(sv[0], F_SETFD, FD_CLOEXEC);
+	w->hw_pid = pid;
+	w->hw_ctl = sv[0];
+	if (set_task(WORK_Deferred_Child, pid, hook_pool_reap, NULL) == NULL)
+		log_err(errno, __func__, "set_task");
+
+	sprintf(log_buffer, "started hook worker %d", pid);
+	log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_HOOK, LOG_INFO,
+		__func__, log_buffer);
+	return 0;
+}
+
+/**
+ * @brief
+ *	Stop all hook workers.  Closing the control socket makes a
+ *	worker exit once the hooks it is running are done.
+ *
+ * @return	void
+ */
+void
+hook_pool_stop(void)
+{
+	int	i;
+
+	for (i = 0; i < hook_pool_nworkers; i++) {
+		if (hook_pool[i].hw_ctl != -1)
+			close(hook_pool[i].hw_ctl);
+		hook_pool[i].hw_ctl = -1;
+		hook_pool[i].hw_pid = -1;
+	}
+	free(hook_pool);
+	hook_pool = NULL;
+	hook_pool_nworkers = 0;
+}
+
+/**
+ * @brief
+ *	Make the pool match $hook_worker_pool before a hook is run:
+ *	start missing workers and restart all of them when the hooks
+ *	resourcedef file changed, since custom resource types are
+ *	loaded into a worker's interpreter when it starts.
+ *
+ * @return	void
+ */
+void
+hook_pool_check(void)
+{
+	char	rescdef[MAXPATHLEN+1];
+	time_t	mtime;
+	int	i;
+
+	mtime = hook_pool_rescdef(rescdef, sizeof(rescdef));
+	if ((hook_pool_nworkers != hook_pool_size) ||
+		(mtime != hook_pool_rescdef_mtime))
+		hook_pool_stop();
+	if (hook_pool_size <= 0)
+		return;
+
+	if (hook_pool == NULL) {
+		hook_pool = (struct hook_worker *)malloc(hook_pool_size *
+			sizeof(struct hook_worker));
+		if (hook_pool == NULL) {
+			log_err(errno, __func__, msg_err_malloc);
+			return;
+		}
+		for (i = 0; i < hook_pool_size; i++) {
+			hook_pool[i].hw_pid = -1;
+			hook_pool[i].hw_ctl = -1;
+		}
+		hook_pool_nworkers = hook_pool_size;
+		hook_pool_rescdef_mtime = mtime;
+	}
+
+	for (i = 0; i < hook_pool_nworkers; i++) {
+		if (hook_pool[i].hw_pid == -1)
+			(void)hook_pool_spawn(&hook_pool[i],
+				(mtime != 0) ? rescdef : NULL);
+	}
+}
+
+/**
+ * @brief
+ *	Read exactly 'len' bytes from 'fd'.
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	-1	- error or end of file
+ */
+static int
+hook_pool_readn(int fd, void *buf, size_t len)
+{
+	char	*p = buf;
+	ssize_t	n;
+
+	while (len > 0) {
+		n = read(fd, p, len);
+		if (n == -1 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return -1;
+		p += n;
+		len -= n;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Called in the child forked by run_hook() in place of executing
+ *	pbs_python: pass the hook request to a pool worker and exit
+ *	with the wait status of the hook process it runs.
+ *
+ * @param[in]	argv	- the "pbs_python --hook" argument vector
+ * @param[in]	config	- PBS_HOOK_CONFIG_FILE for the hook, or empty
+ *
+ * @return	int
+ * @retval	-1	- no worker took the request; caller should exec
+ *			  pbs_python itself.  Does not return otherwise.
+ */
+int
+hook_pool_exec(char **argv, char *config)
+{
+	struct hook_worker_hdr	hdr;
+	struct msghdr	msg;
+	struct iovec	iov;
+	struct cmsghdr	*cmsg;
+	union {
+		struct cmsghdr	cm;
+		char		buf[CMSG_SPACE(sizeof(int))];
+	} cbuf;
+	char	cwd[MAXPATHLEN+1];
+	char	*req;
+	char	*p;
+	char	c = 'r';
+	int	sv[2];
+	int	i, w;
+	pid_t	hpid;
+	int	status;
+
+	if (hook_pool_nworkers <= 0)
+		return -1;
+	for (i = 0; i < hook_pool_nworkers; i++) {
+		w = (getpid() + i) % hook_pool_nworkers;
+		if (hook_pool[w].hw_ctl != -1)
+			break;
+	}
+	if (i == hook_pool_nworkers)
+		return -1;
+	if (getcwd(cwd, sizeof(cwd)) == NULL)
+		return -1;
+
+	hdr.hw_nstr = 2;
+	hdr.hw_len = strlen(cwd) + strlen(config) + 2;
+	for (i = 0; argv[i] != NULL; i++) {
+		hdr.hw_nstr++;
+		hdr.hw_len += strlen(argv[i]) + 1;
+	}
+	if (hdr.hw_len > HOOK_WORKER_MAXREQ)
+		return -1;
+	if ((req = malloc(sizeof(hdr) + hdr.hw_len)) == NULL)
+		return -1;
+	memcpy(req, &hdr, sizeof(hdr));
+	p = req + sizeof(hdr);
+	p += sprintf(p, "%s", cwd) + 1;
+	p += sprintf(p, "%s", config) + 1;
+	for (i = 0; argv[i] != NULL; i++)
+		p += sprintf(p, "%s", argv[i]) + 1;
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == -1) {
+		free(req);
+		return -1;
+	}
+	/* the whole request is queued before the worker is told about it */
+	if (write(sv[0], req, p - req) != p - req) {
+		free(req);
+		close(sv[0]);
+		close(sv[1]);
+		return -1;
+	}
+	free(req);
+
+	memset(&msg, 0, sizeof(msg));
+	iov.iov_base = &c;
+	iov.iov_len = 1;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = cbuf.buf;
+	msg.msg_controllen = sizeof(cbuf.buf);
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &sv[1], sizeof(int));
+
+	i = sendmsg(hook_pool[w].hw_ctl, &msg, MSG_NOSIGNAL);
+	close(sv[1]);
+	/* no pid back means the worker never started the hook */
+	if ((i != 1) || (hook_pool_readn(sv[0], &hpid, sizeof(hpid)) != 0)) {
+		close(sv[0]);
+		return -1;
+	}
+
+	sprintf(log_buffer, "hook running in worker %d as pid %d",
+		hook_pool[w].hw_pid, hpid);
+	log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_HOOK, LOG_INFO,
+		__func__, log_buffer);
+
+	if (hook_pool_readn(sv[0], &status, sizeof(status)) != 0)
+		exit(255);
+	if (WIFEXITED(status))
+		exit(WEXITSTATUS(status));
+	if (WIFSIGNALED(status)) {
+		(void)signal(WTERMSIG(status), SIG_DFL);
+		(void)kill(getpid(), WTERMSIG(status));
+	}
+	exit(255);
+}
@@ -123,6 +123,7 @@
 #include	"mom_mach.h"
 #endif	/* MOM_CSA or MOM_ALPS */
 #include	"pbs_reliable.h"
+#include	"pbs_trace.h"
 
 #define STATE_UPDATE_TIME 10
 #ifndef	PRIO_MAX
@@ -208,6 +209,10 @@ int		inc_check_poll = 20;
 int		num_acpus = 1;
 int		num_pcpus = 1;
 int		num_oscpus = 1;
+#ifdef	linux
+int		proc_sample_mode = PROC_SAMPLE_FULL;
+char		*proc_sample_cgroup_prefix = NULL;
+#endif	/* linux */
 u_Long		av_phy_mem = 0;	/* physical memory in KB */
 int		num_var_env;
 char	       *path_epilog;
@@ -261,6 +266,7 @@ unsigned int	pbs_rm_port;
 pbs_list_head	mom_polljobs;	/* jobs that must have resource limits polled */
 pbs_list_head	mom_deadjobs;	/* jobs that need to purged, see chk_del_job */
 int		server_stream = -1;
+int		svr_rused_gen = 0;	/* bumped when resources_used must be resent in full */
 pbs_list_head	svr_newjobs;	/* jobs being sent to MOM */
 pbs_list_head	svr_alljobs;	/* all jobs under MOM's control */
 time_t		time_last_sample = 0;
@@ -462,8 +468,14 @@ static handler_ret_t	set_cpuset_error_action(char *);
 #endif	/* MOM_CPUSET && CPUSET_VERSION >= 4 */
 static handler_ret_t	parse_config(char *);
 static handler_ret_t	prologalarm(char *);
+#ifdef	linux
+static handler_ret_t	set_proc_sample_mode(char *);
+#endif	/* linux */
 static handler_ret_t	set_joinjob_alarm(char *);
 static handler_ret_t	set_job_launch_delay(char *);
+#ifndef	WIN32
+static handler_ret_t	set_hook_worker_pool(char *);
+#endif	/* WIN32 */
 static handler_ret_t	restricted(char *);
 static handler_ret_t	set_alien_attach(char *);
 static handler_ret_t	set_alien_kill(char *);
@@ -554,6 +566,9 @@ static struct	specials {
 	{ "cpuset_error_action",	set_cpuset_error_action },
 #endif	/* MOM_CPUSET && CPUSET_VERSION >= 4 */
 	{ "enforce",			set_enforcement },
+#ifndef	WIN32
+	{ "hook_worker_pool",		set_hook_worker_pool },
+#endif	/* WIN32 */
 	{ "ideal_load",			setidealload },
 	{ "jobdir_root",		set_jobdir_root },
 	{ "kbd_idle",			set_kbd_idle },
@@ -568,6 +583,9 @@ static struct	specials {
 #endif
 	{ "port",			set_momport },
 	{ "prologalarm",		prologalarm },
+#ifdef	linux
+	{ "proc_sample_mode",		set_proc_sample_mode },
+#endif	/* linux */
 	{ "sister_join_job_alarm",	set_joinjob_alarm },
 	{ "job_launch_delay",		set_job_launch_delay },
 	{ "restart_background",		set_restart_background },
@@ -2449,6 +2467,35 @@ set_job_launch_delay(char *value)
 	return HANDLER_SUCCESS;
 }
 
+#ifndef	WIN32
+/**
+ * @brief
+ *	Handler function for the $hook_worker_pool config option, the
+ *	number of pre-started pbs_python processes used to run hooks
+ *	that execute as root.  0 runs every hook in a new pbs_python.
+ *
+ * @param[in]	value - the input given in config file.
+ *
+ * @return handler_ret_t
+ * @retval HANDLER_SUCCESS
+ * @retval HANDLER_FAIL
+ */
+static handler_ret_t
+set_hook_worker_pool(char *value)
+{
+	long i;
+	char *endp;
+
+	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_NOTICE,
+		"hook_worker_pool", value);
+	i = strtol(value, &endp, 10);
+	if ((*endp != '\0') || (i < 0) || (i > 64))
+		return HANDLER_FAIL;	/* error */
+	hook_pool_size = (int)i;
+	return HANDLER_SUCCESS;
+}
+#endif	/* WIN32 */
+
 #ifdef	WIN32
 
 /**
@@ -3550,6 +3597,61 @@ set_max_poll_downtime(char *value)
 	return HANDLER_SUCCESS;
 }
 
+#ifdef	linux
+/**
+ * @brief
+ *	process $proc_sample_mode directive in config file:
+ *	$proc_sample_mode full|session|cgroup [cgroup_prefix]
+ *
+ *	"full" reads every process in /proc at each sample.  "session"
+ *	reads only the processes of job sessions, tracked through kernel
+ *	process events.  "cgroup" does the same and takes cput, mem and
+ *	vmem from the job cgroups made by the cgroups hook, whose parent
+ *	directory is cgroup_prefix (default "pbspro").
+ *
+ * @param[in] value - value for the directive
+ *
+ * @return      handler_ret_t
+ * @retval      HANDLER_FAIL            Failure
+ * @retval      HANDLER_SUCCESS         Success
+ *
+ */
+static handler_ret_t
+set_proc_sample_mode(char *value)
+{
+	char	*mode;
+	char	*prefix;
+
+	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER,
+		LOG_INFO, "proc_sample_mode", value);
+	mode = strtok(value, " \t");
+	if (mode == NULL)
+		return HANDLER_FAIL;
+	prefix = strtok(NULL, " \t");
+
+	if (strcasecmp(mode, "full") == 0)
+		proc_sample_mode = PROC_SAMPLE_FULL;
+	else if (strcasecmp(mode, "session") == 0)
+		proc_sample_mode = PROC_SAMPLE_SESSION;
+	else if (strcasecmp(mode, "cgroup") == 0)
+		proc_sample_mode = PROC_SAMPLE_CGROUP;
+	else
+		return HANDLER_FAIL;
+
+	if (proc_sample_cgroup_prefix != NULL) {
+		free(proc_sample_cgroup_prefix);
+		proc_sample_cgroup_prefix = NULL;
+	}
+	if (prefix != NULL) {
+		if (proc_sample_mode != PROC_SAMPLE_CGROUP)
+			return HANDLER_FAIL;
+		if ((proc_sample_cgroup_prefix = strdup(prefix)) == NULL)
+			return HANDLER_FAIL;
+	}
+	return HANDLER_SUCCESS;
+}
+#endif	/* linux */
+
 /**
  * @brief
  *	process $kbd_idle directive in config file:
@@ -4934,6 +5036,16 @@ read_config(char *file)
 	alps_confirm_switch_timeout = ALPS_CONF_SWITCH_TIMEOUT;
 	set_alps_client(NULL);
 #endif /* MOM_ALPS */
+#ifndef	WIN32
+	hook_pool_size = 0;
+#endif	/* WIN32 */
+#ifdef	linux
+	proc_sample_mode = PROC_SAMPLE_FULL;
+	if (proc_sample_cgroup_prefix != NULL) {
+		free(proc_sample_cgroup_prefix);
+		proc_sample_cgroup_prefix = NULL;
+	}
+#endif	/* linux */
 
 	strcpy(pbs_jobdir_root, "");
 	restrict_user = 0;
@@ -6511,6 +6623,9 @@ finish_loop(time_t waittime)
 		waittime = next_sample_time;
 	DBPRT(("%s: waittime %lu\n", __func__, (unsigned long) waittime))
 
+	/* write out the spans of the last pass before sleeping */
+	trace_flush();
+
 	/* wait for a request to process */
 	if (wait_request(waittime) != 0)
 		log_err(-1, msg_daemonname, "wait_request failed");
@@ -9665,6 +9780,10 @@ main(int argc, char *argv[])
 	if (pbs_conf.pbs_use_tcp == 0)
 		send_restart();
 
+	/* in the background now, hand logging to the writer thread if configured */
+	(void)log_async_start();
+	(void)trace_open(path_log, "mom");
+
 #ifdef	WIN32
 	/* put here to minimize chance of hanging up or delaying mom startup */
 	initialize();
@@ -10186,6 +10305,7 @@ main(int argc, char *argv[])
 	cleanup();
 	log_event(PBSEVENT_SYSTEM | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER,
 		LOG_NOTICE, msg_daemonname, "Is down");
+	trace_close();
 	log_close(1);
 #ifdef	WIN32
 	mom_lock(lockfds, F_UNLCK);     /* unlock  */
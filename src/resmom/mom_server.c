@@ -118,6 +118,7 @@ extern  int		svr_hook_resend_job_attrs;
 extern  int 		mom_recvd_ip_cluster_addrs;
 
 extern  int		server_stream;
+extern  int		svr_rused_gen;
 extern  int		enable_exechost2;
 extern  vnl_t		*vnlp;        	   /* vnode list */
 extern  vnl_t		*vnlp_from_hook;   /* vnode list updates from hook */
@@ -815,6 +816,7 @@ is_request(int stream, int version)
 			 * does "vnodes".
 			 */
 			server_stream = stream;		/* save stream to server */
+			svr_rused_gen++;		/* resend all resources_used */
 			next_sample_time = min_check_poll;
 			reply_hello4(stream);
 			internal_state_update = UPDATE_MOM_STATE;
@@ -828,6 +830,7 @@ is_request(int stream, int version)
 			DBPRT(("%s: IS_HELLO_NO_INVENTORY, state=0x%x stream=%d\n", __func__,
 				internal_state, stream))
 			server_stream = stream;         /* save stream to server */
+			svr_rused_gen++;		/* resend all resources_used */
 			next_sample_time = min_check_poll;
 			reply_hello4(stream);
 			internal_state_update = UPDATE_MOM_STATE;
@@ -1572,6 +1575,7 @@ err:
 	if (errno != 10054)
 #endif
 		log_err(errno, "send_resc_used", log_buffer);
+	svr_rused_gen++;	/* update lost, resend all resources_used */
 
 	if (cmd != IS_RESCUSED_FROM_HOOK) {
 		rpp_close(server_stream);
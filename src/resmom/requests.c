@@ -4569,20 +4569,16 @@ update_vnodes_on_resourcedef_change(char **deleted_resources)
 
 /**
  * @brief
- *	Receive a hook-related file.
+ *	Install one hook-related file received from the server.
+ *
+ * @param[in]	filename - the basename (including suffix) of the target
+ *			   hook file.
+ * @param[in]	seq - sequence of this chunk of the file, 0 for the first.
+ * @param[in]	data - the file data.
+ * @param[in]	size - the size of 'data'.
  *
- *  @param[in] 	preq - Pointer to batch request structure for a Copy Hook
- *			request.
- *			The 'preq' parameter holds:
- * 			- preq->rq_ind.rq_hookfile.rq_filename - the basename
- *			  including suffix)  of the target hook file.
- *			- preq->rq_ind.rq_hookfile.rq_data contains the hook
- *			  data.
- *			- preq->rq_ind.rq_hookfile.rq_size is the size of
- *			  rq_data.
  * @note
- *	The idea is to put contents (preq->rq_ind.rq_hookfile.rq_data) into
- *	[PATH_HOOKS]/<preq->rq_ind.rq_hookfile.rq_filename>
+ *	The idea is to put contents 'data' into [PATH_HOOKS]/<filename>
  *
  *	If the file received is for a periodic hook, then attempt is made
  *	to instantiate the hook, if none is queued up for execution.
@@ -4593,12 +4589,13 @@ update_vnodes_on_resourcedef_change(char **deleted_resources)
  *		<file_name>HOOK_SCRIPT_SUFFIX
  *		PBS_RESCDEF
  *
- * @return 	Void
+ * @return	int
+ * @retval	PBSE_NONE	the file was installed
+ * @retval	other		PBS error code to reject the request with
  *
  */
-
-void
-req_copy_hookfile(struct batch_request *preq) /* ptr to the decoded request   */
+static int
+copy_hookfile(char *filename, int seq, char *data, long size)
 {
 	int	filemode = 0700;
 	int	fds;
@@ -4614,48 +4611,40 @@ req_copy_hookfile(struct batch_request *preq) /* ptr to the decoded request   */
 	int	oflag;
 	char	**prev_resources = NULL;
 
-	if (reject_root_scripts == TRUE) {
-		log_err(-1, __func__, msg_mom_reject_root_scripts);
-		req_reject(PBSE_MOM_REJECT_ROOT_SCRIPTS, 0, preq);
-		return;
-	}
-
-	p = strstr(preq->rq_ind.rq_hookfile.rq_filename, HOOK_FILE_SUFFIX);
+	p = strstr(filename, HOOK_FILE_SUFFIX);
 	if ((p != NULL) && (strcmp(p, HOOK_FILE_SUFFIX) == 0)) {
 		is_hook_cntrl_file = 1;
 	}
 	if (!is_hook_cntrl_file) {
-		p = strstr(preq->rq_ind.rq_hookfile.rq_filename, HOOK_SCRIPT_SUFFIX);
+		p = strstr(filename, HOOK_SCRIPT_SUFFIX);
 		if ((p != NULL) && (strcmp(p, HOOK_SCRIPT_SUFFIX) == 0))
 			is_hook_script_file = 1;
 	}
 
 	if (!is_hook_cntrl_file && !is_hook_script_file) {
-		p = strstr(preq->rq_ind.rq_hookfile.rq_filename, HOOK_CONFIG_SUFFIX);
+		p = strstr(filename, HOOK_CONFIG_SUFFIX);
 		if ((p != NULL) && (strcmp(p, HOOK_CONFIG_SUFFIX) == 0))
 			is_hook_config_file = 1;
 	}
 
 	if (!is_hook_cntrl_file && !is_hook_script_file &&
 		!is_hook_config_file) {
-		p = strstr(preq->rq_ind.rq_hookfile.rq_filename, PBS_RESCDEF);
+		p = strstr(filename, PBS_RESCDEF);
 		if ((p == NULL) || (strcmp(p, PBS_RESCDEF) != 0)) {
 			log_err(errno, __func__, "malformed request");
-			req_reject(PBSE_INTERNAL, 0, preq);
-			return;
+			return PBSE_INTERNAL;
 		}
 		is_hook_resourcedef_file = 1;
 	}
 
-	snprintf(namebuf, sizeof(namebuf), "%s%s", path_hooks,
-		preq->rq_ind.rq_hookfile.rq_filename);
+	snprintf(namebuf, sizeof(namebuf), "%s%s", path_hooks, filename);
 
 	/* Resources prior to update of the resourcedef file */
 	if (is_hook_resourcedef_file) {
 		prev_resources = get_resources_from_file(namebuf);
 	}
 
-	if (preq->rq_ind.rq_hookfile.rq_sequence == 0) { /* 1st chunk of data */
+	if (seq == 0) { /* 1st chunk of data */
 		oflag = O_TRUNC|O_RDWR|O_CREAT|O_Sync;
 	} else {
 		oflag = O_RDWR|O_APPEND|O_CREAT|O_Sync;
@@ -4665,9 +4654,8 @@ req_copy_hookfile(struct batch_request *preq) /* ptr to the decoded request   */
 
 	if (fds < 0) {
 		log_err(errno, __func__, msg_hookfile_open);
-		req_reject(PBSE_SYSTEM, 0, preq);
 		free_str_array(prev_resources);
-		return;
+		return PBSE_SYSTEM;
 	}
 
 #ifdef WIN32
@@ -4675,14 +4663,11 @@ req_copy_hookfile(struct batch_request *preq) /* ptr to the decoded request   */
 	setmode(fds, O_BINARY);
 #endif /* WIN32 */
 
-	if (write(fds, preq->rq_ind.rq_hookfile.rq_data,
-		(unsigned)preq->rq_ind.rq_hookfile.rq_size) !=
-		preq->rq_ind.rq_hookfile.rq_size) {
+	if (write(fds, data, (unsigned)size) != size) {
 		log_err(errno, __func__, msg_hookfile_write);
-		req_reject(PBSE_SYSTEM, 0, preq);
 		(void)close(fds);
 		free_str_array(prev_resources);
-		return;
+		return PBSE_SYSTEM;
 	}
 
 	if (is_hook_cntrl_file) {
@@ -4698,12 +4683,11 @@ req_copy_hookfile(struct batch_request *preq) /* ptr to the decoded request   */
 		if ((phook=hook_recov(namebuf, fp, hook_msg, HOOK_MSG_SIZE,
 			python_script_alloc, python_script_free)) == NULL) {
 			log_err(-1, __func__, hook_msg);
-			req_reject(PBSE_SYSTEM, 0, preq);
 			if (fp != NULL)
 				(void)fclose(fp);
 			else
 				(void)close(fds);
-			return;
+			return PBSE_SYSTEM;
 		} else {
 
 			hook  *phook2;
@@ -4774,9 +4758,8 @@ req_copy_hookfile(struct batch_request *preq) /* ptr to the decoded request   */
 					if (python_script_alloc(namebuf,
 						(struct python_script **)&phook->script) == -1) {
 						log_err(-1, __func__, "python_script_alloc call failed!");
-						req_reject(PBSE_SYSTEM, 0, preq);
 						(void)close(fds);
-						return;
+						return PBSE_SYSTEM;
 					}
 				} else if (is_hook_config_file) {
 					strcat(p, HOOK_CONFIG_SUFFIX);
@@ -4836,9 +4819,109 @@ req_copy_hookfile(struct batch_request *preq) /* ptr to the decoded request   */
 		hooks_rescdef_checksum = crc_file(namebuf);
 	}
 
+	return PBSE_NONE;
+}
+
+/**
+ * @brief
+ *	Receive a hook-related file.
+ *
+ *  @param[in] 	preq - Pointer to batch request structure for a Copy Hook
+ *			request.
+ *			The 'preq' parameter holds:
+ * 			- preq->rq_ind.rq_hookfile.rq_filename - the basename
+ *			  including suffix)  of the target hook file.
+ *			- preq->rq_ind.rq_hookfile.rq_data contains the hook
+ *			  data.
+ *			- preq->rq_ind.rq_hookfile.rq_size is the size of
+ *			  rq_data.
+ *
+ * @return 	Void
+ *
+ */
+
+void
+req_copy_hookfile(struct batch_request *preq) /* ptr to the decoded request   */
+{
+	int	rc;
+
+	if (reject_root_scripts == TRUE) {
+		log_err(-1, __func__, msg_mom_reject_root_scripts);
+		req_reject(PBSE_MOM_REJECT_ROOT_SCRIPTS, 0, preq);
+		return;
+	}
+
+	rc = copy_hookfile(preq->rq_ind.rq_hookfile.rq_filename,
+		preq->rq_ind.rq_hookfile.rq_sequence,
+		preq->rq_ind.rq_hookfile.rq_data,
+		preq->rq_ind.rq_hookfile.rq_size);
+	if (rc != PBSE_NONE) {
+		req_reject(rc, 0, preq);
+		return;
+	}
+
 	reply_ack(preq);
 }
 
+/**
+ * @brief
+ *	Receive a hook bundle: the hook-related files of one hook, sent
+ *	together and named by the hash of their contents.
+ *
+ *  @param[in] 	preq - Pointer to batch request structure for a Copy Hook
+ *			Bundle request.
+ *			- preq->rq_ind.rq_hookbundle.rq_hash - the bundle hash
+ *			  computed by the server.
+ *			- preq->rq_ind.rq_hookbundle.rq_files and rq_count -
+ *			  the files, in the order to install them.
+ *
+ * @note
+ *	The hash is recomputed over what was received and nothing is
+ *	installed unless it matches.  The reply carries the hash back as
+ *	text; the server only counts the bundle as delivered when it gets
+ *	its own hash back.
+ *
+ * @return 	Void
+ *
+ */
+
+void
+req_copy_hookbundle(struct batch_request *preq)
+{
+	struct rq_hookbundle *pbundle = &preq->rq_ind.rq_hookbundle;
+	char	hash[HOOK_BUNDLE_HASH_SIZE+1];
+	int	i;
+	int	rc;
+
+	if (reject_root_scripts == TRUE) {
+		log_err(-1, __func__, msg_mom_reject_root_scripts);
+		req_reject(PBSE_MOM_REJECT_ROOT_SCRIPTS, 0, preq);
+		return;
+	}
+
+	if ((pbs_hook_bundle_hash(pbundle->rq_files, pbundle->rq_count,
+		hash) != 0) || (strcmp(hash, pbundle->rq_hash) != 0)) {
+		snprintf(log_buffer, sizeof(log_buffer),
+			"hook bundle %s does not match its contents",
+			pbundle->rq_hash);
+		log_err(-1, __func__, log_buffer);
+		req_reject(PBSE_PROTOCOL, 0, preq);
+		return;
+	}
+
+	for (i = 0; i < pbundle->rq_count; i++) {
+		rc = copy_hookfile(pbundle->rq_files[i].hbf_name, 0,
+			pbundle->rq_files[i].hbf_data,
+			pbundle->rq_files[i].hbf_size);
+		if (rc != PBSE_NONE) {
+			req_reject(rc, 0, preq);
+			return;
+		}
+	}
+
+	(void)reply_text(preq, PBSE_NONE, hash);
+}
+
 /**
  * @brief
  *	Receive a request to delete a hook-related file.
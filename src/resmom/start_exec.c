@@ -96,6 +96,7 @@
 #include "placementsets.h"
 #include "pbs_internal.h"
 #include "pbs_reliable.h"
+#include "pbs_trace.h"
 
 #define	PIPE_READ_TIMEOUT	5
 #define EXTRA_ENV_PTRS	       32
@@ -1814,6 +1815,8 @@ record_finish_exec(int sd)
 	sprintf(log_buffer, "Started, pid = %d", sjr.sj_session);
 	log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, LOG_INFO,
 		pjob->ji_qs.ji_jobid, log_buffer);
+	launch_stage(pjob, LAUNCH_STARTED);
+	trace_span(pjob->ji_trace, pjob->ji_qs.ji_jobid, "exec");
 
 	return;
 }
@@ -5172,7 +5175,8 @@ start_process(task *ptask, char **argv, char **envp, bool nodemux)
 /**
  * @brief
  *	Free the ji_hosts and ji_vnods arrays for a job.  If any events are
- *	attached to an array element, free them as well.
+ *	attached to an array element, free them as well, and forget the
+ *	JOIN_JOB replies still awaited and the launch stage times.
  *
  * @param[in] pj - job pointer
  *
@@ -5243,6 +5247,8 @@ nodes_free(job *pj)
 		free(pj->ji_hosts);
 		pj->ji_hosts = NULL;
 	}
+	pj->ji_join_pending = 0;
+	memset(pj->ji_launch_ts, 0, sizeof(pj->ji_launch_ts));
 }
 
 /**
@@ -5449,6 +5455,9 @@ job_nodes_inner(struct job *pjob, hnodent **mynp)
 	DBPRT(("- allocating %d hosts and %d procs\n", nmoms, nprocs))
 	pjob->ji_hosts = (hnodent *)calloc(nmoms+1, sizeof(hnodent));
 	pjob->ji_vnods = (vmpiprocs *)calloc(nprocs+1, sizeof(vmpiprocs));
+	/* a new set of hosts, no JOIN_JOB sent to them yet */
+	pjob->ji_join_pending = 0;
+	memset(pjob->ji_launch_ts, 0, sizeof(pjob->ji_launch_ts));
 
 	n_assn_vnodes = 0;
 	evnode = strdup(execvnode);
@@ -5976,6 +5985,8 @@ start_exec(job *pjob)
 	int             job_error_code;
 #endif/* MOM_BGL */
 
+	trace_span(pjob->ji_trace, pjob->ji_qs.ji_jobid, "start_exec");
+
 	/* make sure we have an open rpp stream back to the server */
 
 	if (server_stream == -1)
@@ -6139,6 +6150,7 @@ start_exec(job *pjob)
 			}
 		} else
 			com = IM_JOIN_JOB;
+		launch_stage(pjob, LAUNCH_JOIN_SENT);
 
 		if (nodemux) {
 			pjob->ji_ports[0] = -1;
@@ -6199,6 +6211,8 @@ start_exec(job *pjob)
 			if (pbs_conf.pbs_use_mcast == 0)
 				send_join_job_restart(com, ep, i, pjob, &phead);
 		}
+		if (com == IM_JOIN_JOB)
+			pjob->ji_join_pending = nodenum - 1;
 		if (pbs_conf.pbs_use_mcast == 1) {
 			send_join_job_restart_mcast(mtfd, com, ep, i, pjob, &phead);
 			tpp_mcast_close(mtfd);
@@ -114,6 +114,7 @@
 #include "limits_if.h"
 #include "pbs_version.h"
 #include "buckets.h"
+#include "pbs_trace.h"
 
 
 #ifdef NAS
@@ -1303,6 +1304,7 @@ run_job(int pbs_sd, resource_resv *rjob, char *execvnode, int throughput, schd_e
 	}
 
 	if (!rc) {
+		trace_span(NULL, rjob->name, "run");
 		if (rjob->is_shrink_to_fit) {
 			char timebuf[TIMEBUF_SIZE] = {0};
 			rc = 1;
@@ -111,6 +111,7 @@
 #include	"config.h"
 #include	"fifo.h"
 #include	"globals.h"
+#include	"pbs_trace.h"
 
 struct		connect_handle connection[NCONNECTS];
 int		connector;
@@ -222,6 +223,7 @@ die(int sig)
 		}
 	}
 
+	trace_close();
 	log_close(1);
 	exit(1);
 }
@@ -1312,6 +1314,7 @@ main(int argc, char *argv[])
 
 	sprintf(log_buffer, "%s startup pid %ld", argv[0], (long)pid);
 	log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__, log_buffer);
+	(void)trace_open(path_log, "sched");
 
 	rpp_fd = -1;
 	if (pbs_conf.pbs_use_tcp == 1) {
@@ -1443,6 +1446,7 @@ main(int argc, char *argv[])
 			if (schedule(cmd, connector, runjobid)) /* magic happens here */ {
 				go = 0;
 			}
+			trace_flush();
 			if (second_connection != -1) {
 				close(second_connection);
 				second_connection = -1;
@@ -1464,6 +1468,7 @@ main(int argc, char *argv[])
 	sprintf(log_buffer, "%s normal finish pid %ld", argv[0], (long)pid);
 	log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__, log_buffer);
 	lock_out(lockfds, F_UNLCK);
+	trace_close();
 
 	(void)close(server_sock);
 	exit(0);
@@ -72,6 +72,7 @@
 #include "pbs_nodes.h"
 #include "log.h"
 #include "acct.h"
+#include "acct_bin.h"
 #include "pbs_license.h"
 #include "server.h"
 #include "svrfunc.h"
@@ -80,6 +81,8 @@
 /* Local Data */
 
 static FILE	    *acctfile;		/* open stream for log file */
+static struct acct_bin_file *acctbin;	/* binary accounting file */
+static FILE	    *acctindex;		/* id index of the text file */
 static volatile int  acct_opened = 0;
 static int	     acct_opened_day;
 static int	     acct_auto_switch = 0;
@@ -918,7 +921,11 @@ acct_open(char *filename)
 	char  filen[_POSIX_PATH_MAX];
 	char  logmsg[_POSIX_PATH_MAX+80];
 #endif
-	FILE *newacct;
+	char  binname[sizeof(filen) + sizeof(ACCT_BIN_SUFFIX)];
+	char  idxname[sizeof(filen) + sizeof(LOG_INDEX_SUFFIX)];
+	FILE *newacct = NULL;
+	FILE *newindex = NULL;
+	struct acct_bin_file *newbin = NULL;
 	time_t now;
 	struct tm *ptm;
 
@@ -942,27 +949,57 @@ acct_open(char *filename)
 	} else if (*filename != '/') {
 		return (-1);		/* not absolute */
 	}
-	if ((newacct = fopen(filename, "a")) == NULL) {
-		log_err(errno, "acct_open", filename);
-		return (-1);
-	}
+	if (pbs_conf.pbs_acct_format & PBS_ACCT_FORMAT_TEXT) {
+		if ((newacct = fopen(filename, "a")) == NULL) {
+			log_err(errno, "acct_open", filename);
+			return (-1);
+		}
 
 #ifdef WIN32
-	secure_file(filename, "Administrators", READS_MASK|WRITES_MASK|STANDARD_RIGHTS_REQUIRED);
-	(void)setvbuf(newacct, NULL, _IONBF, 0); /* no buffering to get instant
-						  log*/
+		secure_file(filename, "Administrators", READS_MASK|WRITES_MASK|STANDARD_RIGHTS_REQUIRED);
+		(void)setvbuf(newacct, NULL, _IONBF, 0); /* no buffering to get instant
+							  log*/
 #else
-	(void)setvbuf(newacct, NULL, _IOLBF, 0); /* set line buffering */
+		(void)setvbuf(newacct, NULL, _IOLBF, 0); /* set line buffering */
 #endif
+		if (pbs_conf.pbs_log_index) {
+			(void)snprintf(idxname, sizeof(idxname), "%s%s", filename, LOG_INDEX_SUFFIX);
+			if ((newindex = log_index_open(idxname, newacct)) == NULL)
+				log_err(errno, "acct_open", idxname);
+		}
+	}
 
-	if (acct_opened > 0) 		/* if acct was open, close it */
-		(void)fclose(acctfile);
+	if (pbs_conf.pbs_acct_format & PBS_ACCT_FORMAT_BINARY) {
+		(void)snprintf(binname, sizeof(binname), "%s%s", filename, ACCT_BIN_SUFFIX);
+		if ((newbin = acct_bin_open(binname, 1)) == NULL) {
+			log_err(errno, "acct_open", binname);
+			if (newacct != NULL)
+				(void)fclose(newacct);
+			if (newindex != NULL)
+				(void)fclose(newindex);
+			return (-1);
+		}
+#ifdef WIN32
+		secure_file(binname, "Administrators", READS_MASK|WRITES_MASK|STANDARD_RIGHTS_REQUIRED);
+#endif
+	}
+
+	acct_close();			/* if acct was open, close it */
 
 	acctfile = newacct;
+	acctindex = newindex;
+	acctbin = newbin;
 	acct_opened = 1;			/* note that file is open */
-	(void)sprintf(logmsg, "Account file %s opened", filename);
-	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO,
-		"Act", logmsg);
+	if (newacct != NULL) {
+		(void)sprintf(logmsg, "Account file %s opened", filename);
+		log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO,
+			"Act", logmsg);
+	}
+	if (newbin != NULL) {
+		(void)sprintf(logmsg, "Account file %s opened", binname);
+		log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO,
+			"Act", logmsg);
+	}
 
 	return (0);
 }
@@ -977,7 +1014,14 @@ void
 acct_close()
 {
 	if (acct_opened == 1) {
-		(void)fclose(acctfile);
+		if (acctfile != NULL)
+			(void)fclose(acctfile);
+		if (acctindex != NULL)
+			(void)fclose(acctindex);
+		acct_bin_close(acctbin);
+		acctfile = NULL;
+		acctindex = NULL;
+		acctbin = NULL;
 		acct_opened = 0;
 	}
 }
@@ -996,6 +1040,7 @@ void
 write_account_record(int acctype, char *id, char *text)
 {
 	struct tm *ptm;
+	long	   offset;
 
 	if (acct_opened == 0)
 		return;		/* file not open, don't bother */
@@ -1011,11 +1056,20 @@ write_account_record(int acctype, char *id, char *text)
 	if (text == NULL)
 		text = "";
 
-	(void)fprintf(acctfile,
-		"%02d/%02d/%04d %02d:%02d:%02d;%c;%s;%s\n",
-		ptm->tm_mon+1, ptm->tm_mday, ptm->tm_year+1900,
-		ptm->tm_hour, ptm->tm_min, ptm->tm_sec,
-		(char)acctype, id, text);
+	if (acctfile != NULL) {
+		offset = (acctindex != NULL) ? ftell(acctfile) : -1;
+		if ((fprintf(acctfile,
+			"%02d/%02d/%04d %02d:%02d:%02d;%c;%s;%s\n",
+			ptm->tm_mon+1, ptm->tm_mday, ptm->tm_year+1900,
+			ptm->tm_hour, ptm->tm_min, ptm->tm_sec,
+			(char)acctype, id, text) > 0) && (offset >= 0)) {
+			(void)fprintf(acctindex, "%ld %s\n", offset, id);
+			(void)fflush(acctindex);
+		}
+	}
+
+	if ((acctbin != NULL) && (acct_bin_write(acctbin, time_now, acctype, id, text) != 0))
+		log_err(errno, "write_account_record", "cannot write binary accounting record");
 }
 
 /**
@@ -816,6 +816,8 @@ create_subjob(job *parent, char *newjid, int *rc)
 	strcpy(subj->ji_qs.ji_jobid, newjid);	/* replace job id */
 	*subj->ji_qs.ji_fileprefix = '\0';
 	subj->ji_subjindx = indx;
+	if (parent->ji_trace != NULL)
+		subj->ji_trace = strdup(parent->ji_trace);
 
 	/*
 	 * now that is all done, copy the required attributes by
@@ -933,6 +935,7 @@ dup_br_for_subjob(struct batch_request *opreq, job *pjob, void (*func)(struct ba
 	strcpy(npreq->rq_user, opreq->rq_user);
 	strcpy(npreq->rq_host, opreq->rq_host);
 	npreq->rq_extend  = opreq->rq_extend;
+	npreq->rq_trace   = opreq->rq_trace;
 	npreq->rq_reply.brp_choice = BATCH_REPLY_CHOICE_NULL;
 	npreq->rq_refct   = 0;
 
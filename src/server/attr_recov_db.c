@@ -47,6 +47,10 @@
  * Included public functions are:
  *	save_attr_db		Save attributes to the database
  *	recov_attr_db		Read attributes from the database
+ *	recov_attr_db_index	File an attribute read from the database by index
+ *	recov_attr_db_decode	Decode the filed attributes into the parent
+ *	recov_attr_db_plain	Tell whether an attribute value is plain data
+ *	recov_attr_db_predecode	Decode the filed attributes that are MT-safe
  *	delete_attr_db		Delete a single attribute from the database
  *	make_attr			create a svrattrl structure from the attr_name, and values
  *  recov_attr_db_raw	Recover the list of attributes from the database without triggering
@@ -91,7 +95,7 @@ extern struct attribute_def	que_attr_def[];
  * @retval - Not NULL - Success
  *
  */
-static svrattrl *
+svrattrl *
 make_attr(char *attr_name, char *attr_resc,
 	char *attr_value, int attr_flags)
 {
@@ -261,6 +265,235 @@ err:
 	return ((rc < 0 || dbrc !=0)? -1 : 0);
 }
 
+/**
+ * @brief
+ *	File an attribute read from the database under the index of its
+ *	definition, chaining it behind any entries already filed there
+ *
+ * @param[in]	padef - Address of parent's attribute definition array
+ * @param[in]	palarray - Per index lists of svrattrl being recovered
+ * @param[in]	pal - The attribute read from the database
+ * @param[in]	limit - Number of attributes in the list
+ * @param[in]	unknown	- The index of the unknown attribute if any
+ *
+ * @return	int
+ * @retval	>=0 - index the attribute was filed under
+ * @retval	-1  - unknown attribute, logged and freed
+ *
+ * @par MT-safe: Yes when unknown is greater than 0
+ */
+int
+recov_attr_db_index(struct attribute_def *padef,
+	void **palarray,
+	svrattrl *pal,
+	int limit,
+	int unknown)
+{
+	int	  index;
+	svrattrl *tmp_pal;
+
+	/* find the attribute definition based on the name */
+	index = find_attr(padef, pal->al_name, limit);
+	if (index < 0) {
+
+		/*
+		 * There are two ways this could happen:
+		 * 1. if the (job) attribute is in the "unknown" list -
+		 *    keep it there;
+		 * 2. if the server was rebuilt and an attribute was
+		 *    deleted, -  the fact is logged and the attribute
+		 *    is discarded (system,queue) or kept (job)
+		 */
+		if (unknown > 0) {
+			index = unknown;
+		} else {
+			sprintf(log_buffer,
+				"unknown attribute \"%s\" discarded",
+				pal->al_name);
+			log_err(-1,__func__, log_buffer);
+			(void)free(pal);
+			return -1;
+		}
+	}
+	if (palarray[index] == NULL)
+		palarray[index] = pal;
+	else {
+		tmp_pal = palarray[index];
+		while (tmp_pal->al_sister)
+			tmp_pal = tmp_pal->al_sister;
+
+		/* this is the end of the list of attributes */
+		tmp_pal->al_sister = pal;
+	}
+	return index;
+}
+
+/**
+ * @brief
+ *	Decode the attributes filed by recov_attr_db_index into the attribute
+ *	array of the parent, call their recovery actions and free them
+ *
+ * @param[in]	parent - Address of parent object
+ * @param[in]	padef - Address of parent's attribute definition array
+ * @param[in]	pattr - Address of the parent objects attribute array
+ * @param[in]	palarray - Per index lists of svrattrl being recovered
+ * @param[in]	limit - Number of attributes in the list
+ *
+ * @return	void
+ */
+void
+recov_attr_db_decode(void *parent,
+	struct attribute_def *padef,
+	struct attribute *pattr,
+	void **palarray,
+	int limit)
+{
+	int	  index;
+	svrattrl *pal;
+	svrattrl *tmp_pal;
+
+	/* now do the decoding */
+	for (index = 0; index < limit; index++) {
+		/*
+		 * In the normal case we just decode the attribute directly
+		 * into the real attribute since there will be one entry only
+		 * for that attribute.
+		 *
+		 * However, "entity limits" are special and may have multiple,
+		 * the first of which is "SET" and the following are "INCR".
+		 * For the SET case, we do it directly as for the normal attrs.
+		 * For the INCR,  we have to decode into a temp attr and then
+		 * call set_entity to do the INCR.
+		 */
+		/*
+		 * we don't store the op value into the database, so we need to
+		 * determine (in case of an ENTITY) whether it is the first
+		 * value, or was decoded before. We decide this based on whether
+		 * the flag has ATR_VFLAG_SET
+		 *
+		 */
+		pal = palarray[index];
+		while (pal) {
+			if (((padef + index)->at_type == ATR_TYPE_ENTITY) &&
+				((pattr + index)->at_flags & ATR_VFLAG_SET)) {
+				attribute tmpa;
+				memset(&tmpa, 0, sizeof(attribute));
+				/* for INCR case of entity limit, decode locally */
+				if ((padef+index)->at_decode) {
+					(void)(padef+index)->at_decode(&tmpa,
+						pal->al_name,
+						pal->al_resc,
+						pal->al_value);
+					(void)(padef+index)->at_set(pattr+index,
+						&tmpa,
+						INCR);
+					(void)(padef+index)->at_free(&tmpa);
+				}
+			} else {
+				if ((padef+index)->at_decode) {
+					(void)(padef+index)->at_decode(pattr+index,
+						pal->al_name,
+						pal->al_resc,
+						pal->al_value);
+					if ((padef+index)->at_action)
+						(void)(padef+index)->at_action(
+							pattr+index, parent,
+							ATR_ACTION_RECOV);
+				}
+			}
+			(pattr+index)->at_flags = pal->al_flags & ~ATR_VFLAG_MODIFY;
+
+			tmp_pal = pal->al_sister;
+			(void)free(pal);
+			pal = tmp_pal;
+		}
+	}
+}
+
+/*
+ * Decoders that keep no static state and so may run on several threads at
+ * once, see recov_attr_db_predecode()
+ */
+static int (*recov_mt_decoders[])(attribute *, char *, char *, char *) = {
+	decode_b,
+	decode_c,
+	decode_f,
+	decode_l,
+	decode_str,
+	decode_time,
+	NULL
+};
+
+/**
+ * @brief
+ *	Tell whether the value of an attribute is plain data that can be
+ *	decoded on any thread, or copied as is: it has no action routine and
+ *	its decoder is listed in recov_mt_decoders.
+ *
+ * @param[in]	pdef - The attribute definition
+ *
+ * @return	int
+ * @retval	1 - plain
+ * @retval	0 - not plain
+ */
+int
+recov_attr_db_plain(struct attribute_def *pdef)
+{
+	int	i;
+
+	if (pdef->at_action != NULL)
+		return 0;
+	for (i = 0; recov_mt_decoders[i] != NULL; i++)
+		if (pdef->at_decode == recov_mt_decoders[i])
+			return 1;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Decode the attributes filed by recov_attr_db_index that can be decoded
+ *	away from the main thread: a single value of a plain attribute, see
+ *	recov_attr_db_plain().  Decoded entries are freed and
+ *	removed from palarray, the rest are left for recov_attr_db_decode.
+ *
+ * @param[in]	padef - Address of parent's attribute definition array
+ * @param[in]	pattr - Address of the parent objects attribute array
+ * @param[in]	palarray - Per index lists of svrattrl being recovered
+ * @param[in]	limit - Number of attributes in the list
+ *
+ * @return	int
+ * @retval	number of attributes decoded
+ *
+ * @par MT-safe: Yes, for distinct attribute arrays
+ */
+int
+recov_attr_db_predecode(struct attribute_def *padef,
+	struct attribute *pattr,
+	void **palarray,
+	int limit)
+{
+	int	  index;
+	int	  done = 0;
+	svrattrl *pal;
+
+	for (index = 0; index < limit; index++) {
+		pal = palarray[index];
+		if ((pal == NULL) || (pal->al_sister != NULL) ||
+			!recov_attr_db_plain(padef + index))
+			continue;
+
+		(void)(padef + index)->at_decode(pattr + index,
+			pal->al_name,
+			pal->al_resc,
+			pal->al_value);
+		(pattr + index)->at_flags = pal->al_flags & ~ATR_VFLAG_MODIFY;
+		(void)free(pal);
+		palarray[index] = NULL;
+		done++;
+	}
+	return done;
+}
+
 /**
  * @brief
  *	Recover the list of attributes from the database
@@ -289,7 +522,6 @@ recov_attr_db(pbs_db_conn_t *conn,
 	int	  amt;
 	int	  index;
 	svrattrl *pal = NULL;
-	svrattrl *tmp_pal = NULL;
 	int	  ret;
 	void	 *state = NULL;
 	pbs_db_obj_info_t obj;
@@ -364,39 +596,7 @@ recov_attr_db(pbs_db_conn_t *conn,
 
 		pal->al_refct = 1;	/* ref count reset to 1 */
 
-		/* find the attribute definition based on the name */
-		index = find_attr(padef, pal->al_name, limit);
-		if (index < 0) {
-
-			/*
-			 * There are two ways this could happen:
-			 * 1. if the (job) attribute is in the "unknown" list -
-			 *    keep it there;
-			 * 2. if the server was rebuilt and an attribute was
-			 *    deleted, -  the fact is logged and the attribute
-			 *    is discarded (system,queue) or kept (job)
-			 */
-			if (unknown > 0) {
-				index = unknown;
-			} else {
-				sprintf(log_buffer,
-					"unknown attribute \"%s\" discarded",
-					pal->al_name);
-				log_err(-1,__func__, log_buffer);
-				(void)free(pal);
-				continue;
-			}
-		}
-		if (palarray[index] == NULL)
-			palarray[index] = pal;
-		else {
-			tmp_pal = palarray[index];
-			while (tmp_pal->al_sister)
-				tmp_pal = tmp_pal->al_sister;
-
-			/* this is the end of the list of attributes */
-			tmp_pal->al_sister = pal;
-		}
+		(void)recov_attr_db_index(padef, palarray, pal, limit, unknown);
 	}
 	pbs_db_cursor_close(conn, state);
 
@@ -413,62 +613,7 @@ recov_attr_db(pbs_db_conn_t *conn,
 		return -1;
 	}
 
-	/* now do the decoding */
-	for (index = 0; index < limit; index++) {
-		/*
-		 * In the normal case we just decode the attribute directly
-		 * into the real attribute since there will be one entry only
-		 * for that attribute.
-		 *
-		 * However, "entity limits" are special and may have multiple,
-		 * the first of which is "SET" and the following are "INCR".
-		 * For the SET case, we do it directly as for the normal attrs.
-		 * For the INCR,  we have to decode into a temp attr and then
-		 * call set_entity to do the INCR.
-		 */
-		/*
-		 * we don't store the op value into the database, so we need to
-		 * determine (in case of an ENTITY) whether it is the first
-		 * value, or was decoded before. We decide this based on whether
-		 * the flag has ATR_VFLAG_SET
-		 *
-		 */
-		pal = palarray[index];
-		while (pal) {
-			if (((padef + index)->at_type == ATR_TYPE_ENTITY) &&
-				((pattr + index)->at_flags & ATR_VFLAG_SET)) {
-				attribute tmpa;
-				memset(&tmpa, 0, sizeof(attribute));
-				/* for INCR case of entity limit, decode locally */
-				if ((padef+index)->at_decode) {
-					(void)(padef+index)->at_decode(&tmpa,
-						pal->al_name,
-						pal->al_resc,
-						pal->al_value);
-					(void)(padef+index)->at_set(pattr+index,
-						&tmpa,
-						INCR);
-					(void)(padef+index)->at_free(&tmpa);
-				}
-			} else {
-				if ((padef+index)->at_decode) {
-					(void)(padef+index)->at_decode(pattr+index,
-						pal->al_name,
-						pal->al_resc,
-						pal->al_value);
-					if ((padef+index)->at_action)
-						(void)(padef+index)->at_action(
-							pattr+index, parent,
-							ATR_ACTION_RECOV);
-				}
-			}
-			(pattr+index)->at_flags = pal->al_flags & ~ATR_VFLAG_MODIFY;
-
-			tmp_pal = pal->al_sister;
-			(void)free(pal);
-			pal = tmp_pal;
-		}
-	}
+	recov_attr_db_decode(parent, padef, pattr, palarray, limit);
 	(void)free(palarray);
 
 	return (0);
@@ -507,8 +507,13 @@ dis_request_read(int sfds, struct batch_request *request)
 	int	 proto_ver;
 	int	 rc; 	/* return code */
 
-	if (!request->isrpp)
-		DIS_tcp_setup(sfds);	/* setup for DIS over tcp */
+	if (!request->isrpp) {
+		/* keep any request pipelined behind the last one */
+		if (DIS_tcp_rpending(sfds) > 0)
+			DIS_tcp_funcs();
+		else
+			DIS_tcp_setup(sfds);	/* setup for DIS over tcp */
+	}
 
 	/* Decode the Request Header, that will tell the request type */
 
@@ -605,6 +610,13 @@ dis_request_read(int sfds, struct batch_request *request)
 			rc = decode_DIS_RelnodesJob(sfds, request);
 			break;
 
+		case PBS_BATCH_JobList:
+			rc = decode_DIS_JobList(sfds, request);
+			break;
+
+		case PBS_BATCH_SubmitBatch:
+			break;
+
 		case PBS_BATCH_LocateJob:
 			rc = decode_DIS_JobId(sfds, request->rq_ind.rq_locate);
 			break;
@@ -695,6 +707,10 @@ dis_request_read(int sfds, struct batch_request *request)
 			rc = decode_DIS_DelHookFile(sfds, request);
 			break;
 
+		case PBS_BATCH_CopyHookBundle:
+			rc = decode_DIS_CopyHookBundle(sfds, request);
+			break;
+
 		case PBS_BATCH_CopyFiles:
 		case PBS_BATCH_DelFiles:
 			rc = decode_DIS_CopyFiles(sfds, request);
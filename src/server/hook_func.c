@@ -83,6 +83,8 @@
  * sync_mom_hookfiles
  * mk_deferred_hook_info
  * post_sendhookRPP
+ * load_hook_bundle
+ * free_hook_bundle
  * check_add_hook_mcast_info
  * del_deferred_hook_cmds
  * sync_mom_hookfilesRPP
@@ -103,6 +105,8 @@
 #include <unistd.h>
 #include <sys/param.h>
 #include <dirent.h>
+#include <sys/time.h>
+#include <sys/resource.h>
 #endif
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -169,9 +173,31 @@ static  int g_hook_replies_recvd = 0; /* used only in TPP mode */
 static	time_t	g_sync_hook_time = 0; /* time when mom hook files were last sent */
 static	long long int g_sync_hook_tid = 0LL; /* identifies the latest group of hook updates to send out */
 static	pid_t	g_sync_hook_pid = -1;	/* pid of the child sync_mom_hookfiles() process (non-TPP only) */
+static	int	g_sync_hook_cursor = 0;	/* mominfo_array index the next batch of hook updates starts at (TPP only) */
 					/* process sending out mom hook files */
 static	unsigned long	hook_rescdef_checksum = 0;
 
+/* execution profile of the hook currently being run, see hook_stat_*() */
+static	hook	*hook_stat_cur = NULL;	/* hook being timed */
+static	hook	*hook_stat_last = NULL;	/* last hook run for the request */
+static	double	hook_stat_wall[HOOK_STAT_NPHASES];
+static	double	hook_stat_cpu[HOOK_STAT_NPHASES];
+static	double	hook_stat_wall_mark;	/* start of the current phase */
+static	double	hook_stat_cpu_mark;
+
+/* children running HOOK_ASYNC_EVENTS hooks, see hook_async_fork() */
+static	struct {
+	pid_t	pid;
+	double	start;		/* wall time the child was started */
+} hook_async_child[HOOK_ASYNC_MAX_CHILDREN];
+static	int	hook_async_running = 0;	/* # of hook_async_child[] in use */
+static	int	hook_async_in_child = 0;	/* set in the child itself */
+static	unsigned long	hook_async_started = 0;	/* events run in a child */
+static	unsigned long	hook_async_inline = 0;	/* events run in the server */
+static	unsigned long	hook_async_done = 0;	/* children reaped */
+static	double	hook_async_wall = 0;	/* total child run time, secs */
+static	double	hook_async_max = 0;	/* longest child run time, secs */
+
 /* mom hook action(s) to keep track */
 
 #define GROW_MOMHOOK_ARRAY_AMT 10
@@ -180,6 +206,7 @@ static	unsigned long	hook_rescdef_checksum = 0;
 #define VALID_HOOK_CONFIG_SUFFIX        ".json .py .txt .xml .ini"
 
 #define	SYNC_MOM_HOOKFILES_TIMEOUT_TPP	120	/* 2 minutes */
+#define	SYNC_MOM_HOOKFILES_BATCH_TPP	1000	/* moms sent updates at once */
 #define	SYNC_MOM_HOOKFILES_TIMEOUT	900	/* 15 minutes */
 
 extern char *msg_daemonname;
@@ -239,6 +266,8 @@ struct def_hk_cmd_info {
 	int index;
 	int event;
 	long long int tid;	/* transaction id */
+	int bundled;		/* send actions whose file is in the bundle */
+	char hash[HOOK_BUNDLE_HASH_SIZE+1]; /* bundle hash, "" if none */
 };
 
 /* structures required for TPP mcast communication
@@ -249,8 +278,24 @@ typedef struct {
 	char *msgid;
 	char *hookname;
 	int  action;
+	/* hook bundle, for MOM_HOOK_SEND_ACTIONS */
+	int  bundled;		/* send actions whose file is in the bundle */
+	int  nfiles;
+	struct hook_bundle_file *files;
+	char hash[HOOK_BUNDLE_HASH_SIZE+1];
 } hook_mcast_info_t;
 
+/* the files of a hook bundle, in the order mom installs them */
+static struct {
+	int	action;
+	char	*suffix;
+} hook_bundle_files[] = {
+	{MOM_HOOK_ACTION_SEND_ATTRS, HOOK_FILE_SUFFIX},
+	{MOM_HOOK_ACTION_SEND_CONFIG, HOOK_CONFIG_SUFFIX},
+	{MOM_HOOK_ACTION_SEND_SCRIPT, HOOK_SCRIPT_SUFFIX}
+};
+#define HOOK_BUNDLE_NFILES (int)(sizeof(hook_bundle_files) / sizeof(hook_bundle_files[0]))
+
 /* global array of mcast information structs */
 hook_mcast_info_t *g_hook_mcast_array = NULL;
 int g_hook_mcast_array_len = 0;
@@ -2373,6 +2418,10 @@ status_hook(hook *phook, struct batch_request *preq, pbs_list_head *pstathd, cha
 				strcpy(val_str, hook_debug_as_string(phook->debug));
 			} else if (strcmp(pal->al_name, HOOKATT_FAIL_ACTION) == 0) {
 				strcpy(val_str, hook_fail_action_as_string(phook->fail_action));
+			} else if (strcmp(pal->al_name, HOOKATT_STATS) == 0) {
+				/* only given when asked for, so that "print hook" */
+				/* output remains valid qmgr input */
+				strcpy(val_str, hook_stats_as_string(phook));
 			} else {
 				snprintf(hook_msg, msg_len-1,
 					"unknown hook attribute %s", pal->al_name);
@@ -3779,6 +3828,225 @@ get_resv_list(void) {
 	return &resv_attr_list;
 }
 
+/**
+ * @brief
+ *		Returns the current wall clock and process cpu times, in seconds.
+ *
+ * @param[out]	wall - wall clock time
+ * @param[out]	cpu - user plus system cpu time used by the server so far
+ */
+static void
+hook_stat_now(double *wall, double *cpu)
+{
+	struct timeval	tv;
+#ifndef WIN32
+	struct rusage	ru;
+#endif
+
+	gettimeofday(&tv, NULL);
+	*wall = tv.tv_sec + tv.tv_usec / 1000000.0;
+	*cpu = 0;
+#ifndef WIN32
+	if (getrusage(RUSAGE_SELF, &ru) == 0)
+		*cpu = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1000000.0 +
+			ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1000000.0;
+#endif
+}
+
+/**
+ * @brief
+ *		Starts timing a run of hook 'phook'.  The time until the next
+ *		hook_stat_phase() call is charged to that call's phase.
+ *
+ * @param[in]	phook - hook about to run
+ */
+static void
+hook_stat_begin(hook *phook)
+{
+	int	i;
+
+	for (i = 0; i < HOOK_STAT_NPHASES; i++) {
+		hook_stat_wall[i] = 0;
+		hook_stat_cpu[i] = 0;
+	}
+	hook_stat_cur = phook;
+	hook_stat_now(&hook_stat_wall_mark, &hook_stat_cpu_mark);
+}
+
+/**
+ * @brief
+ *		Charges the time since the previous mark to 'phase' of the hook
+ *		being timed, and starts the next phase.
+ *
+ * @param[in]	phase - one of the HOOK_STAT_* phases
+ */
+static void
+hook_stat_phase(int phase)
+{
+	double	wall;
+	double	cpu;
+
+	if (hook_stat_cur == NULL)
+		return;
+	hook_stat_now(&wall, &cpu);
+	hook_stat_wall[phase] += wall - hook_stat_wall_mark;
+	hook_stat_cpu[phase] += cpu - hook_stat_cpu_mark;
+	hook_stat_wall_mark = wall;
+	hook_stat_cpu_mark = cpu;
+}
+
+/**
+ * @brief
+ *		Ends timing the current hook run, charging what remains to its
+ *		HOOK_STAT_RESULT phase and adding the run to the hook's profile.
+ */
+static void
+hook_stat_end(void)
+{
+	if (hook_stat_cur == NULL)
+		return;
+	hook_stat_phase(HOOK_STAT_RESULT);
+	hook_stats_add(hook_stat_cur, hook_stat_wall, hook_stat_cpu);
+	hook_stat_cur = NULL;
+}
+
+/**
+ * @brief
+ *		Reaps a child started by hook_async_fork() and records how long
+ *		it took to run its hooks.
+ *
+ * @param[in]	ptask - work task, wt_event is the child's pid
+ */
+static void
+post_async_hooks(struct work_task *ptask)
+{
+	double	wall;
+	double	cpu;
+	int	i;
+
+	hook_stat_now(&wall, &cpu);
+	for (i = 0; i < HOOK_ASYNC_MAX_CHILDREN; i++) {
+		if (hook_async_child[i].pid == (pid_t)ptask->wt_event)
+			break;
+	}
+	if (i == HOOK_ASYNC_MAX_CHILDREN)
+		return;
+
+	wall -= hook_async_child[i].start;
+	hook_async_wall += wall;
+	if (wall > hook_async_max)
+		hook_async_max = wall;
+	hook_async_child[i].pid = 0;
+	hook_async_running--;
+	hook_async_done++;
+
+	if (!WIFEXITED(ptask->wt_aux) || (WEXITSTATUS(ptask->wt_aux) != 0)) {
+		sprintf(log_buffer, msg_badexit, ptask->wt_aux);
+		log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_HOOK, LOG_ERR,
+			__func__, log_buffer);
+	}
+}
+
+/**
+ * @brief
+ *		Forks a child to run the hooks of an event in HOOK_ASYNC_EVENTS,
+ *		so that the server need not wait for them.  The child works on
+ *		its own copy of the server state as of the fork.
+ *
+ * @return	pid_t
+ * @retval	>0	in the server, the hooks are being run by this child
+ * @retval	0	in the child, which must run the hooks and exit
+ * @retval	-1	too many children running, or fork failed: the
+ *			caller runs the hooks itself
+ */
+static pid_t
+hook_async_fork(void)
+{
+#ifndef WIN32
+	pid_t	pid;
+	double	cpu;
+	int	i;
+
+	if (hook_async_in_child)
+		return (-1);
+
+	if (hook_async_running >= HOOK_ASYNC_MAX_CHILDREN) {
+		hook_async_inline++;
+		log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_HOOK, LOG_INFO,
+			__func__, "too many hook children running, "
+			"running hooks in the server");
+		return (-1);
+	}
+	for (i = 0; i < HOOK_ASYNC_MAX_CHILDREN; i++) {
+		if (hook_async_child[i].pid == 0)
+			break;
+	}
+
+	pid = fork();
+	if (pid == -1) {
+		log_err(errno, __func__, "fork failed");
+		hook_async_inline++;
+		return (-1);
+	}
+	if (pid == 0) {
+		hook_async_in_child = 1;
+		net_close(-1);
+		rpp_terminate();
+		daemon_protect(0, PBS_DAEMON_PROTECT_OFF);
+		return (0);
+	}
+
+	if (set_task(WORK_Deferred_Child, (long)pid, post_async_hooks,
+		NULL) == NULL) {
+		log_err(errno, __func__, msg_err_malloc);
+		return (pid);
+	}
+	hook_async_child[i].pid = pid;
+	hook_stat_now(&hook_async_child[i].start, &cpu);
+	hook_async_running++;
+	hook_async_started++;
+	return (pid);
+#else
+	return (-1);
+#endif
+}
+
+/**
+ * @brief
+ *		Logs the execution profile of each hook that has run since the
+ *		last time this was called, then reschedules itself to run again
+ *		in HOOK_STATS_LOG_INTERVAL seconds.
+ *
+ * @param[in]	ptask - work task (unused)
+ */
+void
+log_hook_stats(struct work_task *ptask)
+{
+	hook	*phook;
+
+	for (phook = (hook *)GET_NEXT(svr_allhooks); phook != NULL;
+		phook = (hook *)GET_NEXT(phook->hi_allhooks)) {
+		if (phook->run_stats.hs_runs == phook->run_stats.hs_runs_logged)
+			continue;
+		phook->run_stats.hs_runs_logged = phook->run_stats.hs_runs;
+		log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_HOOK, LOG_INFO,
+			phook->hook_name, hook_stats_as_string(phook));
+	}
+	if ((hook_async_started > 0) || (hook_async_inline > 0)) {
+		snprintf(log_buffer, sizeof(log_buffer),
+			"async hook events: forked=%lu running=%d inline=%lu "
+			"avg_ms=%.1f max_ms=%.1f", hook_async_started,
+			hook_async_running, hook_async_inline,
+			(hook_async_done > 0) ?
+			hook_async_wall * 1000 / hook_async_done : 0.0,
+			hook_async_max * 1000);
+		log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_HOOK, LOG_INFO,
+			__func__, log_buffer);
+	}
+	(void)set_task(WORK_Timed, time_now + HOOK_STATS_LOG_INTERVAL,
+		log_hook_stats, NULL);
+}
+
 /**
  * @brief
  *
@@ -3805,6 +4073,10 @@ get_resv_list(void) {
  * @retval	2 means no hook script executed (special case).
  * @retval	-1 an internal error occurred
  *
+ * @note
+ *		Hooks for HOOK_ASYNC_EVENTS are normally run by a forked child,
+ *		in which case this returns 2 right away.
+ *
  * @par MT-safe: No
  */
 int
@@ -3822,6 +4094,7 @@ process_hooks(struct batch_request *preq, char *hook_msg, size_t msg_len,
 	int			num_run = 0;
 	int			rc = 1;
 	int			event_initialized = 0;
+	hook			*last_run = NULL;
 
 	if (!svr_interp_data.interp_started) {
 		log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_HOOK,
@@ -3883,6 +4156,20 @@ process_hooks(struct batch_request *preq, char *hook_msg, size_t msg_len,
 	}
 
 	memset(hook_msg, '\0', msg_len);
+	hook_stat_last = NULL;
+
+	/* hooks that only observe are run by a child, while we carry on */
+	if ((hook_event & HOOK_ASYNC_EVENTS) && (GET_NEXT(*head_ptr) != NULL)) {
+		pid_t	pid;
+
+		pid = hook_async_fork();
+		if (pid > 0)
+			return (2);
+		if (pid == 0) {
+			(void)process_hooks(preq, hook_msg, msg_len, pyinter_func);
+			exit(0);
+		}
+	}
 
 	/* initialize global flags */
 	pbs_python_event_accept();
@@ -3927,15 +4214,19 @@ process_hooks(struct batch_request *preq, char *hook_msg, size_t msg_len,
 			num_run++;
 			continue;
 		}
+		hook_stat_begin(phook);
 		rc = server_process_hooks(preq->rq_type, preq->rq_user, preq->rq_host, phook,
 				hook_event, pjob, &req_ptr, hook_msg, msg_len, pyinter_func,
 				&num_run, &event_initialized);
+		hook_stat_end();
 		if ((rc == 0) || (rc == -1))
 			return (rc);
+		last_run = phook;
 	}
 
 	if (num_run == 0)
 		return (2);
+	hook_stat_last = last_run;	/* for recreate_request() */
 	return 1;
 }
 /**
@@ -4326,9 +4617,11 @@ int server_process_hooks(int rq_type, char *rq_user, char *rq_host, hook *phook,
 	}
 
 	/* let rc pass through */
+	hook_stat_phase(HOOK_STAT_SETUP);
 	if (rc==0)
 		rc=pbs_python_run_code_in_namespace(&svr_interp_data,
 			phook->script, 0);
+	hook_stat_phase(HOOK_STAT_RUN);
 
 	if (fp_debug != NULL) {
 		fclose(fp_debug);
@@ -4669,6 +4962,7 @@ recreate_request(struct batch_request *preq)
 	hook_output_param_t req_params;
 	FILE *fp_debug = NULL;
 	char *hook_outfile = NULL;
+	double wall_start, cpu_start, wall_end, cpu_end;
 
 	if (!svr_interp_data.interp_started) {
 		log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_HOOK,
@@ -4695,6 +4989,7 @@ recreate_request(struct batch_request *preq)
 		}
 	}
 
+	hook_stat_now(&wall_start, &cpu_start);
 	hook_output_param_init(&req_params);
 	if (preq->rq_type == PBS_BATCH_QueueJob) {
 		req_params.rq_job = (struct rq_quejob *)&preq->rq_ind.rq_queuejob;
@@ -4720,6 +5015,18 @@ recreate_request(struct batch_request *preq)
 		log_err(PBSE_INTERNAL, __func__, "error occured recreating request!");
 	}
 
+	/* the final event values are written back once for all the hooks */
+	/* that ran; charge it to the last one, whose values are the ones */
+	/* being applied */
+	if (hook_stat_last != NULL) {
+		hook_stat_now(&wall_end, &cpu_end);
+		hook_stat_last->run_stats.hs_wall[HOOK_STAT_RESULT] +=
+			wall_end - wall_start;
+		hook_stat_last->run_stats.hs_cpu[HOOK_STAT_RESULT] +=
+			cpu_end - cpu_start;
+		hook_stat_last = NULL;
+	}
+
 	if (fp_debug != NULL) {
 		fclose(fp_debug);
 		fp_debug = NULL;
@@ -5040,9 +5347,13 @@ add_pending_mom_hook_action(void *minfo, char *hookname, unsigned int action)
 			&minfo_array[i]->mi_num_action, hookname,
 			action, 0, hook_action_tid);
 
-		hook_track_save((mominfo_t *)minfo_array[i], j);
+		if (minfo != NULL)
+			hook_track_save((mominfo_t *)minfo_array[i], j);
 	}
 
+	/* rewrite the tracking file once rather than append to it per mom */
+	if (minfo == NULL)
+		hook_track_save(NULL, -1);
 }
 
 /**
@@ -5095,9 +5406,12 @@ delete_pending_mom_hook_action(void *minfo, char *hookname,
 			hookname,
 			action);
 
-		hook_track_save((mominfo_t *)minfo_array[i], k);
+		if (minfo != NULL)
+			hook_track_save((mominfo_t *)minfo_array[i], k);
 	}
 
+	if (minfo == NULL)
+		hook_track_save(NULL, -1);
 }
 
 /**
@@ -5717,6 +6031,8 @@ mk_deferred_hook_info(int index, int event, long long int tid)
 		info->index = index;
 		info->event = event;
 		info->tid = tid;
+		info->bundled = 0;
+		info->hash[0] = '\0';
 	}
 	return info;
 }
@@ -5726,6 +6042,7 @@ mk_deferred_hook_info(int index, int event, long long int tid)
  *		Call back for the hook deferred requests over RPP.
  *		parm1 points to the mominfo_t
  *		parm2 points to more information about the hook cmd
+ *		parm3 points to the reply from mom
  *		wt_aux has the reply code from mom
  *
  * @Note
@@ -5733,12 +6050,21 @@ mk_deferred_hook_info(int index, int event, long long int tid)
  *		mom is not acceping root remote scripts for security reasons, then
  *		this will be considered still a successful send.
  *
+ *		The send actions of a hook go out as one hook bundle; mom
+ *		acknowledges it by replying with the bundle hash, and any
+ *		other reply leaves the actions pending so they are retried.
+ *
  *		The globals g_hook_replies_recvd is incremented for
  *		each reply received. When this matches the global
  *		variable g_hook_replies_expected, the global variable
  *		sync_mom_hookfiles_proc_running is reset to 0, such
  *		that the next "hook transaction" can now start.
  *
+ *		The completed actions are not written to the hook tracking
+ *		file per reply; collapse_hook_tr() rewrites it once the whole
+ *		batch has replied or timed out.  Actions lost by a server crash
+ *		in between are simply sent again.
+ *
  * @param[in] pwt - The work task pointer
  *
  * @return void
@@ -5754,6 +6080,8 @@ post_sendhookRPP(struct work_task *pwt)
 	int j;
 	int event;
 	long long int tid;
+	int bundled;
+	char hash[HOOK_BUNDLE_HASH_SIZE+1];
 	char *msgbuf;
 
 	if (!info)
@@ -5762,6 +6090,8 @@ post_sendhookRPP(struct work_task *pwt)
 	j = info->index;
 	event = info->event;
 	tid = info->tid;
+	bundled = info->bundled;
+	strcpy(hash, info->hash);
 
 	free(info);
 
@@ -5797,7 +6127,6 @@ post_sendhookRPP(struct work_task *pwt)
 			/* so it doesn't get retried for this */
 			/* "deleted" resourcdef. */
 			pact->action &= ~(MOM_HOOK_ACTION_DELETE_RESCDEF | MOM_HOOK_ACTION_SEND_RESCDEF);
-			hook_track_save((mominfo_t *) minfo, j);
 		}
 	}
 
@@ -5825,7 +6154,6 @@ post_sendhookRPP(struct work_task *pwt)
 				log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_REQUEST, LOG_INFO, msg_daemonname, log_buffer);
 			}
 			pact->action &= ~(MOM_HOOK_ACTION_SEND_RESCDEF);
-			hook_track_save((mominfo_t *) minfo, j);
 		}
 	}
 
@@ -5846,94 +6174,55 @@ post_sendhookRPP(struct work_task *pwt)
 			log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_INFO, msg_daemonname, msgbuf);
 			free(msgbuf);
 			pact->action &= ~MOM_HOOK_ACTION_DELETE;
-			hook_track_save((mominfo_t *) minfo, j);
 		}
 	}
 
-	if (event == MOM_HOOK_ACTION_SEND_ATTRS) {
-		snprintf(hookfile, sizeof(hookfile), "%.*s%.*s%s",
-			(int)(sizeof(hookfile) - PBS_HOOK_NAME_SIZE - strlen(HOOK_FILE_SUFFIX)),
-			path_hooks, PBS_HOOK_NAME_SIZE, pact->hookname, HOOK_FILE_SUFFIX);
-		if ((rc != 0) && (pbs_errno != PBSE_MOM_REJECT_ROOT_SCRIPTS)) {
+	if (event & MOM_HOOK_SEND_ACTIONS) {
+		struct batch_reply *reply = (struct batch_reply *) pwt->wt_parm3;
+		int k;
+
+		/* the mom acknowledges a bundle by sending back its hash */
+		if ((rc == 0) && ((reply == NULL) ||
+			(reply->brp_choice != BATCH_REPLY_CHOICE_Text) ||
+			(reply->brp_un.brp_txt.brp_str == NULL) ||
+			(strcmp(reply->brp_un.brp_txt.brp_str, hash) != 0))) {
 			pbs_asprintf(&msgbuf,
-				"errno %d: failed to copy hook file %s to %s:%d",
-				pbs_errno, hookfile, minfo->mi_host, minfo->mi_port);
+				"hook bundle %s for hook %s not acknowledged by %s:%d",
+				hash, pact->hookname, minfo->mi_host, minfo->mi_port);
 			log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_REQUEST, LOG_WARNING, msg_daemonname, msgbuf);
 			free(msgbuf);
-		} else {
-			if (pbs_errno != PBSE_MOM_REJECT_ROOT_SCRIPTS) {
-				pbs_asprintf(&msgbuf,
-					"successfully sent hook file %s to %s:%d",
-					hookfile, minfo->mi_host, minfo->mi_port);
-				log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_INFO, msg_daemonname, msgbuf);
-				free(msgbuf);
-			} else {
-				pbs_asprintf(&msgbuf,
-					"warning: sending hook file %s to %s:%d got rejected (mom's reject_root_scripts=1)",
-					hookfile, minfo->mi_host, minfo->mi_port);
-				log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_REQUEST, LOG_INFO, msg_daemonname, msgbuf);
-				free(msgbuf);
-			}
-			pact->action &= ~(MOM_HOOK_ACTION_SEND_ATTRS);
-			hook_track_save((mominfo_t *) minfo, j);
-		}
-	}
-
-	if (event == MOM_HOOK_ACTION_SEND_CONFIG) {
-		snprintf(hookfile, sizeof(hookfile), "%.*s%.*s%s",
-			(int)(sizeof(hookfile) - PBS_HOOK_NAME_SIZE - strlen(HOOK_CONFIG_SUFFIX)),
-			path_hooks, PBS_HOOK_NAME_SIZE, pact->hookname, HOOK_CONFIG_SUFFIX);
-		if ((rc != 0) && (pbs_errno != PBSE_MOM_REJECT_ROOT_SCRIPTS)) {
+		} else if ((rc != 0) && (pbs_errno != PBSE_MOM_REJECT_ROOT_SCRIPTS)) {
 			pbs_asprintf(&msgbuf,
-				"errno %d: failed to copy hook file %s to %s:%d",
-				pbs_errno, hookfile, minfo->mi_host, minfo->mi_port);
+				"errno %d: failed to copy hook bundle %s for hook %s to %s:%d",
+				pbs_errno, hash, pact->hookname, minfo->mi_host, minfo->mi_port);
 			log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_REQUEST, LOG_WARNING, msg_daemonname, msgbuf);
 			free(msgbuf);
 		} else {
-			if (pbs_errno != PBSE_MOM_REJECT_ROOT_SCRIPTS) {
-				pbs_asprintf(&msgbuf,
-					"successfully sent hook file %s to %s:%d",
-					hookfile, minfo->mi_host, minfo->mi_port);
+			for (k = 0; k < HOOK_BUNDLE_NFILES; k++) {
+				if ((bundled & hook_bundle_files[k].action) == 0)
+					continue;
+				snprintf(hookfile, sizeof(hookfile), "%.*s%.*s%s",
+					(int)(sizeof(hookfile) - PBS_HOOK_NAME_SIZE - strlen(hook_bundle_files[k].suffix)),
+					path_hooks, PBS_HOOK_NAME_SIZE, pact->hookname, hook_bundle_files[k].suffix);
+				if (pbs_errno != PBSE_MOM_REJECT_ROOT_SCRIPTS)
+					pbs_asprintf(&msgbuf,
+						"successfully sent hook file %s to %s:%d",
+						hookfile, minfo->mi_host, minfo->mi_port);
+				else
+					pbs_asprintf(&msgbuf,
+						"warning: sending hook file %s to %s:%d got rejected (mom's reject_root_scripts=1)",
+						hookfile, minfo->mi_host, minfo->mi_port);
 				log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_INFO, msg_daemonname, msgbuf);
 				free(msgbuf);
-			} else {
-				pbs_asprintf(&msgbuf,
-					"warning: sending hook file %s to %s:%d got rejected (mom's reject_root_scripts=1)",
-					hookfile, minfo->mi_host, minfo->mi_port);
-				log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_REQUEST, LOG_INFO, msg_daemonname, msgbuf);
-				free(msgbuf);
 			}
-			pact->action &= ~(MOM_HOOK_ACTION_SEND_CONFIG);
-			hook_track_save((mominfo_t *) minfo, j);
-		}
-	}
-
-	if (event == MOM_HOOK_ACTION_SEND_SCRIPT) {
-		snprintf(hookfile, sizeof(hookfile), "%.*s%.*s%s",
-			(int)(sizeof(hookfile) - PBS_HOOK_NAME_SIZE - strlen(HOOK_SCRIPT_SUFFIX)),
-			path_hooks, PBS_HOOK_NAME_SIZE, pact->hookname, HOOK_SCRIPT_SUFFIX);
-		if ((rc != 0) && (pbs_errno != PBSE_MOM_REJECT_ROOT_SCRIPTS)) {
-			pbs_asprintf(&msgbuf,
-				"errno %d: failed to copy hook file %s to %s:%d",
-				pbs_errno, hookfile, minfo->mi_host, minfo->mi_port);
-			log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_REQUEST, LOG_WARNING, msg_daemonname, msgbuf);
-			free(msgbuf);
-		} else {
-			if (pbs_errno != PBSE_MOM_REJECT_ROOT_SCRIPTS) {
+			if (rc == 0) {
 				pbs_asprintf(&msgbuf,
-					"successfully sent hook file %s to %s:%d",
-					hookfile, minfo->mi_host, minfo->mi_port);
+					"hook bundle %s for hook %s acknowledged by %s:%d",
+					hash, pact->hookname, minfo->mi_host, minfo->mi_port);
 				log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_INFO, msg_daemonname, msgbuf);
 				free(msgbuf);
-			} else {
-				pbs_asprintf(&msgbuf,
-					"warning: sending hook file %s to %s:%d got rejected (mom's reject_root_scripts=1)",
-					hookfile, minfo->mi_host, minfo->mi_port);
-				log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_REQUEST, LOG_INFO, msg_daemonname, msgbuf);
-				free(msgbuf);
 			}
-			pact->action &= ~(MOM_HOOK_ACTION_SEND_SCRIPT);
-			hook_track_save((mominfo_t *) minfo, j);
+			pact->action &= ~(event & MOM_HOOK_SEND_ACTIONS);
 		}
 	}
 
@@ -5955,13 +6244,118 @@ post_sendhookRPP(struct work_task *pwt)
 	}
 }
 
+/**
+ * @brief
+ *		static helper function to load the hook bundle of a multicast
+ *		entry: the files of 'pm->hookname' named by the send actions in
+ *		'pm->action', read into memory in the order mom installs them
+ *		(control file, config, script), and the hash naming them.
+ *
+ * @note
+ *		A file that does not exist is left out of the bundle, as it
+ *		would be skipped when sent on its own.  If none exist the
+ *		bundle is empty and there is nothing to send.
+ *
+ * @param[in,out] pm - the multicast entry
+ *
+ * @return int
+ * @retval	0 - bundle loaded (possibly empty)
+ * @retval	-1 - error reading a file or computing the hash
+ */
+static int
+load_hook_bundle(hook_mcast_info_t *pm)
+{
+	int k;
+	int fd;
+	ssize_t cc;
+	long amt;
+	struct stat sbuf;
+	char hookfile[MAXPATHLEN+1];
+	struct hook_bundle_file *pf;
+
+	pm->bundled = 0;
+	pm->nfiles = 0;
+	pm->hash[0] = '\0';
+	pm->files = calloc(HOOK_BUNDLE_NFILES,
+		sizeof(struct hook_bundle_file));
+	if (pm->files == NULL) {
+		log_err(errno, __func__, "Could not allocate hook bundle");
+		return -1;
+	}
+
+	for (k = 0; k < HOOK_BUNDLE_NFILES; k++) {
+		if ((pm->action & hook_bundle_files[k].action) == 0)
+			continue;
+
+		snprintf(hookfile, sizeof(hookfile), "%s%s%s", path_hooks,
+			pm->hookname, hook_bundle_files[k].suffix);
+		if ((fd = open(hookfile, O_RDONLY, 0)) < 0)
+			continue;	/* ok, if nothing to copy */
+
+		pf = &pm->files[pm->nfiles];
+		if ((fstat(fd, &sbuf) == -1) ||
+			((pf->hbf_data = malloc(sbuf.st_size + 1)) == NULL)) {
+			log_err(errno, __func__, hookfile);
+			close(fd);
+			return -1;
+		}
+		pm->nfiles++;
+		snprintf(pf->hbf_name, sizeof(pf->hbf_name), "%s%s",
+			pm->hookname, hook_bundle_files[k].suffix);
+		for (amt = 0; amt < sbuf.st_size; amt += cc) {
+			cc = read(fd, pf->hbf_data + amt, sbuf.st_size - amt);
+			if (cc <= 0) {
+				log_err(errno, __func__, hookfile);
+				close(fd);
+				return -1;
+			}
+		}
+		pf->hbf_size = amt;
+		close(fd);
+		pm->bundled |= hook_bundle_files[k].action;
+	}
+
+	if ((pm->nfiles > 0) &&
+		(pbs_hook_bundle_hash(pm->files, pm->nfiles, pm->hash) != 0)) {
+		log_err(-1, __func__, "could not compute hook bundle hash");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *		static helper function to free the hook bundle of a multicast
+ *		entry.
+ *
+ * @param[in,out] pm - the multicast entry
+ *
+ * @return void
+ */
+static void
+free_hook_bundle(hook_mcast_info_t *pm)
+{
+	int k;
+
+	if (pm->files == NULL)
+		return;
+	for (k = 0; k < pm->nfiles; k++)
+		free(pm->files[k].hbf_data);
+	free(pm->files);
+	pm->files = NULL;
+	pm->nfiles = 0;
+}
+
 /**
  * @brief
  *		static helper function to check and add a hook command to a mom
  *		to a list of multicast commands.
  *
  *		A RPP multicast command consists of the same command to be sent to
- *		a groups of target moms.
+ *		a groups of target moms.  For the send actions the command is a
+ *		hook bundle, loaded once here when the entry is created and then
+ *		shared by every mom needing the same files of that hook.
  *
  * @param[in] conn      - The stream to the mom
  * @param[in] minfo     - The pointer to the mom info
@@ -5990,9 +6384,13 @@ check_add_hook_mcast_info(int conn, mominfo_t *minfo, char *hookname, int action
 		if ((info = mk_deferred_hook_info(act_index, action,
 						g_sync_hook_tid)) == NULL)
 			return NULL;
+		info->bundled = g_hook_mcast_array[i].bundled;
+		strcpy(info->hash, g_hook_mcast_array[i].hash);
 
-		if ((dup_msgid = strdup(g_hook_mcast_array[i].msgid)) == NULL)
+		if ((dup_msgid = strdup(g_hook_mcast_array[i].msgid)) == NULL) {
+			free(info);
 			return NULL;
+		}
 
 		if (add_mom_deferred_list(conn, minfo, post_sendhookRPP,
 					dup_msgid, minfo, info) == NULL) {
@@ -6022,29 +6420,50 @@ check_add_hook_mcast_info(int conn, mominfo_t *minfo, char *hookname, int action
 	g_hook_mcast_array = tmp;
 
 	g_hook_mcast_array[i].action = action;
+	g_hook_mcast_array[i].files = NULL;
+	g_hook_mcast_array[i].nfiles = 0;
+	g_hook_mcast_array[i].bundled = 0;
+	g_hook_mcast_array[i].hash[0] = '\0';
 	if ((g_hook_mcast_array[i].hookname = strdup(hookname)) == NULL)
 		return NULL;
 
-	if (get_msgid(&g_hook_mcast_array[i].msgid) != 0)
+	if ((action & MOM_HOOK_SEND_ACTIONS) &&
+		(load_hook_bundle(&g_hook_mcast_array[i]) != 0)) {
+		free_hook_bundle(&g_hook_mcast_array[i]);
+		free(g_hook_mcast_array[i].hookname);
+		return NULL;
+	}
+
+	if (get_msgid(&g_hook_mcast_array[i].msgid) != 0) {
+		free_hook_bundle(&g_hook_mcast_array[i]);
+		free(g_hook_mcast_array[i].hookname);
 		return NULL;
+	}
 
 	if ((info = mk_deferred_hook_info(act_index, action,
-					g_sync_hook_tid)) == NULL)
+					g_sync_hook_tid)) == NULL) {
+		free_hook_bundle(&g_hook_mcast_array[i]);
 		return NULL;
+	}
+	info->bundled = g_hook_mcast_array[i].bundled;
+	strcpy(info->hash, g_hook_mcast_array[i].hash);
 
 	if (add_mom_deferred_list(conn, minfo, post_sendhookRPP,
 				strdup(g_hook_mcast_array[i].msgid), minfo, info) == NULL) {
 		free(info);
+		free_hook_bundle(&g_hook_mcast_array[i]);
 		return NULL;
 	}
 
 	if ((g_hook_mcast_array[i].mconn = tpp_mcast_open()) == -1) {
 		free(info);
+		free_hook_bundle(&g_hook_mcast_array[i]);
 		return NULL;
 	}
 
 	if (tpp_mcast_add_strm(g_hook_mcast_array[i].mconn, conn) != 0) {
 		free(info);
+		free_hook_bundle(&g_hook_mcast_array[i]);
 		return NULL;
 	}
 
@@ -6138,6 +6557,11 @@ del_deferred_hook_cmds(int index)
  *		Performs actions such as send hook attributes/scripts, and also
  *		resourcedef file to a particular mom, or to all the moms in the
  *		system (this function performs this using RPP deferred requests).
+ *		At most sync_mom_hookfiles_batch moms are sent their updates per
+ *		call.  The control, config and script files of a hook go out
+ *		as one hook bundle, named by the hash of its contents, in a
+ *		single multicast to all the moms needing it; each mom
+ *		acknowledges the bundle by replying with that hash.
  *
  * @see
  * 		bg_sync_mom_hookfiles and bg_delete_mom_hooks
@@ -6163,10 +6587,24 @@ sync_mom_hookfilesRPP(void *minfo)
 	mom_hook_action_t *pact;
 	int		skipped = 0;
 	int ret = SYNC_HOOKFILES_NONE;
+	int		k;
+	int		batch_max;
+	int		nsent = 0;	/* moms sent updates in this batch */
+	int		npending = 0;	/* moms with pending updates */
+	int		start = 0;
+	int		more = 0;	/* moms left for the next batch */
+	int		expected;
+
+	batch_max = SYNC_MOM_HOOKFILES_BATCH_TPP;
+	if (server.sv_attr[(int)SRV_ATR_sync_mom_hookfiles_batch].at_flags & ATR_VFLAG_SET)
+		batch_max = server.sv_attr[(int)SRV_ATR_sync_mom_hookfiles_batch].at_val.at_long;
 
 	if (minfo == NULL) {
 		minfo_array = mominfo_array;
 		minfo_array_size = mominfo_array_size;
+		/* carry on from where the previous batch stopped */
+		if (g_sync_hook_cursor < minfo_array_size)
+			start = g_sync_hook_cursor;
 	} else {
 		minfo_array_tmp[0] = minfo;
 		minfo_array = (mominfo_t **)minfo_array_tmp;
@@ -6180,11 +6618,16 @@ sync_mom_hookfilesRPP(void *minfo)
 	log_event(PBSEVENT_DEBUG4, PBS_EVENTCLASS_SERVER,
 		LOG_INFO, __func__, log_buffer);
 
-	for (i = 0; i < minfo_array_size; i++) {
+	for (k = 0; k < minfo_array_size; k++) {
 
+		i = (start + k) % minfo_array_size;
 		if (minfo_array[i] == NULL)
 			continue;
 
+		if (sync_mom_hookfiles_count(minfo_array[i]) == 0)
+			continue;
+		npending++;
+
 		conn = ((mom_svrinfo_t *) minfo_array[i]->mi_data)->msr_stream;
 		if (conn == -1) {
 			skipped++;
@@ -6196,7 +6639,16 @@ sync_mom_hookfilesRPP(void *minfo)
 			continue;
 		}
 
+		if (nsent >= batch_max) {
+			/* leave this and the remaining moms to the next batch */
+			if (!more)
+				g_sync_hook_cursor = i;
+			more = 1;
+			continue;
+		}
+
 		rpp_add_close_func(conn, process_DreplyRPP); /* register a close handler */
+		expected = g_hook_replies_expected;
 
 		pbs_errno = 0;
 		for (j = 0; j < minfo_array[i]->mi_num_action; j++) {
@@ -6223,26 +6675,17 @@ sync_mom_hookfilesRPP(void *minfo)
 					ret = SYNC_HOOKFILES_FAIL;
 			}
 
+			/*
+			 * the control, config and script files of the hook go
+			 * as one bundle; moms needing the same files of the
+			 * hook share a single multicast of it
+			 */
 			phook = find_hook(pact->hookname);
-			if (pact->action & MOM_HOOK_ACTION_SEND_ATTRS) {
-				if (!phook || (phook->event & MOM_EVENTS) == 0)
-					pact->action &= ~MOM_HOOK_ACTION_SEND_ATTRS;
-				else if (!check_add_hook_mcast_info(conn, minfo_array[i], pact->hookname, MOM_HOOK_ACTION_SEND_ATTRS, j))
-					ret = SYNC_HOOKFILES_FAIL;
-			}
-
-			if (pact->action & MOM_HOOK_ACTION_SEND_CONFIG) {
-				if (!phook || (phook->event & MOM_EVENTS) == 0)
-					pact->action &= ~MOM_HOOK_ACTION_SEND_CONFIG;
-				else if (!check_add_hook_mcast_info(conn, minfo_array[i], pact->hookname, MOM_HOOK_ACTION_SEND_CONFIG, j))
-					ret = SYNC_HOOKFILES_FAIL;
-			}
-
-			if (pact->action & MOM_HOOK_ACTION_SEND_SCRIPT) {
+			if (pact->action & MOM_HOOK_SEND_ACTIONS) {
 				if (!phook || (phook->event & MOM_EVENTS) == 0)
-					pact->action &= ~MOM_HOOK_ACTION_SEND_SCRIPT;
+					pact->action &= ~MOM_HOOK_SEND_ACTIONS;
 				else if (!check_add_hook_mcast_info(conn, minfo_array[i], pact->hookname,
-							MOM_HOOK_ACTION_SEND_SCRIPT, j))
+							pact->action & MOM_HOOK_SEND_ACTIONS, j))
 					ret = SYNC_HOOKFILES_FAIL;
 			}
 
@@ -6254,8 +6697,23 @@ sync_mom_hookfilesRPP(void *minfo)
 					ret = SYNC_HOOKFILES_FAIL;
 			}
 		} /* j-loop */
+		if (g_hook_replies_expected > expected)
+			nsent++;
 	} /* i-loop */
 
+	if (minfo == NULL) {
+		if (!more)
+			g_sync_hook_cursor = 0;
+		if (npending > 0) {
+			snprintf(log_buffer, sizeof(log_buffer),
+				"sending hook updates to %d of %d moms with "
+				"pending hook updates (%d unreachable)",
+				nsent, npending, skipped);
+			log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER,
+				LOG_INFO, __func__, log_buffer);
+		}
+	}
+
 	/* now do the actual transmissions */
 	for (i = 0; i < g_hook_mcast_array_len; i++) {
 		char *msgid = g_hook_mcast_array[i].msgid;
@@ -6277,17 +6735,8 @@ sync_mom_hookfilesRPP(void *minfo)
 			snprintf(hookfile, sizeof(hookfile), "%s%s", hookname, HOOK_FILE_SUFFIX);
 			cmd = 1;
 			filetype = 2;
-		} else if (g_hook_mcast_array[i].action & MOM_HOOK_ACTION_SEND_ATTRS) {
-			snprintf(hookfile, sizeof(hookfile), "%s%s%s", path_hooks, hookname, HOOK_FILE_SUFFIX);
-			cmd = 2;
-			filetype = 2;
-		} else if (g_hook_mcast_array[i].action & MOM_HOOK_ACTION_SEND_CONFIG) {
-			snprintf(hookfile, sizeof(hookfile), "%s%s%s", path_hooks, hookname, HOOK_CONFIG_SUFFIX);
-			cmd = 2;
-			filetype = 2;
-		} else if (g_hook_mcast_array[i].action & MOM_HOOK_ACTION_SEND_SCRIPT) {
-			snprintf(hookfile, sizeof(hookfile), "%s%s%s", path_hooks, hookname, HOOK_SCRIPT_SUFFIX);
-			cmd = 2;
+		} else if (g_hook_mcast_array[i].action & MOM_HOOK_SEND_ACTIONS) {
+			cmd = 3;
 			filetype = 2;
 		} else {
 			cmd = 0;
@@ -6328,6 +6777,33 @@ sync_mom_hookfilesRPP(void *minfo)
 				snprintf(log_buffer, sizeof(log_buffer), "PBSD_copyhookfile(hookfile=%s)", hookfile);
 				log_event(PBSEVENT_DEBUG4, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__, log_buffer);
 			}
+		} else if (cmd == 3) {
+			hook_mcast_info_t *pm = &g_hook_mcast_array[i];
+
+			if (pm->nfiles == 0) {
+				snprintf(log_buffer, sizeof(log_buffer),
+					"hook %s: no hook files to bundle", hookname);
+				log_event(PBSEVENT_DEBUG4, PBS_EVENTCLASS_SERVER,
+					LOG_INFO, __func__, log_buffer);
+				/* no hookfile to copy */
+				del_deferred_hook_cmds(i);
+			} else if (PBSD_copyhookbundle(mconn, pm->files, pm->nfiles,
+				pm->hash, 1, &msgid) != 0) {
+				snprintf(log_buffer, sizeof(log_buffer),
+					"errno %d: failed to multicast hook bundle %s for hook %s",
+					pbs_errno, pm->hash, hookname);
+				log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__, log_buffer);
+				rc = -1;
+			} else {
+				int nmoms = 0;
+
+				(void)tpp_mcast_members(mconn, &nmoms);
+				snprintf(log_buffer, sizeof(log_buffer),
+					"multicast hook bundle %s for hook %s "
+					"(%d files) to %d moms", pm->hash, hookname,
+					pm->nfiles, nmoms);
+				log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__, log_buffer);
+			}
 		}
 
 		if (rc == -1) {
@@ -6338,6 +6814,7 @@ sync_mom_hookfilesRPP(void *minfo)
 
 		/* we are done with the mcast for this index */
 		tpp_mcast_close(mconn);
+		free_hook_bundle(&g_hook_mcast_array[i]);
 		free(g_hook_mcast_array[i].hookname);
 		free(g_hook_mcast_array[i].msgid);
 	}
@@ -6357,7 +6834,7 @@ sync_mom_hookfilesRPP(void *minfo)
 	}
 
 	/* set success to partial so that we come back and try again later */
-	if (skipped > 0)
+	if ((skipped > 0) || more)
 		ret = SYNC_HOOKFILES_SUCCESS_PARTIAL;
 
 	/* if we returned SYNC_HOOKFILES_NONE, then all hook actions were sent, no retry
@@ -127,6 +127,7 @@
 
 #ifndef PBS_MOM
 #include "avltree.h"
+#include "svr_snapshot.h"
 #endif
 
 #include "svrfunc.h"
@@ -339,6 +340,7 @@ job_alloc(void)
 	CLEAR_HEAD(pj->ji_tasks);
 	CLEAR_HEAD(pj->ji_failed_node_list);
 	CLEAR_HEAD(pj->ji_node_list);
+	CLEAR_HEAD(pj->ji_rused_sent);
 	pj->ji_taskid = TM_INIT_TASK;
 	pj->ji_numnodes = 0;
 	pj->ji_numrescs = 0;
@@ -372,6 +374,9 @@ job_alloc(void)
 	pj->ji_setup = NULL;
 #else	/* SERVER */
 	pj->ji_prunreq = NULL;
+	CLEAR_LINK(pj->ji_jobque_state);
+	CLEAR_LINK(pj->ji_jobowner);
+	pj->ji_ownerent = NULL;
 	CLEAR_HEAD(pj->ji_svrtask);
 	CLEAR_HEAD(pj->ji_rejectdest);
 	pj->ji_terminated = 0;
@@ -460,6 +465,11 @@ job_free(job *pj)
 		job_attr_def[i].at_free(&pj->ji_wattr[i]);
 	}
 
+	if (pj->ji_trace) {
+		free(pj->ji_trace);
+		pj->ji_trace = NULL;
+	}
+
 #ifndef PBS_MOM
 	{
 		/* Server only */
@@ -548,6 +558,7 @@ job_free(job *pj)
 
 	reliable_job_node_free(&pj->ji_failed_node_list);
 	reliable_job_node_free(&pj->ji_node_list);
+	free_attrlist(&pj->ji_rused_sent);
 
 	/*
 	 ** This gets rid of any dependent job structure(s) from ji_setup.
@@ -896,6 +907,7 @@ job_purge(job *pjob)
 		log_joberr(-1, __func__, msg_err_purgejob_db,
 			pjob->ji_qs.ji_jobid);
 	}
+	snap_journal_delete(pjob->ji_qs.ji_jobid);
 
 	if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_HasNodes) {
 		is_called_by_job_purge = 1;
@@ -50,6 +50,7 @@
  *	job_save_db()         -	save job to database
  *	job_or_resv_save_db() -	save to database (job/reservation)
  *	job_recov_db()        - recover(read) job from database
+ *	job_recov_db_all()    - recover(read) all jobs from database in bulk
  *	job_or_resv_recov_db() -	recover(read) job/reservation from database
  *	svr_to_db_job		  -	Load a server job object to a database job object
  *	db_to_svr_job		  - Load data from database job object to a server job object
@@ -78,6 +79,8 @@
 #include <time.h>
 
 #include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
 #include "server_limits.h"
 #include "list_link.h"
 #include "attribute.h"
@@ -98,6 +101,7 @@
 #include <memory.h>
 #include "libutil.h"
 #include "pbs_db.h"
+#include "svr_snapshot.h"
 
 
 #define MAX_SAVE_TRIES 3
@@ -123,6 +127,7 @@ extern int recov_attr_db(pbs_db_conn_t *conn,
 
 /* global data items */
 extern time_t time_now;
+extern int resc_access_perm;
 
 #ifndef PBS_MOM
 
@@ -138,7 +143,7 @@ extern time_t time_now;
  *
  * @return void
  */
-static void
+void
 svr_to_db_job(job *pjob, pbs_db_job_info_t *dbjob)
 {
 	memset(dbjob, 0, sizeof(pbs_db_job_info_t));
@@ -188,7 +193,7 @@ svr_to_db_job(job *pjob, pbs_db_job_info_t *dbjob)
  *
  * @return	void
  */
-static void
+void
 db_to_svr_job(job *pjob,  pbs_db_job_info_t *dbjob)
 {
 	/* Variables assigned constant values are not stored in the DB */
@@ -356,10 +361,15 @@ job_save_db(job *pjob, int updatetype)
 	obj.pbs_db_obj_type = PBS_DB_JOB;
 	obj.pbs_db_un.pbs_db_job = &dbjob;
 
+	/* until the new image is journaled, recover the job from the database */
+	if (updatetype != SAVEJOB_NEW)
+		snap_journal_intent(pjob->ji_qs.ji_jobid);
+
 	if (updatetype == SAVEJOB_QUICK) {
 		/* update database */
 		if (pbs_db_update_obj(conn, &obj) != 0)
 			goto db_err;
+		snap_journal_quick(&dbjob);
 	} else {
 
 		/*
@@ -402,6 +412,7 @@ job_save_db(job *pjob, int updatetype)
 
 		pjob->ji_modified = 0;
 		pjob->ji_newjob = 0; /* reset dontsave - job is now saved */
+		snap_journal_job(pjob);
 	}
 	return (0);
 db_err:
@@ -574,6 +585,321 @@ db_err:
 	return NULL;
 }
 
+/* One job of a bulk recovery, see job_recov_db_all() */
+struct recov_job {
+	job		*rj_job;	/* job being recovered */
+	pbs_list_head	rj_attrs;	/* its attributes, as read from the database */
+	void		**rj_palarray;	/* rj_attrs filed by attribute index */
+};
+
+/* Jobs shared by the decode threads of a bulk recovery */
+struct recov_pool {
+	pthread_mutex_t	rp_mutex;
+	struct recov_job *rp_jobs;
+	int		rp_njobs;
+	int		rp_next;	/* next job to decode */
+};
+
+/**
+ * @brief
+ *		Compare the job ids of two bulk recovery entries, for qsort/bsearch
+ *
+ * @param[in]	a - Address of a struct recov_job pointer
+ * @param[in]	b - Address of a struct recov_job pointer
+ *
+ * @return	int
+ * @retval	<0, 0, >0 as strcmp() of the job ids
+ */
+static int
+recov_job_cmp(const void *a, const void *b)
+{
+	return strcmp((*(struct recov_job **)a)->rj_job->ji_qs.ji_jobid,
+		(*(struct recov_job **)b)->rj_job->ji_qs.ji_jobid);
+}
+
+/**
+ * @brief
+ *		Compare a job id with the job id of a bulk recovery entry, for bsearch
+ *
+ * @param[in]	key - The job id
+ * @param[in]	elem - Address of a struct recov_job pointer
+ *
+ * @return	int
+ * @retval	<0, 0, >0 as strcmp() of the job ids
+ */
+static int
+recov_job_find(const void *key, const void *elem)
+{
+	return strcmp((char *)key,
+		(*(struct recov_job **)elem)->rj_job->ji_qs.ji_jobid);
+}
+
+/**
+ * @brief
+ *		Free the attributes of a bulk recovery entry and its job
+ *
+ * @param[in]	prj - The bulk recovery entry
+ *
+ * @return void
+ */
+static void
+recov_job_free(struct recov_job *prj)
+{
+	svrattrl *pal;
+	svrattrl *sister;
+	int	  i;
+
+	while ((pal = (svrattrl *)GET_NEXT(prj->rj_attrs)) != NULL) {
+		delete_link(&pal->al_link);
+		free(pal);
+	}
+	if (prj->rj_palarray != NULL) {
+		for (i = 0; i < JOB_ATR_LAST; i++) {
+			for (pal = prj->rj_palarray[i]; pal; pal = sister) {
+				sister = pal->al_sister;
+				free(pal);
+			}
+		}
+		free(prj->rj_palarray);
+		prj->rj_palarray = NULL;
+	}
+	if (prj->rj_job != NULL) {
+		job_free(prj->rj_job);
+		prj->rj_job = NULL;
+	}
+}
+
+/**
+ * @brief
+ *		Decode thread of a bulk job recovery.  Takes jobs off the pool one
+ *		at a time, files their attributes by index and decodes those that
+ *		recov_attr_db_predecode() allows off the main thread.
+ *
+ * @param[in]	arg - The struct recov_pool
+ *
+ * @return	NULL
+ *
+ * @par MT-safe: Yes
+ */
+static void *
+recov_job_worker(void *arg)
+{
+	struct recov_pool *pool = (struct recov_pool *)arg;
+	struct recov_job *prj;
+	svrattrl *pal;
+	void	**palarray;
+	int	  i;
+
+	for (;;) {
+		pthread_mutex_lock(&pool->rp_mutex);
+		i = pool->rp_next++;
+		pthread_mutex_unlock(&pool->rp_mutex);
+		if (i >= pool->rp_njobs)
+			break;
+
+		prj = &pool->rp_jobs[i];
+		palarray = calloc(JOB_ATR_LAST, sizeof(void *));
+		if (palarray == NULL)
+			continue;	/* rj_palarray left NULL, job fails */
+		while ((pal = (svrattrl *)GET_NEXT(prj->rj_attrs)) != NULL) {
+			delete_link(&pal->al_link);
+			(void)recov_attr_db_index(job_attr_def, palarray, pal,
+				(int)JOB_ATR_LAST, (int)JOB_ATR_UNKN);
+		}
+		(void)recov_attr_db_predecode(job_attr_def, prj->rj_job->ji_wattr,
+			palarray, (int)JOB_ATR_LAST);
+		prj->rj_palarray = palarray;
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *		Milliseconds elapsed between two times
+ */
+static long
+recov_ms(struct timeval *from, struct timeval *to)
+{
+	return ((to->tv_sec - from->tv_sec) * 1000L +
+		(to->tv_usec - from->tv_usec) / 1000L);
+}
+
+/**
+ * @brief
+ *		Recover all the jobs of an open job cursor in bulk.
+ *
+ *		The job rows come from the cursor and the attributes of every job
+ *		from a single query ordered by job id, instead of two queries per
+ *		job.  The attributes are filed and, where their decoders allow it,
+ *		decoded on nthreads threads.  Then, on the calling thread and in
+ *		cursor order, the remaining attributes are decoded and their
+ *		recovery actions run, and func is called with each job.  The time
+ *		spent in each phase is logged.
+ *
+ * @see
+ * 		pbsd_init
+ *
+ * @param[in]	state - Job cursor, as opened by pbsd_init
+ * @param[in]	nthreads - Number of decode threads
+ * @param[in]	func - Called with each recovered job, or NULL and the job id
+ *			of a job that could not be recovered
+ * @param[in]	arg - Passed to func
+ *
+ * @return	int
+ * @retval	>=0 - number of jobs passed to func
+ * @retval	-1  - failure, nothing was passed to func and the job cursor
+ *			is consumed; the caller may recover the jobs one by one
+ *
+ */
+int
+job_recov_db_all(void *state, int nthreads,
+	void (*func)(job *, char *, void *), void *arg)
+{
+	pbs_db_conn_t		*conn = svr_db_conn;
+	pbs_db_job_info_t	dbjob;
+	pbs_db_attr_info_t	attr_info;
+	pbs_db_obj_info_t	obj;
+	pbs_db_query_options_t	opts;
+	struct recov_pool	pool;
+	struct recov_job	**idx = NULL;
+	struct recov_job	*prj = NULL;
+	struct recov_job	**found;
+	pthread_t		*tids = NULL;
+	void			*attr_state;
+	svrattrl		*pal;
+	struct timeval		t0, t1, t2, t3;
+	char			jobid[PBS_MAXSVRJOBID + 1];
+	int			nstarted = 0;
+	int			nattrs = 0;
+	int			count;
+	int			i;
+
+	gettimeofday(&t0, NULL);
+
+	memset(&pool, 0, sizeof(pool));
+	count = pbs_db_get_rowcount(state);
+	if (count <= 0)
+		return -1;
+	pool.rp_jobs = calloc(count, sizeof(struct recov_job));
+	idx = calloc(count, sizeof(struct recov_job *));
+	if ((pool.rp_jobs == NULL) || (idx == NULL)) {
+		log_err(errno, __func__, "Out of memory");
+		goto err;
+	}
+
+	/* the job rows */
+	obj.pbs_db_obj_type = PBS_DB_JOB;
+	obj.pbs_db_un.pbs_db_job = &dbjob;
+	while ((pool.rp_njobs < count) &&
+		(pbs_db_cursor_next(conn, state, &obj) == 0)) {
+		prj = &pool.rp_jobs[pool.rp_njobs];
+		CLEAR_HEAD(prj->rj_attrs);
+		if ((prj->rj_job = job_alloc()) == NULL)
+			goto err;
+		db_to_svr_job(prj->rj_job, &dbjob);
+		idx[pool.rp_njobs++] = prj;
+	}
+	qsort(idx, pool.rp_njobs, sizeof(struct recov_job *), recov_job_cmp);
+
+	/* the attributes of every job, grouped by job id */
+	memset(&attr_info, 0, sizeof(attr_info));
+	attr_info.parent_obj_type = PARENT_TYPE_JOB;
+	obj.pbs_db_obj_type = PBS_DB_ATTR;
+	obj.pbs_db_un.pbs_db_attr = &attr_info;
+	opts.flags = PBS_DB_ATTR_ALL_PARENTS;
+	opts.timestamp = 0;
+	if ((attr_state = pbs_db_cursor_init(conn, &obj, &opts)) == NULL)
+		goto err;
+
+	prj = NULL;
+	while (pbs_db_cursor_next(conn, attr_state, &obj) == 0) {
+		if ((prj == NULL) || strcmp(prj->rj_job->ji_qs.ji_jobid,
+			attr_info.parent_id)) {
+			found = bsearch(attr_info.parent_id, idx, pool.rp_njobs,
+				sizeof(struct recov_job *), recov_job_find);
+			prj = (found != NULL) ? *found : NULL;
+			if (prj == NULL)
+				continue;	/* job row is gone */
+		}
+
+		pal = make_attr(attr_info.attr_name, attr_info.attr_resc,
+			attr_info.attr_value, attr_info.attr_flags);
+		if (pal == NULL) {
+			log_err(-1, __func__, "Out of memory");
+			pbs_db_cursor_close(conn, attr_state);
+			goto err;
+		}
+		CLEAR_LINK(pal->al_link);
+		pal->al_refct = 1;	/* ref count reset to 1 */
+		append_link(&prj->rj_attrs, &pal->al_link, pal);
+		nattrs++;
+	}
+	pbs_db_cursor_close(conn, attr_state);
+	free(idx);
+	idx = NULL;
+
+	/* file and decode the attributes */
+	gettimeofday(&t1, NULL);
+	pthread_mutex_init(&pool.rp_mutex, NULL);
+	if (nthreads > pool.rp_njobs)
+		nthreads = pool.rp_njobs;
+	if ((nthreads > 1) &&
+		((tids = calloc(nthreads - 1, sizeof(pthread_t))) != NULL)) {
+		for (i = 0; i < nthreads - 1; i++) {
+			if (pthread_create(&tids[nstarted], NULL,
+				recov_job_worker, &pool) == 0)
+				nstarted++;
+		}
+	}
+	(void)recov_job_worker(&pool);
+	for (i = 0; i < nstarted; i++)
+		pthread_join(tids[i], NULL);
+	free(tids);
+	pthread_mutex_destroy(&pool.rp_mutex);
+	gettimeofday(&t2, NULL);
+
+	/* finish each job and hand it over, in cursor order */
+	resc_access_perm = ATR_DFLAG_ACCESS;
+	for (i = 0; i < pool.rp_njobs; i++) {
+		prj = &pool.rp_jobs[i];
+		strcpy(jobid, prj->rj_job->ji_qs.ji_jobid);
+		if (prj->rj_palarray == NULL) {
+			recov_job_free(prj);
+			sprintf(log_buffer, "Failed to recover job %s", jobid);
+			log_err(-1, "job_recov", log_buffer);
+			func(NULL, jobid, arg);
+			continue;
+		}
+		recov_attr_db_decode(prj->rj_job, job_attr_def,
+			prj->rj_job->ji_wattr, prj->rj_palarray, (int)JOB_ATR_LAST);
+		free(prj->rj_palarray);
+		prj->rj_palarray = NULL;
+		func(prj->rj_job, jobid, arg);
+		prj->rj_job = NULL;
+	}
+	gettimeofday(&t3, NULL);
+
+	sprintf(log_buffer, "recovered %d jobs with %d attributes: "
+		"load %ld ms, decode %ld ms on %d threads, init %ld ms",
+		pool.rp_njobs, nattrs, recov_ms(&t0, &t1), recov_ms(&t1, &t2),
+		nstarted + 1, recov_ms(&t2, &t3));
+	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO,
+		msg_daemonname, log_buffer);
+
+	free(pool.rp_jobs);
+	return pool.rp_njobs;
+
+err:
+	for (i = 0; i < pool.rp_njobs; i++)
+		recov_job_free(&pool.rp_jobs[i]);
+	free(pool.rp_jobs);
+	free(idx);
+	sprintf(log_buffer, "bulk job recovery failed after %d jobs",
+		pool.rp_njobs);
+	log_err(-1, __func__, log_buffer);
+	return -1;
+}
+
 /**
  * @brief
  *		Recover resv from database
@@ -2278,10 +2278,102 @@ decode_stat_update(int stream, struct resc_used_update *prused)
 }
 
 
+/**
+ * @brief
+ *		Apply an update from Mom which carries nothing but resources_used
+ *		values, and optionally an unchanged session id, directly to the
+ *		job's resources_used attribute.
+ * @par Functionality:
+ *		This is the update sent for every running job at each polling
+ *		interval.  Unlike modify_job_attr(), only the resources named
+ *		in the update are decoded and set, and the job is not saved;
+ *		resources_used is not saved on modify (ATR_DFLAG_NOSAVM) and
+ *		goes to the database with the next save of the job.
+ *
+ * @param[in] pjob - job being updated
+ * @param[in] plist - attributes of the update
+ *
+ * @return	int
+ * @retval	0	update applied
+ * @retval	-1	update has other content or could not be decoded,
+ *			use the general path
+ */
+static int
+stat_update_used(job *pjob, pbs_list_head *plist)
+{
+	svrattrl	*psatl;
+	attribute	*pused;
+	attribute	 tmp;
+	resource_def	*prdef;
+	resource	*presc;
+	attribute	*psid = &pjob->ji_wattr[(int)JOB_ATR_session_id];
+
+	/* first make sure the update holds nothing else */
+	for (psatl = (svrattrl *)GET_NEXT(*plist); psatl != NULL;
+		psatl = (svrattrl *)GET_NEXT(psatl->al_link)) {
+		if (psatl->al_flags & ATR_VFLAG_HOOK)
+			return -1;
+		if (strcmp(psatl->al_name, ATTR_used) == 0) {
+			if ((psatl->al_resc == NULL) || (psatl->al_value == NULL) ||
+				(*psatl->al_value == '@') ||
+				(find_resc_def(svr_resc_def, psatl->al_resc,
+				svr_resc_size) == NULL))
+				return -1;
+		} else if (strcmp(psatl->al_name, ATTR_session) == 0) {
+			if (((psid->at_flags & ATR_VFLAG_SET) == 0) ||
+				(psatl->al_value == NULL) ||
+				(atol(psatl->al_value) != psid->at_val.at_long))
+				return -1;
+		} else
+			return -1;
+	}
+
+	pused = &pjob->ji_wattr[(int)JOB_ATR_resc_used];
+	if ((pused->at_flags & ATR_VFLAG_SET) == 0)
+		CLEAR_HEAD(pused->at_val.at_list);
+
+	for (psatl = (svrattrl *)GET_NEXT(*plist); psatl != NULL;
+		psatl = (svrattrl *)GET_NEXT(psatl->al_link)) {
+		if (strcmp(psatl->al_name, ATTR_used) != 0)
+			continue;
+		prdef = find_resc_def(svr_resc_def, psatl->al_resc, svr_resc_size);
+
+		memset(&tmp, 0, sizeof(tmp));
+		tmp.at_type = prdef->rs_type;
+		if ((prdef->rs_decode(&tmp, psatl->al_name, psatl->al_resc,
+			psatl->al_value) != 0) ||
+			((tmp.at_flags & ATR_VFLAG_SET) == 0)) {
+			prdef->rs_free(&tmp);
+			return -1;
+		}
+
+		presc = find_resc_entry(pused, prdef);
+		if (presc == NULL) {
+			if ((presc = add_resource_entry(pused, prdef)) == NULL) {
+				prdef->rs_free(&tmp);
+				return -1;
+			}
+		} else if ((presc->rs_value.at_flags & ATR_VFLAG_SET) &&
+			(prdef->rs_comp(&presc->rs_value, &tmp) == 0)) {
+			prdef->rs_free(&tmp);
+			continue;	/* unchanged */
+		}
+		if (prdef->rs_set(&presc->rs_value, &tmp, SET) != 0) {
+			prdef->rs_free(&tmp);
+			return -1;
+		}
+		prdef->rs_free(&tmp);
+		pused->at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODCACHE | ATR_VFLAG_MODIFY;
+	}
+	return 0;
+}
+
 /**
  * @brief
  *		Update job resource usage based on information sent from Mom.
- *		All updates include the lastest information on resource usage.
+ *		Updates carry the resources_used values changed since the last
+ *		update; those with nothing else are applied by
+ *		stat_update_used().
  * @par Functionality:
  *		An update from Mom also contains certain attributes which
  *		need to be recorded,  the most inportant of which is the job's
@@ -2338,6 +2430,10 @@ stat_update(int stream)
 			char		*cur_execvnode = NULL;
 			char		*cur_schedselect = NULL;
 
+			/* the periodic usage update, nothing to save */
+			if (stat_update_used(pjob, &rused.ru_attr) == 0)
+				goto next_job;
+
 			if (pjob->ji_wattr[(int)JOB_ATR_exec_vnode].at_flags & ATR_VFLAG_SET)
 				cur_execvnode = pjob->ji_wattr[(int)JOB_ATR_exec_vnode].at_val.at_str;
 
@@ -2497,6 +2593,7 @@ stat_update(int stream)
 				pjob->ji_modified = 0;
 			}
 		}
+next_job:
 		(void)free(rused.ru_comment);
 		rused.ru_comment = NULL;
 		(void)free(rused.ru_pjobid);
@@ -5410,8 +5507,11 @@ found:
 				unsigned long chksum_py;
 				unsigned long chksum_cf;
 				unsigned int  haction;
+				unsigned int  hdone;
+				mom_hook_action_t *pact;
 
 				haction = 0;
+				hdone = 0;
 				/* hook name */
 				hname = disrst(stream, &ret);
 				if ((ret != DIS_SUCCESS) || (hname == NULL))
@@ -5511,6 +5611,33 @@ found:
 						hname, haction);
 				}
 
+				/* mom already has the server's copy of these */
+				/* files, so drop any pending resend of them */
+				if ((phook->hook_control_checksum > 0) &&
+				    (phook->hook_control_checksum == chksum_hk))
+					hdone |= MOM_HOOK_ACTION_SEND_ATTRS;
+				if ((phook->hook_script_checksum > 0) &&
+				    (phook->hook_script_checksum == chksum_py))
+					hdone |= MOM_HOOK_ACTION_SEND_SCRIPT;
+				if ((phook->hook_config_checksum > 0) &&
+				    (phook->hook_config_checksum == chksum_cf))
+					hdone |= MOM_HOOK_ACTION_SEND_CONFIG;
+				pact = find_mom_hook_action(pmom->mi_action,
+					pmom->mi_num_action, hname);
+				if ((pact != NULL) && (pact->action & hdone)) {
+					snprintf(log_buffer, sizeof(log_buffer),
+						"mom (%s) hook files match the "
+						"server's, dropping pending "
+						"send action %d",
+						pmom->mi_host, pact->action & hdone);
+					log_event(PBSEVENT_DEBUG3,
+						PBS_EVENTCLASS_HOOK,
+						LOG_INFO, phook->hook_name,
+						log_buffer);
+					delete_pending_mom_hook_action(pmom,
+						hname, pact->action & hdone);
+				}
+
 				if (add_to_svrattrl_list(&reported_hooks, hname,
 					NULL, NULL, 0, NULL) == -1) {
 					log_event(PBSEVENT_DEBUG3,
@@ -123,6 +123,7 @@
 #include "hook.h"
 #include "hook_func.h"
 #include "pbs_share.h"
+#include "svr_snapshot.h"
 
 #ifndef SIGKILL
 /* there is some weid stuff in gcc include files signal.h & sys/params.h */
@@ -229,6 +230,7 @@ static int   pbsd_init_reque(job *job, int change_state);
 static void  resume_net_move(struct work_task *);
 static void  stop_me(int);
 static int   Rmv_if_resv_not_possible(job *);
+static void  recov_job_init(job *, char *, void *);
 static int   attach_queue_to_reservation(resc_resv *);
 static void  call_log_license(struct work_task *);
 extern int create_resreleased(job *pjob);
@@ -238,6 +240,12 @@ extern pbs_sched *sched_alloc(char *sched_name);
 
 #define CHANGE_STATE 1
 #define KEEP_STATE   0
+
+/* state of the job recovery loop of pbsd_init(), see recov_job_init() */
+struct recov_init_info {
+	int	ri_type;	/* type of initialization */
+	int	ri_numjobs;	/* jobs recovered so far */
+};
 static char badlicense[] = "One or more PBS license keys are invalid, jobs may not run";
 
 /**
@@ -365,13 +373,15 @@ pbsd_init(int type)
 	char	*hook_suffix = HOOK_FILE_SUFFIX;
 	int	hook_suf_len = strlen(hook_suffix);
 	int	 logtype;
-	int	 numjobs;
+	struct recov_init_info recov_info;
 	job	*pjob;
 	hook	*phook, *phook_current;
 	pbs_queue *pque;
 	resc_resv *presv;
+	resource_def *prdef;
 	char	*psuffix;
 	int	 rc;
+	int	 snap;
 	struct stat statbuf;
 	char	hook_msg[HOOK_MSG_SIZE];
 #ifndef WIN32
@@ -637,6 +647,19 @@ pbsd_init(int type)
 			return (-1);
 	}
 
+	/* enter the attribute and resource names shared by status replies */
+	for (prdef = svr_resc_def; prdef != NULL; prdef = prdef->rs_next) {
+		if (attr_intern(prdef->rs_name) == NULL)
+			break;
+	}
+	if ((prdef != NULL) ||
+		(attr_intern_defs(job_attr_def, JOB_ATR_LAST) == -1) ||
+		(attr_intern_defs(svr_attr_def, SRV_ATR_LAST) == -1) ||
+		(attr_intern_defs(que_attr_def, QA_ATR_LAST) == -1) ||
+		(attr_intern_defs(node_attr_def, ND_ATR_LAST) == -1) ||
+		(attr_intern_defs(resv_attr_def, RESV_ATR_LAST) == -1))
+		log_err(errno, __func__, "unable to enter shared attribute names");
+
 	/* 3. Set default server attibutes values */
 
 	if (server.sv_attr[(int)SRV_ATR_scheduling].at_flags & ATR_VFLAG_SET)
@@ -943,6 +966,9 @@ pbsd_init(int type)
 
 	server.sv_qs.sv_numjobs = 0;
 
+	/* map the snapshot of the jobs, if any */
+	snap = snap_init(type);
+
 	/* get jobs from DB */
 	obj.pbs_db_obj_type = PBS_DB_JOB;
 	obj.pbs_db_un.pbs_db_job = &dbjob;
@@ -962,50 +988,27 @@ pbsd_init(int type)
 		}
 	} else {
 		/* Now, for each job found ... */
-		numjobs = 0;
-		while ((rc = pbs_db_cursor_next(conn, state, &obj)) == 0) {
-			if ((pjob = job_recov(dbjob.ji_jobid)) == NULL) {
-				if ((type == RECOV_COLD) || (type == RECOV_CREATE)) {
-					/* remove the loaded job from db */
-					if (pbs_db_delete_obj(conn, &obj) != 0) {
-						sprintf(log_buffer, "job %s not purged", dbjob.ji_jobid);
-						log_err(-1, __func__, log_buffer);
-					}
-				} else {
-					sprintf(log_buffer, "Failed to recover job %s", dbjob.ji_jobid);
-					log_event(PBSEVENT_SYSTEM,
-						PBS_EVENTCLASS_SERVER, LOG_NOTICE,
-						msg_daemonname, log_buffer);
-				}
-				continue;
+		recov_info.ri_type = type;
+		recov_info.ri_numjobs = 0;
+		if (snap) {
+			/* rebuild from the snapshot the jobs that have an image */
+			while (pbs_db_cursor_next(conn, state, &obj) == 0) {
+				if ((pjob = snap_recov_job(&dbjob)) == NULL)
+					pjob = job_recov(dbjob.ji_jobid);
+				recov_job_init(pjob, dbjob.ji_jobid, &recov_info);
 			}
-
-			/*chk if job belongs to a reservation or
-			 *is a reservation job.  If this is true
-			 *and the reservation is no longer possible,
-			 *return (1) else return (0)
-			 */
-			if (Rmv_if_resv_not_possible(pjob)) {
-				account_record(PBS_ACCT_ABT, pjob, "");
-				svr_mailowner(pjob, MAIL_ABORT, MAIL_NORMAL,
-					msg_init_abt);
-				check_block(pjob, msg_init_abt);
-				job_purge(pjob);
-				continue;
-			}
-
-			rc = pbsd_init_job(pjob, type);
-			/*
-			 *	in the db version, job always has job script
-			 *	since they are saved together, so nothing to
-			 *	check
-			 *
-			 */
-			if ((++numjobs % 20) == 0) {
-				/* periodically touch the file so the  */
-				/* world knows we are alive and active */
-				(void)update_svrlive();
+		} else if ((pbs_conf.pbs_recov_threads == 0) ||
+			(job_recov_db_all(state, (int)pbs_conf.pbs_recov_threads,
+			recov_job_init, &recov_info) < 0)) {
+			if (pbs_conf.pbs_recov_threads != 0) {
+				/* bulk recovery failed, go over the jobs one by one */
+				pbs_db_cursor_close(conn, state);
+				state = pbs_db_cursor_init(conn, &obj, NULL);
 			}
+			while ((state != NULL) &&
+				(pbs_db_cursor_next(conn, state, &obj) == 0))
+				recov_job_init(job_recov(dbjob.ji_jobid),
+					dbjob.ji_jobid, &recov_info);
 		}
 
 		sprintf(log_buffer, msg_init_exptjobs,
@@ -1018,6 +1021,7 @@ pbsd_init(int type)
 	/* close transaction */
 	if (pbs_db_end_trx(conn, PBS_DB_COMMIT) != 0)
 		return (-1);
+	snap_recov_done();
 
 	/* If we have trial licenses, we would need to immediately   */
 	/* license the jobs under svr_unlicensedjobs list.           */
@@ -1129,6 +1133,8 @@ pbsd_init(int type)
 	 */
 
 	cleanup_hooks_workdir(0);
+	(void)set_task(WORK_Timed, time_now + HOOK_STATS_LOG_INTERVAL,
+		log_hook_stats, NULL);
 
 	/* Put us back in the Server's Private directory */
 
@@ -1834,6 +1840,74 @@ pbsd_init_job(job *pjob, int type)
 	return 0;
 }
 
+/**
+ * @brief
+ * 		recov_job_init - bring a job recovered from the database into the
+ *		server, or deal with a job that could not be recovered.
+ *
+ * @see
+ *		pbsd_init, job_recov_db_all
+ *
+ * @param[in]	pjob	- the recovered job, NULL if recovery failed
+ * @param[in]	jobid	- the id of the job
+ * @param[in]	arg	- struct recov_init_info of pbsd_init
+ *
+ * @return	void
+ */
+static void
+recov_job_init(job *pjob, char *jobid, void *arg)
+{
+	struct recov_init_info *pri = (struct recov_init_info *)arg;
+	pbs_db_job_info_t	dbjob;
+	pbs_db_obj_info_t	obj;
+
+	if (pjob == NULL) {
+		if ((pri->ri_type == RECOV_COLD) || (pri->ri_type == RECOV_CREATE)) {
+			/* remove the loaded job from db */
+			strcpy(dbjob.ji_jobid, jobid);
+			obj.pbs_db_obj_type = PBS_DB_JOB;
+			obj.pbs_db_un.pbs_db_job = &dbjob;
+			if (pbs_db_delete_obj(svr_db_conn, &obj) != 0) {
+				sprintf(log_buffer, "job %s not purged", jobid);
+				log_err(-1, __func__, log_buffer);
+			}
+		} else {
+			sprintf(log_buffer, "Failed to recover job %s", jobid);
+			log_event(PBSEVENT_SYSTEM,
+				PBS_EVENTCLASS_SERVER, LOG_NOTICE,
+				msg_daemonname, log_buffer);
+		}
+		return;
+	}
+
+	/*chk if job belongs to a reservation or
+	 *is a reservation job.  If this is true
+	 *and the reservation is no longer possible,
+	 *return (1) else return (0)
+	 */
+	if (Rmv_if_resv_not_possible(pjob)) {
+		account_record(PBS_ACCT_ABT, pjob, "");
+		svr_mailowner(pjob, MAIL_ABORT, MAIL_NORMAL,
+			msg_init_abt);
+		check_block(pjob, msg_init_abt);
+		job_purge(pjob);
+		return;
+	}
+
+	(void)pbsd_init_job(pjob, pri->ri_type);
+	/*
+	 *	in the db version, job always has job script
+	 *	since they are saved together, so nothing to
+	 *	check
+	 *
+	 */
+	if ((++pri->ri_numjobs % 20) == 0) {
+		/* periodically touch the file so the  */
+		/* world knows we are alive and active */
+		(void)update_svrlive();
+	}
+}
+
 /**
  * @brief
  * 		pbsd_init_reque - re-enqueue the job into the queue it was in
@@ -139,6 +139,8 @@
 #include "pbs_db.h"
 #include "pbs_sched.h"
 #include "pbs_share.h"
+#include "pbs_trace.h"
+#include "svr_snapshot.h"
 
 #include <pbs_python.h>  /* for python interpreter */
 
@@ -1952,6 +1954,9 @@ try_db_again:
 	log_event(PBSEVENT_SYSTEM | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER,
 		LOG_INFO, msg_daemonname, log_buffer);
 
+	/* in the background now, hand logging to the writer thread if configured */
+	(void)log_async_start();
+	(void)trace_open(path_log, "server");
 
 	/* setup the periodic ping_nodes functionality */
 	setup_ping(0);
@@ -2143,6 +2148,9 @@ try_db_again:
 			reap_child();
 #endif	/* WIN32 */
 
+		/* write out the spans of the last pass before sleeping */
+		trace_flush();
+
 		/* wait for a request and process it */
 		if (wait_request(waittime) != 0) {
 			log_err(-1, msg_daemonname, "wait_requst failed");
@@ -2198,6 +2206,8 @@ try_db_again:
 		(void)save_nodes_db(0, NULL);
 	}
 
+	snap_shutdown();	/* final snapshot of the jobs */
+
 	/* if brought up the Secondary Scheduler, take it down */
 
 	if (brought_up_alt_sched == 1)
@@ -2284,6 +2294,7 @@ try_db_again:
 	log_event(PBSEVENT_SYSTEM | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER,
 		LOG_NOTICE, msg_daemonname, msg_svrdown);
 	acct_close();
+	trace_close();
 	log_close(1);
 	free(keep_daemon_name); /* logs closed, can free here */
 
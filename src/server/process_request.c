@@ -109,6 +109,7 @@
 #include "pbs_nodes.h"
 #include "svrfunc.h"
 #include "pbs_sched.h"
+#include "pbs_trace.h"
 
 /* global data items */
 
@@ -593,6 +594,13 @@ dispatch_request(int sfds, struct batch_request *request)
 		}
 	}
 
+	if ((request->rq_trace != NULL) && trace_active()) {
+		char stage[PBS_TRACE_STAGELEN + 1];
+
+		snprintf(stage, sizeof(stage), "request.%d", request->rq_type);
+		trace_span(request->rq_trace, NULL, stage);
+	}
+
 	switch (request->rq_type) {
 
 		case PBS_BATCH_QueueJob:
@@ -707,6 +715,16 @@ dispatch_request(int sfds, struct batch_request *request)
 			req_holdjob(request);
 			break;
 #ifndef PBS_MOM
+		case PBS_BATCH_JobList:
+			if (sfds != PBS_LOCAL_CONNECTION && !rpp)
+				conn->cn_authen |= PBS_NET_CONN_NOTIMEOUT;
+			req_joblist(request);
+			break;
+
+		case PBS_BATCH_SubmitBatch:
+			req_submitbatch(request);
+			break;
+
 		case PBS_BATCH_LocateJob:
 			req_locatejob(request);
 			break;
@@ -955,6 +973,13 @@ dispatch_request(int sfds, struct batch_request *request)
 				"delete hook-related file request received");
 			req_del_hookfile(request);
 			break;
+		case PBS_BATCH_CopyHookBundle:
+			log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_HOOK,
+				LOG_INFO,
+				request->rq_ind.rq_hookbundle.rq_hash,
+				"copy hook bundle request received");
+			req_copy_hookbundle(request);
+			break;
 
 #endif
 		default:
@@ -1246,6 +1271,10 @@ decode_DIS_RelnodesJob(int sock, struct batch_request *preq)
 void
 free_br(struct batch_request *preq)
 {
+#ifndef PBS_MOM
+	int i;
+#endif
+
 	delete_link(&preq->rq_link);
 	reply_free(&preq->rq_reply);
 
@@ -1275,6 +1304,8 @@ free_br(struct batch_request *preq)
 	 */
 	if (preq->rq_extend)
 		(void)free(preq->rq_extend);
+	if (preq->rq_trace)
+		(void)free(preq->rq_trace);
 
 	switch (preq->rq_type) {
 		case PBS_BATCH_QueueJob:
@@ -1296,6 +1327,15 @@ free_br(struct batch_request *preq)
 			if (preq->rq_ind.rq_hookfile.rq_data)
 				(void)free(preq->rq_ind.rq_hookfile.rq_data);
 			break;
+		case PBS_BATCH_CopyHookBundle:
+			if (preq->rq_ind.rq_hookbundle.rq_files) {
+				int i;
+
+				for (i = 0; i < preq->rq_ind.rq_hookbundle.rq_count; i++)
+					free(preq->rq_ind.rq_hookbundle.rq_files[i].hbf_data);
+				(void)free(preq->rq_ind.rq_hookbundle.rq_files);
+			}
+			break;
 		case PBS_BATCH_HoldJob:
 			freebr_manage(&preq->rq_ind.rq_hold.rq_orig);
 			break;
@@ -1359,6 +1399,16 @@ free_br(struct batch_request *preq)
 		case PBS_BATCH_ReleaseJob:
 			freebr_manage(&preq->rq_ind.rq_release);
 			break;
+		case PBS_BATCH_JobList:
+			if (preq->rq_ind.rq_joblist.rq_jobs) {
+				for (i = 0; i < preq->rq_ind.rq_joblist.rq_count; i++)
+					(void)free(preq->rq_ind.rq_joblist.rq_jobs[i]);
+				(void)free(preq->rq_ind.rq_joblist.rq_jobs);
+			}
+			if (preq->rq_ind.rq_joblist.rq_arg)
+				(void)free(preq->rq_ind.rq_joblist.rq_arg);
+			free_attrlist(&preq->rq_ind.rq_joblist.rq_attr);
+			break;
 		case PBS_BATCH_Rescq:
 		case PBS_BATCH_ReserveResc:
 		case PBS_BATCH_ReleaseResc:
@@ -120,6 +120,8 @@ que_alloc(char *name)
 	pq->qu_qs.qu_type = QTYPE_Unset;
 	CLEAR_HEAD(pq->qu_jobs);
 	CLEAR_LINK(pq->qu_link);
+	for (i = 0; i < PBS_NUMJOBSTATE; i++)
+		CLEAR_HEAD(pq->qu_jobstate[i]);
 
 	snprintf(pq->qu_qs.qu_name, PBS_MAXQUEUENAME, "%s", name);
 	append_link(&svr_queues, &pq->qu_link, pq);
@@ -47,6 +47,7 @@
  *	req_reject()  - send a basic error return
  *	reply_text()  - send a return with a supplied text string
  *	reply_jobid() - used by several requests where the job id must be sent
+ *	reply_jobresult() - add the result of one job to a job list reply
  *	reply_free()  - free the substructure that might hang from a reply
  *	set_err_msg() - set a message relating to the error "code"
  *	dis_reply_write()	- reply is sent to a remote client
@@ -57,6 +58,7 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <sys/types.h>
@@ -184,7 +186,12 @@ dis_reply_write(int sfds, struct batch_request *preq)
 		 * either in encode_DIS_reply() or directly below.
 		 */
 		pbs_tcp_errno = 0;
-		DIS_tcp_setup(sfds);		/* setup for DIS over tcp */
+		if (DIS_tcp_rpending(sfds) > 0) {
+			/* keep the requests pipelined behind this one */
+			DIS_tcp_funcs();
+			DIS_tcp_reset(sfds, 1);
+		} else
+			DIS_tcp_setup(sfds);	/* setup for DIS over tcp */
 
 		rc = encode_DIS_reply(sfds, preply);
 	}
@@ -236,10 +243,41 @@ reply_send(struct batch_request *request)
 #endif	/* PBS_MOM */
 	int		    rc = 0;
 	int		    sfds = request->rq_conn;		/* socket */
+	char		   *jid;
+	char		   *txt = NULL;
+
+	if (request->rq_refct > 0) {
+		/* waiting on sister (subjob) requests, will send when */
+		/* last one decrecments the reference count to zero    */
+		/* (a job of a job list request may be such a parent)  */
+		return 0;
+	}
 
 	/* if this is a child request, just move the error to the parent */
 
-	if (request->rq_parentbr) {
+	if (request->rq_parentbr &&
+		(request->rq_parentbr->rq_type == PBS_BATCH_JobList)) {
+
+		/* one job of a job list request, keep its own result */
+
+		if (request->rq_reply.brp_code != PBSE_NONE) {
+			switch (request->rq_type) {
+				case PBS_BATCH_SignalJob:
+					jid = request->rq_ind.rq_signal.rq_jid;
+					break;
+				case PBS_BATCH_HoldJob:
+					jid = request->rq_ind.rq_hold.rq_orig.rq_objname;
+					break;
+				default:
+					jid = request->rq_ind.rq_manager.rq_objname;
+					break;
+			}
+			if (request->rq_reply.brp_choice == BATCH_REPLY_CHOICE_Text)
+				txt = request->rq_reply.brp_un.brp_txt.brp_str;
+			rc = reply_jobresult(request->rq_parentbr, jid,
+				request->rq_reply.brp_code, txt);
+		}
+	} else if (request->rq_parentbr) {
 		if ((request->rq_parentbr->rq_reply.brp_choice == BATCH_REPLY_CHOICE_NULL) && (request->rq_parentbr->rq_reply.brp_code == 0)) {
 			request->rq_parentbr->rq_reply.brp_code = request->rq_reply.brp_code;
 			request->rq_parentbr->rq_reply.brp_auxcode = request->rq_reply.brp_auxcode;
@@ -256,10 +294,6 @@ reply_send(struct batch_request *request)
 				}
 			}
 		}
-	} else if (request->rq_refct > 0) {
-		/* waiting on sister (subjob) requests, will send when */
-		/* last one decrecments the reference count to zero    */
-		return 0;
 	} else if (sfds == PBS_LOCAL_CONNECTION) {
 
 #ifndef PBS_MOM
@@ -295,6 +329,11 @@ reply_send(struct batch_request *request)
 		/*
 		 * Otherwise, the reply is to be sent to a remote client
 		 */
+#ifndef PBS_MOM
+		/* sent later, in order, see process_submitbatch() */
+		if (submitbatch_hold(request))
+			return (0);
+#endif	/* PBS_MOM */
 		if (rc == PBSE_NONE) {
 			rc = dis_reply_write(sfds, request);
 		}
@@ -377,6 +416,9 @@ reply_free(struct batch_reply *prep)
 		(void)free(prep->brp_un.brp_rescq.brq_alloc);
 		(void)free(prep->brp_un.brp_rescq.brq_resvd);
 		(void)free(prep->brp_un.brp_rescq.brq_down);
+	} else if (prep->brp_choice == BATCH_REPLY_CHOICE_JobList) {
+		pbs_jobresultfree(prep->brp_un.brp_jobres);
+		prep->brp_un.brp_jobres = NULL;
 	}
 	prep->brp_choice = BATCH_REPLY_CHOICE_NULL;
 }
@@ -552,3 +594,47 @@ reply_jobid(struct batch_request *preq, char *jobid, int which)
 	(void)strncpy(preq->rq_reply.brp_un.brp_jid, jobid, PBS_MAXSVRJOBID);
 	return (reply_send(preq));
 }
+
+/**
+ * @brief
+ * 		Add the result of one job to the reply of a job list request.
+ * 		Only failures are returned, in the order the jobs completed.
+ *
+ * @param[in,out]	preq	- the job list request
+ * @param[in]	jobid	- job id
+ * @param[in]	code	- PBS error code for the job
+ * @param[in]	text	- error message, may be NULL
+ *
+ * @return	error code
+ * @retval	0	- success
+ * @retval	PBSE_SYSTEM	- out of memory
+ */
+int
+reply_jobresult(struct batch_request *preq, char *jobid, int code, char *text)
+{
+	struct batch_jobresult *pres;
+
+	pres = (struct batch_jobresult *)calloc(1, sizeof(struct batch_jobresult));
+	if (pres == NULL) {
+		log_err(errno, __func__, "Unable to allocate Memory!");
+		return (PBSE_SYSTEM);
+	}
+	pres->code = code;
+	pres->name = strdup(jobid);
+	if (text && *text)
+		pres->text = strdup(text);
+	if ((pres->name == NULL) || (text && *text && (pres->text == NULL))) {
+		pbs_jobresultfree(pres);
+		log_err(errno, __func__, "Unable to allocate Memory!");
+		return (PBSE_SYSTEM);
+	}
+
+	if (preq->rq_reply.brp_choice != BATCH_REPLY_CHOICE_JobList) {
+		preq->rq_reply.brp_choice = BATCH_REPLY_CHOICE_JobList;
+		preq->rq_reply.brp_un.brp_jobres = pres;
+	} else {
+		preq->rq_ind.rq_joblist.rq_last->next = pres;
+	}
+	preq->rq_ind.rq_joblist.rq_last = pres;
+	return (PBSE_NONE);
+}
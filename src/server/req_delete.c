@@ -186,7 +186,10 @@ acct_del_write(char *jid, job *pjob, struct batch_request *preq, int nomail)
 				check_block(pjob, log_buffer);
 		}
 
-		if (preq->rq_parentbr == NULL && nomail == 0 &&
+		/* a Job List parent stands for the client, not an array job */
+		if ((preq->rq_parentbr == NULL ||
+			preq->rq_parentbr->rq_type == PBS_BATCH_JobList) &&
+			nomail == 0 &&
 			svr_chk_owner(preq, pjob) != 0 &&
 			qdel_mail != 0) {
 			svr_mailowner_id(jid, pjob,
@@ -55,6 +55,7 @@
 #include "net_connect.h"
 #include "batch_request.h"
 #include "pbs_share.h"
+#include "dis.h"
 
 
 /* External Global Data Items Referenced */
@@ -69,7 +70,9 @@ extern int max_connection;
 /**
  * @brief
  * 		req_connect - process a Connection Request
- * 		Almost does nothing.
+ * 		Almost does nothing.  A client asking for binary DIS integers
+ * 		with the DIS_BINARY_EXT extend gets it echoed back, and the
+ * 		connection switches to them right after the reply.
  *
  * @param[in]	preq	- Connection Request
  */
@@ -94,6 +97,16 @@ req_connect(struct batch_request *preq)
 
 	if ((conn->cn_authen &
 		(PBS_NET_CONN_AUTHENTICATED|PBS_NET_CONN_FROM_PRIVIL))==0) {
+#ifndef WIN32
+		if ((preq->rq_extend != NULL) &&
+			(strcmp(preq->rq_extend, DIS_BINARY_EXT) == 0)) {
+			int sock = preq->rq_conn;
+
+			if (reply_text(preq, PBSE_NONE, DIS_BINARY_EXT) == 0)
+				(void)DIS_tcp_set_binary(sock, 1);
+			return;
+		}
+#endif
 		reply_ack(preq);
 	} else
 		req_reject(PBSE_BADCRED, 0, preq);
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+
+
+/**
+ * @file	req_joblist.c
+ *
+ * @brief
+ * 		req_joblist.c - service the Job List request, which applies one
+ *		Delete, Hold, Release or Signal Job request to a list of jobs.
+ *
+ *	Each job gets its own child of the request, processed as if it had
+ *	been sent by itself.  The result of every job which fails is added to
+ *	the reply by reply_send(), the reply goes back once the last child has
+ *	been replied to.
+ *
+ * Functions included are:
+ * 	req_joblist()
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include "libpbs.h"
+#include "server_limits.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "server.h"
+#include "credential.h"
+#include "batch_request.h"
+#include "job.h"
+#include "pbs_error.h"
+#include "log.h"
+#include "svrfunc.h"
+
+
+/**
+ * @brief
+ * 		create the request for one job of a job list request
+ *
+ * @param[in]	preq	- the job list request
+ * @param[in]	jobid	- the job
+ *
+ * @return	struct batch_request *
+ * @retval	NULL	- out of memory
+ */
+static struct batch_request *
+joblist_dup(struct batch_request *preq, char *jobid)
+{
+	struct batch_request *npreq;
+	struct rq_joblist    *plist = &preq->rq_ind.rq_joblist;
+
+	npreq = alloc_br(plist->rq_op);
+	if (npreq == NULL)
+		return NULL;
+
+	npreq->rq_perm    = preq->rq_perm;
+	npreq->rq_fromsvr = preq->rq_fromsvr;
+	npreq->rq_conn    = preq->rq_conn;
+	npreq->rq_orgconn = preq->rq_orgconn;
+	npreq->rq_time    = preq->rq_time;
+	strcpy(npreq->rq_user, preq->rq_user);
+	strcpy(npreq->rq_host, preq->rq_host);
+	npreq->rq_extend  = preq->rq_extend;
+	npreq->rq_trace   = preq->rq_trace;
+	npreq->rq_reply.brp_choice = BATCH_REPLY_CHOICE_NULL;
+	npreq->rq_refct   = 0;
+
+	switch (plist->rq_op) {
+		case PBS_BATCH_SignalJob:
+			strcpy(npreq->rq_ind.rq_signal.rq_jid, jobid);
+			strcpy(npreq->rq_ind.rq_signal.rq_signame, plist->rq_arg);
+			break;
+		case PBS_BATCH_HoldJob:
+		case PBS_BATCH_ReleaseJob:
+			/* the hold types are only read, share the parent's list */
+			npreq->rq_ind.rq_hold.rq_orig.rq_cmd = MGR_CMD_SET;
+			npreq->rq_ind.rq_hold.rq_orig.rq_objtype = MGR_OBJ_JOB;
+			strcpy(npreq->rq_ind.rq_hold.rq_orig.rq_objname, jobid);
+			npreq->rq_ind.rq_hold.rq_orig.rq_attr = plist->rq_attr;
+			npreq->rq_ind.rq_hold.rq_hpref = 0;
+			break;
+		default:
+			npreq->rq_ind.rq_delete.rq_cmd = MGR_CMD_DELETE;
+			npreq->rq_ind.rq_delete.rq_objtype = MGR_OBJ_JOB;
+			strcpy(npreq->rq_ind.rq_delete.rq_objname, jobid);
+			CLEAR_HEAD(npreq->rq_ind.rq_delete.rq_attr);
+			break;
+	}
+
+	npreq->rq_parentbr = preq;
+	preq->rq_refct++;
+
+	return npreq;
+}
+
+/**
+ * @brief
+ * 		req_joblist - service the Job List request
+ *
+ *		The jobs are handed one at a time to the function servicing
+ *		the request for a single job, in the order they were given.
+ *		Only the jobs which fail are returned in the reply.
+ *
+ * @param[in]	preq	- Job List Request
+ */
+
+void
+req_joblist(struct batch_request *preq)
+{
+	int		   i;
+	char		  *jobid;
+	char		  *desc;
+	svrattrl	  *pal;
+	struct rq_joblist *plist = &preq->rq_ind.rq_joblist;
+	struct batch_request *npreq;
+
+	switch (plist->rq_op) {
+		case PBS_BATCH_DeleteJob:
+			desc = "delete";
+			break;
+		case PBS_BATCH_SignalJob:
+			if ((plist->rq_arg == NULL) ||
+				(strlen(plist->rq_arg) > PBS_SIGNAMESZ)) {
+				req_reject(PBSE_IVALREQ, 0, preq);
+				return;
+			}
+			desc = "signal";
+			break;
+		case PBS_BATCH_HoldJob:
+		case PBS_BATCH_ReleaseJob:
+			if (plist->rq_arg == NULL) {
+				req_reject(PBSE_IVALREQ, 0, preq);
+				return;
+			}
+			pal = attrlist_create(ATTR_h, NULL, strlen(plist->rq_arg) + 1);
+			if (pal == NULL) {
+				req_reject(PBSE_SYSTEM, 0, preq);
+				return;
+			}
+			strcpy(pal->al_value, plist->rq_arg);
+			pal->al_op = SET;
+			append_link(&plist->rq_attr, &pal->al_link, pal);
+			desc = (plist->rq_op == PBS_BATCH_HoldJob) ? "hold" : "release";
+			break;
+		default:
+			req_reject(PBSE_IVALREQ, 0, preq);
+			return;
+	}
+
+	sprintf(log_buffer, "%s request for %d jobs received from %s@%s",
+		desc, plist->rq_count, preq->rq_user, preq->rq_host);
+	log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_INFO,
+		__func__, log_buffer);
+
+	/* hold the reply until every job has been done */
+	preq->rq_refct++;
+
+	for (i = 0; i < plist->rq_count; i++) {
+		jobid = plist->rq_jobs[i];
+		if (strlen(jobid) > PBS_MAXSVRJOBID) {
+			(void)reply_jobresult(preq, jobid, PBSE_UNKJOBID, NULL);
+			continue;
+		}
+		npreq = joblist_dup(preq, jobid);
+		if (npreq == NULL) {
+			(void)reply_jobresult(preq, jobid, PBSE_SYSTEM, NULL);
+			continue;
+		}
+
+		switch (plist->rq_op) {
+			case PBS_BATCH_DeleteJob:
+				log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, LOG_INFO,
+					jobid, "delete job request received");
+				req_deletejob(npreq);
+				break;
+			case PBS_BATCH_HoldJob:
+				req_holdjob(npreq);
+				break;
+			case PBS_BATCH_ReleaseJob:
+				req_releasejob(npreq);
+				break;
+			case PBS_BATCH_SignalJob:
+				log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, LOG_INFO,
+					jobid, "signal job request received");
+				req_signaljob(npreq);
+				break;
+		}
+	}
+
+	if (--preq->rq_refct == 0)
+		(void)reply_send(preq);
+}
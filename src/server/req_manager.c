@@ -118,6 +118,7 @@
 #include "sched_cmds.h"
 #include "pbs_sched.h"
 #include "pbs_share.h"
+#include "svr_snapshot.h"
 
 
 #define PERM_MANAGER (ATR_DFLAG_MGWR | ATR_DFLAG_MGRD)
@@ -1157,6 +1158,8 @@ mgr_unset_attr(attribute *pattr, attribute_def *pdef, int limit, svrattrl *plist
 		else if (ptype == PARENT_TYPE_SCHED)
 			attr_info.parent_id = ((pbs_sched *) pobj)->sc_name;
 
+		if (ptype == PARENT_TYPE_JOB)
+			snap_journal_intent(attr_info.parent_id);
 		delete_attr_db(conn, &attr_info, plist);
 
 		if (((pdef+index)->at_type == ATR_TYPE_RESC) &&
@@ -51,6 +51,9 @@
  *	req_mvjobfile()
  *	req_commit()
  *	locate_new_job()
+ *	req_submitbatch()
+ *	process_submitbatch()
+ *	submitbatch_hold()
  *	req_resvSub()
  *	get_queue_for_reservation()
  *	ignore_attr()
@@ -108,9 +111,14 @@
 #include "user.h"
 #include "hook.h"
 #include "pbs_internal.h"
+#include "pbs_trace.h"
 #include "pbs_sched.h"
 #ifndef PBS_MOM
 #include "pbs_db.h"
+#include "dis.h"
+#ifndef WIN32
+#include <poll.h>
+#endif
 #define SEQ_WIN_INCR 1000 /*save jobid number to database in this increment*/
 #endif
 
@@ -360,6 +368,7 @@ req_quejob(struct batch_request *preq)
 		psatl = (svrattrl *)GET_NEXT(psatl->al_link);
 	}
 
+	trace_span(preq->rq_trace, NULL, "hook.queuejob");
 	switch (process_hooks(preq, hook_msg, sizeof(hook_msg),
 			pbs_python_set_interrupt)) {
 		case 0:	/* explicit reject */
@@ -383,6 +392,7 @@ req_quejob(struct batch_request *preq)
 			log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_HOOK,
 				LOG_INFO, "", "queuejob event: accept req by default");
 	}
+	trace_span(preq->rq_trace, NULL, "hook.queuejob.done");
 
 	prdefsel = find_resc_def(svr_resc_def, "select", svr_resc_size);
 	prdefplc = find_resc_def(svr_resc_def, "place",  svr_resc_size);
@@ -1146,6 +1156,11 @@ req_quejob(struct batch_request *preq)
 	pj->ji_qs.ji_un.ji_newt.ji_fromsock = sock;
 	pj->ji_qs.ji_un.ji_newt.ji_scriptsz = 0;
 
+	if (preq->rq_trace != NULL) {
+		pj->ji_trace = strdup(preq->rq_trace);
+		trace_span(pj->ji_trace, pj->ji_qs.ji_jobid, "quejob");
+	}
+
 #ifdef PBS_MOM
 	mom_hook_input_init(&hook_input);
 	hook_input.pjob = pj;
@@ -1760,7 +1775,11 @@ req_commit(struct batch_request *preq)
 	pbs_db_conn_t		*conn = (pbs_db_conn_t *) svr_db_conn;
 #endif
 
-	pj = locate_new_job(preq, preq->rq_ind.rq_commit);
+	/* a pipelined Commit names no job, see pbs_submit_batch() */
+	if (preq->rq_ind.rq_commit[0] == '\0')
+		pj = locate_new_job(preq, NULL);
+	else
+		pj = locate_new_job(preq, preq->rq_ind.rq_commit);
 	if (pj == NULL) {
 		req_reject(PBSE_UNKJOBID, 0, preq);
 		return;
@@ -1820,6 +1839,7 @@ req_commit(struct batch_request *preq)
 	 * used for a terminated job
 	 */
 
+	trace_span(pj->ji_trace, pj->ji_qs.ji_jobid, "commit");
 	(void)reply_jobid(preq, pj->ji_qs.ji_jobid, BATCH_REPLY_CHOICE_Commit);
 	start_exec(pj);
 	job_or_resv_save((void *)pj, SAVEJOB_NEW, JOB_OBJECT);
@@ -1981,6 +2001,7 @@ req_commit(struct batch_request *preq)
 
 	log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, LOG_INFO,
 		pj->ji_qs.ji_jobid, log_buffer);
+	trace_span(pj->ji_trace, pj->ji_qs.ji_jobid, "queued");
 
 	if ((pj->ji_qs.ji_svrflags & JOB_SVFLG_HERE) == 0)
 		issue_track(pj);	/* notify creator where job is */
@@ -2049,6 +2070,181 @@ locate_new_job(struct batch_request *preq, char *jobid)
 
 
 #ifndef PBS_MOM	/* SERVER only */
+
+/* most replies held back while requests are taken from a batch submission */
+#define SUBMITBATCH_MAXREQ	1024
+
+static int			 held_sock = -1;	/* connection whose replies are held */
+static int			 held_num = 0;		/* number of replies held */
+static struct batch_request	*held_reqs[SUBMITBATCH_MAXREQ];
+
+/**
+ * @brief
+ *		"SubmitBatch" Batch Request processing routine, the client is
+ *		going to pipeline the Queue Job, Job Script and Commit requests
+ *		of many jobs on the connection.  From now on the connection is
+ *		read by process_submitbatch().
+ *
+ *  @param[in]	preq	-	ptr to the decoded request
+ */
+
+void
+req_submitbatch(struct batch_request *preq)
+{
+	conn_t *conn;
+
+	if (preq->isrpp || ((conn = get_conn(preq->rq_conn)) == NULL)) {
+		req_reject(PBSE_IVALREQ, 0, preq);
+		return;
+	}
+	conn->cn_authen |= PBS_NET_CONN_NOTIMEOUT;
+	conn->cn_func = process_submitbatch;
+
+	sprintf(log_buffer, "batch submission from %s@%s",
+		preq->rq_user, preq->rq_host);
+	log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_DEBUG,
+		"", log_buffer);
+	reply_ack(preq);
+}
+
+/**
+ * @brief
+ *		Check if another request of a batch submission can be read from
+ *		the connection without waiting.
+ *
+ * @param[in]	sfds	- connection socket
+ *
+ * @return	int
+ * @retval	1	- data is buffered or waiting on the socket
+ * @retval	0	- nothing to read now
+ */
+static int
+submitbatch_more(int sfds)
+{
+#ifndef WIN32
+	struct pollfd pfd;
+#endif
+
+	if (DIS_tcp_rpending(sfds) > 0)
+		return 1;
+#ifndef WIN32
+	pfd.fd = sfds;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	if (poll(&pfd, 1, 0) == 1)
+		return 1;
+#endif
+	return 0;
+}
+
+/**
+ * @brief
+ *		Read the requests of a batch submission.  The requests waiting on
+ *		the connection are processed in one go, and the jobs they commit
+ *		are saved in one database transaction.  Their replies are held
+ *		back, see submitbatch_hold(), and sent in order once the
+ *		transaction has ended.  If it fails, the jobs committed by it are
+ *		purged and their Commit requests are rejected.
+ *
+ * @param[in]	sfds	- connection socket
+ */
+void
+process_submitbatch(int sfds)
+{
+	pbs_db_conn_t		*conn = (pbs_db_conn_t *) svr_db_conn;
+	struct batch_request	*preq;
+	job			*pj;
+	int			 failed = 0;
+	int			 nreq = 0;
+	int			 i;
+
+	if (pbs_db_begin_trx(conn, 0, 0) != 0) {
+		process_request(sfds);
+		return;
+	}
+
+	held_sock = sfds;
+	held_num = 0;
+	do {
+		process_request(sfds);
+		nreq++;
+	} while ((held_num < SUBMITBATCH_MAXREQ - 1) &&
+		(get_conn(sfds) != NULL) && submitbatch_more(sfds));
+	held_sock = -1;
+
+	if (pbs_db_end_trx(conn, PBS_DB_COMMIT) != 0)
+		failed = 1;
+
+	if (nreq > 1) {
+		sprintf(log_buffer, "%d pipelined requests %s in one transaction",
+			nreq, failed ? "failed" : "saved");
+		log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_REQUEST, LOG_DEBUG,
+			"", log_buffer);
+	}
+
+	for (i = 0; i < held_num; i++) {
+		preq = held_reqs[i];
+		if (failed && (preq->rq_type == PBS_BATCH_Commit) &&
+			(preq->rq_reply.brp_code == PBSE_NONE)) {
+			/* the job was never saved, do not keep it */
+			pj = find_job(preq->rq_reply.brp_un.brp_jid);
+			if (pj != NULL) {
+				log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, LOG_ERR,
+					pj->ji_qs.ji_jobid,
+					"job purged, batch submission not saved");
+				job_purge(pj);
+			}
+			if (get_conn(sfds) != NULL) {
+				req_reject(PBSE_SAVE_ERR, 0, preq);
+				continue;
+			}
+		}
+		if (get_conn(sfds) != NULL)
+			(void)reply_send(preq);
+		else
+			free_br(preq);
+	}
+	held_num = 0;
+}
+
+/**
+ * @brief
+ *		Hold back the reply to a request of a batch submission until the
+ *		jobs committed with it are saved, see process_submitbatch().
+ *		Called by reply_send().
+ *
+ * @par
+ *		A job whose script did not get across is purged here, so that the
+ *		Commit pipelined behind the script does not queue it.
+ *
+ * @param[in]	preq	- request being replied to
+ *
+ * @return	int
+ * @retval	1	- the reply is held
+ * @retval	0	- send the reply now
+ */
+int
+submitbatch_hold(struct batch_request *preq)
+{
+	job *pj;
+
+	if ((held_sock < 0) || preq->isrpp || (preq->rq_conn != held_sock))
+		return 0;
+
+	if ((preq->rq_type == PBS_BATCH_jobscript) &&
+		(preq->rq_reply.brp_code != PBSE_NONE)) {
+		if ((pj = locate_new_job(preq, NULL)) != NULL) {
+			delete_link(&pj->ji_alljobs);
+			job_purge(pj);
+		}
+	}
+
+	if (held_num >= SUBMITBATCH_MAXREQ)
+		return 0;
+	held_reqs[held_num++] = preq;
+	return 1;
+}
+
 /**
  * @brief
  *		"resvSub" Batch Request processing routine
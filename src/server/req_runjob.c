@@ -105,6 +105,7 @@
 #include "provision.h"
 #include "pbs_share.h"
 #include "pbs_sched.h"
+#include "pbs_trace.h"
 
 
 /* External Functions Called: */
@@ -277,10 +278,13 @@ call_to_process_hooks(struct batch_request *preq, char *hook_msg, size_t msg_len
 	void	(*pyinter_func)(void))
 {
 	int rc;
+
+	trace_span(NULL, preq->rq_ind.rq_run.rq_jid, "hook.runjob");
 	rc = process_hooks(preq, hook_msg, msg_len, pyinter_func);
 	if (rc == -1)
 		log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_HOOK,
 				LOG_INFO, "", "runjob event: accept req by default");
+	trace_span(NULL, preq->rq_ind.rq_run.rq_jid, "hook.runjob.done");
 	return rc;
 }
 
@@ -326,6 +330,7 @@ req_runjob(struct batch_request *preq)
 	parent = chk_job_request(jid, preq, &jt);
 	if (parent == NULL)
 		return;		/* note, req_reject already called */
+	trace_span(parent->ji_trace, jid, "runjob");
 
 	/* the job must be in an execution queue */
 
@@ -1050,6 +1055,7 @@ svr_strtjob2(job *pjob, struct batch_request *preq)
 			JOB_SUBSTATE_PRERUN);
 
 
+	trace_span(pjob->ji_trace, pjob->ji_qs.ji_jobid, "sendjob");
 	if (send_job(pjob, pjob->ji_qs.ji_un.ji_exect.ji_momaddr,
 		pjob->ji_qs.ji_un.ji_exect.ji_momport, MOVE_TYPE_Exec,
 		post_sendmom, (void *)preq) == 2) {
@@ -1110,6 +1116,8 @@ complete_running(job *jobp)
 	if (jobp->ji_qs.ji_stime != 0)
 		return;		/* already called for this incarnation */
 
+	trace_span(jobp->ji_trace, jobp->ji_qs.ji_jobid, "running");
+
 	/**
 	 *	For a subjob, insure the parent array's state is set to 'B'
 	 *	and deal with any dependency on the parent.
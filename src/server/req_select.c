@@ -49,6 +49,7 @@
  * 	chk_job_statenum()
  * 	add_select_entry()
  * 	add_select_array_entries()
+ * 	selstat_job()
  * 	req_selectjobs()
  * 	select_job()
  * 	sel_attr()
@@ -56,6 +57,7 @@
  * 	build_selentry()
  * 	build_selist()
  * 	select_subjob()
+ * 	select_candidates()
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -88,6 +90,7 @@
 
 extern int	 resc_access_perm;
 extern pbs_list_head svr_alljobs;
+extern pbs_list_head svr_queues;
 extern time_t	 time_now;
 extern char	 statechars[];
 extern long svr_history_enable;
@@ -102,6 +105,9 @@ static void free_sellist(struct select_list *pslist);
 static int  sel_attr(attribute *, struct select_list *);
 static int  select_job(job *, struct select_list *, int, int);
 static int  select_subjob(int, struct select_list *);
+static job **select_candidates(struct select_list *, pbs_queue *, int, int, int *);
+static job **grow_candidates(job **, long *);
+static int  selstat_job(struct batch_request *, job *, int, char *, int *);
 
 
 /**
@@ -305,6 +311,47 @@ add_select_array_entries(job *pjob, int dosub, char *statelist,
 	return ct;
 }
 
+/**
+ * @brief
+ * 		Add the status of a selected job, or of its subjobs in the
+ * 		selected states, to the reply of a Select-Status request.
+ *
+ * @param[in,out]	preq	-	Select-Status Job Request, reply updated
+ * @param[in]	pjob	-	the selected job
+ * @param[in]	dosubjobs	-	1 to status the subjobs of an Array Job
+ * @param[in]	pstate	-	the selected states, NULL for any
+ * @param[out]	bad	-	RETURN: index of the bad attribute
+ *
+ * @return	int
+ * @retval	0	: success, or the client may not see the job
+ * @retval	!0	: error code
+ */
+static int
+selstat_job(struct batch_request *preq, job *pjob, int dosubjobs, char *pstate, int *bad)
+{
+	struct batch_reply *preply = &preq->rq_reply;
+	svrattrl	   *plist;
+	int		    rc = 0;
+	int		    i;
+
+	plist = (svrattrl *)GET_NEXT(preq->rq_ind.rq_select.rq_rtnattr);
+	if ((dosubjobs == 1) && pjob->ji_ajtrk) {
+		for (i=0; i<pjob->ji_ajtrk->tkm_ct; ++i) {
+			if ((pstate == 0) || chk_job_statenum(pjob->ji_ajtrk->tkm_tbl[i].trk_status, pstate)) {
+				rc = status_subjob(pjob, preq, plist, i, &preply->brp_un.brp_status, bad);
+				if (rc && (rc != PBSE_PERM))
+					return (rc);
+			}
+		}
+	} else {
+		rc = status_job(pjob, preq, plist,
+			&preply->brp_un.brp_status, bad);
+		if (rc && (rc != PBSE_PERM))
+			return (rc);
+	}
+	return (0);
+}
+
 /**
  * @brief
  * 		req_selectjobs - service both the Select Job Request and the (special
@@ -334,6 +381,15 @@ req_selectjobs(struct batch_request *preq)
 	int		    rc;
 	struct select_list *selistp;
 	pbs_sched	   *psched;
+	job		  **cand;
+	int		    ncand = 0;
+	int		    icand = 0;
+	struct stat_order   order;
+	job		  **sel = NULL;
+	long		    selsize = 32;
+	int		    nsel = 0;
+	int		    first;
+	int		    count;
 
 	/*
 	 * if the letter T (or t) is in the extend string,  select subjobs
@@ -341,11 +397,11 @@ req_selectjobs(struct batch_request *preq)
 	 * regualar and running subjobs (whatever has a job structure.  This
 	 * is for the Scheduler.
 	 */
-	if ((preq->rq_extend != NULL) && strchr(preq->rq_extend, 'T'))
+	if (stat_extend_flag(preq->rq_extend, 'T'))
 		dosubjobs = 1;
-	else if ((preq->rq_extend != NULL) && strchr(preq->rq_extend, 't'))
+	else if (stat_extend_flag(preq->rq_extend, 't'))
 		dosubjobs = 1;
-	else if ((preq->rq_extend != NULL) && strchr(preq->rq_extend, 'S'))
+	else if (stat_extend_flag(preq->rq_extend, 'S'))
 		dosubjobs = 2;
 	/*
 	 * If the letter x is in the extend string, Check if the server is
@@ -353,7 +409,7 @@ req_selectjobs(struct batch_request *preq)
 	 * then return with PBSE_JOBHISTNOTSET error. Otherwise select history
 	 * jobs also.
 	 */
-	if ((preq->rq_extend != NULL) && strchr(preq->rq_extend, 'x')) {
+	if (stat_extend_flag(preq->rq_extend, 'x')) {
 		if (svr_history_enable == 0) {
 			req_reject(PBSE_JOBHISTNOTSET, 0, preq);
 			return;
@@ -361,6 +417,17 @@ req_selectjobs(struct batch_request *preq)
 		dohistjobs = 1;
 	}
 
+	/*
+	 * Sort and paging options apply to a Select-Status request: the
+	 * selected jobs are gathered first and only the page is statused.
+	 */
+	if ((rc = parse_stat_order(preq, &order)) != PBSE_NONE) {
+		req_reject(rc, 0, preq);
+		return;
+	}
+	if (preq->rq_type == PBS_BATCH_SelectJobs)
+		order.so_set = 0;
+
 	/* The first selstat() call from the scheduler indicates that a cycle
 	 * is in progress and has reached the point of querying for jobs.
 	 * TODO: This approach must be revisited if the scheduler changes its
@@ -394,9 +461,13 @@ req_selectjobs(struct batch_request *preq)
 	}
 	pselx = &preply->brp_un.brp_select;
 
-	/* now start checking for jobs that match the selection criteria */
+	/* now start checking for jobs that match the selection criteria, */
+	/* only those found through a job index if one narrows them down */
 
-	if (pque)
+	cand = select_candidates(selistp, pque, dosubjobs, dohistjobs, &ncand);
+	if (cand)
+		pjob = (ncand > 0) ? cand[0] : NULL;
+	else if (pque)
 		pjob = (job *)GET_NEXT(pque->qu_jobs);
 	else
 		pjob = (job *)GET_NEXT(svr_alljobs);
@@ -426,33 +497,44 @@ req_selectjobs(struct batch_request *preq)
 
 					/* Select-Status  Reply */
 
-					plist = (svrattrl *)GET_NEXT(preq->rq_ind.rq_select.rq_rtnattr);
-					if ((dosubjobs == 1) && pjob->ji_ajtrk) {
-						for (i=0; i<pjob->ji_ajtrk->tkm_ct; ++i) {
-							if ((pstate == 0) || chk_job_statenum(pjob->ji_ajtrk->tkm_tbl[i].trk_status, pstate)) {
-								rc = status_subjob(pjob, preq, plist, i, &preply->brp_un.brp_status, &bad);
-								if (rc && (rc != PBSE_PERM))
-									goto out;
-								plist = (svrattrl *)GET_NEXT(preq->rq_ind.rq_select.rq_rtnattr);
-
-							}
+					if (order.so_set) {
+						/* statused once sorted, below */
+						if (sel == NULL)
+							sel = (job **)malloc(selsize * sizeof(job *));
+						else if (nsel == selsize)
+							sel = grow_candidates(sel, &selsize);
+						if (sel == NULL) {
+							rc = PBSE_SYSTEM;
+							goto out;
 						}
+						sel[nsel++] = pjob;
 					} else {
-						rc = status_job(pjob, preq, plist,
-							&preply->brp_un.brp_status, &bad);
-						if (rc && (rc != PBSE_PERM))
+						rc = selstat_job(preq, pjob, dosubjobs, pstate, &bad);
+						if (rc)
 							goto out;
 					}
-
 				}
 			}
 		}
-		if (pque)
+		if (cand)
+			pjob = (++icand < ncand) ? cand[icand] : NULL;
+		else if (pque)
 			pjob = (job *)GET_NEXT(pjob->ji_jobque);
 		else
 			pjob = (job *)GET_NEXT(pjob->ji_alljobs);
 	}
+
+	if (order.so_set && (nsel > 0)) {
+		count = order_stat_jobs(sel, nsel, &order, &first);
+		for (i = first; i < first + count; i++) {
+			rc = selstat_job(preq, sel[i], dosubjobs, pstate, &bad);
+			if (rc)
+				goto out;
+		}
+	}
 out:
+	free(sel);
+	free(cand);
 	free_sellist(selistp);
 	if (rc)
 		req_reject(rc, 0, preq);
@@ -841,3 +923,200 @@ select_subjob(int state, struct select_list *psel)
 	}
 	return (1);
 }
+
+/**
+ * @brief
+ *		Order jobs as they are in the server and queue lists, by queue rank
+ */
+static int
+cmp_qrank(const void *a, const void *b)
+{
+	job *pa = *(job **)a;
+	job *pb = *(job **)b;
+	unsigned long ra = (unsigned long)pa->ji_wattr[(int)JOB_ATR_qrank].at_val.at_long;
+	unsigned long rb = (unsigned long)pb->ji_wattr[(int)JOB_ATR_qrank].at_val.at_long;
+
+	if (ra != rb)
+		return ((ra < rb) ? -1 : 1);
+	return (strcmp(pa->ji_qs.ji_jobid, pb->ji_qs.ji_jobid));
+}
+
+/**
+ * @brief
+ *		Double the size of the candidate array of select_candidates()
+ *
+ * @return	job **
+ * @retval	NULL	: out of memory, the array is freed
+ */
+static job **
+grow_candidates(job **cand, long *psize)
+{
+	job **tmp;
+
+	tmp = (job **)realloc(cand, *psize * 2 * sizeof(job *));
+	if (tmp == NULL) {
+		free(cand);
+		return NULL;
+	}
+	*psize *= 2;
+	return tmp;
+}
+
+/**
+ * @brief
+ *		Plan a selection: find the job index that narrows the jobs to check
+ *		the most, and list the jobs it holds.
+ *
+ * @par Functionality:
+ *		Two indices are kept by svr_enquejob(), svr_dequejob() and
+ *		set_statechar(): the jobs of each queue by state, and the queued
+ *		jobs by owner.  A selection on job_state (qselect -s) can visit only
+ *		the jobs of the selected states, one on User_List (qselect -u,
+ *		qstat -u) only the jobs of the listed users.  The sizes of the
+ *		candidate sets are known from qu_njstate[] and jo_count without
+ *		walking them, so the smallest one is taken, or none if it would not
+ *		beat walking the queue or the server.
+ *
+ *		Every candidate is still checked by select_job(), so an index only
+ *		has to hold a superset of the matching jobs.  The indices cover
+ *		queued jobs only, and select states of the Array Job's subjobs
+ *		rather than of the Array Job itself with dosubjobs, so they are not
+ *		used for history or subjob selections.
+ *
+ * @param[in]	psel	-	the selection list
+ * @param[in]	pque	-	queue the selection is limited to, or NULL
+ * @param[in]	dosubjobs	-	subjobs are selected, see req_selectjobs()
+ * @param[in]	dohistjobs	-	history jobs are selected
+ * @param[out]	pct	-	number of candidate jobs
+ *
+ * @return	job **
+ * @retval	NULL	: no index helps, walk the queue or the server
+ * @retval	!NULL	: the candidate jobs in queue rank order, to free()
+ */
+static job **
+select_candidates(struct select_list *psel, pbs_queue *pque, int dosubjobs,
+	int dohistjobs, int *pct)
+{
+	struct select_list	*ps;
+	struct array_strings	*pas;
+	struct job_owner	*owners[64];
+	struct job_owner	*pown;
+	pbs_queue		*pq;
+	job			*pjob;
+	job			**cand;
+	char			 user[PBS_MAXUSER + 1];
+	char			*pc;
+	int			 states = 0;
+	int			 nowners = 0;
+	long			 scan_cost;
+	long			 state_cost = -1;
+	long			 owner_cost = -1;
+	long			 size;
+	int			 i;
+	int			 j;
+	int			 ct = 0;
+
+	*pct = 0;
+	if ((dosubjobs != 0) || (dohistjobs != 0))
+		return NULL;
+	scan_cost = pque ? pque->qu_numjobs : server.sv_qs.sv_numjobs;
+
+	for (ps = psel; ps; ps = ps->sl_next) {
+		if ((ps->sl_atindx == (int)JOB_ATR_state) && (ps->sl_op == EQ) &&
+			(states == 0) && (ps->sl_attr.at_val.at_str != NULL)) {
+			/* job states whose letter is selected */
+			for (pc = ps->sl_attr.at_val.at_str; *pc; pc++) {
+				for (i = 0; i < PBS_NUMJOBSTATE; i++)
+					if (statechars[i] == *pc)
+						states |= 1 << i;
+				if ((*pc == 'S') || (*pc == 'U'))
+					states |= 1 << JOB_STATE_RUNNING;
+			}
+			state_cost = 0;
+			for (i = 0; i < PBS_NUMJOBSTATE; i++) {
+				if ((states & (1 << i)) == 0)
+					continue;
+				if (pque)
+					state_cost += pque->qu_njstate[i];
+				else
+					state_cost += server.sv_jobstates[i];
+			}
+		} else if ((ps->sl_atindx == (int)JOB_ATR_userlst) &&
+			(owner_cost < 0) && svr_jobidx_owners &&
+			((pas = ps->sl_attr.at_val.at_arst) != NULL) &&
+			(pas->as_usedptr > 0) &&
+			(pas->as_usedptr <= (int)(sizeof(owners) / sizeof(owners[0])))) {
+			/* owners whose name is selected; +/- entries change */
+			/* what acl_check() defaults to, so they rule it out */
+			owner_cost = 0;
+			for (i = 0; i < pas->as_usedptr; i++) {
+				pc = pas->as_string[i];
+				if ((*pc == '+') || (*pc == '-')) {
+					owner_cost = -1;
+					nowners = 0;
+					break;
+				}
+				get_jobowner(pc, user);
+				if ((pown = find_job_owner(user)) == NULL)
+					continue;
+				for (j = 0; j < nowners; j++)
+					if (owners[j] == pown)
+						break;
+				if (j == nowners) {
+					owners[nowners++] = pown;
+					owner_cost += pown->jo_count;
+				}
+			}
+		}
+	}
+
+	if ((owner_cost >= 0) && ((state_cost < 0) || (owner_cost < state_cost)))
+		state_cost = -1;	/* owner index is the better one */
+	else
+		owner_cost = -1;
+	if (((state_cost < 0) || (state_cost >= scan_cost)) &&
+		((owner_cost < 0) || (owner_cost >= scan_cost)))
+		return NULL;
+
+	/* the counts only size the array, the lists are what is walked */
+	size = ((state_cost >= 0) ? state_cost : owner_cost) + 16;
+	if ((cand = (job **)malloc(size * sizeof(job *))) == NULL)
+		return NULL;
+
+	if (state_cost >= 0) {
+		pq = pque ? pque : (pbs_queue *)GET_NEXT(svr_queues);
+		for (; pq; pq = pque ? NULL : (pbs_queue *)GET_NEXT(pq->qu_link)) {
+			for (i = 0; i < PBS_NUMJOBSTATE; i++) {
+				if ((states & (1 << i)) == 0)
+					continue;
+				for (pjob = (job *)GET_NEXT(pq->qu_jobstate[i]); pjob;
+					pjob = (job *)GET_NEXT(pjob->ji_jobque_state)) {
+					if ((ct == size) && ((cand = grow_candidates(cand,
+						&size)) == NULL))
+						return NULL;
+					cand[ct++] = pjob;
+				}
+			}
+		}
+	} else {
+		for (j = 0; j < nowners; j++) {
+			for (pjob = (job *)GET_NEXT(owners[j]->jo_jobs); pjob;
+				pjob = (job *)GET_NEXT(pjob->ji_jobowner)) {
+				if ((pque != NULL) && (pjob->ji_qhdr != pque))
+					continue;
+				if ((ct == size) && ((cand = grow_candidates(cand,
+					&size)) == NULL))
+					return NULL;
+				cand[ct++] = pjob;
+			}
+		}
+	}
+	qsort(cand, ct, sizeof(job *), cmp_qrank);
+
+	sprintf(log_buffer, "select by %s index: %d of %ld jobs",
+		(state_cost >= 0) ? "state" : "owner", ct, scan_cost);
+	log_event(PBSEVENT_DEBUG4, PBS_EVENTCLASS_SERVER, LOG_DEBUG,
+		msg_daemonname, log_buffer);
+	*pct = ct;
+	return cand;
+}
@@ -45,6 +45,7 @@
  * Functions included are:
  * 	do_stat_of_a_job()
  * 	stat_a_jobidname()
+ * 	stat_ordered_jobs()
  * 	req_stat_job()
  * 	req_stat_que()
  * 	status_que()
@@ -268,6 +269,77 @@ stat_a_jobidname(struct batch_request *preq, char *name, int dohistjobs, int dos
 	}
 }
 
+/**
+ * @brief
+ * 		Support function for req_stat_job().
+ * 		Builds the status reply for the jobs of a queue, or of the server if
+ * 		pque is NULL, in the order and for the page given by the sort and
+ * 		paging options of the request.  Only the jobs the client may see are
+ * 		counted in the page.
+ *
+ * @param[in,out]	preq	-	pointer to the stat job batch request, reply updated
+ * @param[in]	pque	-	queue of the jobs, NULL for all jobs
+ * @param[in]	pord	-	sort and paging options, see parse_stat_order()
+ * @param[in]	dohistjobs	-	flag to include history jobs
+ * @param[in]	dosubjobs	-	flag to expand a Array job to include all subjobs
+ *
+ * @return	int
+ * @retval	PBSE_NONE (0)	: no error
+ * @retval	non-zero	: PBS error code to return to client
+ */
+static int
+stat_ordered_jobs(struct batch_request *preq, pbs_queue *pque,
+	struct stat_order *pord, int dohistjobs, int dosubjobs)
+{
+	job	**jobs;
+	job	 *pjob;
+	int	  njobs = 0;
+	int	  first;
+	int	  count;
+	int	  i;
+	int	  rc = PBSE_NONE;
+
+	if (pque)
+		pjob = (job *)GET_NEXT(pque->qu_jobs);
+	else
+		pjob = (job *)GET_NEXT(svr_alljobs);
+	for (i = 0; pjob; i++) {
+		if (pque)
+			pjob = (job *)GET_NEXT(pjob->ji_jobque);
+		else
+			pjob = (job *)GET_NEXT(pjob->ji_alljobs);
+	}
+	if (i == 0)
+		return (PBSE_NONE);
+	if ((jobs = (job **)malloc(i * sizeof(job *))) == NULL)
+		return (PBSE_SYSTEM);
+
+	/* the jobs that would be in the reply */
+	if (pque)
+		pjob = (job *)GET_NEXT(pque->qu_jobs);
+	else
+		pjob = (job *)GET_NEXT(svr_alljobs);
+	while (pjob) {
+		if (((pjob->ji_qs.ji_svrflags & JOB_SVFLG_SubJob) == 0) &&
+			(dohistjobs ||
+			((pjob->ji_qs.ji_state != JOB_STATE_FINISHED) &&
+			(pjob->ji_qs.ji_state != JOB_STATE_MOVED))) &&
+			(server.sv_attr[(int)SRV_ATR_query_others].at_val.at_long ||
+			(svr_authorize_jobreq(preq, pjob) == 0)))
+			jobs[njobs++] = pjob;
+		if (pque)
+			pjob = (job *)GET_NEXT(pjob->ji_jobque);
+		else
+			pjob = (job *)GET_NEXT(pjob->ji_alljobs);
+	}
+
+	count = order_stat_jobs(jobs, njobs, pord, &first);
+	for (i = first; (i < first + count) && (rc == PBSE_NONE); i++)
+		rc = do_stat_of_a_job(preq, jobs[i], dohistjobs, dosubjobs);
+	free(jobs);
+	return (rc);
+}
+
 /**
  * @brief
  * 		Service the Status Job Request
@@ -280,6 +352,9 @@ stat_a_jobidname(struct batch_request *preq, char *name, int dohistjobs, int dos
  * 		The requested object may be a job id (either a single regular job, an Array
  * 		job, a subjob or a range of subjobs), a comma separated list of the above,
  * 		a queue name or null (or @...) for all jobs in the Server.
+ * @par
+ * 		For a queue or the Server, the extend string may also carry sort
+ * 		and paging options, see parse_stat_order().
  *
  * @param[in,out]	preq	-	pointer to the stat job batch request, reply updated
  *
@@ -298,6 +373,7 @@ void req_stat_job(struct batch_request *preq)
 	int		    rc   = 0;
 	int		    type = 0;
 	char		   *pnxtjid = NULL;
+	struct stat_order   order;
 
 	/* check for any extended flag in the batch request. 't' for
 	 * the sub jobs. If 'x' is there, then check if the server is
@@ -306,9 +382,9 @@ void req_stat_job(struct batch_request *preq)
 	 * jobs.
 	 */
 	if (preq->rq_extend) {
-		if (strchr(preq->rq_extend, (int)'t'))
+		if (stat_extend_flag(preq->rq_extend, 't'))
 			dosubjobs = 1;	/* status sub jobs of an Array Job */
-		if (strchr(preq->rq_extend, (int)'x')) {
+		if (stat_extend_flag(preq->rq_extend, 'x')) {
 			if (svr_history_enable == 0) {
 				req_reject(PBSE_JOBHISTNOTSET, 0, preq);
 				return;
@@ -317,6 +393,12 @@ void req_stat_job(struct batch_request *preq)
 		}
 	}
 
+	/* sort and paging options, for the jobs of a queue or the server */
+	if ((rc = parse_stat_order(preq, &order)) != PBSE_NONE) {
+		req_reject(rc, 0, preq);
+		return;
+	}
+
 	/*
 	 * first, validate the name of the requested object, either
 	 * a job, a queue, or the whole server.
@@ -377,6 +459,8 @@ void req_stat_job(struct batch_request *preq)
 			req_reject(rc, 0, preq);
 		return;
 
+	} else if (order.so_set) {
+		rc = stat_ordered_jobs(preq, pque, &order, dohistjobs, dosubjobs);
 	} else if (type == 2) {
 		pjob = (job *)GET_NEXT(pque->qu_jobs);
 		while (pjob && (rc == PBSE_NONE)) {
@@ -368,6 +368,9 @@ expand_resc_array(char *rname, int rtype, int rflag)
 	pold->rs_next  = pnew;
 	svr_resc_size++;
 
+	/* status replies share the name, see attr_intern() */
+	(void)attr_intern(rname);
+
 	return 0;
 }
 
@@ -48,10 +48,16 @@
  *	status_attrib()
  *	status_job()
  *	status_subjob()
+ *	stat_extend_flag()
+ *	parse_stat_order()
+ *	order_stat_jobs()
  *
  */
+#define STAT_CNTL 1
+
 #include <sys/types.h>
 #include <stdlib.h>
+#include <string.h>
 #include "libpbs.h"
 #include <ctype.h>
 #include <time.h>
@@ -69,6 +75,7 @@
 #include "pbs_nodes.h"
 #include "svrfunc.h"
 #include "pbs_ifl.h"
+#include "resource.h"
 
 
 /* Global Data Items: */
@@ -78,6 +85,9 @@ extern int	     resc_access_perm; /* see encode_resc() in attr_fn_resc.c */
 extern struct server server;
 extern char	     statechars[];
 
+/* sort options of the request being ordered, for cmp_stat_order() */
+static struct stat_order *cur_order;
+
 /**
  * @brief
  * 		svrcached - either link in (to phead) a cached svrattrl struct which is
@@ -123,8 +133,10 @@ svrcached(attribute *pat, pbs_list_head *phead, attribute_def *pdef)
 	if ((encoded == NULL) || (pat->at_flags & ATR_VFLAG_MODCACHE)) {
 		if (pat->at_flags & ATR_VFLAG_SET) {
 			/* encode and cache new svrattrl structure */
+			attrlist_intern_names = 1;
 			(void)pdef->at_encode(pat, phead, pdef->at_name,
 				NULL, ATR_ENCODE_CLIENT, &working);
+			attrlist_intern_names = 0;
 			if (resc_access_perm & PRIV_READ)
 				pat->at_priv_encoded = working;
 			else
@@ -383,9 +395,10 @@ status_subjob(job *pjob, struct batch_request *preq, svrattrl *pal, int subj, pb
 	if ((get_subjob_state(pjob, subj) != JOB_STATE_QUEUED) && (psubjob = find_job(mk_subjob_id(pjob, subj)))) {
 
 		/* if parent job state is F and 'x' is present in rq_extend then we set subjob state also as F */
-		if((pjob->ji_qs.ji_state == JOB_STATE_FINISHED) && strchr(preq->rq_extend, (int)'x')) {
+		if((pjob->ji_qs.ji_state == JOB_STATE_FINISHED) && stat_extend_flag(preq->rq_extend, 'x')) {
 			psubjob->ji_qs.ji_state = JOB_STATE_FINISHED;
 			set_attr_svr(&psubjob->ji_wattr[(int)JOB_ATR_state], &job_attr_def[(int)JOB_ATR_state], &statechars[JOB_STATE_FINISHED]);
+			svr_jobidx_state(psubjob);
 		}
 		status_job(psubjob, preq, pal, pstathd, bad);
 		return 0;
@@ -501,3 +514,222 @@ status_subjob(job *pjob, struct batch_request *preq, svrattrl *pal, int subj, pb
 
 	return (rc);
 }
+
+/**
+ * @brief
+ *		Check for a flag in the extend string of a Status Job or
+ *		Select-Status request.  The flags are the characters before the
+ *		first STAT_ORDER_SEP, the sort and paging options follow it.
+ *
+ * @param[in]	extend	-	the extend string, may be NULL
+ * @param[in]	flag	-	the flag character
+ *
+ * @return	int
+ * @retval	1	: the flag is set
+ * @retval	0	: it is not
+ */
+int
+stat_extend_flag(char *extend, int flag)
+{
+	char *pc;
+
+	if (extend == NULL)
+		return 0;
+	for (pc = extend; (*pc != '\0') && (*pc != STAT_ORDER_SEP); pc++) {
+		if (*pc == flag)
+			return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *		Parse the sort and paging options of a Status Job or Select-Status
+ *		request, a comma separated list after STAT_ORDER_SEP in the extend
+ *		string:
+ *		    sort=[-]attribute[.resource]   order of the jobs, - descending
+ *		    offset=n                       number of jobs to skip
+ *		    limit=n                        most jobs to return
+ *
+ * @param[in]	preq	-	the request
+ * @param[out]	pord	-	RETURN: the options, so_set is 0 if none given
+ *
+ * @return	int
+ * @retval	PBSE_NONE	: success
+ * @retval	PBSE_IVALREQ	: malformed options
+ * @retval	PBSE_NOATTR	: unknown sort attribute
+ * @retval	PBSE_UNKRESC	: unknown sort resource
+ * @retval	PBSE_PERM	: the sort attribute cannot be read by the client
+ */
+int
+parse_stat_order(struct batch_request *preq, struct stat_order *pord)
+{
+	char *opts;
+	char *pc;
+	char *name;
+	char *value;
+	char *resc;
+	char *endp;
+	long  num;
+	int   rc = PBSE_NONE;
+
+	memset(pord, 0, sizeof(struct stat_order));
+	pord->so_index = -1;
+	pord->so_limit = -1;
+
+	if ((preq->rq_extend == NULL) ||
+		((pc = strchr(preq->rq_extend, STAT_ORDER_SEP)) == NULL))
+		return PBSE_NONE;
+	if ((opts = strdup(pc + 1)) == NULL)
+		return PBSE_SYSTEM;
+	pord->so_set = 1;
+
+	for (name = strtok(opts, ","); name != NULL; name = strtok(NULL, ",")) {
+		if ((value = strchr(name, '=')) == NULL) {
+			rc = PBSE_IVALREQ;
+			break;
+		}
+		*value++ = '\0';
+
+		if (strcmp(name, "sort") == 0) {
+			if (*value == '-') {
+				pord->so_desc = 1;
+				value++;
+			} else if (*value == '+')
+				value++;
+			if ((resc = strchr(value, '.')) != NULL)
+				*resc++ = '\0';
+			pord->so_index = find_attr(job_attr_def, value, JOB_ATR_LAST);
+			if (pord->so_index < 0) {
+				rc = PBSE_NOATTR;
+				break;
+			}
+			if ((job_attr_def[pord->so_index].at_flags & ATR_DFLAG_RDACC &
+				preq->rq_perm) == 0) {
+				rc = PBSE_PERM;
+				break;
+			}
+			if (job_attr_def[pord->so_index].at_type == ATR_TYPE_RESC) {
+				if ((resc == NULL) || ((pord->so_rdef = find_resc_def(
+					svr_resc_def, resc, svr_resc_size)) == NULL)) {
+					rc = PBSE_UNKRESC;
+					break;
+				}
+			} else if (resc != NULL) {
+				rc = PBSE_IVALREQ;
+				break;
+			}
+		} else if ((strcmp(name, "offset") == 0) ||
+			(strcmp(name, "limit") == 0)) {
+			num = strtol(value, &endp, 10);
+			if ((*value == '\0') || (*endp != '\0') || (num < 0)) {
+				rc = PBSE_IVALREQ;
+				break;
+			}
+			if (*name == 'o')
+				pord->so_offset = num;
+			else
+				pord->so_limit = num;
+		} else {
+			rc = PBSE_IVALREQ;
+			break;
+		}
+	}
+	free(opts);
+	return rc;
+}
+
+/**
+ * @brief
+ *		Compare two jobs on the sort attribute of cur_order.  Jobs
+ *		without a value come last, jobs with the same value are kept
+ *		in queue rank order.
+ *
+ * @param[in]	a	-	pointer to the first job pointer
+ * @param[in]	b	-	pointer to the second job pointer
+ *
+ * @return	int
+ * @retval	<0, 0, >0 as for qsort()
+ */
+static int
+cmp_stat_order(const void *a, const void *b)
+{
+	job	  *pa = *(job **)a;
+	job	  *pb = *(job **)b;
+	attribute *va = NULL;
+	attribute *vb = NULL;
+	resource  *pr;
+	long	   ra;
+	long	   rb;
+	int	   cmp = 0;
+
+	if (cur_order->so_index >= 0) {
+		va = &pa->ji_wattr[cur_order->so_index];
+		vb = &pb->ji_wattr[cur_order->so_index];
+		if (cur_order->so_rdef != NULL) {
+			pr = find_resc_entry(va, cur_order->so_rdef);
+			va = (pr != NULL) ? &pr->rs_value : NULL;
+			pr = find_resc_entry(vb, cur_order->so_rdef);
+			vb = (pr != NULL) ? &pr->rs_value : NULL;
+		}
+		if ((va != NULL) && ((va->at_flags & ATR_VFLAG_SET) == 0))
+			va = NULL;
+		if ((vb != NULL) && ((vb->at_flags & ATR_VFLAG_SET) == 0))
+			vb = NULL;
+	}
+
+	if ((va != NULL) && (vb != NULL)) {
+		if (cur_order->so_rdef != NULL)
+			cmp = cur_order->so_rdef->rs_comp(va, vb);
+		else
+			cmp = job_attr_def[cur_order->so_index].at_comp(va, vb);
+		if (cur_order->so_desc)
+			cmp = -cmp;
+	} else if (va != NULL)
+		cmp = -1;
+	else if (vb != NULL)
+		cmp = 1;
+	if (cmp != 0)
+		return cmp;
+
+	ra = pa->ji_wattr[(int)JOB_ATR_qrank].at_val.at_long;
+	rb = pb->ji_wattr[(int)JOB_ATR_qrank].at_val.at_long;
+	if (ra != rb)
+		return ((ra < rb) ? -1 : 1);
+	return (strcmp(pa->ji_qs.ji_jobid, pb->ji_qs.ji_jobid));
+}
+
+/**
+ * @brief
+ *		Sort the jobs selected for a Status Job or Select-Status request
+ *		and find the page of them to return.
+ *
+ * @param[in,out]	jobs	-	the jobs, sorted on return
+ * @param[in]	njobs	-	number of jobs
+ * @param[in]	pord	-	sort and paging options from parse_stat_order()
+ * @param[out]	pfirst	-	RETURN: index of the first job to return
+ *
+ * @return	int
+ * @retval	number of jobs to return from *pfirst
+ */
+int
+order_stat_jobs(job **jobs, int njobs, struct stat_order *pord, int *pfirst)
+{
+	int count;
+
+	if (pord->so_index >= 0) {
+		cur_order = pord;
+		qsort(jobs, njobs, sizeof(job *), cmp_stat_order);
+		cur_order = NULL;
+	}
+
+	if (pord->so_offset >= njobs) {
+		*pfirst = njobs;
+		return 0;
+	}
+	*pfirst = (int)pord->so_offset;
+	count = njobs - *pfirst;
+	if ((pord->so_limit >= 0) && (pord->so_limit < count))
+		count = (int)pord->so_limit;
+	return count;
+}
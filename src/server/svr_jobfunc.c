@@ -57,6 +57,8 @@
  *		get_jobowner()	   - get job owner name without @host suffix
  *		set_resc_deflt()   - set unspecified resource_limit to default values
  *		set_statechar()	   - set the job state attribute character value
+ *		svr_jobidx_state() - move a job to the state list of its queue
+ *		find_job_owner()   - find the queued jobs of an owner
  *		get_wall ()		   - get the "walltime" for a job if it has one set
  *		get_used_wall ()   - get the "walltime" resourse used for a job
  *      state_char2int()   - returns the state from char form to int form.
@@ -78,6 +80,8 @@
  *		default_std()	   - make the default name for standard out/error
  *		set_deflt_resc()   - set unspecified resource_limit to default values
  *		job_wait_over()	   - event handler for job_set_wait()
+ *		svr_jobidx_link()  - add a queued job to the job indices
+ *		svr_jobidx_unlink() - remove a job from the job indices
  */
 #include <pbs_config.h>   /* the master config generated by configure */
 
@@ -160,6 +164,8 @@ static void running_jobs_count(struct work_task *);
 
 /** For faster job lookup through AVL tree */
 static void svr_avljob_oper(job *pjob, int delkey);
+static void svr_jobidx_link(job *pjob, pbs_queue *pque);
+static void svr_jobidx_unlink(job *pjob);
 
 /* Global Data Items: */
 extern char *msg_noloopbackif;
@@ -169,6 +175,9 @@ extern struct server server;
 extern int  pbs_mom_port;
 extern pbs_list_head svr_alljobs;
 extern pbs_list_head svr_unlicensedjobs;
+
+int svr_jobidx_owners = 1;	/* the owner index is usable */
+static AVL_IX_DESC *job_owner_tree;	/* struct job_owner by owner name */
 extern char  *msg_badwait;		/* error message */
 extern char  *msg_daemonname;
 extern char  *msg_also_deleted_job_history;
@@ -369,6 +378,7 @@ svr_enquejob(job *pjob)
 
 	pque->qu_numjobs++;
 	pque->qu_njstate[pjob->ji_qs.ji_state]++;
+	svr_jobidx_link(pjob, pque);
 
 	if ((pjob->ji_qs.ji_state == JOB_STATE_MOVED) ||
 		(pjob->ji_qs.ji_state == JOB_STATE_FINISHED)) {
@@ -602,6 +612,7 @@ svr_dequejob(job *pjob)
 			if (--pque->qu_njstate[pjob->ji_qs.ji_state] < 0)
 				bad_ct = 1;
 		}
+		svr_jobidx_unlink(pjob);
 		pjob->ji_qhdr = NULL;
 	}
 
@@ -621,6 +632,124 @@ svr_dequejob(job *pjob)
 	clear_default_resc(pjob);
 }
 
+/**
+ * @brief
+ *		svr_jobidx_link - add a job being enqueued to the job indices: the
+ *		list of the jobs in the same state of the queue and the list of
+ *		the queued jobs of its owner.
+ *
+ * @par
+ *		If an owner entry cannot be created, the owner index is turned off,
+ *		like the job AVL tree in svr_avljob_oper(), and req_selectjobs()
+ *		no longer uses it.
+ *
+ * @param[in]	pjob	-	the job
+ * @param[in]	pque	-	the queue it enters
+ *
+ * @see	svr_enquejob()
+ */
+static void
+svr_jobidx_link(job *pjob, pbs_queue *pque)
+{
+	char		  owner[PBS_MAXUSER + 1];
+	struct job_owner *pown;
+
+	append_link(&pque->qu_jobstate[pjob->ji_qs.ji_state],
+		&pjob->ji_jobque_state, pjob);
+
+	if (!svr_jobidx_owners ||
+		!(pjob->ji_wattr[(int)JOB_ATR_job_owner].at_flags & ATR_VFLAG_SET))
+		return;
+	get_jobowner(pjob->ji_wattr[(int)JOB_ATR_job_owner].at_val.at_str, owner);
+
+	if ((pown = find_job_owner(owner)) == NULL) {
+		if ((job_owner_tree == NULL) &&
+			((job_owner_tree = create_tree(AVL_NO_DUP_KEYS, 0)) == NULL))
+			goto owner_fail;
+		if ((pown = malloc(sizeof(struct job_owner))) == NULL)
+			goto owner_fail;
+		CLEAR_HEAD(pown->jo_jobs);
+		pown->jo_count = 0;
+		strcpy(pown->jo_name, owner);
+		if (tree_add_del(job_owner_tree, pown->jo_name, pown,
+			TREE_OP_ADD) != 0) {
+			free(pown);
+			goto owner_fail;
+		}
+	}
+	append_link(&pown->jo_jobs, &pjob->ji_jobowner, pjob);
+	pown->jo_count++;
+	pjob->ji_ownerent = pown;
+	return;
+
+owner_fail:
+	log_err(errno, __func__, "job owner index turned off");
+	svr_jobidx_owners = 0;
+}
+
+/**
+ * @brief
+ *		svr_jobidx_unlink - remove a job being dequeued from the job indices
+ *
+ * @param[in]	pjob	-	the job
+ *
+ * @see	svr_dequejob()
+ */
+static void
+svr_jobidx_unlink(job *pjob)
+{
+	struct job_owner *pown = pjob->ji_ownerent;
+
+	delete_link(&pjob->ji_jobque_state);
+	if (pown == NULL)
+		return;
+	delete_link(&pjob->ji_jobowner);
+	pjob->ji_ownerent = NULL;
+	if (--pown->jo_count <= 0) {
+		(void)tree_add_del(job_owner_tree, pown->jo_name, NULL, TREE_OP_DEL);
+		free(pown);
+	}
+}
+
+/**
+ * @brief
+ *		svr_jobidx_state - move a queued job to the list of its new state in
+ *		its queue.  Called by set_statechar() whenever the state changes.
+ *
+ * @param[in]	pjob	-	the job
+ */
+void
+svr_jobidx_state(job *pjob)
+{
+	pbs_list_link *plink = &pjob->ji_jobque_state;
+
+	if ((pjob->ji_qhdr == NULL) || (plink->ll_next == plink))
+		return;		/* not in a queue yet */
+	if ((pjob->ji_qs.ji_state < 0) ||
+		(pjob->ji_qs.ji_state >= PBS_NUMJOBSTATE))
+		return;
+	delete_link(plink);
+	append_link(&pjob->ji_qhdr->qu_jobstate[pjob->ji_qs.ji_state],
+		plink, pjob);
+}
+
+/**
+ * @brief
+ *		find_job_owner - find the entry listing the queued jobs of an owner
+ *
+ * @param[in]	owner	-	owner name, without the @host suffix
+ *
+ * @return	struct job_owner *
+ * @retval	NULL	: the owner has no queued job
+ */
+struct job_owner *
+find_job_owner(char *owner)
+{
+	if (job_owner_tree == NULL)
+		return NULL;
+	return ((struct job_owner *)find_tree(job_owner_tree, owner));
+}
+
 /**
  * @brief
  * 		svr_setjobstate - set the job state, update the server/queue state counts,
@@ -2526,6 +2655,7 @@ set_statechar(job *pjob)
 		pjob->ji_wattr[JOB_ATR_state].at_val.at_char =
 			*(statechars + pjob->ji_qs.ji_state);
 	pjob->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_MODCACHE;
+	svr_jobidx_state(pjob);
 }
 
 /**
@@ -567,7 +567,10 @@ send_job_exec(job *jobp, pbs_net_t hostaddr, int port, struct batch_request *req
 	(void) strcpy(job_id, jobp->ji_qs.ji_jobid);
 
 	pqjatr = &((svrattrl *) GET_NEXT(attrl))->al_atopl;
+	/* hand the submission's trace id on to the MoM */
+	pbs_current_trace = jobp->ji_trace;
 	jobid = PBSD_queuejob(stream, jobp->ji_qs.ji_jobid, destin, pqjatr, NULL, rpp, &msgid);
+	pbs_current_trace = NULL;
 	free_attrlist(&attrl);
 	if (jobid == NULL)
 		goto send_err;
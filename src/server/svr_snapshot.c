@@ -0,0 +1,1198 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+
+/**
+ * @file    svr_snapshot.c
+ *
+ * @brief
+ * 		svr_snapshot.c - snapshot and journal of the server's jobs, used to
+ *		rebuild them at a warm start without reading and decoding every
+ *		job attribute from the database.  See svr_snapshot.h.
+ *
+ *	The snapshot file and each journal start with a struct snap_header,
+ *	followed by records.  A record is a struct snap_rec, naming the job,
+ *	and sr_len bytes of payload, padded to 8 bytes:
+ *
+ *	SNAP_REC_JOB	the job row (pbs_db_job_info_t) and the job's set
+ *			attributes, each a struct snap_attr and its value:
+ *			plain values (see recov_attr_db_plain) are kept as
+ *			they are in memory, others in their database encoding
+ *	SNAP_REC_QUICK	the job row only, for a SAVEJOB_QUICK save
+ *	SNAP_REC_INTENT	a save of the job is about to be committed
+ *	SNAP_REC_DELETE	the job was purged
+ *
+ *	A journal gets an intent, synced to disk, before each job save is
+ *	committed to the database, and the new image once it is.  A job whose
+ *	last record is an intent may be newer in the database than in the
+ *	journal, so it is recovered from the database.
+ *
+ * Included functions are:
+ *	snap_init()		map the snapshot and journals at server start
+ *	snap_recov_job()	rebuild a job from its image
+ *	snap_recov_done()	unmap and start the snapshot task
+ *	snap_journal_intent()	journal an intent to save a job
+ *	snap_journal_job()	journal the image of a saved job
+ *	snap_journal_quick()	journal the row of a quick saved job
+ *	snap_journal_delete()	journal a purged job
+ *	snap_shutdown()		write the final snapshot
+ *
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <signal.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include "pbs_ifl.h"
+#include "libpbs.h"
+#include "pbs_internal.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "server_limits.h"
+#include "server.h"
+#include "job.h"
+#include "work_task.h"
+#include "log.h"
+#include "svrfunc.h"
+#include "net_connect.h"
+#include "rpp.h"
+#include "pbs_db.h"
+#include "svr_snapshot.h"
+
+#define SNAP_MAGIC	"PBSSNAP"
+#define SNAP_JMAGIC	"PBSJRNL"
+
+/* record types */
+#define SNAP_REC_JOB	1
+#define SNAP_REC_QUICK	2
+#define SNAP_REC_INTENT	3
+#define SNAP_REC_DELETE	4
+
+/* encodings of an attribute in a job image */
+#define SNAP_ATTR_VAL	1	/* union attr_val, as in memory */
+#define SNAP_ATTR_STR	2	/* at_str */
+#define SNAP_ATTR_ENC	3	/* svrattrl entries: flags, name, resource, value */
+
+#define SNAP_ALIGN(n)	(((n) + 7) & ~((size_t)7))
+
+struct snap_header {
+	char		sh_magic[8];	/* SNAP_MAGIC or SNAP_JMAGIC */
+	uint32_t	sh_version;	/* SNAP_VERSION */
+	uint32_t	sh_jsversion;	/* JSVERSION */
+	uint32_t	sh_nattr;	/* JOB_ATR_LAST */
+	uint32_t	sh_dbsize;	/* sizeof(pbs_db_job_info_t) */
+	uint32_t	sh_defhash;	/* of the job attribute names and types */
+	uint32_t	sh_pad;
+	uint64_t	sh_gen;		/* generation */
+	int64_t		sh_time;	/* time written */
+};
+
+struct snap_rec {
+	uint32_t	sr_type;	/* SNAP_REC_* */
+	uint32_t	sr_len;		/* bytes of payload */
+	uint32_t	sr_sum;		/* checksum of job id and payload */
+	uint32_t	sr_pad;
+	char		sr_jobid[PBS_MAXSVRJOBID + 1];
+};
+#define SNAP_RECSZ	SNAP_ALIGN(sizeof(struct snap_rec))
+
+struct snap_attr {
+	uint16_t	sa_index;	/* in job_attr_def */
+	uint16_t	sa_kind;	/* SNAP_ATTR_* */
+	uint32_t	sa_flags;	/* at_flags, for VAL and STR */
+	uint32_t	sa_len;		/* bytes of value */
+	uint32_t	sa_pad;
+};
+
+/* a record read from a mapped snapshot or journal */
+struct snap_ref {
+	struct snap_rec	*sf_rec;
+	long		sf_seq;		/* order in which it was written */
+};
+
+/* the latest state of a job in the mapped snapshot and journals */
+struct snap_job {
+	char		*sj_jobid;
+	struct snap_rec	*sj_image;	/* SNAP_REC_JOB */
+	struct snap_rec	*sj_quick;	/* SNAP_REC_QUICK newer than sj_image */
+};
+
+struct snap_map {
+	void		*sm_addr;
+	size_t		sm_len;
+};
+
+extern char		*path_priv;
+extern time_t		time_now;
+extern int		resc_access_perm;
+
+static int		snap_active;	/* journaling for this server */
+static char		*snap_dir;
+static uint64_t		snap_gen;	/* of the open journal */
+static uint64_t		snap_low_gen;	/* oldest journal kept */
+static int		snap_jfd = -1;	/* the open journal */
+static pid_t		snap_child;	/* writing a snapshot */
+static uint64_t		snap_child_gen;
+static struct timeval	snap_child_start;
+static int		snap_in_child;
+
+static struct snap_map	*snap_maps;
+static int		snap_nmaps;
+static struct snap_ref	*snap_refs;
+static long		snap_nrefs;
+static struct snap_job	*snap_jobs;
+static long		snap_njobs;
+static int		snap_loaded;	/* a snapshot was mapped */
+static long		snap_nused;	/* jobs rebuilt from images */
+static long		snap_nstale;	/* images that did not match the database */
+static struct timeval	snap_load_start;
+
+static char		*snap_buf;	/* a record being built */
+static size_t		snap_bufsz;
+static size_t		snap_buflen;
+
+static void snap_task(struct work_task *);
+
+/**
+ * @brief
+ *		FNV-1a checksum, continued from sum
+ */
+static uint32_t
+snap_sum(uint32_t sum, const void *data, size_t len)
+{
+	const unsigned char *p = data;
+
+	while (len-- > 0) {
+		sum ^= *p++;
+		sum *= 16777619U;
+	}
+	return sum;
+}
+
+/**
+ * @brief
+ *		Checksum of the job attribute definitions, so that a snapshot
+ *		is only read by a server with the same attributes
+ */
+static uint32_t
+snap_defhash(void)
+{
+	uint32_t sum = 2166136261U;
+	uint32_t type;
+	int	 i;
+
+	for (i = 0; i < JOB_ATR_LAST; i++) {
+		sum = snap_sum(sum, job_attr_def[i].at_name,
+			strlen(job_attr_def[i].at_name));
+		type = job_attr_def[i].at_type;
+		sum = snap_sum(sum, &type, sizeof(type));
+	}
+	return sum;
+}
+
+/**
+ * @brief
+ *		Fill in a snapshot or journal header
+ */
+static void
+snap_header_init(struct snap_header *psh, char *magic, uint64_t gen)
+{
+	memset(psh, 0, sizeof(*psh));
+	strcpy(psh->sh_magic, magic);
+	psh->sh_version = SNAP_VERSION;
+	psh->sh_jsversion = JSVERSION;
+	psh->sh_nattr = JOB_ATR_LAST;
+	psh->sh_dbsize = sizeof(pbs_db_job_info_t);
+	psh->sh_defhash = snap_defhash();
+	psh->sh_gen = gen;
+	psh->sh_time = time_now;
+}
+
+/**
+ * @brief
+ *		Append to the record being built in snap_buf
+ *
+ * @return	int
+ * @retval	0  - success
+ * @retval	-1 - out of memory
+ */
+static int
+snap_put(const void *data, size_t len)
+{
+	char	*tmp;
+	size_t	 need = SNAP_ALIGN(snap_buflen + len);
+
+	if (need > snap_bufsz) {
+		size_t	sz = (snap_bufsz == 0) ? 8192 : snap_bufsz;
+
+		while (sz < need)
+			sz *= 2;
+		if ((tmp = realloc(snap_buf, sz)) == NULL)
+			return -1;
+		snap_buf = tmp;
+		snap_bufsz = sz;
+	}
+	if (data != NULL)
+		memcpy(snap_buf + snap_buflen, data, len);
+	else
+		memset(snap_buf + snap_buflen, 0, len);
+	snap_buflen += len;
+	return 0;
+}
+
+/**
+ * @brief
+ *		Pad the record being built to 8 bytes
+ */
+static int
+snap_put_align(void)
+{
+	size_t	pad = SNAP_ALIGN(snap_buflen) - snap_buflen;
+
+	return ((pad > 0) ? snap_put(NULL, pad) : 0);
+}
+
+/**
+ * @brief
+ *		Start a record in snap_buf
+ */
+static int
+snap_rec_start(int type, char *jobid)
+{
+	snap_buflen = 0;
+	if (snap_put(NULL, SNAP_RECSZ) != 0)
+		return -1;
+	((struct snap_rec *)snap_buf)->sr_type = type;
+	snprintf(((struct snap_rec *)snap_buf)->sr_jobid,
+		PBS_MAXSVRJOBID + 1, "%s", jobid);
+	return 0;
+}
+
+/**
+ * @brief
+ *		Finish the record in snap_buf: set its length and checksum
+ */
+static int
+snap_rec_end(void)
+{
+	struct snap_rec *prec;
+
+	if (snap_put_align() != 0)
+		return -1;
+	prec = (struct snap_rec *)snap_buf;
+	prec->sr_len = snap_buflen - SNAP_RECSZ;
+	prec->sr_sum = snap_sum(snap_sum(2166136261U, prec->sr_jobid,
+		sizeof(prec->sr_jobid)), snap_buf + SNAP_RECSZ, prec->sr_len);
+	return 0;
+}
+
+/**
+ * @brief
+ *		How an attribute is kept in a job image: values without pointers
+ *		as they are, plain strings as strings, the rest encoded
+ *
+ * @return	int
+ * @retval	SNAP_ATTR_VAL, SNAP_ATTR_STR or SNAP_ATTR_ENC
+ */
+static int
+snap_attr_kind(attribute_def *pdef)
+{
+	if (!recov_attr_db_plain(pdef))
+		return SNAP_ATTR_ENC;
+	if (pdef->at_decode == decode_str)
+		return ((pdef->at_type == ATR_TYPE_STR) ? SNAP_ATTR_STR : SNAP_ATTR_ENC);
+	return SNAP_ATTR_VAL;
+}
+
+/**
+ * @brief
+ *		Build the image of a job in snap_buf
+ *
+ * @param[in]	pjob - the job
+ *
+ * @return	int
+ * @retval	0  - success
+ * @retval	-1 - out of memory or an attribute could not be encoded
+ */
+static int
+snap_encode_job(job *pjob)
+{
+	pbs_db_job_info_t	dbjob;
+	struct snap_attr	sa;
+	attribute		*pattr;
+	attribute_def		*pdef;
+	pbs_list_head		lhead;
+	svrattrl		*pal;
+	size_t			off;
+	uint32_t		flags;
+	int			kind;
+	int			i;
+	int			rc = 0;
+
+	if (snap_rec_start(SNAP_REC_JOB, pjob->ji_qs.ji_jobid) != 0)
+		return -1;
+	svr_to_db_job(pjob, &dbjob);
+	if ((snap_put(&dbjob, sizeof(dbjob)) != 0) || (snap_put_align() != 0))
+		return -1;
+
+	for (i = 0; (i < JOB_ATR_LAST) && (rc == 0); i++) {
+		pattr = &pjob->ji_wattr[i];
+		pdef = &job_attr_def[i];
+		if ((pattr->at_flags & ATR_VFLAG_SET) == 0)
+			continue;
+
+		memset(&sa, 0, sizeof(sa));
+		sa.sa_index = i;
+		sa.sa_flags = pattr->at_flags;
+		kind = snap_attr_kind(pdef);
+		if (kind == SNAP_ATTR_VAL) {
+			sa.sa_kind = SNAP_ATTR_VAL;
+			sa.sa_len = sizeof(pattr->at_val);
+			rc = snap_put(&sa, sizeof(sa));
+			if (rc == 0)
+				rc = snap_put(&pattr->at_val, sa.sa_len);
+		} else if ((kind == SNAP_ATTR_STR) && (pattr->at_val.at_str != NULL)) {
+			sa.sa_kind = SNAP_ATTR_STR;
+			sa.sa_len = strlen(pattr->at_val.at_str) + 1;
+			rc = snap_put(&sa, sizeof(sa));
+			if (rc == 0)
+				rc = snap_put(pattr->at_val.at_str, sa.sa_len);
+		} else {
+			CLEAR_HEAD(lhead);
+			if (pdef->at_encode(pattr, &lhead, pdef->at_name, NULL,
+				ATR_ENCODE_DB, NULL) < 0)
+				rc = -1;
+			sa.sa_kind = SNAP_ATTR_ENC;
+			off = snap_buflen;
+			if (rc == 0)
+				rc = snap_put(&sa, sizeof(sa));
+			while ((pal = (svrattrl *)GET_NEXT(lhead)) != NULL) {
+				flags = pal->al_flags;
+				if (rc == 0)
+					rc = snap_put(&flags, sizeof(flags));
+				if (rc == 0)
+					rc = snap_put(pal->al_name, strlen(pal->al_name) + 1);
+				if (rc == 0)
+					rc = snap_put(pal->al_resc ? pal->al_resc : "",
+						strlen(pal->al_resc ? pal->al_resc : "") + 1);
+				if (rc == 0)
+					rc = snap_put(pal->al_value ? pal->al_value : "",
+						strlen(pal->al_value ? pal->al_value : "") + 1);
+				delete_link(&pal->al_link);
+				free(pal);
+			}
+			if (rc == 0)
+				((struct snap_attr *)(snap_buf + off))->sa_len =
+					snap_buflen - off - sizeof(sa);
+		}
+		if (rc == 0)
+			rc = snap_put_align();
+	}
+	if (rc != 0)
+		return -1;
+	return (snap_rec_end());
+}
+
+/**
+ * @brief
+ *		Rebuild a job from its image
+ *
+ * @param[in]	prec - the SNAP_REC_JOB record
+ * @param[in]	dbjob - the job row to use, from the image or a later
+ *			SNAP_REC_QUICK record
+ *
+ * @return	job *
+ * @retval	the job
+ * @retval	NULL - the image is unusable or out of memory
+ */
+static job *
+snap_decode_job(struct snap_rec *prec, pbs_db_job_info_t *dbjob)
+{
+	job		 *pj;
+	char		 *p;
+	char		 *end;
+	char		 *vend;
+	char		 *name;
+	char		 *resc;
+	char		 *value;
+	struct snap_attr *psa;
+	svrattrl	 *pal;
+	void		**palarray;
+	uint32_t	  flags;
+	pbs_db_job_info_t dbcopy;
+
+	if ((pj = job_alloc()) == NULL)
+		return NULL;
+	if ((palarray = calloc(JOB_ATR_LAST, sizeof(void *))) == NULL) {
+		job_free(pj);
+		return NULL;
+	}
+	memcpy(&dbcopy, dbjob, sizeof(dbcopy));	/* mapping is read only */
+	db_to_svr_job(pj, &dbcopy);
+
+	p = (char *)prec + SNAP_RECSZ + SNAP_ALIGN(sizeof(pbs_db_job_info_t));
+	end = (char *)prec + SNAP_RECSZ + prec->sr_len;
+	while (p + sizeof(*psa) <= end) {
+		psa = (struct snap_attr *)p;
+		p += sizeof(*psa);
+		vend = p + psa->sa_len;
+		if ((vend > end) || (psa->sa_index >= JOB_ATR_LAST))
+			goto bad;
+		if (psa->sa_kind == SNAP_ATTR_ENC) {
+			while (p + sizeof(flags) < vend) {
+				memcpy(&flags, p, sizeof(flags));
+				name = p + sizeof(flags);
+				resc = name + strnlen(name, vend - name) + 1;
+				if (resc >= vend)
+					goto bad;
+				value = resc + strnlen(resc, vend - resc) + 1;
+				if (value >= vend)
+					goto bad;
+				p = value + strnlen(value, vend - value) + 1;
+				if (p > vend)
+					goto bad;
+				pal = make_attr(name, resc, value, flags);
+				if (pal == NULL)
+					goto bad;
+				CLEAR_LINK(pal->al_link);
+				pal->al_refct = 1;
+				(void)recov_attr_db_index(job_attr_def, palarray, pal,
+					(int)JOB_ATR_LAST, (int)JOB_ATR_UNKN);
+			}
+		} else if (psa->sa_kind != snap_attr_kind(&job_attr_def[psa->sa_index])) {
+			goto bad;
+		} else if (psa->sa_kind == SNAP_ATTR_VAL) {
+			if (psa->sa_len != sizeof(pj->ji_wattr[0].at_val))
+				goto bad;
+			memcpy(&pj->ji_wattr[psa->sa_index].at_val, p, psa->sa_len);
+			pj->ji_wattr[psa->sa_index].at_flags =
+				psa->sa_flags & ~ATR_VFLAG_MODIFY;
+		} else if (psa->sa_kind == SNAP_ATTR_STR) {
+			if ((psa->sa_len == 0) || (p[psa->sa_len - 1] != '\0'))
+				goto bad;
+			if ((pj->ji_wattr[psa->sa_index].at_val.at_str =
+				strdup(p)) == NULL)
+				goto bad;
+			pj->ji_wattr[psa->sa_index].at_flags =
+				psa->sa_flags & ~ATR_VFLAG_MODIFY;
+		} else
+			goto bad;
+		p = (char *)prec + SNAP_ALIGN(vend - (char *)prec);
+	}
+
+	resc_access_perm = ATR_DFLAG_ACCESS;
+	recov_attr_db_decode(pj, job_attr_def, pj->ji_wattr, palarray,
+		(int)JOB_ATR_LAST);
+	free(palarray);
+	return pj;
+
+bad:
+	recov_attr_db_decode(pj, job_attr_def, pj->ji_wattr, palarray,
+		(int)JOB_ATR_LAST);	/* frees the entries */
+	free(palarray);
+	job_free(pj);
+	return NULL;
+}
+
+/**
+ * @brief
+ *		Path of the snapshot, or of a journal when gen is not 0
+ */
+static char *
+snap_path(char *buf, size_t len, uint64_t gen, int tmp)
+{
+	if (gen != 0)
+		snprintf(buf, len, "%s/%s.%llu", snap_dir, SNAP_JOURNAL,
+			(unsigned long long)gen);
+	else
+		snprintf(buf, len, "%s/%s%s", snap_dir, SNAP_FILE,
+			tmp ? ".new" : "");
+	return buf;
+}
+
+/**
+ * @brief
+ *		Map a snapshot or journal and collect its records in snap_refs.
+ *		Reading stops at the first record that is incomplete or fails
+ *		its checksum: the tail of a journal being written when the
+ *		server or its host stopped.
+ *
+ * @param[in]	path - the file
+ * @param[in]	magic - SNAP_MAGIC or SNAP_JMAGIC
+ * @param[out]	pgen - the generation in the header
+ *
+ * @return	int
+ * @retval	0  - success
+ * @retval	-1 - missing or unusable file
+ */
+static int
+snap_map_file(char *path, char *magic, uint64_t *pgen)
+{
+	struct snap_header hdr;
+	struct snap_header *psh;
+	struct snap_rec	*prec;
+	struct snap_map	*pm;
+	struct snap_ref	*pr;
+	struct stat	 sb;
+	char		*addr;
+	size_t		 off;
+	int		 fd;
+
+	if ((fd = open(path, O_RDONLY)) == -1)
+		return -1;
+	if ((fstat(fd, &sb) == -1) || (sb.st_size < (off_t)sizeof(hdr))) {
+		close(fd);
+		return -1;
+	}
+	addr = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return -1;
+
+	psh = (struct snap_header *)addr;
+	snap_header_init(&hdr, magic, psh->sh_gen);
+	if (memcmp(psh->sh_magic, hdr.sh_magic, sizeof(hdr.sh_magic)) ||
+		(psh->sh_version != hdr.sh_version) ||
+		(psh->sh_jsversion != hdr.sh_jsversion) ||
+		(psh->sh_nattr != hdr.sh_nattr) ||
+		(psh->sh_dbsize != hdr.sh_dbsize) ||
+		(psh->sh_defhash != hdr.sh_defhash)) {
+		sprintf(log_buffer, "%s: format or job attributes changed, "
+			"ignored", path);
+		log_err(-1, __func__, log_buffer);
+		munmap(addr, sb.st_size);
+		return -1;
+	}
+	*pgen = psh->sh_gen;
+
+	pm = realloc(snap_maps, (snap_nmaps + 1) * sizeof(*pm));
+	if (pm == NULL) {
+		munmap(addr, sb.st_size);
+		return -1;
+	}
+	snap_maps = pm;
+	snap_maps[snap_nmaps].sm_addr = addr;
+	snap_maps[snap_nmaps++].sm_len = sb.st_size;
+
+	off = SNAP_ALIGN(sizeof(hdr));
+	while (off + SNAP_RECSZ <= (size_t)sb.st_size) {
+		prec = (struct snap_rec *)(addr + off);
+		if ((prec->sr_type < SNAP_REC_JOB) ||
+			(prec->sr_type > SNAP_REC_DELETE) ||
+			(off + SNAP_RECSZ + prec->sr_len > (size_t)sb.st_size) ||
+			(prec->sr_jobid[PBS_MAXSVRJOBID] != '\0') ||
+			((prec->sr_type == SNAP_REC_JOB) &&
+			(prec->sr_len < SNAP_ALIGN(sizeof(pbs_db_job_info_t)))) ||
+			((prec->sr_type == SNAP_REC_QUICK) &&
+			(prec->sr_len != SNAP_ALIGN(sizeof(pbs_db_job_info_t)))) ||
+			(snap_sum(snap_sum(2166136261U, prec->sr_jobid,
+			sizeof(prec->sr_jobid)), addr + off + SNAP_RECSZ,
+			prec->sr_len) != prec->sr_sum)) {
+			sprintf(log_buffer, "%s: stopped at a bad record at "
+				"offset %lu", path, (unsigned long)off);
+			log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER,
+				LOG_NOTICE, msg_daemonname, log_buffer);
+			break;
+		}
+		if ((snap_nrefs % 4096) == 0) {
+			pr = realloc(snap_refs, (snap_nrefs + 4096) * sizeof(*pr));
+			if (pr == NULL)
+				return -1;
+			snap_refs = pr;
+		}
+		snap_refs[snap_nrefs].sf_rec = prec;
+		snap_refs[snap_nrefs].sf_seq = snap_nrefs;
+		snap_nrefs++;
+		off += SNAP_RECSZ + prec->sr_len;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *		Order records by job id, then in the order they were written
+ */
+static int
+snap_ref_cmp(const void *a, const void *b)
+{
+	const struct snap_ref *ra = a;
+	const struct snap_ref *rb = b;
+	int	rc;
+
+	rc = strcmp(ra->sf_rec->sr_jobid, rb->sf_rec->sr_jobid);
+	if (rc != 0)
+		return rc;
+	return ((ra->sf_seq < rb->sf_seq) ? -1 : (ra->sf_seq > rb->sf_seq));
+}
+
+/**
+ * @brief
+ *		Find a job in snap_jobs, for bsearch
+ */
+static int
+snap_job_find(const void *key, const void *elem)
+{
+	return strcmp((char *)key, ((struct snap_job *)elem)->sj_jobid);
+}
+
+/**
+ * @brief
+ *		Open journal gen for appending, and write its header
+ */
+static int
+snap_journal_open(uint64_t gen)
+{
+	struct snap_header hdr;
+	char	path[MAXPATHLEN + 1];
+
+	if (snap_jfd != -1)
+		close(snap_jfd);
+	snap_path(path, sizeof(path), gen, 0);
+	snap_jfd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0600);
+	if (snap_jfd == -1) {
+		log_err(errno, __func__, path);
+		return -1;
+	}
+	snap_header_init(&hdr, SNAP_JMAGIC, gen);
+	if (write(snap_jfd, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+		log_err(errno, __func__, path);
+		return -1;
+	}
+	snap_gen = gen;
+	return 0;
+}
+
+/**
+ * @brief
+ *		Stop journaling after an error.  The snapshot is removed, since
+ *		the journal no longer follows the jobs, and the next start
+ *		recovers every job from the database.
+ */
+static void
+snap_disable(char *why)
+{
+	char	path[MAXPATHLEN + 1];
+
+	sprintf(log_buffer, "%s, snapshot removed and journaling stopped", why);
+	log_err(errno, __func__, log_buffer);
+	(void)unlink(snap_path(path, sizeof(path), 0, 0));
+	if (snap_jfd != -1)
+		close(snap_jfd);
+	snap_jfd = -1;
+	snap_active = 0;
+}
+
+/**
+ * @brief
+ *		Remove the journals older than generation gen
+ */
+static void
+snap_journal_trim(uint64_t gen)
+{
+	char	path[MAXPATHLEN + 1];
+
+	for (; snap_low_gen < gen; snap_low_gen++)
+		(void)unlink(snap_path(path, sizeof(path), snap_low_gen, 0));
+}
+
+/**
+ * @brief
+ *		At server start, map the snapshot and its journals, if snapshots
+ *		are configured and this is a warm or hot start, and start a new
+ *		journal.
+ *
+ * @param[in]	type - the type of start, RECOV_*
+ *
+ * @return	int
+ * @retval	1 - jobs may be rebuilt with snap_recov_job()
+ * @retval	0 - no snapshot, recover jobs from the database
+ */
+int
+snap_init(int type)
+{
+	char		 path[MAXPATHLEN + 1];
+	DIR		*dir;
+	struct dirent	*pdirent;
+	struct snap_ref	*pr;
+	struct snap_job	*psj;
+	uint64_t	 gen;
+	uint64_t	 sgen = 0;
+	uint64_t	 maxgen = 0;
+	uint64_t	 hgen;
+	unsigned long long jgen;
+	size_t		 jlen = strlen(SNAP_JOURNAL);
+	long		 i;
+
+	if (pbs_conf.pbs_snapshot_interval == 0)
+		return 0;
+	gettimeofday(&snap_load_start, NULL);
+
+	snprintf(path, sizeof(path), "%s%s", path_priv, SNAP_DIR);
+	if ((snap_dir = strdup(path)) == NULL)
+		return 0;
+	if ((mkdir(snap_dir, 0750) == -1) && (errno != EEXIST)) {
+		log_err(errno, __func__, snap_dir);
+		return 0;
+	}
+	snap_active = 1;
+
+	/* the snapshot must go when jobs are not recovered */
+	if ((type == RECOV_COLD) || (type == RECOV_CREATE))
+		(void)unlink(snap_path(path, sizeof(path), 0, 0));
+	else if (snap_map_file(snap_path(path, sizeof(path), 0, 0),
+		SNAP_MAGIC, &sgen) == 0)
+		snap_loaded = 1;
+
+	/* replay the journals written since the snapshot, drop the others */
+	if ((dir = opendir(snap_dir)) != NULL) {
+		while ((pdirent = readdir(dir)) != NULL) {
+			if ((strncmp(pdirent->d_name, SNAP_JOURNAL, jlen) != 0) ||
+				(pdirent->d_name[jlen] != '.') ||
+				(sscanf(pdirent->d_name + jlen + 1, "%llu", &jgen) != 1))
+				continue;
+			if (jgen > maxgen)
+				maxgen = jgen;
+			if (!snap_loaded || (jgen < sgen)) {
+				snprintf(path, sizeof(path), "%s/%s", snap_dir,
+					pdirent->d_name);
+				(void)unlink(path);
+			}
+		}
+		closedir(dir);
+	}
+	if (sgen > maxgen)
+		maxgen = sgen;
+	snap_low_gen = snap_loaded ? sgen : maxgen + 1;
+	for (gen = sgen; snap_loaded && (gen <= maxgen); gen++)
+		(void)snap_map_file(snap_path(path, sizeof(path), gen, 0),
+			SNAP_JMAGIC, &hgen);
+
+	/* journal the saves made while jobs are recovered */
+	if (snap_journal_open(maxgen + 1) != 0) {
+		snap_disable("cannot start a journal");
+		snap_loaded = 0;
+	}
+	if (!snap_loaded || (snap_nrefs == 0))
+		return 0;
+
+	/* fold the records of each job into its latest state */
+	qsort(snap_refs, snap_nrefs, sizeof(*snap_refs), snap_ref_cmp);
+	if ((snap_jobs = calloc(snap_nrefs, sizeof(*snap_jobs))) == NULL) {
+		snap_loaded = 0;
+		return 0;
+	}
+	psj = NULL;
+	for (i = 0; i < snap_nrefs; i++) {
+		pr = &snap_refs[i];
+		if ((psj == NULL) ||
+			strcmp(psj->sj_jobid, pr->sf_rec->sr_jobid)) {
+			if ((psj != NULL) && (psj->sj_image != NULL))
+				snap_njobs++;
+			psj = &snap_jobs[snap_njobs];
+			memset(psj, 0, sizeof(*psj));
+			psj->sj_jobid = pr->sf_rec->sr_jobid;
+		}
+		switch (pr->sf_rec->sr_type) {
+			case SNAP_REC_JOB:
+				psj->sj_image = pr->sf_rec;
+				psj->sj_quick = NULL;
+				break;
+			case SNAP_REC_QUICK:
+				psj->sj_quick = pr->sf_rec;
+				break;
+			default:	/* intent or delete: no usable image */
+				psj->sj_image = NULL;
+				psj->sj_quick = NULL;
+				break;
+		}
+	}
+	if ((psj != NULL) && (psj->sj_image != NULL))
+		snap_njobs++;
+	free(snap_refs);
+	snap_refs = NULL;
+	return 1;
+}
+
+/**
+ * @brief
+ *		Rebuild a job from the snapshot and journals, if its image there
+ *		agrees with the row read from the database.
+ *
+ * @param[in]	dbjob - the job's row from the database
+ *
+ * @return	job *
+ * @retval	the rebuilt job
+ * @retval	NULL - no usable image, recover the job from the database
+ */
+job *
+snap_recov_job(pbs_db_job_info_t *dbjob)
+{
+	struct snap_job	  *psj;
+	pbs_db_job_info_t *idb;
+	job		  *pj;
+
+	if (snap_njobs == 0)
+		return NULL;
+	psj = bsearch(dbjob->ji_jobid, snap_jobs, snap_njobs,
+		sizeof(*snap_jobs), snap_job_find);
+	if (psj == NULL)
+		return NULL;
+
+	idb = (pbs_db_job_info_t *)((char *)(psj->sj_quick ?
+		psj->sj_quick : psj->sj_image) + SNAP_RECSZ);
+	if ((idb->ji_state != dbjob->ji_state) ||
+		(idb->ji_substate != dbjob->ji_substate) ||
+		(idb->ji_svrflags != dbjob->ji_svrflags) ||
+		(idb->ji_un_type != dbjob->ji_un_type) ||
+		(idb->ji_stime != dbjob->ji_stime) ||
+		(idb->ji_qrank != dbjob->ji_qrank) ||
+		strcmp(idb->ji_queue, dbjob->ji_queue)) {
+		snap_nstale++;
+		return NULL;
+	}
+	if ((pj = snap_decode_job(psj->sj_image, idb)) == NULL) {
+		snap_nstale++;
+		return NULL;
+	}
+	snap_nused++;
+	return pj;
+}
+
+/**
+ * @brief
+ *		Milliseconds elapsed since a time
+ */
+static long
+snap_ms(struct timeval *from)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return ((now.tv_sec - from->tv_sec) * 1000L +
+		(now.tv_usec - from->tv_usec) / 1000L);
+}
+
+/**
+ * @brief
+ *		After the jobs are recovered: unmap the snapshot and journals
+ *		and schedule the snapshot task.  The first
+ *		snapshot is taken right away if none was usable.
+ */
+void
+snap_recov_done(void)
+{
+	int	i;
+
+	if (!snap_active)
+		return;
+
+	if (snap_loaded) {
+		sprintf(log_buffer, "snapshot: %ld jobs rebuilt from %ld images, "
+			"%ld stale images, in %ld ms", snap_nused, snap_njobs,
+			snap_nstale, snap_ms(&snap_load_start));
+		log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO,
+			msg_daemonname, log_buffer);
+	}
+	for (i = 0; i < snap_nmaps; i++)
+		munmap(snap_maps[i].sm_addr, snap_maps[i].sm_len);
+	free(snap_maps);
+	snap_maps = NULL;
+	snap_nmaps = 0;
+	free(snap_refs);
+	snap_refs = NULL;
+	free(snap_jobs);
+	snap_jobs = NULL;
+	snap_njobs = 0;
+
+	(void)set_task(WORK_Timed, snap_loaded ?
+		time_now + pbs_conf.pbs_snapshot_interval : time_now,
+		snap_task, NULL);
+}
+
+/**
+ * @brief
+ *		Append the record in snap_buf to the journal
+ *
+ * @param[in]	sync - flush it to disk before returning
+ */
+static void
+snap_journal_write(int sync)
+{
+	if (write(snap_jfd, snap_buf, snap_buflen) != (ssize_t)snap_buflen) {
+		snap_disable("journal write failed");
+		return;
+	}
+	if (sync && (fdatasync(snap_jfd) == -1))
+		snap_disable("journal sync failed");
+}
+
+/**
+ * @brief
+ *		Journal that a save of a job is about to be committed to the
+ *		database.  Until the job's next image is journaled, the job is
+ *		recovered from the database.
+ *
+ * @param[in]	jobid - the job
+ */
+void
+snap_journal_intent(char *jobid)
+{
+	if (!snap_active || (snap_jfd == -1) || snap_in_child)
+		return;
+	if ((snap_rec_start(SNAP_REC_INTENT, jobid) != 0) ||
+		(snap_rec_end() != 0)) {
+		snap_disable("out of memory");
+		return;
+	}
+	snap_journal_write(1);
+}
+
+/**
+ * @brief
+ *		Journal the image of a job whose save was committed
+ *
+ * @param[in]	pjob - the job
+ */
+void
+snap_journal_job(job *pjob)
+{
+	if (!snap_active || (snap_jfd == -1) || snap_in_child)
+		return;
+	if (snap_encode_job(pjob) != 0) {
+		snap_disable("cannot encode a job image");
+		return;
+	}
+	snap_journal_write(0);
+}
+
+/**
+ * @brief
+ *		Journal the row of a job saved with SAVEJOB_QUICK
+ *
+ * @param[in]	dbjob - the row written to the database
+ */
+void
+snap_journal_quick(pbs_db_job_info_t *dbjob)
+{
+	if (!snap_active || (snap_jfd == -1) || snap_in_child)
+		return;
+	if ((snap_rec_start(SNAP_REC_QUICK, dbjob->ji_jobid) != 0) ||
+		(snap_put(dbjob, sizeof(*dbjob)) != 0) ||
+		(snap_rec_end() != 0)) {
+		snap_disable("out of memory");
+		return;
+	}
+	snap_journal_write(0);
+}
+
+/**
+ * @brief
+ *		Journal a purged job
+ *
+ * @param[in]	jobid - the job
+ */
+void
+snap_journal_delete(char *jobid)
+{
+	if (!snap_active || (snap_jfd == -1) || snap_in_child)
+		return;
+	if ((snap_rec_start(SNAP_REC_DELETE, jobid) != 0) ||
+		(snap_rec_end() != 0)) {
+		snap_disable("out of memory");
+		return;
+	}
+	snap_journal_write(0);
+}
+
+/**
+ * @brief
+ *		Write a snapshot of every job saved in the database, as
+ *		generation gen, and put it in place of the previous one
+ *
+ * @return	int
+ * @retval	0  - success
+ * @retval	-1 - failure, the previous snapshot is left in place
+ */
+static int
+snap_write(uint64_t gen)
+{
+	struct snap_header hdr;
+	char	 path[MAXPATHLEN + 1];
+	char	 tmp[MAXPATHLEN + 1];
+	job	*pjob;
+	FILE	*fp;
+	int	 rc = 0;
+
+	snap_path(tmp, sizeof(tmp), 0, 1);
+	if ((fp = fopen(tmp, "w")) == NULL)
+		return -1;
+	snap_header_init(&hdr, SNAP_MAGIC, gen);
+	if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1)
+		rc = -1;
+	for (pjob = (job *)GET_NEXT(svr_alljobs);
+		pjob && (rc == 0);
+		pjob = (job *)GET_NEXT(pjob->ji_alljobs)) {
+		if (pjob->ji_newjob || pjob->ji_modified)
+			continue;	/* differs from the database */
+		if ((snap_encode_job(pjob) != 0) ||
+			(fwrite(snap_buf, snap_buflen, 1, fp) != 1))
+			rc = -1;
+	}
+	if ((fflush(fp) != 0) || (fsync(fileno(fp)) == -1))
+		rc = -1;
+	if ((fclose(fp) != 0) || (rc != 0) ||
+		(rename(tmp, snap_path(path, sizeof(path), 0, 0)) == -1)) {
+		(void)unlink(tmp);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *		Reap the child that wrote a snapshot.  Once the snapshot is in
+ *		place, the journals it replaces are removed.
+ *
+ * @param[in]	ptask - work task, wt_event is the child's pid
+ */
+static void
+snap_post(struct work_task *ptask)
+{
+	if ((pid_t)ptask->wt_event != snap_child)
+		return;
+	snap_child = 0;
+	if (WIFEXITED(ptask->wt_aux) && (WEXITSTATUS(ptask->wt_aux) == 0)) {
+		snap_journal_trim(snap_child_gen);
+		sprintf(log_buffer, "snapshot generation %llu written in %ld ms",
+			(unsigned long long)snap_child_gen,
+			snap_ms(&snap_child_start));
+		log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, LOG_INFO,
+			msg_daemonname, log_buffer);
+	} else {
+		sprintf(log_buffer, "snapshot generation %llu failed, status %d",
+			(unsigned long long)snap_child_gen, ptask->wt_aux);
+		log_err(-1, __func__, log_buffer);
+	}
+}
+
+/**
+ * @brief
+ *		Periodic task: switch to a new journal and fork a child that
+ *		writes the snapshot of the jobs as of the switch
+ *
+ * @param[in]	ptask - work task
+ */
+static void
+snap_task(struct work_task *ptask)
+{
+	pid_t	pid;
+
+	if (!snap_active)
+		return;
+	(void)set_task(WORK_Timed, time_now + pbs_conf.pbs_snapshot_interval,
+		snap_task, NULL);
+	if (snap_child != 0)
+		return;		/* previous one still running */
+
+	if (snap_journal_open(snap_gen + 1) != 0) {
+		snap_disable("cannot start a journal");
+		return;
+	}
+	pid = fork();
+	if (pid == -1) {
+		log_err(errno, __func__, "fork failed");
+		return;
+	}
+	if (pid == 0) {
+		snap_in_child = 1;
+		close(snap_jfd);
+		net_close(-1);
+		rpp_terminate();
+		daemon_protect(0, PBS_DAEMON_PROTECT_OFF);
+		_exit(snap_write(snap_gen) == 0 ? 0 : 1);
+	}
+	snap_child = pid;
+	snap_child_gen = snap_gen;
+	gettimeofday(&snap_child_start, NULL);
+	if (set_task(WORK_Deferred_Child, (long)pid, snap_post, NULL) == NULL)
+		log_err(errno, __func__, "cannot track snapshot child");
+}
+
+/**
+ * @brief
+ *		At server shutdown, write the final snapshot so the next start
+ *		needs no journal
+ */
+void
+snap_shutdown(void)
+{
+	struct timeval	start;
+	int		status;
+
+	if (!snap_active)
+		return;
+	if (snap_child != 0) {
+		/* its snapshot would be older than ours */
+		(void)kill(snap_child, SIGKILL);
+		(void)waitpid(snap_child, &status, 0);
+		snap_child = 0;
+	}
+	gettimeofday(&start, NULL);
+	if (snap_write(snap_gen + 1) != 0) {
+		log_err(errno, __func__, "final snapshot failed");
+		return;
+	}
+	if (snap_jfd != -1)
+		close(snap_jfd);
+	snap_jfd = -1;
+	snap_journal_trim(snap_gen + 1);
+	sprintf(log_buffer, "final snapshot written in %ld ms", snap_ms(&start));
+	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO,
+		msg_daemonname, log_buffer);
+}
@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+/**
+ * @file pbs_acctbin.c
+ *
+ * @brief
+ *		pbs_acctbin.c - convert, print and summarize binary accounting logs
+ *
+ * Functions included are:
+ * 	main()
+ * 	convert()
+ * 	print_text()
+ * 	summarize()
+ * 	hms_to_secs()
+ *
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/param.h>
+#include "cmds.h"
+#include "pbs_version.h"
+#include "pbs_ifl.h"
+#include "acct_bin.h"
+
+#define LINE_SIZE	(64 * 1024)
+#define ACCT_END	'E'	/* PBS_ACCT_END in acct.h, job ended record */
+
+/* per user totals kept by summarize() */
+struct user_sum {
+	char		*us_user;
+	long		 us_jobs;
+	double		 us_walltime;
+	double		 us_cput;
+	double		 us_cpu_secs;	/* ncpus times walltime */
+	struct user_sum	*us_next;
+};
+
+/**
+ * @brief
+ * 		Convert a duration written as [[HH:]MM:]SS to seconds.
+ *
+ * @param[in]	val - duration, may be NULL
+ *
+ * @return	double
+ * @retval	seconds, 0 if val is NULL
+ */
+static double
+hms_to_secs(char *val)
+{
+	double	secs = 0;
+	char   *p;
+
+	if (val == NULL)
+		return 0;
+	for (p = val; ; p++) {
+		secs = secs * 60 + strtol(p, &p, 10);
+		if (*p != ':')
+			break;
+	}
+	return secs;
+}
+
+/**
+ * @brief
+ * 		Convert a text accounting file to the binary format.
+ *
+ * @param[in]	txtname - text accounting file
+ * @param[in]	binname - binary file to write, appended to if it exists
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	1	error
+ */
+static int
+convert(char *txtname, char *binname)
+{
+	FILE	*in;
+	struct acct_bin_file *out;
+	char	*line;
+	char	*id;
+	char	*text;
+	char	*p;
+	struct tm tm;
+	long	lineno = 0;
+	long	bad = 0;
+	int	rc = 0;
+
+	if ((in = fopen(txtname, "r")) == NULL) {
+		perror(txtname);
+		return 1;
+	}
+	if ((out = acct_bin_open(binname, 1)) == NULL) {
+		perror(binname);
+		fclose(in);
+		return 1;
+	}
+	if ((line = malloc(LINE_SIZE)) == NULL) {
+		fprintf(stderr, "out of memory\n");
+		fclose(in);
+		acct_bin_close(out);
+		return 1;
+	}
+
+	while (fgets(line, LINE_SIZE, in) != NULL) {
+		lineno++;
+		if ((p = strchr(line, '\n')) != NULL)
+			*p = '\0';
+		memset(&tm, 0, sizeof(tm));
+		if ((sscanf(line, "%d/%d/%d %d:%d:%d;", &tm.tm_mon, &tm.tm_mday,
+			&tm.tm_year, &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6) ||
+			((p = strchr(line, ';')) == NULL) || (p[1] == '\0') || (p[2] != ';')) {
+			bad++;
+			continue;
+		}
+		tm.tm_mon -= 1;
+		tm.tm_year -= 1900;
+		tm.tm_isdst = -1;
+		id = p + 3;
+		if ((text = strchr(id, ';')) == NULL) {
+			bad++;
+			continue;
+		}
+		*text++ = '\0';
+		if (acct_bin_write(out, mktime(&tm), (int)p[1], id, text) != 0) {
+			perror(binname);
+			rc = 1;
+			break;
+		}
+	}
+	if (bad > 0)
+		fprintf(stderr, "%s: skipped %ld of %ld lines not in accounting format\n",
+			txtname, bad, lineno);
+
+	free(line);
+	fclose(in);
+	acct_bin_close(out);
+	return rc;
+}
+
+/**
+ * @brief
+ * 		Print a binary accounting file in the text format.
+ *
+ * @param[in]	binname - binary accounting file
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	1	error
+ */
+static int
+print_text(char *binname)
+{
+	struct acct_bin_file *abf;
+	char	*line;
+	int	 rc;
+
+	if ((abf = acct_bin_open(binname, 0)) == NULL) {
+		perror(binname);
+		return 1;
+	}
+	if ((line = malloc(LINE_SIZE)) == NULL) {
+		fprintf(stderr, "out of memory\n");
+		acct_bin_close(abf);
+		return 1;
+	}
+	while ((rc = acct_bin_read(abf)) == 1) {
+		if (acct_bin_text(abf, line, LINE_SIZE) < 0)
+			fprintf(stderr, "%s: record for %s too long, skipped\n", binname, abf->abf_id);
+		else
+			printf("%s\n", line);
+	}
+	if (rc == -1)
+		fprintf(stderr, "%s: truncated or corrupt after offset %ld\n", binname, abf->abf_end);
+
+	free(line);
+	acct_bin_close(abf);
+	return (rc == -1);
+}
+
+/**
+ * @brief
+ * 		Add up job end records per user over a set of binary files.
+ *
+ * @par
+ *	Only the 'E' records are looked at.  The fields are found through
+ *	their key ids, which are looked up again only when the file's
+ *	dictionary has grown.
+ *
+ * @param[in]	nfiles - number of files
+ * @param[in]	files - binary accounting files
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	1	error
+ */
+static int
+summarize(int nfiles, char **files)
+{
+	struct acct_bin_file *abf;
+	struct user_sum *users = NULL;
+	struct user_sum *us;
+	int	 k_user = -1, k_wall = -1, k_cput = -1, k_ncpus = -1;
+	int	 nkeys;
+	int	 rc;
+	int	 err = 0;
+	int	 i;
+	char	*user;
+	double	 wall;
+
+	for (i = 0; i < nfiles; i++) {
+		if ((abf = acct_bin_open(files[i], 0)) == NULL) {
+			perror(files[i]);
+			err = 1;
+			continue;
+		}
+		nkeys = -1;
+		while ((rc = acct_bin_read(abf)) == 1) {
+			if (abf->abf_type != ACCT_END)
+				continue;
+			if (nkeys != abf->abf_nkeys) {
+				k_user = acct_bin_keyid(abf, "user");
+				k_wall = acct_bin_keyid(abf, "resources_used.walltime");
+				k_cput = acct_bin_keyid(abf, "resources_used.cput");
+				k_ncpus = acct_bin_keyid(abf, "resources_used.ncpus");
+				nkeys = abf->abf_nkeys;
+			}
+			if ((user = acct_bin_value(abf, k_user)) == NULL)
+				continue;
+			for (us = users; us != NULL; us = us->us_next) {
+				if (strcmp(us->us_user, user) == 0)
+					break;
+			}
+			if (us == NULL) {
+				if (((us = calloc(1, sizeof(struct user_sum))) == NULL) ||
+					((us->us_user = strdup(user)) == NULL)) {
+					fprintf(stderr, "out of memory\n");
+					free(us);
+					acct_bin_close(abf);
+					return 1;
+				}
+				us->us_next = users;
+				users = us;
+			}
+			wall = hms_to_secs(acct_bin_value(abf, k_wall));
+			us->us_jobs++;
+			us->us_walltime += wall;
+			us->us_cput += hms_to_secs(acct_bin_value(abf, k_cput));
+			if (acct_bin_value(abf, k_ncpus) != NULL)
+				us->us_cpu_secs += wall * atol(acct_bin_value(abf, k_ncpus));
+		}
+		if (rc == -1) {
+			fprintf(stderr, "%s: truncated or corrupt after offset %ld\n", files[i], abf->abf_end);
+			err = 1;
+		}
+		acct_bin_close(abf);
+	}
+
+	printf("%-16s %8s %14s %14s %14s\n", "user", "jobs", "walltime_h", "cput_h", "cpu_h");
+	for (us = users; us != NULL; us = users) {
+		printf("%-16s %8ld %14.2f %14.2f %14.2f\n", us->us_user, us->us_jobs,
+			us->us_walltime / 3600, us->us_cput / 3600, us->us_cpu_secs / 3600);
+		users = us->us_next;
+		free(us->us_user);
+		free(us);
+	}
+	return err;
+}
+
+/**
+ * @brief
+ * 		This is main function of pbs_acctbin.
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	1	error
+ */
+int
+main(int argc, char *argv[])
+{
+	char	 binname[MAXPATHLEN + 1];
+	int	 c;
+	int	 mode = 0;
+	int	 rc = 0;
+	int	 i;
+
+	/*the real deal or output pbs_version and exit?*/
+	execution_mode(argc, argv);
+
+	while ((c = getopt(argc, argv, "ctu")) != EOF) {
+		switch (c) {
+			case 'c':
+			case 't':
+			case 'u':
+				if (mode != 0 && mode != c)
+					mode = '?';
+				else
+					mode = c;
+				break;
+			default:
+				mode = '?';
+				break;
+		}
+	}
+
+	if ((mode == 'c') && ((argc - optind) == 1 || (argc - optind) == 2)) {
+		if ((argc - optind) == 2)
+			snprintf(binname, sizeof(binname), "%s", argv[optind + 1]);
+		else
+			snprintf(binname, sizeof(binname), "%s%s", argv[optind], ACCT_BIN_SUFFIX);
+		return (convert(argv[optind], binname));
+	} else if ((mode == 't') && (optind < argc)) {
+		for (i = optind; i < argc; i++)
+			rc |= print_text(argv[i]);
+		return rc;
+	} else if ((mode == 'u') && (optind < argc)) {
+		return (summarize(argc - optind, &argv[optind]));
+	}
+
+	fprintf(stderr, "usage: %s -c text_acct_file [binary_acct_file]\n", argv[0]);
+	fprintf(stderr, "       %s -t binary_acct_file ...\n", argv[0]);
+	fprintf(stderr, "       %s -u binary_acct_file ...\n", argv[0]);
+	fprintf(stderr, "       %s --version\n", argv[0]);
+	return 1;
+}
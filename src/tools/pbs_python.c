@@ -96,6 +96,12 @@
 #include "cmds.h"
 #include "svrfunc.h"
 #include "pbs_sched.h"
+#ifndef WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#endif
 
 #define PBS_PYTHON 1.1
 #define MAXBUF	4096
@@ -2191,6 +2197,387 @@ argv_list_to_str(pbs_list_head *argv_list)
 
 }
 
+#ifndef WIN32
+/*
+ * State of a pbs_python started with --hook-worker by pbs_mom.  The
+ * worker loads the interpreter and the pbs module once, then forks a
+ * copy of itself for each request arriving on its control socket (fd 0);
+ * the copy returns from hook_worker() and runs the request through the
+ * normal --hook code in main().
+ */
+#define	HOOK_WORKER_MAXSCRIPTS	64
+
+struct hook_worker_child {
+	pid_t	hc_pid;		/* process running the hook */
+	int	hc_fd;		/* request socket to answer on */
+};
+
+static struct python_script *hook_worker_scripts[HOOK_WORKER_MAXSCRIPTS];
+static int	hook_worker_nscripts = 0;
+static int	hook_worker_sigpipe[2] = {-1, -1};
+static struct sigaction	hook_worker_oldchld;
+static struct sigaction	hook_worker_oldpipe;
+#endif	/* WIN32 */
+
+/* compiled script handed to the hook process by the worker, if any */
+static struct python_script *hook_worker_script = NULL;
+
+#ifndef WIN32
+/**
+ * @brief
+ *	SIGCHLD handler of the hook worker: wake up the poll() loop.
+ */
+static void
+hook_worker_sigchld(int sig)
+{
+	int	save = errno;
+
+	(void)write(hook_worker_sigpipe[1], "c", 1);
+	errno = save;
+}
+
+/**
+ * @brief
+ *	Return the compiled form of hook script 'path', compiling it
+ *	the first time or when it has changed since.  Kept in the worker
+ *	so that each forked hook process starts with the code object.
+ *
+ * @param[in]	path	- hook script path
+ *
+ * @return	struct python_script *
+ * @retval	NULL	- script could not be compiled here
+ */
+static struct python_script *
+hook_worker_compile(char *path)
+{
+	struct python_script	*py_script = NULL;
+	int			i;
+
+	for (i = 0; i < hook_worker_nscripts; i++) {
+		if (strcmp(hook_worker_scripts[i]->path, path) == 0) {
+			py_script = hook_worker_scripts[i];
+			break;
+		}
+	}
+	if (py_script == NULL) {
+		if (pbs_python_ext_alloc_python_script(path, &py_script) != 0)
+			return NULL;
+		if (hook_worker_nscripts == HOOK_WORKER_MAXSCRIPTS) {
+			/* drop the oldest entry */
+			pbs_python_ext_free_python_script(hook_worker_scripts[0]);
+			free(hook_worker_scripts[0]);
+			memmove(&hook_worker_scripts[0], &hook_worker_scripts[1],
+				(HOOK_WORKER_MAXSCRIPTS - 1) *
+				sizeof(struct python_script *));
+			hook_worker_nscripts--;
+		}
+		hook_worker_scripts[hook_worker_nscripts++] = py_script;
+	}
+	if (pbs_python_check_and_compile_script(&svr_interp_data,
+		py_script) != 0)
+		return NULL;
+	return py_script;
+}
+
+/**
+ * @brief
+ *	Receive a request socket passed by pbs_mom on control socket 'ctl'.
+ *
+ * @return	int
+ * @retval	>=0	- the request socket
+ * @retval	-1	- nothing usable received
+ * @retval	-2	- pbs_mom closed the control socket
+ */
+static int
+hook_worker_recv(int ctl)
+{
+	struct msghdr	msg;
+	struct iovec	iov;
+	struct cmsghdr	*cmsg;
+	union {
+		struct cmsghdr	cm;
+		char		buf[CMSG_SPACE(sizeof(int))];
+	} cbuf;
+	char		c;
+	int		fd = -1;
+	ssize_t		n;
+
+	memset(&msg, 0, sizeof(msg));
+	iov.iov_base = &c;
+	iov.iov_len = 1;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = cbuf.buf;
+	msg.msg_controllen = sizeof(cbuf.buf);
+
+	n = recvmsg(ctl, &msg, 0);
+	if (n == 0)
+		return -2;
+	if (n == -1)
+		return ((errno == EINTR) || (errno == EAGAIN)) ? -1 : -2;
+	cmsg = CMSG_FIRSTHDR(&msg);
+	if ((cmsg != NULL) && (cmsg->cmsg_level == SOL_SOCKET) &&
+		(cmsg->cmsg_type == SCM_RIGHTS))
+		memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+	return fd;
+}
+
+/**
+ * @brief
+ *	Read a hook request from socket 'fd' into a NULL terminated
+ *	string vector: working directory, hook config file, then the
+ *	"pbs_python --hook" arguments.
+ *
+ * @return	char **
+ * @retval	NULL	- malformed request
+ */
+static char **
+hook_worker_read(int fd, int *nstr)
+{
+	struct hook_worker_hdr	hdr;
+	char	*buf;
+	char	**strs;
+	char	*p;
+	int	i;
+
+	if ((read(fd, &hdr, sizeof(hdr)) != sizeof(hdr)) ||
+		(hdr.hw_nstr < 4) || (hdr.hw_len <= 0) ||
+		(hdr.hw_len > HOOK_WORKER_MAXREQ))
+		return NULL;
+	if ((buf = malloc(hdr.hw_len + 1)) == NULL)
+		return NULL;
+	for (i = 0; i < hdr.hw_len; ) {
+		ssize_t n = read(fd, buf + i, hdr.hw_len - i);
+		if (n <= 0) {
+			free(buf);
+			return NULL;
+		}
+		i += n;
+	}
+	buf[hdr.hw_len] = '\0';
+	if ((strs = calloc(hdr.hw_nstr + 1, sizeof(char *))) == NULL) {
+		free(buf);
+		return NULL;
+	}
+	for (i = 0, p = buf; i < hdr.hw_nstr; i++) {
+		if (p >= buf + hdr.hw_len) {
+			free(strs);
+			free(buf);
+			return NULL;
+		}
+		strs[i] = p;
+		p += strlen(p) + 1;
+	}
+	*nstr = hdr.hw_nstr;
+	return strs;
+}
+
+/**
+ * @brief
+ *	Main loop of "pbs_python --hook-worker [-L path_log] [-e mask]
+ *	[-r resourcedef]".  Starts the interpreter, then forks a hook
+ *	process per request.  The worker answers each request with the
+ *	pid of the hook process and later its wait status, and kills the
+ *	hook if pbs_mom's side of the request goes away (hook alarm).
+ *	Returns only in a forked hook process, with *pargc and *pargv
+ *	set to the "--hook" command line to run; the worker itself exits
+ *	when pbs_mom closes the control socket.
+ *
+ * @param[in,out]	pargc	- argc of main()
+ * @param[in,out]	pargv	- argv of main()
+ *
+ * @return	void
+ */
+static void
+hook_worker(int *pargc, char ***pargv)
+{
+	extern void pbs_python_svr_initialize_interpreter_data(
+		struct python_interpreter_data *interp_data);
+	extern void pbs_python_svr_destroy_interpreter_data(
+		struct python_interpreter_data *interp_data);
+	struct hook_worker_child *kids = NULL;
+	struct pollfd	*pfds = NULL;
+	struct sigaction act;
+	struct python_script *py_script;
+	char	path_log[MAXPATHLEN + 1] = ".";
+	char	**strs;
+	char	c;
+	int	nkids = 0;
+	int	nstr;
+	int	fd;
+	int	i;
+	int	status;
+	pid_t	pid;
+
+	while ((i = getopt(*pargc - 1, *pargv + 1, "L:e:r:")) != EOF) {
+		switch (i) {
+			case 'L':
+				snprintf(path_log, sizeof(path_log), "%s", optarg);
+				break;
+			case 'e':
+				*log_event_mask = strtol(optarg, NULL, 0);
+				break;
+			case 'r':
+				path_rescdef = strdup(optarg);
+				if ((path_rescdef == NULL) || (setup_resc(1) == -1))
+					exit(2);
+				break;
+			default:
+				exit(2);
+		}
+	}
+	if (log_open_main("", path_log, 1) != 0)
+		exit(1);
+
+	svr_interp_data.data_initialized = 0;
+	svr_interp_data.init_interpreter_data =
+		pbs_python_svr_initialize_interpreter_data;
+	svr_interp_data.destroy_interpreter_data =
+		pbs_python_svr_destroy_interpreter_data;
+	svr_interp_data.daemon_name = strdup("pbs_python");
+	if (svr_interp_data.daemon_name == NULL)
+		exit(1);
+	pbs_python_ext_start_interpreter(&svr_interp_data);
+	if (!svr_interp_data.interp_started)
+		exit(1);
+
+	if (pipe(hook_worker_sigpipe) == -1)
+		exit(1);
+	(void)fcntl(hook_worker_sigpipe[0], F_SETFL, O_NONBLOCK);
+	(void)fcntl(hook_worker_sigpipe[1], F_SETFL, O_NONBLOCK);
+	memset(&act, 0, sizeof(act));
+	sigemptyset(&act.sa_mask);
+	act.sa_handler = hook_worker_sigchld;
+	act.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+	(void)sigaction(SIGCHLD, &act, &hook_worker_oldchld);
+	act.sa_handler = SIG_IGN;
+	act.sa_flags = 0;
+	(void)sigaction(SIGPIPE, &act, &hook_worker_oldpipe);
+
+	log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SERVER, LOG_INFO,
+		__func__, "hook worker ready");
+
+	for (;;) {
+		struct pollfd *tmp;
+
+		tmp = realloc(pfds, (nkids + 2) * sizeof(struct pollfd));
+		if (tmp == NULL)
+			exit(1);
+		pfds = tmp;
+		pfds[0].fd = 0;
+		pfds[0].events = POLLIN;
+		pfds[1].fd = hook_worker_sigpipe[0];
+		pfds[1].events = POLLIN;
+		for (i = 0; i < nkids; i++) {
+			pfds[i + 2].fd = kids[i].hc_fd;
+			pfds[i + 2].events = 0;		/* hangup only */
+		}
+		for (i = 0; i < nkids + 2; i++)
+			pfds[i].revents = 0;
+		if (poll(pfds, nkids + 2, -1) == -1) {
+			if (errno == EINTR)
+				continue;
+			exit(1);
+		}
+
+		/* pbs_mom gave up on the hook: kill it, reaped below */
+		for (i = 0; i < nkids; i++) {
+			if ((pfds[i + 2].revents & (POLLHUP | POLLERR)) &&
+				(kids[i].hc_fd != -1)) {
+				(void)kill(-kids[i].hc_pid, SIGKILL);
+				(void)kill(kids[i].hc_pid, SIGKILL);
+				close(kids[i].hc_fd);
+				kids[i].hc_fd = -1;
+			}
+		}
+
+		if (pfds[1].revents & POLLIN) {
+			while (read(hook_worker_sigpipe[0], &c, 1) == 1)
+				;
+			while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+				for (i = 0; i < nkids; i++) {
+					if (kids[i].hc_pid == pid)
+						break;
+				}
+				if (i == nkids)
+					continue;
+				if (kids[i].hc_fd != -1) {
+					(void)write(kids[i].hc_fd, &status,
+						sizeof(status));
+					close(kids[i].hc_fd);
+				}
+				kids[i] = kids[--nkids];
+			}
+		}
+
+		if ((pfds[0].revents & (POLLIN | POLLHUP | POLLERR)) == 0)
+			continue;
+		fd = hook_worker_recv(0);
+		if (fd == -2)
+			exit(0);	/* pbs_mom is done with us */
+		if (fd == -1)
+			continue;
+		if ((strs = hook_worker_read(fd, &nstr)) == NULL) {
+			close(fd);
+			continue;
+		}
+		/* last argument of a hook request is the hook script */
+		py_script = hook_worker_compile(strs[nstr - 1]);
+
+		pid = fork();
+		if (pid == 0) {
+			/* hook process: set up and run the --hook path */
+			close(0);
+			close(hook_worker_sigpipe[0]);
+			close(hook_worker_sigpipe[1]);
+			for (i = 0; i < nkids; i++) {
+				if (kids[i].hc_fd != -1)
+					close(kids[i].hc_fd);
+			}
+			close(fd);
+			free(kids);
+			free(pfds);
+			(void)sigaction(SIGCHLD, &hook_worker_oldchld, NULL);
+			(void)sigaction(SIGPIPE, &hook_worker_oldpipe, NULL);
+			PyOS_AfterFork();
+			(void)setsid();
+			if (chdir(strs[0]) == -1)
+				exit(2);
+			if (strs[1][0] != '\0')
+				(void)setenv(PBS_HOOK_CONFIG_FILE, strs[1], 1);
+			else
+				(void)unsetenv(PBS_HOOK_CONFIG_FILE);
+			log_close(0);
+			optind = 1;
+			hook_worker_script = py_script;
+			*pargc = nstr - 2;
+			*pargv = &strs[2];
+			return;
+		}
+		if (pid == -1) {
+			close(fd);
+		} else {
+			struct hook_worker_child *ktmp;
+
+			ktmp = realloc(kids, (nkids + 1) *
+				sizeof(struct hook_worker_child));
+			if (ktmp == NULL) {
+				(void)kill(-pid, SIGKILL);
+				close(fd);
+			} else {
+				kids = ktmp;
+				kids[nkids].hc_pid = pid;
+				kids[nkids].hc_fd = fd;
+				nkids++;
+				(void)write(fd, &pid, sizeof(pid));
+			}
+		}
+		free(strs[0]);	/* the request buffer */
+		free(strs);
+	}
+}
+#endif	/* WIN32 */
+
 /**
  *
  * @brief
@@ -2269,7 +2656,8 @@ main(int argc, char *argv[], char *envp[])
 		svr_resc_def[i].rs_next = &svr_resc_def[i+1];
 	/* last entry is left with null pointer */
 
-	if ((argv[1] == NULL) || (strcmp(argv[1], HOOK_MODE) != 0)) {
+	if ((argv[1] == NULL) || ((strcmp(argv[1], HOOK_MODE) != 0) &&
+		(strcmp(argv[1], HOOK_WORKER_MODE) != 0))) {
 #ifdef WIN32
 		/* If this is 64-bit Windows, use 64-bit Python */
 		if (TRUE == is_64bit_Windows()) {
@@ -2493,6 +2881,14 @@ main(int argc, char *argv[], char *envp[])
 		int	print_env = 0;
 		char	*tmp_str = NULL;
 
+#ifndef WIN32
+		if (strcmp(argv[1], HOOK_WORKER_MODE) == 0) {
+			/* returns in a forked hook process, argv set to */
+			/* the "--hook" request it is to run              */
+			hook_worker(&argc, &argv);
+		}
+#endif
+
 		the_input[0] = '\0';
 		the_output[0] = '\0';
 		the_server_output[0] = '\0';
@@ -2796,22 +3192,26 @@ main(int argc, char *argv[], char *envp[])
 			snprintf(logname, sizeof(logname), "%s", full_logname);
 		}
 
-		/* set python interp data */
-		svr_interp_data.data_initialized = 0;
-		svr_interp_data.init_interpreter_data =
-			pbs_python_svr_initialize_interpreter_data;
-		svr_interp_data.destroy_interpreter_data =
-			pbs_python_svr_destroy_interpreter_data;
+		/* set python interp data, unless a hook worker already did */
+		if (!svr_interp_data.interp_started) {
+			svr_interp_data.data_initialized = 0;
+			svr_interp_data.init_interpreter_data =
+				pbs_python_svr_initialize_interpreter_data;
+			svr_interp_data.destroy_interpreter_data =
+				pbs_python_svr_destroy_interpreter_data;
 
-		svr_interp_data.daemon_name = strdup("pbs_python");
+			svr_interp_data.daemon_name = strdup("pbs_python");
 
-		if (svr_interp_data.daemon_name == NULL) { /* should not happen */
-			fprintf(stderr, "strdup failed");
-			exit(1);
+			if (svr_interp_data.daemon_name == NULL) { /* should not happen */
+				fprintf(stderr, "strdup failed");
+				exit(1);
+			}
 		}
 
-		(void)pbs_python_ext_alloc_python_script(hook_script,
-			(struct python_script **) &py_script);
+		py_script = hook_worker_script;
+		if (py_script == NULL)
+			(void)pbs_python_ext_alloc_python_script(hook_script,
+				(struct python_script **) &py_script);
 
 		pbs_python_ext_start_interpreter(&svr_interp_data);
 		hook_input_param_init(&req_params);
@@ -0,0 +1,344 @@
+/*
+ * Copyright (C) 1994-2018 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * PBS Pro is free software. You can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * For a copy of the commercial license terms and conditions,
+ * go to: (http://www.pbspro.com/UserArea/agreement.html)
+ * or contact the Altair Legal Department.
+ *
+ * Altair’s dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of PBS Pro and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair’s trademarks, including but not limited to "PBS™",
+ * "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+ * trademark licensing policies.
+ *
+ */
+/**
+ * @file pbs_tracereport.c
+ *
+ * @brief
+ *		pbs_tracereport.c - join the request tracing files of pbs_server,
+ *		pbs_sched and pbs_mom into per job latency breakdowns
+ *
+ * Functions included are:
+ * 	main()
+ * 	read_trace()
+ * 	resolve_jobs()
+ * 	report_job()
+ *
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include "cmds.h"
+#include "pbs_version.h"
+#include "pbs_ifl.h"
+#include "pbs_trace.h"
+
+#define LINE_SIZE	1024
+#define NO_TIME		(-1.0)
+
+/* one line of a trace file */
+struct span {
+	double	 sp_time;
+	char	*sp_daemon;
+	char	*sp_trace;
+	char	*sp_job;	/* job id, filled in from the trace id if missing */
+	char	*sp_stage;
+	long	 sp_seq;	/* order read, keeps sorting stable */
+};
+
+static struct span *spans = NULL;
+static long	    nspans = 0;
+static long	    spanslots = 0;
+
+/**
+ * @brief
+ * 		Read the spans of one trace file.
+ *
+ * @param[in]	name - trace file
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	1	error
+ */
+static int
+read_trace(char *name)
+{
+	FILE	*fp;
+	char	 line[LINE_SIZE];
+	char	 daemon[LINE_SIZE];
+	char	 trace[LINE_SIZE];
+	char	 job[LINE_SIZE];
+	char	 stage[LINE_SIZE];
+	double	 when;
+	struct span *sp;
+
+	if ((fp = fopen(name, "r")) == NULL) {
+		perror(name);
+		return 1;
+	}
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		if (sscanf(line, "%lf %s %s %s %s", &when, daemon, trace, job, stage) != 5)
+			continue;
+		if (nspans == spanslots) {
+			spanslots = spanslots ? spanslots * 2 : 1024;
+			sp = realloc(spans, spanslots * sizeof(struct span));
+			if (sp == NULL) {
+				fprintf(stderr, "out of memory\n");
+				fclose(fp);
+				return 1;
+			}
+			spans = sp;
+		}
+		sp = &spans[nspans];
+		sp->sp_time = when;
+		sp->sp_daemon = strdup(daemon);
+		sp->sp_trace = strdup(trace);
+		sp->sp_job = strdup(job);
+		sp->sp_stage = strdup(stage);
+		sp->sp_seq = nspans;
+		if (!sp->sp_daemon || !sp->sp_trace || !sp->sp_job || !sp->sp_stage) {
+			fprintf(stderr, "out of memory\n");
+			fclose(fp);
+			return 1;
+		}
+		nspans++;
+	}
+	fclose(fp);
+	return 0;
+}
+
+static int
+cmp_trace(const void *a, const void *b)
+{
+	const struct span *x = *(struct span * const *)a;
+	const struct span *y = *(struct span * const *)b;
+
+	return strcmp(x->sp_trace, y->sp_trace);
+}
+
+static int
+cmp_job_time(const void *a, const void *b)
+{
+	const struct span *x = a;
+	const struct span *y = b;
+	int	rc;
+
+	if ((rc = strcmp(x->sp_job, y->sp_job)) != 0)
+		return rc;
+	if (x->sp_time != y->sp_time)
+		return ((x->sp_time < y->sp_time) ? -1 : 1);
+	return ((x->sp_seq < y->sp_seq) ? -1 : 1);
+}
+
+/**
+ * @brief
+ * 		Give the spans recorded before the job had an id, such as the
+ *		receipt of the submission and the queuejob hook, the job id
+ *		that another span of the same trace id carries.
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	1	out of memory
+ */
+static int
+resolve_jobs(void)
+{
+	struct span **known;
+	struct span   key;
+	struct span  *pkey = &key;
+	struct span **found;
+	long	nknown = 0;
+	long	i;
+
+	if ((known = malloc((nspans + 1) * sizeof(struct span *))) == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	for (i = 0; i < nspans; i++) {
+		if (strcmp(spans[i].sp_trace, PBS_TRACE_NONE) &&
+			strcmp(spans[i].sp_job, PBS_TRACE_NONE))
+			known[nknown++] = &spans[i];
+	}
+	qsort(known, nknown, sizeof(struct span *), cmp_trace);
+
+	for (i = 0; i < nspans; i++) {
+		if (strcmp(spans[i].sp_job, PBS_TRACE_NONE) ||
+			!strcmp(spans[i].sp_trace, PBS_TRACE_NONE))
+			continue;
+		key.sp_trace = spans[i].sp_trace;
+		found = bsearch(&pkey, known, nknown, sizeof(struct span *), cmp_trace);
+		if (found != NULL) {
+			free(spans[i].sp_job);
+			spans[i].sp_job = strdup((*found)->sp_job);
+			if (spans[i].sp_job == NULL) {
+				fprintf(stderr, "out of memory\n");
+				free(known);
+				return 1;
+			}
+		}
+	}
+	free(known);
+	return 0;
+}
+
+/**
+ * @brief
+ * 		Find the time of the first span of a stage recorded by a daemon.
+ *
+ * @param[in]	sp - spans of one job, in time order
+ * @param[in]	n - number of spans
+ * @param[in]	daemon - daemon that records the stage
+ * @param[in]	stage - stage name
+ *
+ * @return	double
+ * @retval	time of the span
+ * @retval	NO_TIME	not found
+ */
+static double
+stage_time(struct span *sp, long n, char *daemon, char *stage)
+{
+	long	i;
+
+	for (i = 0; i < n; i++) {
+		if (!strcmp(sp[i].sp_daemon, daemon) && !strcmp(sp[i].sp_stage, stage))
+			return sp[i].sp_time;
+	}
+	return NO_TIME;
+}
+
+/**
+ * @brief
+ * 		Print the difference of two stage times, or "--" if one is missing.
+ */
+static void
+print_delta(double from, double to)
+{
+	if ((from == NO_TIME) || (to == NO_TIME))
+		printf(" %12s", "--");
+	else
+		printf(" %12.6f", to - from);
+}
+
+/**
+ * @brief
+ * 		Print the latency breakdown of one job and, if asked for, the
+ *		spans it is made of.
+ *
+ * @param[in]	sp - spans of the job, in time order
+ * @param[in]	n - number of spans
+ * @param[in]	verbose - also list the spans
+ */
+static void
+report_job(struct span *sp, long n, int verbose)
+{
+	double	first;
+	double	queued;
+	double	decided;
+	double	run;
+	double	exec;
+	long	i;
+
+	first = sp[0].sp_time;
+	queued = stage_time(sp, n, "server", "queued");
+	decided = stage_time(sp, n, "sched", "run");
+	run = stage_time(sp, n, "server", "runjob");
+	exec = stage_time(sp, n, "mom", "exec");
+
+	printf("%-24s", sp[0].sp_job);
+	print_delta(first, queued);
+	print_delta(queued, (decided != NO_TIME) ? decided : run);
+	print_delta(run, exec);
+	print_delta(first, exec);
+	printf("\n");
+
+	if (!verbose)
+		return;
+	for (i = 0; i < n; i++)
+		printf("    %+12.6f %-8s %-18s %s\n", sp[i].sp_time - first,
+			sp[i].sp_daemon, sp[i].sp_stage, sp[i].sp_trace);
+}
+
+int
+main(int argc, char *argv[])
+{
+	char	*jobid = NULL;
+	int	 verbose = 0;
+	int	 errflg = 0;
+	int	 c;
+	int	 i;
+	long	 start;
+	long	 end;
+
+	/*the real deal or output pbs_version and exit?*/
+	execution_mode(argc, argv);
+
+	while ((c = getopt(argc, argv, "j:v")) != EOF) {
+		switch (c) {
+			case 'j':
+				jobid = optarg;
+				break;
+			case 'v':
+				verbose = 1;
+				break;
+			default:
+				errflg = 1;
+				break;
+		}
+	}
+	if (errflg || (optind == argc)) {
+		fprintf(stderr, "usage: %s [-v] [-j job_id] trace_file ...\n", argv[0]);
+		fprintf(stderr, "       %s --version\n", argv[0]);
+		return 1;
+	}
+
+	for (i = optind; i < argc; i++) {
+		if (read_trace(argv[i]) != 0)
+			return 1;
+	}
+	if (resolve_jobs() != 0)
+		return 1;
+	qsort(spans, nspans, sizeof(struct span), cmp_job_time);
+
+	printf("%-24s %12s %12s %12s %12s\n", "Job ID", "submit-queue",
+		"queue-run", "run-exec", "total");
+	for (start = 0; start < nspans; start = end) {
+		for (end = start + 1; end < nspans; end++) {
+			if (strcmp(spans[end].sp_job, spans[start].sp_job))
+				break;
+		}
+		if (!strcmp(spans[start].sp_job, PBS_TRACE_NONE))
+			continue;
+		if ((jobid != NULL) && strcmp(jobid, spans[start].sp_job))
+			continue;
+		report_job(&spans[start], end - start, verbose);
+	}
+	return 0;
+}
@@ -45,6 +45,8 @@
  * 	get_cols()
  * 	main()
  * 	parse_log()
+ * 	parse_log_range()
+ * 	parse_log_index()
  * 	sort_by_date()
  * 	sort_by_message()
  * 	strip_path()
@@ -126,8 +128,10 @@ main(int argc, char *argv[])
 {
 	/* Array for the log entries for the specified job */
 	FILE *fp;
+	FILE *idx;
 	int i, j;
 	char *filename;		/* full path of logfile to read */
+	char idxname[256 + sizeof(LOG_INDEX_SUFFIX)];	/* its index */
 	struct tm *tm_ptr;
 	int    month, day, year;
 	time_t t, t_save;
@@ -319,7 +323,17 @@ main(int argc, char *argv[])
 					continue;
 				}
 
-				parse_log(fp, argv[opt], j);
+				/* seek through the index when the daemon keeps one */
+				snprintf(idxname, sizeof(idxname), "%s%s", filename, LOG_INDEX_SUFFIX);
+				idx = fopen(idxname, "r");
+				if ((idx == NULL) || (parse_log_index(fp, idx, argv[opt], j) != 0)) {
+					if (idx != NULL && verbose)
+						fprintf(stderr, "%s: does not match the log, scanning\n", idxname);
+					rewind(fp);
+					parse_log(fp, argv[opt], j);
+				}
+				if (idx != NULL)
+					fclose(idx);
 
 				fclose(fp);
 			}
@@ -371,6 +385,229 @@ main(int argc, char *argv[])
 	return 0;
 }
 
+/**
+ * @brief
+ *		job_name_match - whether the object name of a log line is the job
+ *			being traced.  A job id given without a server name
+ *			matches on the sequence number part only.
+ *
+ * @param[in]	job	-	the name of the job
+ * @param[in]	name	-	object name from the log line, may be NULL
+ *
+ * @return	int
+ * @retval	1	: match
+ * @retval	0	: no match
+ */
+static int
+job_name_match(char *job, char *name)
+{
+	int slen;
+	int tlen;
+
+	if (name == NULL)
+		return 0;
+	if (strchr(job, (int)'.') == NULL) {
+		tlen = strlen(job);
+		slen = strcspn(name, ".");
+		if (tlen > slen)
+			slen = tlen;
+	} else
+		slen = strlen(job);
+
+	return (strncmp(job, name, slen) == 0);
+}
+
+/**
+ * @brief
+ *		read_log_line - read one line of a log file, growing the buffer
+ *			as needed, and strip the newline
+ *
+ * @param[in]	fp	-	the log file
+ * @param[in,out]	buf	-	line buffer
+ * @param[in,out]	buf_size	-	size of the line buffer
+ *
+ * @return	int
+ * @retval	1	: a line was read
+ * @retval	0	: end of file or out of memory
+ */
+static int
+read_log_line(FILE *fp, char **buf, int *buf_size)
+{
+	char *tbuf;		/* temporarily hold realloc's for main buffer */
+	int len;
+
+	if (fgets(*buf, *buf_size, fp) == NULL)
+		return 0;
+	while (*buf_size == (strlen(*buf) + 1)) {
+		*buf_size *= 2;
+		tbuf = (char*)realloc(*buf, (*buf_size + 1) * sizeof(char));
+		if (!tbuf)
+			return 0;
+		*buf = tbuf;
+		if (fgets(*buf + strlen(*buf), *buf_size/2 + 1, fp) == NULL)
+			return 0;
+	}
+	len = strlen(*buf);
+	if ((len > 0) && ((*buf)[len - 1] == '\n'))
+		(*buf)[len - 1] = '\0';
+	return 1;
+}
+
+/**
+ * @brief
+ *		parse_log_line - add a log line to log_lines if it is for the job
+ *
+ * @param[in]	buf	-	the log line, modified
+ * @param[in]	job	-	the name of the job
+ * @param[in]	ind	-	which log file - index in enum index
+ * @param[in]	lineno	-	position of the line, to stabilize the sort
+ *
+ * @return	int
+ * @retval	1	: the line is for the job and was added
+ * @retval	0	: the line is for some other object
+ *
+ * @par MT-safe: No
+ */
+static int
+parse_log_line(char *buf, char *job, int ind, int lineno)
+{
+	struct log_entry tmp;	/* temporary log entry */
+	char *p;		/* pointer to use for strtok */
+	int field_count;	/* which field in log entry */
+	struct tm tms;		/* used to convert date to unix date */
+
+	tms.tm_isdst = -1;	/* mktime() will attempt to figure it out */
+
+	p = strtok(buf, ";");
+	field_count = 0;
+	memset(&tmp, 0, sizeof(struct log_entry));
+
+	for (field_count = 0; field_count < 6 && p != NULL; field_count++) {
+		switch (field_count) {
+			case FLD_DATE:
+				tmp.date = p;
+				if (ind == IND_ACCT)
+					field_count = 2;
+				break;
+
+			case FLD_EVENT:
+				tmp.event = p;
+				break;
+
+			case FLD_OBJ:
+				tmp.obj = p;
+				break;
+
+			case FLD_TYPE:
+				tmp.type = p;
+				break;
+
+			case FLD_NAME:
+				tmp.name = p;
+				break;
+
+			case FLD_MSG:
+				tmp.msg = p;
+				break;
+
+			default:
+				printf("Field count too big!\n");
+				printf("%s\n", p);
+		}
+
+		p = strtok(NULL, ";");
+	}
+
+	if (job_name_match(job, tmp.name)) {
+		if (ll_cur_amm >= ll_max_amm)
+			alloc_more_space();
+
+		free_log_entry(&log_lines[ll_cur_amm]);
+
+		if (tmp.date != NULL) {
+			/*
+			 * We need to parse the time string.
+			 * The string will either have high res logging or not.
+			 * The high res logging is after the dot after the seconds field.
+			 */
+			log_lines[ll_cur_amm].date = strdup(tmp.date);
+			if ((ind != IND_ACCT) && (strchr(tmp.date, '.'))) {
+				/* Parse time string looking for high res logging.  If we don't parse 7 fields, we have a invalid log time. */
+				if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d.%ld", &tms.tm_mon, 
+				    &tms.tm_mday, &tms.tm_year, &tms.tm_hour, &tms.tm_min, 
+				    &tms.tm_sec, &(log_lines[ll_cur_amm].highres)) != 7) {
+					log_lines[ll_cur_amm].date_time = -1;	/* error in date field */
+					log_lines[ll_cur_amm].highres = NO_HIGH_RES_TIMESTAMP;
+				} else { /* We found all 7 fields, correctly formed time string */
+					has_high_res_timestamp = 1;
+					if (tms.tm_year > 1900)
+						tms.tm_year -= 1900;
+					/* The number of months since January, 
+ 						 * in the range 0 to 11 for mktime()
+ 						 */
+					tms.tm_mon--;
+					log_lines[ll_cur_amm].date_time = mktime(&tms);
+				}
+			} else { /* Normal time string */
+				if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d", &tms.tm_mon, &tms.tm_mday, 
+				    &tms.tm_year, &tms.tm_hour, &tms.tm_min, &tms.tm_sec) != 6) {
+					log_lines[ll_cur_amm].date_time = -1;	/* error in date field */
+				} else { /* We found all 6 fields, correctly formed time string */
+					if (tms.tm_year > 1900)
+						tms.tm_year -= 1900;
+					tms.tm_mon--;         /* The number of months since January, in the range 0 to 11 for mktime */
+					log_lines[ll_cur_amm].date_time = mktime(&tms);
+				}
+				log_lines[ll_cur_amm].highres = NO_HIGH_RES_TIMESTAMP;
+
+			}
+		}
+		if (tmp.event != NULL)
+			log_lines[ll_cur_amm].event = strdup(tmp.event);
+		else
+			log_lines[ll_cur_amm].event = none;
+		if (tmp.obj != NULL)
+			log_lines[ll_cur_amm].obj = strdup(tmp.obj);
+		else
+			log_lines[ll_cur_amm].obj = none;
+		if (tmp.type != NULL)
+			log_lines[ll_cur_amm].type = strdup(tmp.type);
+		else
+			log_lines[ll_cur_amm].type = none;
+		if (tmp.name != NULL)
+			log_lines[ll_cur_amm].name = strdup(tmp.name);
+		else
+			log_lines[ll_cur_amm].name = none;
+		if (tmp.msg != NULL)
+			log_lines[ll_cur_amm].msg = strdup(tmp.msg);
+		else
+			log_lines[ll_cur_amm].msg = none;
+		switch (ind) {
+			case IND_SERVER:
+				log_lines[ll_cur_amm].log_file = 'S';
+				break;
+
+			case IND_SCHED:
+				log_lines[ll_cur_amm].log_file = 'L';
+				break;
+
+			case IND_ACCT:
+				log_lines[ll_cur_amm].log_file = 'A';
+				break;
+
+			case IND_MOM:
+				log_lines[ll_cur_amm].log_file = 'M';
+				break;
+			default:
+				log_lines[ll_cur_amm].log_file = 'U';	/* undefined */
+		}
+		log_lines[ll_cur_amm].lineno = lineno;
+		ll_cur_amm++;
+		return 1;
+	}
+	return 0;
+}
+
 /**
  * @brief
  *		parse_log - parse out entires of a log file for a specific job
@@ -389,185 +626,142 @@ main(int argc, char *argv[])
 void
 parse_log(FILE *fp, char *job, int ind)
 {
-	struct log_entry tmp;	/* temporary log entry */
 	char *buf;		/* buffer to read in from file */
-	char *tbuf;		/* temporarily hold realloc's for main buffer */
-	char job_buf[128];	/* hold the jobid and the . */
-	char *p;		/* pointer to use for strtok */
-	int field_count;	/* which field in log entry */
-	int j = 0;
-	struct tm tms;		/* used to convert date to unix date */
 	int lineno = 0;
-	int slen;
-	char *pdot;
 	int buf_size = 16384;	/* initial buffer size */
-	int break_fl = 0;
 
 	buf = (char*)calloc(buf_size, sizeof(char));
 	if (!buf)
 		return;
 
-	tms.tm_isdst = -1;	/* mktime() will attempt to figure it out */
+	while (read_log_line(fp, &buf, &buf_size))
+		(void)parse_log_line(buf, job, ind, ++lineno);
 
-	strcpy(job_buf, job);
+	free(buf);
+}
 
-	while (fgets(buf, buf_size, fp) != NULL) {
-		while (buf_size == (strlen(buf) + 1)) {
-			buf_size *= 2;
-			tbuf = (char*)realloc(buf, (buf_size + 1) * sizeof(char));
-			if (!tbuf) {
-				break_fl = 1;
-				break;
-			}
-			buf = tbuf;
-			if(fgets(buf + strlen(buf), buf_size/2 + 1, fp) == NULL) {
-				break_fl = 1;
-				break;
-			}
-		}
-		if (break_fl)
-			break;
-		lineno++;
-		j++;
-		buf[strlen(buf)-1] = '\0';
-		p = strtok(buf, ";");
-		field_count = 0;
-		memset(&tmp, 0, sizeof(struct log_entry));
-
-		for (field_count = 0; field_count < 6 && p != NULL; field_count++) {
-			switch (field_count) {
-				case FLD_DATE:
-					tmp.date = p;
-					if (ind == IND_ACCT)
-						field_count = 2;
-					break;
-
-				case FLD_EVENT:
-					tmp.event = p;
-					break;
-
-				case FLD_OBJ:
-					tmp.obj = p;
-					break;
-
-				case FLD_TYPE:
-					tmp.type = p;
-					break;
-
-				case FLD_NAME:
-					tmp.name = p;
-					break;
-
-				case FLD_MSG:
-					tmp.msg = p;
-					break;
-
-				default:
-					printf("Field count too big!\n");
-					printf("%s\n", p);
-			}
+/**
+ * @brief
+ *		parse_log_range - parse_log() for the lines of a log file that start
+ *		    at or after an offset and before another
+ *
+ * @param[in]	fp	-	the log file
+ * @param[in]	from	-	offset of the first line
+ * @param[in]	skip	-	skip the line at from, it was read through the index
+ * @param[in]	to	-	offset to stop at, -1 for the end of the file
+ * @param[in,out]	buf	-	line buffer
+ * @param[in,out]	buf_size	-	size of buf
+ * @param[in]	job	-	the name of the job
+ * @param[in]	ind	-	which log file - index in enum index
+ * @param[in,out]	lineno	-	number of the last line parsed
+ *
+ * @return	void
+ *
+ * @par MT-safe: No
+ */
+static void
+parse_log_range(FILE *fp, long from, int skip, long to, char **buf, int *buf_size,
+	char *job, int ind, int *lineno)
+{
+	if (fseek(fp, from, SEEK_SET) != 0)
+		return;
+	if (skip && !read_log_line(fp, buf, buf_size))
+		return;
+	while (((to < 0) || (ftell(fp) < to)) && read_log_line(fp, buf, buf_size))
+		(void)parse_log_line(*buf, job, ind, ++(*lineno));
+}
 
-			p = strtok(NULL, ";");
-		}
+/**
+ * @brief
+ *		parse_log_index - like parse_log(), but read only the lines that
+ *		    the log's index (see LOG_INDEX_SUFFIX) lists for the job,
+ *		    plus the parts of the log the index does not cover: what was
+ *		    written before each LOG_INDEX_START header of the index and
+ *		    after the last line indexed ahead of it, and what was written
+ *		    after the last indexed line.
+ *
+ * @param[in]	fp	-	the log file
+ * @param[in]	idx	-	its index file
+ * @param[in]	job	-	the name of the job
+ * @param[in]	ind	-	which log file - index in enum index
+ *
+ * @return	int
+ * @retval	0	: done
+ * @retval	-1	: the index does not match the log, nothing was added;
+ *			  the caller should use parse_log()
+ *
+ * @par MT-safe: No
+ */
+int
+parse_log_index(FILE *fp, FILE *idx, char *job, int ind)
+{
+	char *buf;		/* buffer to read in from file */
+	char ibuf[512];		/* one index entry */
+	char *name;
+	char *nl;
+	long offset;
+	long size;
+	long gapfrom = 0;	/* where the part not covered by the index starts */
+	int gapskip = 0;	/* the line at gapfrom was read through the index */
+	int started = 0;	/* a LOG_INDEX_START header was seen */
+	int lineno = 0;
+	int buf_size = 16384;	/* initial buffer size */
+	int saved_amm = ll_cur_amm;
 
-		pdot = strchr(job_buf, (int)'.');
-		if (pdot == NULL && tmp.name != NULL) {
-			int	tlen = strlen(job_buf);
-
-			slen = strcspn(tmp.name, ".");
-			if (tlen > slen)
-				slen = tlen;
-		} else
-			slen = strlen(job_buf);
-
-		if (tmp.name != NULL && strncmp(job_buf, tmp.name, slen) == 0) {
-			if (ll_cur_amm >= ll_max_amm)
-				alloc_more_space();
-
-			free_log_entry(&log_lines[ll_cur_amm]);
-
-			if (tmp.date != NULL) {
-				/*
-				 * We need to parse the time string.
-				 * The string will either have high res logging or not.
-				 * The high res logging is after the dot after the seconds field.
-				 */
-				log_lines[ll_cur_amm].date = strdup(tmp.date);
-				if ((ind != IND_ACCT) && (strchr(tmp.date, '.'))) {
-					/* Parse time string looking for high res logging.  If we don't parse 7 fields, we have a invalid log time. */
-					if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d.%ld", &tms.tm_mon, 
-					    &tms.tm_mday, &tms.tm_year, &tms.tm_hour, &tms.tm_min, 
-					    &tms.tm_sec, &(log_lines[ll_cur_amm].highres)) != 7) {
-						log_lines[ll_cur_amm].date_time = -1;	/* error in date field */
-						log_lines[ll_cur_amm].highres = NO_HIGH_RES_TIMESTAMP;
-					} else { /* We found all 7 fields, correctly formed time string */
-						has_high_res_timestamp = 1;
-						if (tms.tm_year > 1900)
-							tms.tm_year -= 1900;
-						/* The number of months since January, 
- 						 * in the range 0 to 11 for mktime()
- 						 */
-						tms.tm_mon--;
-						log_lines[ll_cur_amm].date_time = mktime(&tms);
-					}
-				} else { /* Normal time string */
-					if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d", &tms.tm_mon, &tms.tm_mday, 
-					    &tms.tm_year, &tms.tm_hour, &tms.tm_min, &tms.tm_sec) != 6) {
-						log_lines[ll_cur_amm].date_time = -1;	/* error in date field */
-					} else { /* We found all 6 fields, correctly formed time string */
-						if (tms.tm_year > 1900)
-							tms.tm_year -= 1900;
-						tms.tm_mon--;         /* The number of months since January, in the range 0 to 11 for mktime */
-						log_lines[ll_cur_amm].date_time = mktime(&tms);
-					}
-					log_lines[ll_cur_amm].highres = NO_HIGH_RES_TIMESTAMP;
+	if ((fseek(fp, 0L, SEEK_END) != 0) || ((size = ftell(fp)) < 0))
+		return -1;
 
-				}
-			}
-			if (tmp.event != NULL)
-				log_lines[ll_cur_amm].event = strdup(tmp.event);
-			else
-				log_lines[ll_cur_amm].event = none;
-			if (tmp.obj != NULL)
-				log_lines[ll_cur_amm].obj = strdup(tmp.obj);
-			else
-				log_lines[ll_cur_amm].obj = none;
-			if (tmp.type != NULL)
-				log_lines[ll_cur_amm].type = strdup(tmp.type);
-			else
-				log_lines[ll_cur_amm].type = none;
-			if (tmp.name != NULL)
-				log_lines[ll_cur_amm].name = strdup(tmp.name);
-			else
-				log_lines[ll_cur_amm].name = none;
-			if (tmp.msg != NULL)
-				log_lines[ll_cur_amm].msg = strdup(tmp.msg);
-			else
-				log_lines[ll_cur_amm].msg = none;
-			switch (ind) {
-				case IND_SERVER:
-					log_lines[ll_cur_amm].log_file = 'S';
-					break;
-
-				case IND_SCHED:
-					log_lines[ll_cur_amm].log_file = 'L';
-					break;
-
-				case IND_ACCT:
-					log_lines[ll_cur_amm].log_file = 'A';
-					break;
-
-				case IND_MOM:
-					log_lines[ll_cur_amm].log_file = 'M';
-					break;
-				default:
-					log_lines[ll_cur_amm].log_file = 'U';	/* undefined */
-			}
-			log_lines[ll_cur_amm].lineno = lineno;
-			ll_cur_amm++;
+	buf = (char*)calloc(buf_size, sizeof(char));
+	if (!buf)
+		return -1;
+
+	while (fgets(ibuf, sizeof(ibuf), idx) != NULL) {
+		if ((nl = strchr(ibuf, '\n')) == NULL)
+			continue;	/* partly written entry */
+		*nl = '\0';
+		if (strncmp(ibuf, LOG_INDEX_START " ", sizeof(LOG_INDEX_START)) == 0) {
+			offset = strtol(ibuf + sizeof(LOG_INDEX_START), &name, 10);
+			if ((*name != '\0') || (offset < gapfrom) || (offset > size))
+				goto stale;
+			/* lines written while the log was not indexed */
+			parse_log_range(fp, gapfrom, gapskip, offset, &buf, &buf_size,
+				job, ind, &lineno);
+			gapfrom = offset;
+			gapskip = 0;
+			started = 1;
+			continue;
+		}
+		offset = strtol(ibuf, &name, 10);
+		if ((*name != ' ') || (offset < 0))
+			continue;
+		if (!started || (offset >= size))
+			goto stale;
+		name++;
+		if (offset >= gapfrom) {
+			gapfrom = offset;
+			gapskip = 1;
 		}
+		if (!job_name_match(job, name))
+			continue;
+		if ((fseek(fp, offset, SEEK_SET) != 0) ||
+			!read_log_line(fp, &buf, &buf_size) ||
+			!parse_log_line(buf, job, ind, ++lineno))
+			goto stale;	/* e.g. the log was rewritten */
 	}
+	if (!started)
+		goto stale;
+
+	/* lines logged after the last one in the index */
+	parse_log_range(fp, gapfrom, gapskip, -1, &buf, &buf_size, job, ind, &lineno);
+
+	free(buf);
+	return 0;
+
+stale:
+	while (ll_cur_amm > saved_amm)
+		free_log_entry(&log_lines[--ll_cur_amm]);
 	free(buf);
+	return -1;
 }
 
 /**
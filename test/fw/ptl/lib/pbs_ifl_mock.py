@@ -258,6 +258,7 @@ ATTR_dfltqsubargs = 'default_qsub_arguments'
 ATTR_rpp_retry = 'rpp_retry'
 ATTR_rpp_highwater = 'rpp_highwater'
 ATTR_rpp_max_pkt_check = 'rpp_max_pkt_check'
+ATTR_sync_mom_hookfiles_batch = 'sync_mom_hookfiles_batch'
 ATTR_license_location = 'pbs_license_file_location'
 ATTR_pbs_license_info = 'pbs_license_info'
 ATTR_license_min = 'pbs_license_min'
@@ -399,6 +400,10 @@ def pbs_deljob(c, jobid, extend):
     pass
 
 
+def pbs_deljoblist(c, jobids, count, extend, results):
+    pass
+
+
 def pbs_disconnect(c):
     pass
 
@@ -411,6 +416,10 @@ def pbs_holdjob(c, jobid, hold, extend):
     pass
 
 
+def pbs_holdjoblist(c, jobids, count, hold, extend, results):
+    pass
+
+
 def pbs_locjob(c, jobid, extend):
     pass
 
@@ -439,6 +448,10 @@ def pbs_rlsjob(c, jobid, hold, extend):
     pass
 
 
+def pbs_rlsjoblist(c, jobids, count, hold, extend, results):
+    pass
+
+
 def pbs_runjob(c, jobid, loc, extend):
     pass
 
@@ -451,6 +464,14 @@ def pbs_sigjob(c, jobid, sig, extend):
     pass
 
 
+def pbs_sigjoblist(c, jobids, count, sig, extend, results):
+    pass
+
+
+def pbs_jobresultfree(results):
+    pass
+
+
 def pbs_statfree(batch_status):
     pass
 
@@ -507,6 +528,18 @@ def pbs_submit(c, attropl, script, destin, extend):
     pass
 
 
+def pbs_submit_batch(c, jobs, count, extend, results):
+    pass
+
+
+def pbs_async(server, request, done, arg):
+    pass
+
+
+def pbs_async_wait():
+    pass
+
+
 def pbs_submit_resv(c, attropl, jobid):
     pass
 
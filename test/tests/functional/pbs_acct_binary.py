@@ -0,0 +1,111 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+from tests.functional import *
+import time
+
+
+class TestAcctBinary(TestFunctional):
+    """
+    Test the binary accounting log enabled by PBS_ACCT_FORMAT
+    """
+
+    def set_acct_format(self, fmt):
+        """
+        Set PBS_ACCT_FORMAT in pbs.conf and restart the server
+        """
+        self.du.set_pbs_config(confs={'PBS_ACCT_FORMAT': fmt}, append=True)
+        _msg = 'Failed to restart server: %s' % (self.server.shortname)
+        self.assertTrue(self.server.restart(), _msg)
+
+    def acctbin(self, *args):
+        """
+        Run pbs_acctbin on the server host and return its output lines
+        """
+        cmd = [os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                            'pbs_acctbin')] + list(args)
+        ret = self.server.du.run_cmd(self.server.hostname, cmd, sudo=True)
+        self.assertEqual(ret['rc'], 0, 'pbs_acctbin failed: %s' % ret)
+        return ret['out']
+
+    def test_binary_and_text(self):
+        """
+        With PBS_ACCT_FORMAT=both the binary file holds the same records
+        as the text file, and the per user summary counts the job
+        """
+        self.set_acct_format('both')
+        acct = os.path.join(self.server.pbs_conf['PBS_HOME'], 'server_priv',
+                            'accounting', time.strftime('%Y%m%d'))
+        self.server.log_match('Account file %s.bin opened' % acct,
+                              starttime=self.server.ctime)
+        j = Job(TEST_USER, attrs={'Resource_List.walltime': 10})
+        j.set_sleep_time(1)
+        jid = self.server.submit(j)
+        self.server.accounting_match(';E;%s;' % jid, max_attempts=30)
+
+        lines = self.acctbin('-t', acct + '.bin')
+        for rec in ['Q', 'S', 'E']:
+            text = [l for l in lines if (';%s;%s;' % (rec, jid)) in l]
+            self.assertEqual(len(text), 1, '%s record not found' % rec)
+            self.server.accounting_match(text[0], regexp=False)
+
+        summary = self.acctbin('-u', acct + '.bin')
+        users = [l.split()[0] for l in summary[1:]]
+        self.assertIn(str(TEST_USER), users)
+
+    def test_binary_only(self):
+        """
+        With PBS_ACCT_FORMAT=binary no text record is written
+        """
+        self.set_acct_format('binary')
+        j = Job(TEST_USER, attrs={ATTR_h: None})
+        jid = self.server.submit(j)
+        acct = os.path.join(self.server.pbs_conf['PBS_HOME'], 'server_priv',
+                            'accounting', time.strftime('%Y%m%d'))
+        lines = self.acctbin('-t', acct + '.bin')
+        self.assertTrue([l for l in lines if (';Q;%s;' % jid) in l])
+        ret = self.server.du.run_cmd(self.server.hostname,
+                                     ['grep', ';Q;%s;' % jid, acct],
+                                     sudo=True)
+        self.assertNotEqual(ret['rc'], 0, 'text record written')
+
+    def tearDown(self):
+        confs = self.du.parse_pbs_config()
+        if 'PBS_ACCT_FORMAT' in confs:
+            del confs['PBS_ACCT_FORMAT']
+            self.du.set_pbs_config(confs=confs, append=False)
+            PBSInitServices().restart()
+        TestFunctional.tearDown(self)
@@ -0,0 +1,112 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+from tests.functional import *
+
+
+class TestAsyncLogging(TestFunctional):
+    """
+    Test the asynchronous log writer enabled by PBS_LOG_ASYNC_QUEUE
+    """
+    tm_re = re.compile(
+        r'^\d{2}/\d{2}/\d{4}\s\d{2}:\d{2}:\d{2}(\.\d{6})?;')
+
+    def set_async_conf(self, confs):
+        """
+        Add confs to pbs.conf and restart the server
+        """
+        self.du.set_pbs_config(confs=confs, append=True)
+        _msg = 'Failed to restart server: %s' % (self.server.shortname)
+        self.assertTrue(self.server.restart(), _msg)
+
+    def test_async_logging(self):
+        """
+        With an async log queue every job event still reaches the
+        server log, in order and well formed, and the writer reports
+        its counters when the log is closed
+        """
+        self.set_async_conf({'PBS_LOG_ASYNC_QUEUE': 1024})
+        self.server.log_match('async logging enabled, queue=1024 '
+                              'on_full=block', starttime=self.server.ctime)
+        jids = []
+        for _ in range(20):
+            j = Job(TEST_USER, attrs={ATTR_h: None})
+            jids.append(self.server.submit(j))
+        for jid in jids:
+            self.server.log_match(jid + ';Job Queued at request of',
+                                  starttime=self.server.ctime)
+        lines = self.server.log_lines(logtype=self.server,
+                                      starttime=self.server.ctime, n='ALL')
+        queued = []
+        for line in lines:
+            self.assertTrue(self.tm_re.match(line),
+                            'malformed log line: %s' % line)
+            for jid in jids:
+                if jid + ';Job Queued at request of' in line:
+                    queued.append(jid)
+        self.assertEqual(queued, jids, 'job events logged out of order')
+
+        self.server.restart()
+        self.server.log_match('async log writer stopped, records=',
+                              starttime=self.server.ctime - 60)
+
+    def test_async_logging_drop(self):
+        """
+        The drop policy is reported at startup and the server stays
+        responsive with a tiny queue
+        """
+        self.set_async_conf({'PBS_LOG_ASYNC_QUEUE': 2,
+                             'PBS_LOG_ASYNC_DROP': 1})
+        self.server.log_match('async logging enabled, queue=2 on_full=drop',
+                              starttime=self.server.ctime)
+        a = {'log_events': 2047}
+        self.server.manager(MGR_CMD_SET, SERVER, a)
+        for _ in range(20):
+            j = Job(TEST_USER, attrs={ATTR_h: None})
+            self.server.submit(j)
+        self.server.expect(SERVER, {'total_jobs': 20})
+
+    def tearDown(self):
+        confs = self.du.parse_pbs_config()
+        restart = False
+        for c in ['PBS_LOG_ASYNC_QUEUE', 'PBS_LOG_ASYNC_DROP']:
+            if c in confs:
+                del confs[c]
+                restart = True
+        if restart:
+            self.du.set_pbs_config(confs=confs, append=False)
+            PBSInitServices().restart()
+        TestFunctional.tearDown(self)
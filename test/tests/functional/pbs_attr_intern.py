@@ -0,0 +1,86 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+from tests.functional import *
+
+
+class TestAttrIntern(TestFunctional):
+    """
+    Test the status of attributes and resources whose names the server
+    shares between status replies
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+
+    def test_status_names(self):
+        """
+        Status a job twice, the second time from the cached entries,
+        and check the names and values of its attributes
+        """
+        j = Job(TEST_USER, {'Resource_List.ncpus': 2,
+                            'Resource_List.walltime': '00:10:00',
+                            ATTR_N: 'intern'})
+        jid = self.server.submit(j)
+        for _ in range(2):
+            st = self.server.status(JOB, id=jid)[0]
+            self.assertEqual(st['Job_Name'], 'intern')
+            self.assertEqual(st['Resource_List.ncpus'], '2')
+            self.assertEqual(st['Resource_List.walltime'], '00:10:00')
+            self.assertEqual(st['job_state'], 'Q')
+
+    def test_runtime_resource(self):
+        """
+        Status a resource defined while the server runs, after it has been
+        deleted and defined again with another type
+        """
+        self.server.manager(MGR_CMD_CREATE, RSC, {'type': 'long'},
+                            id='intern_r')
+        j = Job(TEST_USER, {'Resource_List.intern_r': 3})
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'Resource_List.intern_r': 3}, id=jid)
+        self.server.delete(jid, wait=True)
+
+        self.server.manager(MGR_CMD_DELETE, RSC, id='intern_r')
+        self.server.manager(MGR_CMD_CREATE, RSC, {'type': 'string'},
+                            id='intern_r')
+        j = Job(TEST_USER, {'Resource_List.intern_r': 'abc'})
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'Resource_List.intern_r': 'abc'}, id=jid)
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'resources_available.intern_r': 'xyz'})
+        self.server.expect(SERVER, {'resources_available.intern_r': 'xyz'})
@@ -0,0 +1,117 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+import time
+from tests.functional import *
+
+
+class TestBulkRecovery(TestFunctional):
+    """
+    Test bulk job recovery at server startup and its PBS_RECOV_THREADS
+    pbs.conf setting
+    """
+
+    def submit_jobs(self):
+        """
+        Submit a mix of held, queued and array jobs, and return their ids
+        """
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'scheduling': 'False'})
+        jids = []
+        for i in range(5):
+            j = Job(TEST_USER, attrs={ATTR_N: 'recov%d' % i,
+                                      'Resource_List.walltime': 100 + i})
+            jids.append(self.server.submit(j))
+        j = Job(TEST_USER, attrs={ATTR_h: None, ATTR_g: TSTGRP0})
+        jids.append(self.server.submit(j))
+        j = Job(TEST_USER, attrs={ATTR_J: '1-3'})
+        jids.append(self.server.submit(j))
+        return jids
+
+    def stat_jobs(self, jids):
+        """
+        Return the attributes of the jobs that recovery must preserve
+        """
+        keep = ['Job_Name', 'job_state', 'Job_Owner', 'queue', 'ctime',
+                'Hold_Types', 'group_list', 'array_indices_submitted',
+                'Resource_List.walltime', 'Priority', 'Rerunable']
+        ret = {}
+        for jid in jids:
+            st = self.server.status(JOB, id=jid)[0]
+            ret[jid] = dict((k, st.get(k)) for k in keep)
+        return ret
+
+    def restart_with_threads(self, nthreads):
+        self.du.set_pbs_config(confs={'PBS_RECOV_THREADS': nthreads},
+                               append=True)
+        start = int(time.time())
+        self.server.restart()
+        self.assertTrue(self.server.isUp(), 'server did not come back')
+        return start
+
+    def test_bulk_recovery(self):
+        """
+        Jobs come back with the same attributes after a restart with bulk
+        recovery, and the recovery phase timings are logged
+        """
+        jids = self.submit_jobs()
+        before = self.stat_jobs(jids)
+        start = self.restart_with_threads(4)
+        self.server.log_match('recovered %d jobs with' % len(jids),
+                              starttime=start)
+        self.server.log_match('decode .* ms on 4 threads', regexp=True,
+                              starttime=start)
+        self.assertEqual(before, self.stat_jobs(jids))
+
+    def test_serial_recovery(self):
+        """
+        PBS_RECOV_THREADS=0 recovers the jobs one at a time
+        """
+        jids = self.submit_jobs()
+        before = self.stat_jobs(jids)
+        start = self.restart_with_threads(0)
+        self.server.log_match('recovered .* jobs with', regexp=True,
+                              starttime=start, existence=False,
+                              max_attempts=2)
+        self.assertEqual(before, self.stat_jobs(jids))
+
+    def tearDown(self):
+        confs = self.du.parse_pbs_config()
+        if 'PBS_RECOV_THREADS' in confs:
+            del confs['PBS_RECOV_THREADS']
+            self.du.set_pbs_config(confs=confs, append=False)
+            self.server.restart()
+        TestFunctional.tearDown(self)
@@ -0,0 +1,91 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+import time
+from tests.functional import *
+
+
+class TestConnPool(TestFunctional):
+    """
+    Test that with PBS_CONN_POOL set a client reuses its connection to
+    the server instead of connecting again
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+        a = {'queue_type': 'execution', 'enabled': 'True',
+             'started': 'True'}
+        self.server.manager(MGR_CMD_CREATE, QUEUE, a, id='workq2')
+        self.qstat = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                                  'qstat')
+
+    def qstat_queues(self, pool):
+        """
+        Status two queues with one qstat, which connects to the server
+        for each queue, and return the server log lines of its Connect
+        and Status Queue requests
+        """
+        now = int(time.time())
+        cmd = ['env', 'PBS_CONN_POOL=%d' % pool, self.qstat, '-Q',
+               'workq', 'workq2']
+        ret = self.du.run_cmd(self.server.hostname, cmd, runas=TEST_USER)
+        self.assertEqual(ret['rc'], 0)
+        self.assertEqual(len([l for l in ret['out'] if 'workq' in l]), 2)
+        msg = 'Type %%d request received from %s@' % TEST_USER
+        conn = self.server.log_match(msg % 0, n='ALL', allmatch=True,
+                                     starttime=now)
+        stat = self.server.log_match(msg % 20, n='ALL', allmatch=True,
+                                     starttime=now)
+        return conn, stat
+
+    def test_pool_reuse(self):
+        """
+        With the pool both queues are statused over one connection
+        """
+        conn, stat = self.qstat_queues(1)
+        self.assertEqual(len(conn), 1)
+        self.assertEqual(len(stat), 2)
+        socks = set(l[1].split('sock=')[-1] for l in stat)
+        self.assertEqual(len(socks), 1)
+
+    def test_no_pool(self):
+        """
+        Without the pool qstat connects for each queue
+        """
+        conn, stat = self.qstat_queues(0)
+        self.assertEqual(len(conn), 2)
+        self.assertEqual(len(stat), 2)
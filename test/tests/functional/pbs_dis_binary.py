@@ -0,0 +1,93 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+from tests.functional import *
+
+
+class TestDisBinary(TestFunctional):
+    """
+    Test that clients with PBS_DIS_BINARY set talk to the server with
+    binary DIS integers and get the same results as classic clients
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.bin = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin')
+
+    def run_client(self, binary, cmd):
+        """
+        Run a client command as TEST_USER with PBS_DIS_BINARY set to binary
+        """
+        cmd = ['env', 'PBS_DIS_BINARY=%d' % binary,
+               os.path.join(self.bin, cmd[0])] + cmd[1:]
+        ret = self.du.run_cmd(self.server.hostname, cmd, runas=TEST_USER)
+        self.assertEqual(ret['rc'], 0)
+        return ret['out']
+
+    def test_binary_submit_status(self):
+        """
+        A job submitted by a binary client has the attributes asked for,
+        and qstat -f shows the same status with either codec
+        """
+        jid = self.run_client(1, ['qsub', '-N', 'binjob', '-l',
+                                  'walltime=01:02:03', '-l', 'ncpus=3',
+                                  '-p', '-512', '-a', '203001010000',
+                                  '--', '/bin/sleep', '100'])[0]
+        self.server.expect(JOB, {'job_state': 'W', 'Job_Name': 'binjob',
+                                 'Resource_List.walltime': '01:02:03',
+                                 'Resource_List.ncpus': 3,
+                                 'Priority': -512}, id=jid)
+        classic = self.run_client(0, ['qstat', '-f', jid])
+        binary = self.run_client(1, ['qstat', '-f', jid])
+        self.assertEqual(classic, binary)
+        self.assertIn('binjob', '\n'.join(binary))
+
+    def test_binary_job_requests(self):
+        """
+        Hold, release, alter and delete a job from a binary client
+        """
+        j = Job(TEST_USER)
+        jid = self.server.submit(j)
+        self.run_client(1, ['qhold', jid])
+        self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+        self.run_client(1, ['qrls', jid])
+        self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+        self.run_client(1, ['qalter', '-l', 'walltime=100', jid])
+        self.server.expect(JOB, {'Resource_List.walltime': '00:01:40'},
+                           id=jid)
+        self.run_client(1, ['qdel', jid])
+        self.server.expect(JOB, 'queue', op=UNSET, id=jid)
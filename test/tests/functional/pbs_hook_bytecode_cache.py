@@ -0,0 +1,100 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+
+
+from tests.functional import *
+
+
+class TestHookBytecodeCache(TestFunctional):
+    """
+    Test the compiled bytecode cached next to hook scripts
+    """
+
+    def pc_file(self, daemon, hook_name):
+        """
+        Return the path of the bytecode cache of 'hook_name' for 'daemon'
+        """
+        priv = 'server_priv' if daemon is self.server else 'mom_priv'
+        return os.path.join(daemon.pbs_conf['PBS_HOME'], priv, 'hooks',
+                            hook_name + '.PC')
+
+    def test_server_hook_cache(self):
+        """
+        Importing a server hook writes its cache, a new script content is
+        picked up, and deleting the hook removes the cache
+        """
+        body = """
+import pbs
+pbs.logmsg(pbs.LOG_DEBUG, "cached hook version %d")
+"""
+        a = {'event': 'queuejob', 'enabled': 'True'}
+        self.server.create_import_hook("bc", a, body % 1)
+        pc = self.pc_file(self.server, "bc")
+        self.assertTrue(self.du.isfile(path=pc, sudo=True))
+        self.server.submit(Job(TEST_USER))
+        self.server.log_match("cached hook version 1")
+
+        self.server.import_hook("bc", body % 2)
+        self.server.submit(Job(TEST_USER))
+        self.server.log_match("cached hook version 2")
+
+        self.server.restart()
+        self.server.submit(Job(TEST_USER))
+        self.server.log_match("cached hook version 2")
+
+        self.server.manager(MGR_CMD_DELETE, HOOK, id="bc")
+        self.assertFalse(self.du.isfile(path=pc, sudo=True))
+
+    def test_mom_hook_cache(self):
+        """
+        A MoM hook's cache is written by pbs_python on its first run
+        """
+        body = """
+import pbs
+pbs.logjobmsg(pbs.event().job.id, "cached begin hook ran")
+"""
+        a = {'event': 'execjob_begin', 'enabled': 'True'}
+        self.server.create_import_hook("bc_mom", a, body)
+        for _ in range(2):
+            j = Job(TEST_USER)
+            j.set_sleep_time(1)
+            jid = self.server.submit(j)
+            self.mom.log_match("%s;cached begin hook ran" % jid)
+        pc = self.pc_file(self.mom, "bc_mom")
+        self.assertTrue(self.du.isfile(hostname=self.mom.hostname, path=pc,
+                                       sudo=True))
@@ -0,0 +1,123 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+
+
+from tests.functional import *
+
+
+class TestHookLazyObjects(TestFunctional):
+    """
+    Test that server hook job, queue and server objects whose attribute
+    values are loaded on first access show the same values as before
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+
+    def test_runjob_objects(self):
+        """
+        A runjob hook sees the job, its queue and the server, and can
+        still set the job's Resource_List
+        """
+        hook_body = """
+import pbs
+e = pbs.event()
+j = e.job
+pbs.logmsg(pbs.LOG_DEBUG, "lazy name=%s queue=%s qtype=%s server=%s" %
+           (j.Job_Name, j.queue.name, j.queue.queue_type,
+            j.server.default_queue))
+pbs.logmsg(pbs.LOG_DEBUG, "lazy ncpus=%s" % j.Resource_List['ncpus'])
+j.Resource_List['walltime'] = pbs.duration("00:10:00")
+e.accept()
+"""
+        a = {'event': 'runjob', 'enabled': 'True'}
+        self.server.create_import_hook("lazy_run", a, hook_body)
+        j = Job(TEST_USER, {ATTR_N: 'lazyjob', 'Resource_List.ncpus': 1})
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R',
+                                 'Resource_List.walltime': '00:10:00'},
+                           id=jid)
+        self.server.log_match("lazy name=lazyjob queue=workq "
+                              "qtype=Execution server=workq")
+        self.server.log_match("lazy ncpus=1")
+
+    def test_modifyjob_job_o(self):
+        """
+        A modifyjob hook sees the original job values and can reject
+        the change as read-only values are still enforced
+        """
+        hook_body = """
+import pbs
+e = pbs.event()
+pbs.logmsg(pbs.LOG_DEBUG, "lazy job_o name=%s new name=%s" %
+           (e.job_o.Job_Name, e.job.Job_Name))
+try:
+    e.job_o.Job_Name = "changed"
+except pbs.BadAttributeValueError:
+    pbs.logmsg(pbs.LOG_DEBUG, "lazy job_o is readonly")
+e.accept()
+"""
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        a = {'event': 'modifyjob', 'enabled': 'True'}
+        self.server.create_import_hook("lazy_mod", a, hook_body)
+        j = Job(TEST_USER, {ATTR_N: 'before'})
+        jid = self.server.submit(j)
+        self.server.alterjob(jid, {ATTR_N: 'after'})
+        self.server.log_match("lazy job_o name=before new name=after")
+        self.server.log_match("lazy job_o is readonly")
+        self.server.expect(JOB, {ATTR_N: 'after'}, id=jid)
+
+    def test_server_iteration(self):
+        """
+        Jobs obtained by iterating over the server show their values
+        """
+        hook_body = """
+import pbs
+e = pbs.event()
+names = sorted([j.Job_Name for j in pbs.server().jobs()])
+pbs.logmsg(pbs.LOG_DEBUG, "lazy jobs=%s" % ",".join(names))
+e.accept()
+"""
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        for n in ('one', 'two'):
+            self.server.submit(Job(TEST_USER, {ATTR_N: n}))
+        a = {'event': 'queuejob', 'enabled': 'True'}
+        self.server.create_import_hook("lazy_iter", a, hook_body)
+        self.server.submit(Job(TEST_USER, {ATTR_N: 'three'}))
+        self.server.log_match("lazy jobs=one,two")
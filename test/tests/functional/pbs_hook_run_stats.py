@@ -0,0 +1,102 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+
+
+import re
+
+from tests.functional import *
+
+
+class TestHookRunStats(TestFunctional):
+    """
+    Test the per-hook execution profile reported by the read-only
+    hook attribute run_stats
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+        self.qmgr_path = os.path.join(self.server.pbs_conf['PBS_EXEC'],
+                                      'bin', 'qmgr')
+
+    def list_hook(self, hook_name, attr=None):
+        """
+        Return the output of qmgr "list hook <hook_name> [attr]" as a
+        single string, with continuation lines joined
+        """
+        cmd = 'list hook %s' % hook_name
+        if attr is not None:
+            cmd += ' ' + attr
+        if not self.du.is_localhost(self.server.hostname):
+            cmd = "'" + cmd + "'"
+        ret = self.du.run_cmd(self.server.hostname,
+                              [self.qmgr_path, '-c', cmd], sudo=True)
+        self.assertEqual(ret['rc'], 0)
+        return ''.join([l.strip() for l in ret['out']])
+
+    def test_run_stats(self):
+        """
+        run_stats counts the runs of a queuejob hook, its histogram
+        adds up to the number of runs, and it is only listed when asked
+        for by name
+        """
+        hook_body = """
+import pbs
+pbs.event().accept()
+"""
+        a = {'event': 'queuejob', 'enabled': 'True'}
+        self.server.create_import_hook("stats_hook", a, hook_body)
+
+        out = self.list_hook('stats_hook', 'run_stats')
+        self.assertIn('run_stats = runs=0,', out)
+
+        for _ in range(3):
+            self.server.submit(Job(TEST_USER))
+
+        out = self.list_hook('stats_hook', 'run_stats')
+        m = re.search(r'runs=(\d+),max_ms=[\d.]+,'
+                      r'wall_ms=[\d.]+/[\d.]+/[\d.]+,'
+                      r'cpu_ms=[\d.]+/[\d.]+/[\d.]+,hist=(\S+)', out)
+        self.assertTrue(m is not None, "unexpected run_stats: " + out)
+        self.assertEqual(int(m.group(1)), 3)
+        hist = [int(b.split(':')[1]) for b in m.group(2).split('/')]
+        self.assertEqual(len(hist), 12)
+        self.assertEqual(sum(hist), 3)
+
+        # not part of the full listing, which must stay valid qmgr input
+        self.assertNotIn('run_stats', self.list_hook('stats_hook'))
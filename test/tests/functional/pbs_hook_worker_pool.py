@@ -0,0 +1,136 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+import time
+from tests.functional import *
+
+
+class TestHookWorkerPool(TestFunctional):
+    """
+    Test running MoM hooks through the $hook_worker_pool pbs_python workers
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.mom.add_config({'$logevent': '0xffffffff',
+                             '$hook_worker_pool': 2})
+
+    def test_begin_hook_in_worker(self):
+        """
+        An execjob_begin hook runs in a worker and its result is applied
+        """
+        hook_body = """
+import os
+import pbs
+e = pbs.event()
+pbs.logjobmsg(e.job.id, "begin hook ran in pid %d" % os.getpid())
+e.accept()
+"""
+        a = {'event': 'execjob_begin', 'enabled': 'True'}
+        self.server.create_import_hook("begin", a, hook_body)
+        for _ in range(2):
+            j = Job(TEST_USER)
+            j.set_sleep_time(1)
+            jid = self.server.submit(j)
+            self.mom.log_match("%s;begin hook ran in pid" % jid)
+            self.mom.log_match("hook running in worker")
+            self.server.expect(JOB, 'queue', op=UNSET, id=jid, offset=1)
+
+    def test_rejecting_hook_in_worker(self):
+        """
+        A reject from a hook run in a worker holds the job as before
+        """
+        hook_body = """
+import pbs
+pbs.event().reject("rejected by worker hook")
+"""
+        a = {'event': 'execjob_begin', 'enabled': 'True'}
+        self.server.create_import_hook("reject", a, hook_body)
+        j = Job(TEST_USER)
+        jid = self.server.submit(j)
+        self.mom.log_match("rejected by worker hook")
+        self.mom.log_match("hook running in worker")
+        self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+
+    def test_hook_alarm_in_worker(self):
+        """
+        A hook run in a worker that exceeds its alarm is stopped and the
+        worker keeps serving hooks
+        """
+        hook_body = """
+import pbs
+import time
+if pbs.event().job.Job_Name == "slow":
+    time.sleep(60)
+pbs.event().accept()
+"""
+        a = {'event': 'execjob_begin', 'enabled': 'True', 'alarm': 5}
+        self.server.create_import_hook("slow", a, hook_body)
+        j = Job(TEST_USER, {ATTR_N: 'slow'})
+        jid = self.server.submit(j)
+        self.mom.log_match("alarm call while running execjob_begin hook",
+                           max_attempts=30, interval=2)
+        self.server.delete(jid)
+        j = Job(TEST_USER)
+        j.set_sleep_time(1)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+
+    def test_launch_hook_without_pool(self):
+        """
+        An execjob_launch hook, run from the child MoM forks to start the
+        job, is executed directly and starts no workers
+        """
+        hook_body = """
+import pbs
+e = pbs.event()
+pbs.logjobmsg(e.job.id, "launch hook ran")
+e.accept()
+"""
+        a = {'event': 'execjob_launch', 'enabled': 'True'}
+        self.server.create_import_hook("launch", a, hook_body)
+        now = int(time.time())
+        for _ in range(2):
+            j = Job(TEST_USER)
+            j.set_sleep_time(1)
+            jid = self.server.submit(j)
+            self.mom.log_match("%s;launch hook ran" % jid, starttime=now)
+            self.server.expect(JOB, 'queue', op=UNSET, id=jid, offset=1)
+        self.mom.log_match("hook running in worker", existence=False,
+                           starttime=now, max_attempts=2)
+        self.mom.log_match("started hook worker", existence=False,
+                           starttime=now, max_attempts=2)
@@ -0,0 +1,98 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+import time
+from tests.functional import *
+
+
+class TestJobIndex(TestFunctional):
+    """
+    Test that selections by job state and owner go through the server's
+    job indices and return the same jobs as a full scan
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False',
+                                                  'log_events': 2047})
+        a = {'queue_type': 'execution', 'enabled': 'True',
+             'started': 'True'}
+        self.server.manager(MGR_CMD_CREATE, QUEUE, a, id='workq2')
+        self.held = []
+        self.queued = []
+        self.user1 = []
+        for i in range(6):
+            a = {ATTR_q: 'workq2'} if i % 2 else {}
+            if i % 3 == 0:
+                a[ATTR_h] = None
+            user = TEST_USER1 if i < 2 else TEST_USER
+            jid = self.server.submit(Job(user, attrs=a))
+            (self.held if i % 3 == 0 else self.queued).append(jid)
+            if user == TEST_USER1:
+                self.user1.append(jid)
+
+    def test_select_by_state(self):
+        """
+        qselect -s picks only jobs of the selected states, from the
+        state index, per queue and across queues
+        """
+        now = int(time.time())
+        jids = self.server.select(attrib={'job_state': 'H'})
+        self.assertEqual(sorted(jids), sorted(self.held))
+        self.server.log_match('select by state index', starttime=now)
+        jids = self.server.select(attrib={'job_state': 'H',
+                                          ATTR_q: 'workq2'})
+        self.assertEqual(sorted(jids),
+                         sorted([j for j in self.held
+                                 if self.server.status(JOB, 'queue', id=j)
+                                 [0]['queue'] == 'workq2']))
+        self.server.rlsjob(self.held[0], USER_HOLD)
+        jids = self.server.select(attrib={'job_state': 'Q'})
+        self.assertEqual(sorted(jids),
+                         sorted(self.queued + [self.held[0]]))
+
+    def test_select_by_owner(self):
+        """
+        qselect -u picks only the user's jobs, from the owner index, and
+        keeps the order of a full scan
+        """
+        now = int(time.time())
+        jids = self.server.select(attrib={ATTR_u: str(TEST_USER1)})
+        self.assertEqual(jids, self.user1)
+        self.server.log_match('select by owner index', starttime=now)
+        self.server.deljob(self.user1[0], wait=True)
+        jids = self.server.select(attrib={ATTR_u: str(TEST_USER1)})
+        self.assertEqual(jids, self.user1[1:])
@@ -0,0 +1,188 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+
+import time
+from tests.functional import *
+
+
+class TestJobListOps(TestFunctional):
+    """
+    Test that qdel, qhold, qrls and qsig send one job list request for
+    the jobs of a server and report the jobs it failed for
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False',
+                                                  'log_events': 2047})
+        self.pbs_bin = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin')
+        self.jids = []
+        for _ in range(5):
+            self.jids.append(self.server.submit(Job(TEST_USER)))
+
+    def run_qcmd(self, cmd, args):
+        """
+        Run a PBS command as TEST_USER and return its result
+        """
+        cmd = [os.path.join(self.pbs_bin, cmd)] + args
+        return self.du.run_cmd(self.server.hostname, cmd, runas=TEST_USER)
+
+    def test_hold_release_list(self):
+        """
+        qhold and qrls of several jobs use one request each
+        """
+        now = int(time.time())
+        ret = self.run_qcmd('qhold', self.jids)
+        self.assertEqual(ret['rc'], 0)
+        self.server.log_match('hold request for %d jobs' % len(self.jids),
+                              starttime=now)
+        for jid in self.jids:
+            self.server.expect(JOB, {'Hold_Types': 'u',
+                                     'job_state': 'H'}, id=jid)
+        ret = self.run_qcmd('qrls', self.jids)
+        self.assertEqual(ret['rc'], 0)
+        self.server.log_match('release request for %d jobs' %
+                              len(self.jids), starttime=now)
+        for jid in self.jids:
+            self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+
+    def test_delete_list_with_failures(self):
+        """
+        qdel of a list with an unknown job deletes the other jobs and
+        reports only the unknown one
+        """
+        now = int(time.time())
+        sid = self.jids[0].split('.', 1)[1]
+        bad = '999999.' + sid
+        ret = self.run_qcmd('qdel', self.jids[:2] + [bad] + self.jids[2:])
+        self.assertNotEqual(ret['rc'], 0)
+        self.server.log_match('delete request for %d jobs' %
+                              (len(self.jids) + 1), starttime=now)
+        err = '\n'.join(ret['err'])
+        self.assertIn(bad, err)
+        for jid in self.jids:
+            self.assertNotIn(jid, err)
+            self.server.expect(JOB, 'queue', op=UNSET, id=jid)
+
+    def test_signal_list(self):
+        """
+        qsig of several running jobs suspends them all with one request
+        """
+        self.server.deljob(self.jids, wait=True)
+        a = {'resources_available.ncpus': 4}
+        self.server.manager(MGR_CMD_SET, NODE, a, self.mom.shortname)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        jids = []
+        for _ in range(3):
+            j = Job(TEST_USER, attrs={'Resource_List.ncpus': 1})
+            j.set_sleep_time(1000)
+            jids.append(self.server.submit(j))
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        now = int(time.time())
+        cmd = [os.path.join(self.pbs_bin, 'qsig'), '-s', 'suspend'] + jids
+        ret = self.du.run_cmd(self.server.hostname, cmd, sudo=True)
+        self.assertEqual(ret['rc'], 0)
+        self.server.log_match('signal request for %d jobs' % len(jids),
+                              starttime=now)
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'S'}, id=jid)
+
+    def test_delete_list_mail(self):
+        """
+        Jobs deleted by the manager with one qdel each get the mail sent
+        to their owner, as when they are deleted one at a time
+        """
+        mailfile = os.path.join('/var/mail', str(TEST_USER))
+        if not os.path.isfile(mailfile):
+            self.skip_test("Mail file '%s' does not exist or mail is "
+                           "not setup" % mailfile)
+        now = int(time.time())
+        cmd = [os.path.join(self.pbs_bin, 'qdel')] + self.jids
+        ret = self.du.run_cmd(self.server.hostname, cmd, sudo=True)
+        self.assertEqual(ret['rc'], 0)
+        self.server.log_match('delete request for %d jobs' % len(self.jids),
+                              starttime=now)
+        self.logger.info("Wait 10s for saving the e-mails")
+        time.sleep(10)
+        with open(mailfile, 'r') as f:
+            maillog = [x.strip() for x in f.readlines()[-600:]]
+        for jid in self.jids:
+            self.assertIn('PBS Job Id: ' + jid, maillog)
+
+    def test_delete_subjob_out_of_range(self):
+        """
+        qdel of an array index past the end of the array is rejected,
+        the array job is kept and the server stays up
+        """
+        j = Job(TEST_USER, attrs={ATTR_J: '1-3'})
+        jid = self.server.submit(j)
+        bad = jid.replace('[]', '[999]')
+        ret = self.run_qcmd('qdel', [bad])
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertIn(bad, '\n'.join(ret['err']))
+        self.assertTrue(self.server.isUp(), 'server died')
+        self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+        ret = self.run_qcmd('qdel', [jid.replace('[]', '[2-999]')])
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertTrue(self.server.isUp(), 'server died')
+        self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+
+    def test_delete_subjob_range_running(self):
+        """
+        qdel of a range of subjobs, some of them running, deletes them
+        all, together with other jobs of the same list
+        """
+        a = {'resources_available.ncpus': 2}
+        self.server.manager(MGR_CMD_SET, NODE, a, self.mom.shortname)
+        j = Job(TEST_USER, attrs={ATTR_J: '1-4',
+                                  'Resource_List.ncpus': 1})
+        j.set_sleep_time(1000)
+        jid = self.server.submit(j)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        self.server.expect(JOB, {'job_state': 'B'}, id=jid)
+        self.server.expect(JOB, {'job_state': 'R'},
+                           id=jid.replace('[]', '[1]'))
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        ret = self.run_qcmd('qdel', [jid.replace('[]', '[1-4]')] +
+                            self.jids)
+        self.assertEqual(ret['rc'], 0)
+        self.assertTrue(self.server.isUp(), 'server died')
+        self.server.expect(JOB, 'queue', op=UNSET, id=jid)
+        for i in self.jids:
+            self.server.expect(JOB, 'queue', op=UNSET, id=i)
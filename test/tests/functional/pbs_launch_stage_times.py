@@ -0,0 +1,83 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestLaunchStageTimes(TestFunctional):
+    """
+    Test that Mother Superior logs the latency of each stage of a
+    multi-node job launch
+    """
+
+    def setUp(self):
+        if len(self.moms) < 2:
+            self.skip_test(reason="need 2 mom hosts: -p moms=<m1>:<m2>")
+        TestFunctional.setUp(self)
+        self.momA = self.moms.values()[0]
+        self.momB = self.moms.values()[1]
+        for mom in (self.momA, self.momB):
+            mom.add_config({'$logevent': '0xffffffff'})
+        self.server.expect(NODE, {'state': 'free'}, id=self.momA.shortname)
+        self.server.expect(NODE, {'state': 'free'}, id=self.momB.shortname)
+
+    def test_launch_stage_times(self):
+        """
+        Run a job across two MoMs and check that the join and start
+        latencies are reported by Mother Superior only
+        """
+        a = {'Resource_List.select': '2:ncpus=1',
+             'Resource_List.place': 'scatter'}
+        j = Job(TEST_USER, attrs=a)
+        j.set_sleep_time(30)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        st = self.server.status(JOB, 'exec_host', id=jid)
+        ms = st[0]['exec_host'].split('/')[0]
+        if ms == self.momA.shortname:
+            momMS, momSis = self.momA, self.momB
+        else:
+            momMS, momSis = self.momB, self.momA
+        momMS.log_match(
+            "%s;launch: 1 sisters joined in [0-9.]+ secs, "
+            "first reply after [0-9.]+ secs" % jid, regexp=True)
+        momMS.log_match(
+            "%s;launch: job started [0-9.]+ secs after JOIN_JOB "
+            "was sent" % jid, regexp=True)
+        momSis.log_match("%s;launch:" % jid, existence=False,
+                         max_attempts=5)
@@ -0,0 +1,114 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+
+
+import re
+
+from tests.functional import *
+
+
+class TestMomHookSyncBatch(TestFunctional):
+    """
+    Test that pending mom hook updates are sent out in batches of at
+    most sync_mom_hookfiles_batch moms
+    """
+
+    def setUp(self):
+        if len(self.moms) != 2:
+            self.skip_test(reason="need 2 mom hosts: -p moms=<m1>:<m2>")
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+        self.momA = self.moms.values()[0]
+        self.momB = self.moms.values()[1]
+
+    def test_batch_attribute(self):
+        """
+        sync_mom_hookfiles_batch must be a positive number
+        """
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'sync_mom_hookfiles_batch': 5})
+        self.server.expect(SERVER, {'sync_mom_hookfiles_batch': 5})
+        with self.assertRaises(PbsManagerError):
+            self.server.manager(MGR_CMD_SET, SERVER,
+                                {'sync_mom_hookfiles_batch': 0})
+
+    def test_one_mom_per_batch(self):
+        """
+        With a batch size of one, a new mom hook reaches both moms, one
+        mom at a time
+        """
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'sync_mom_hookfiles_batch': 1})
+        hook_body = "import pbs\n"
+        a = {'event': 'execjob_begin', 'enabled': 'True'}
+        self.server.create_import_hook("batch_hook", a, hook_body)
+
+        self.server.log_match("sending hook updates to 1 of 2 moms with "
+                              "pending hook updates")
+        for mom in [self.momA, self.momB]:
+            self.server.log_match(
+                'successfully sent hook file.*batch_hook.PY ' +
+                'to %s.*' % mom.hostname, max_attempts=30, regexp=True)
+        self.server.log_match("sending hook updates to 1 of 1 moms with "
+                              "pending hook updates")
+
+    def test_bundle_acked_by_hash(self):
+        """
+        The files of a new mom hook go out as one hook bundle, and each
+        mom acknowledges the bundle by its hash
+        """
+        hook_body = "import pbs\n"
+        a = {'event': 'execjob_begin', 'enabled': 'True'}
+        now = int(time.time())
+        self.server.create_import_hook("bundle_hook", a, hook_body)
+
+        for mom in [self.momA, self.momB]:
+            self.server.log_match(
+                'successfully sent hook file.*bundle_hook.PY ' +
+                'to %s.*' % mom.hostname, starttime=now,
+                max_attempts=30, regexp=True)
+            ack = self.server.log_match(
+                'hook bundle [0-9a-f]{64} for hook bundle_hook ' +
+                'acknowledged by %s' % mom.hostname, starttime=now,
+                max_attempts=30, regexp=True)
+            bundle = re.search('hook bundle ([0-9a-f]{64})', ack[1]).group(1)
+            self.server.log_match(
+                'multicast hook bundle %s for hook bundle_hook' % bundle,
+                starttime=now)
+            mom.log_match('%s;copy hook bundle request received' % bundle,
+                          starttime=now)
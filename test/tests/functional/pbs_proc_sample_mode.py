@@ -0,0 +1,121 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+from tests.functional import *
+
+
+class TestProcSampleMode(TestFunctional):
+    """
+    Test the $proc_sample_mode MoM configuration
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        if self.mom.is_cpuset_mom():
+            self.skipTest("cpuset MoMs scan /proc through the PID cache")
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'job_history_enable': 'True'})
+        self.mom.add_config({'$logevent': '0xffffffff',
+                             '$min_check_poll': 5,
+                             '$max_check_poll': 10})
+
+    def run_busy_job(self):
+        """
+        Submit a job whose cpu time is consumed by forked children
+        and check that it is accounted
+        """
+        script = (
+            "for i in 1 2; do\n"
+            "  ( t=$((SECONDS + 15)); while [ $SECONDS -lt $t ]; do :; "
+            "done ) &\n"
+            "done\n"
+            "wait\n"
+        )
+        j = Job(TEST_USER)
+        j.create_script(body=script)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.server.expect(JOB, {ATTR_state: 'F'}, id=jid, extend='x',
+                           offset=15)
+        self.server.expect(JOB, {'resources_used.cput': '00:00:10'},
+                           op=GE, id=jid, extend='x')
+        return jid
+
+    def test_proc_sample_mode_full(self):
+        """
+        Test that the default full /proc scan accounts job cpu time
+        """
+        self.mom.add_config({'$proc_sample_mode': 'full'})
+        self.run_busy_job()
+
+    def test_proc_sample_mode_session(self):
+        """
+        Test that tracking job processes through kernel events
+        accounts the cpu time of processes forked after the job started
+        """
+        self.mom.add_config({'$proc_sample_mode': 'session'})
+        self.run_busy_job()
+        self.mom.log_match("tracked procs:", max_attempts=5)
+
+    def test_proc_sample_mode_cgroup(self):
+        """
+        Test that cgroup mode tracks job processes, and falls back to
+        process sums for a job without a cgroup
+        """
+        self.mom.add_config({'$proc_sample_mode': 'cgroup'})
+        jid = self.run_busy_job()
+        self.server.expect(JOB, 'resources_used.mem', op=SET, id=jid,
+                           extend='x')
+        self.mom.log_match("tracked procs:", max_attempts=5)
+        # no cgroups hook is enabled, so the job has no cgroup
+        self.mom.log_match(
+            "%s;no job cgroup, resources_used from process sums" % jid,
+            max_attempts=5)
+
+    def test_restrict_user_session(self):
+        """
+        Test that $restrict_user still sees processes outside of jobs
+        when only job processes are sampled
+        """
+        self.mom.add_config({'$proc_sample_mode': 'session',
+                             '$restrict_user': 'True'})
+        self.run_busy_job()
+        cmd = ['sh', '-c', 'nohup sleep 300 > /dev/null 2>&1 &']
+        ret = self.du.run_cmd(self.mom.hostname, cmd, runas=TEST_USER)
+        self.assertEqual(ret['rc'], 0)
+        self.mom.log_match(r"killed uid \d+ pid \d+\(sleep\)", regexp=True,
+                           max_attempts=10)
@@ -0,0 +1,110 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+import time
+from tests.functional import *
+
+
+class TestRequestTrace(TestFunctional):
+    """
+    Test request tracing with PBS_TRACE and the pbs_tracereport tool
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.du.set_pbs_config(confs={'PBS_TRACE': 1}, append=True)
+        PBSInitServices().restart()
+        self.assertTrue(self.server.isUp(), 'server did not come back')
+
+    def trace_file(self, logdir):
+        return os.path.join(self.server.pbs_conf['PBS_HOME'], logdir,
+                            'trace')
+
+    def report(self, jid):
+        """
+        Run pbs_tracereport on the traces of all daemons for jid
+        """
+        cmd = [os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                            'pbs_tracereport'), '-v', '-j', jid]
+        cmd += [self.trace_file(d) for d in ['server_logs', 'sched_logs',
+                                             'mom_logs']]
+        ret = self.server.du.run_cmd(self.server.hostname, cmd, sudo=True)
+        self.assertEqual(ret['rc'], 0, 'pbs_tracereport failed: %s' % ret)
+        return ret['out']
+
+    def test_job_traced_to_exec(self):
+        """
+        A submitted job's trace id reaches the server and the MoM, and
+        pbs_tracereport gives a complete latency breakdown once it runs
+        """
+        self.server.log_match('request tracing enabled', starttime=0)
+        j = Job(TEST_USER)
+        j.set_sleep_time(30)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+
+        out = []
+        for _ in range(10):
+            out = self.report(jid)
+            if out and [l for l in out if ' exec ' in l]:
+                break
+            time.sleep(2)
+        self.logger.info('\n'.join(out))
+        self.assertTrue(len(out) > 2, 'no spans for %s' % jid)
+        row = out[1].split()
+        self.assertEqual(row[0], jid)
+        self.assertFalse('--' in row[1:], 'incomplete breakdown: %s' % row)
+
+        # the spans of the submission before the job id existed are
+        # joined by trace id, and the MoM got the same trace id
+        spans = [l.split() for l in out[2:]]
+        trace = [s[3] for s in spans if s[2] == 'quejob' and
+                 s[1] == 'server'][0]
+        self.assertNotEqual(trace, '-')
+        self.assertTrue([s for s in spans if s[2] == 'request.1' and
+                         s[3] == trace])
+        self.assertTrue([s for s in spans if s[1] == 'mom' and
+                         s[2] == 'exec' and s[3] == trace])
+        self.assertTrue([s for s in spans if s[1] == 'sched' and
+                         s[2] == 'run'])
+
+    def tearDown(self):
+        confs = self.du.parse_pbs_config()
+        if 'PBS_TRACE' in confs:
+            del confs['PBS_TRACE']
+            self.du.set_pbs_config(confs=confs, append=False)
+            PBSInitServices().restart()
+        TestFunctional.tearDown(self)
@@ -0,0 +1,93 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+from tests.functional import *
+
+
+class TestRescUsedUpdate(TestFunctional):
+    """
+    Test the periodic resources_used updates from MoM, which carry only
+    the values changed since the previous update
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.mom.add_config({'$min_check_poll': 5,
+                             '$max_check_poll': 10})
+
+    def submit_busy_job(self):
+        """
+        Submit a job that burns cpu for a while and wait for it to run
+        """
+        script = (
+            "t=$((SECONDS + 60)); while [ $SECONDS -lt $t ]; do :; done\n"
+        )
+        j = Job(TEST_USER)
+        j.create_script(body=script)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        return jid
+
+    def test_resc_used_updates(self):
+        """
+        Test that resources_used keeps being updated while the job runs
+        and that values which do not change are kept by the server
+        """
+        jid = self.submit_busy_job()
+        self.server.expect(JOB, {'resources_used.cput': '00:00:05'},
+                           op=GE, id=jid, offset=10)
+        self.server.expect(JOB, 'resources_used.ncpus', op=SET, id=jid)
+        self.server.expect(JOB, 'resources_used.mem', op=SET, id=jid)
+        self.server.expect(JOB, {'resources_used.cput': '00:00:15'},
+                           op=GE, id=jid, offset=10)
+        self.server.expect(JOB, 'resources_used.ncpus', op=SET, id=jid)
+        self.server.expect(JOB, 'resources_used.mem', op=SET, id=jid)
+
+    def test_resc_used_after_server_restart(self):
+        """
+        Test that MoM sends all resources_used values again after the
+        server restarts
+        """
+        jid = self.submit_busy_job()
+        self.server.expect(JOB, {'resources_used.cput': '00:00:05'},
+                           op=GE, id=jid, offset=10)
+        self.server.restart()
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.server.expect(JOB, 'resources_used.ncpus', op=SET, id=jid)
+        self.server.expect(JOB, 'resources_used.vmem', op=SET, id=jid)
+        self.server.expect(JOB, {'resources_used.cput': '00:00:20'},
+                           op=GE, id=jid)
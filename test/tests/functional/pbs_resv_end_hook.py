@@ -595,3 +595,29 @@ if e.type == pbs.RESV_END:
               (self.server.hostname.lower(), rid)
         self.server.log_match(msg, tail=True, max_attempts=10,
                               existence=False)
+
+    def test_hook_runs_in_child(self):
+        """
+        Testcase to verify that the resvend hook is run by a child of
+        the server rather than by the server itself.
+        """
+        hook_script = """
+import pbs
+import os
+pbs.logmsg(pbs.LOG_DEBUG, 'resvend pid=%d ppid=%d' %
+           (os.getpid(), os.getppid()))
+"""
+        self.server.import_hook(self.hook_name, hook_script)
+
+        offset = 10
+        duration = 30
+        rid = self.submit_resv(offset, duration)
+
+        attrs = {'reserve_state': (MATCH_RE, 'RESV_CONFIRMED|2')}
+        self.server.expect(RESV, attrs, id=rid)
+
+        self.server.delete(rid)
+        svr_pid = self.server.get_pid()
+        msg = 'resvend pid=[0-9]+ ppid=%s' % svr_pid
+        self.server.log_match(msg, regexp=True, tail=True, interval=2,
+                              max_attempts=30)
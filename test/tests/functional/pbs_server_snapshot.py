@@ -0,0 +1,134 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+import time
+from tests.functional import *
+
+
+class TestServerSnapshot(TestFunctional):
+    """
+    Test the server job snapshot and journal set by PBS_SNAPSHOT_INTERVAL
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.du.set_pbs_config(confs={'PBS_SNAPSHOT_INTERVAL': 3600},
+                               append=True)
+        self.server.restart()
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'scheduling': 'False'})
+
+    # attributes a restart may change, left out of the comparisons
+    volatile = ['mtime']
+
+    def make_jobs(self):
+        """
+        Queue the jobs whose state a snapshot has to carry: jobs with a
+        long environment, a held job, an array job and a job altered
+        after it was submitted, and return their ids
+        """
+        jids = []
+        for i in range(3):
+            j = Job(TEST_USER, attrs={ATTR_N: 'snap%d' % i,
+                                      ATTR_v: 'SNAP_PAD=%s' % ('x' * 2000)})
+            jids.append(self.server.submit(j))
+        j = Job(TEST_USER, attrs={ATTR_h: None})
+        jids.append(self.server.submit(j))
+        j = Job(TEST_USER, attrs={ATTR_J: '1-3'})
+        jids.append(self.server.submit(j))
+        j = Job(TEST_USER)
+        jid = self.server.submit(j)
+        self.server.alterjob(jid, {ATTR_N: 'snapalt', ATTR_p: '10'})
+        jids.append(jid)
+        return jids
+
+    def job_attrs(self, jids):
+        """
+        Return every attribute of the jobs but the volatile ones
+        """
+        ret = {}
+        for jid in jids:
+            st = self.server.status(JOB, id=jid)[0]
+            ret[jid] = dict((k, v) for k, v in st.items()
+                            if k not in self.volatile)
+        return ret
+
+    def test_snapshot_restart(self):
+        """
+        A clean restart writes a final snapshot and rebuilds every job
+        from it with the same attributes
+        """
+        jids = self.make_jobs()
+        before = self.job_attrs(jids)
+        start = int(time.time())
+        self.server.restart()
+        self.server.log_match('final snapshot written', starttime=start)
+        self.server.log_match('snapshot: %d jobs rebuilt' % len(jids),
+                              starttime=start)
+        self.assertEqual(before, self.job_attrs(jids))
+
+    def test_journal_replay(self):
+        """
+        Changes made after the snapshot survive a killed server through
+        the journal, and deleted jobs stay deleted
+        """
+        jids = self.make_jobs()
+        self.server.restart()
+        self.server.alterjob(jids[0], {ATTR_N: 'altered',
+                                       ATTR_p: '100'})
+        self.server.deljob(jids[1], wait=True)
+        self.server.alterjob(jids[2], {'Resource_List.walltime': 500})
+        keep = [jids[0]] + jids[2:]
+        before = self.job_attrs(keep)
+        start = int(time.time())
+        self.server.signal('-KILL')
+        self.server.start()
+        self.assertTrue(self.server.isUp(), 'server did not come back')
+        self.server.log_match('snapshot: .* jobs rebuilt', regexp=True,
+                              starttime=start)
+        self.assertEqual(before, self.job_attrs(keep))
+        self.assertEqual(self.job_attrs(keep)[jids[0]]['Job_Name'],
+                         'altered')
+        self.assertRaises(PbsStatusError, self.server.status, JOB,
+                          id=jids[1])
+
+    def tearDown(self):
+        confs = self.du.parse_pbs_config()
+        if 'PBS_SNAPSHOT_INTERVAL' in confs:
+            del confs['PBS_SNAPSHOT_INTERVAL']
+            self.du.set_pbs_config(confs=confs, append=False)
+            self.server.restart()
+        TestFunctional.tearDown(self)
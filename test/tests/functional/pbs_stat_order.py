@@ -0,0 +1,100 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestStatOrder(TestFunctional):
+    """
+    Test that the server sorts and pages the jobs of a status request
+    given qstat -O
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.qstat = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                                  'qstat')
+        self.jids = []
+        for wt in [300, 100, 500, 200, 400]:
+            j = Job(TEST_USER, attrs={'Resource_List.walltime': wt})
+            self.jids.append(self.server.submit(j))
+
+    def qstat_ids(self, args):
+        """
+        Run qstat -a -w with args and return the job ids it lists
+        """
+        cmd = [self.qstat, '-a', '-w'] + args
+        ret = self.du.run_cmd(self.server.hostname, cmd, runas=TEST_USER)
+        self.assertEqual(ret['rc'], 0)
+        ids = []
+        for line in ret['out']:
+            fields = line.split()
+            if fields and fields[0][0].isdigit():
+                ids.append(fields[0])
+        return ids
+
+    def test_sort_limit(self):
+        """
+        Jobs come sorted on a resource, and limit and offset select
+        the page
+        """
+        by_wt = [self.jids[i] for i in [2, 4, 0, 3, 1]]
+        ids = self.qstat_ids(['-O', 'sort=-Resource_List.walltime'])
+        self.assertEqual(ids, by_wt)
+        ids = self.qstat_ids(['-O',
+                              'sort=-Resource_List.walltime,limit=2'])
+        self.assertEqual(ids, by_wt[:2])
+        ids = self.qstat_ids(['-O', 'sort=-Resource_List.walltime,'
+                              'offset=2,limit=2'])
+        self.assertEqual(ids, by_wt[2:4])
+
+    def test_select_sort(self):
+        """
+        The jobs selected with -u are sorted and paged as well
+        """
+        ids = self.qstat_ids(['-u', str(TEST_USER), '-O',
+                              'sort=Resource_List.walltime,limit=3'])
+        self.assertEqual(ids, [self.jids[i] for i in [1, 3, 0]])
+
+    def test_bad_order(self):
+        """
+        An unknown sort attribute is rejected
+        """
+        cmd = [self.qstat, '-O', 'sort=nosuchattr']
+        ret = self.du.run_cmd(self.server.hostname, cmd, runas=TEST_USER)
+        self.assertNotEqual(ret['rc'], 0)
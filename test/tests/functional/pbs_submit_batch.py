@@ -0,0 +1,104 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+
+import time
+from tests.functional import *
+
+
+class TestSubmitBatch(TestFunctional):
+    """
+    Test that qsub --batch submits the jobs of a file over one
+    connection and reports the lines it could not submit
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False',
+                                                  'log_events': 2047})
+        self.qsub = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                                 'qsub')
+        self.script = self.du.create_temp_file(
+            asuser=TEST_USER, body='#PBS -N batchjob\n/bin/sleep 100\n')
+
+    def run_batch(self, lines):
+        """
+        Write lines to a batch file and submit it with qsub --batch
+        """
+        fn = self.du.create_temp_file(asuser=TEST_USER,
+                                      body='\n'.join(lines) + '\n')
+        return self.du.run_cmd(self.server.hostname,
+                               [self.qsub, '--batch', fn], runas=TEST_USER)
+
+    def test_batch_submit(self):
+        """
+        All the jobs of a batch file are queued, with the attributes of
+        their line and script, and their ids are printed in order
+        """
+        now = int(time.time())
+        lines = ['# comment', '']
+        for i in range(20):
+            lines.append('-l walltime=%d %s' % (100 + i, self.script))
+        lines.append('-N cmdjob -- /bin/sleep 100')
+        ret = self.run_batch(lines)
+        self.assertEqual(ret['rc'], 0)
+        self.assertEqual(len(ret['out']), 21)
+        self.server.log_match('batch submission from', starttime=now)
+        for i, jid in enumerate(ret['out'][:20]):
+            self.server.expect(JOB, {'job_state': 'Q',
+                                     'Job_Name': 'batchjob',
+                                     'Resource_List.walltime':
+                                     '00:01:%02d' % (40 + i)}, id=jid)
+        self.server.expect(JOB, {'job_state': 'Q', 'Job_Name': 'cmdjob'},
+                           id=ret['out'][20])
+
+    def test_batch_submit_errors(self):
+        """
+        Lines that cannot be submitted are reported with their number,
+        the other jobs are still queued
+        """
+        lines = [self.script,
+                 '-l nosuchresource=1 %s' % self.script,
+                 '-N nojob',
+                 self.script]
+        ret = self.run_batch(lines)
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertEqual(len(ret['out']), 2)
+        err = '\n'.join(ret['err'])
+        self.assertIn('line 2:', err)
+        self.assertIn('line 3:', err)
+        for jid in ret['out']:
+            self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
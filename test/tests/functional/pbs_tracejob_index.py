@@ -0,0 +1,156 @@
+# coding: utf-8
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+from tests.functional import *
+import time
+
+
+class TestTracejobIndex(TestFunctional):
+    """
+    Test the log index files written with PBS_LOG_INDEX and read by
+    tracejob
+    """
+
+    def tracejob(self, jid):
+        """
+        Run tracejob for jid on the server host, return its output lines
+        """
+        cmd = [os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                            'tracejob'), '-z', '-v', jid]
+        ret = self.server.du.run_cmd(self.server.hostname, cmd, sudo=True)
+        self.assertEqual(ret['rc'], 0, 'tracejob failed: %s' % ret)
+        return ret
+
+    def test_index_written_and_used(self):
+        """
+        With PBS_LOG_INDEX set the server log and accounting log get an
+        index naming the job, and tracejob reports the same lines with
+        and without the index
+        """
+        self.du.set_pbs_config(confs={'PBS_LOG_INDEX': 1}, append=True)
+        self.assertTrue(self.server.restart(), 'Failed to restart server')
+        j = Job(TEST_USER, attrs={ATTR_h: None})
+        jid = self.server.submit(j)
+        self.server.accounting_match(';Q;%s;' % jid)
+
+        day = time.strftime('%Y%m%d')
+        home = self.server.pbs_conf['PBS_HOME']
+        for sub in [os.path.join('server_logs', day),
+                    os.path.join('server_priv', 'accounting', day)]:
+            idx = os.path.join(home, sub + '.idx')
+            ret = self.server.du.run_cmd(self.server.hostname,
+                                         ['grep', ' %s$' % jid, idx],
+                                         sudo=True)
+            self.assertEqual(ret['rc'], 0, '%s not in %s' % (jid, idx))
+
+        with_index = self.tracejob(jid)
+        self.assertFalse([l for l in with_index['err']
+                          if 'does not match the log' in l])
+        self.assertTrue([l for l in with_index['out']
+                         if 'Job Queued at request of' in l])
+
+        idx = os.path.join(home, 'server_logs', day + '.idx')
+        self.server.du.run_cmd(self.server.hostname,
+                               ['mv', idx, idx + '.save'], sudo=True)
+        without_index = self.tracejob(jid)
+        self.server.du.run_cmd(self.server.hostname,
+                               ['mv', idx + '.save', idx], sudo=True)
+        self.assertEqual(with_index['out'], without_index['out'])
+
+    def test_index_started_late(self):
+        """
+        Lines logged before PBS_LOG_INDEX was turned on are not in the
+        index but are still reported by tracejob
+        """
+        j = Job(TEST_USER, attrs={ATTR_h: None})
+        jid = self.server.submit(j)
+        self.server.log_match('%s;Job Queued at request of' % jid,
+                              max_attempts=10)
+        self.du.set_pbs_config(confs={'PBS_LOG_INDEX': 1}, append=True)
+        self.assertTrue(self.server.restart(), 'Failed to restart server')
+
+        day = time.strftime('%Y%m%d')
+        idx = os.path.join(self.server.pbs_conf['PBS_HOME'], 'server_logs',
+                           day + '.idx')
+        ret = self.server.du.run_cmd(self.server.hostname,
+                                     ['grep', '^#start ', idx], sudo=True)
+        self.assertEqual(ret['rc'], 0, 'no start offset in %s' % idx)
+
+        ret = self.tracejob(jid)
+        self.assertTrue([l for l in ret['out']
+                         if 'Job Queued at request of' in l])
+
+    def test_index_other_classes(self):
+        """
+        A line that names a job under another class than Job, here the
+        Request line logged when MoM rejects a signal, is in the index,
+        and tracejob reports it as it does without the index
+        """
+        self.du.set_pbs_config(confs={'PBS_LOG_INDEX': 1}, append=True)
+        self.assertTrue(self.server.restart(), 'Failed to restart server')
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+        j = Job(TEST_USER)
+        j.set_sleep_time(1000)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        try:
+            self.server.sigjob(jid, 'SIGNOSUCH')
+        except PbsSignalError:
+            pass
+        msg = 'Execution server rejected request'
+        line = self.server.log_match('%s;%s' % (jid, msg))[1]
+        self.assertEqual(line.split(';')[3], 'Req')
+
+        with_index = self.tracejob(jid)
+        self.assertTrue([l for l in with_index['out'] if msg in l])
+
+        day = time.strftime('%Y%m%d')
+        idx = os.path.join(self.server.pbs_conf['PBS_HOME'], 'server_logs',
+                           day + '.idx')
+        self.server.du.run_cmd(self.server.hostname,
+                               ['mv', idx, idx + '.save'], sudo=True)
+        without_index = self.tracejob(jid)
+        self.server.du.run_cmd(self.server.hostname,
+                               ['mv', idx + '.save', idx], sudo=True)
+        self.assertEqual(with_index['out'], without_index['out'])
+
+    def tearDown(self):
+        confs = self.du.parse_pbs_config()
+        if 'PBS_LOG_INDEX' in confs:
+            del confs['PBS_LOG_INDEX']
+            self.du.set_pbs_config(confs=confs, append=False)
+            PBSInitServices().restart()
+        TestFunctional.tearDown(self)
@@ -0,0 +1,108 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+from tests.performance import *
+
+
+class TestDisThroughput(TestPerformance):
+    """
+    Measure the rate at which a large job status reply is encoded by the
+    server, sent, and decoded by qstat
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.njobs = 100000
+        self.qstat = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                                  'qstat')
+
+    def submit_jobs(self, binary, njobs):
+        """
+        Queue njobs jobs with one qsub --batch, with Data-is-Strings or
+        binary DIS integers, and log the time taken
+        """
+        qsub = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin', 'qsub')
+        body = '-N disperf -- /bin/sleep 1000\n' * njobs
+        fn = self.du.create_temp_file(asuser=TEST_USER, body=body)
+        cmd = ['env', 'PBS_DIS_BINARY=%d' % binary, qsub, '--batch', fn]
+        start = time.time()
+        ret = self.du.run_cmd(self.server.hostname, cmd, runas=TEST_USER)
+        elapsed = time.time() - start
+        self.assertEqual(ret['rc'], 0)
+        self.logger.info("qsub --batch of %d jobs, %s DIS: %.2f sec" %
+                         (njobs, 'binary' if binary else 'classic',
+                          elapsed))
+
+    def stat_time(self, binary):
+        """
+        Status all jobs with qstat -f a few times, with Data-is-Strings or
+        binary DIS integers, and return the best time and the reply size
+        """
+        qstat = 'PBS_DIS_BINARY=%d %s -f' % (binary, self.qstat)
+        times = []
+        for _ in range(3):
+            start = time.time()
+            ret = self.du.run_cmd(self.server.hostname,
+                                  qstat + ' > /dev/null', as_script=True)
+            times.append(time.time() - start)
+            self.assertEqual(ret['rc'], 0)
+        ret = self.du.run_cmd(self.server.hostname, qstat + ' | wc -c',
+                              as_script=True)
+        size = int(ret['out'][0])
+        best = min(times)
+        self.logger.info("qstat -f of %d jobs, %s DIS: %s sec, best %.2f "
+                         "sec, %.1f MB/s" %
+                         (self.njobs, 'binary' if binary else 'classic',
+                          ', '.join('%.2f' % t for t in times), best,
+                          size / best / (1024 * 1024)))
+        return best, size
+
+    @timeout(7200)
+    def test_status_100k_jobs(self):
+        """
+        Submit 100000 jobs, half with classic and half with binary DIS
+        integers, then status them with qstat -f with each, and log the
+        time taken and the throughput of the reply
+        """
+        self.submit_jobs(0, self.njobs // 2)
+        self.submit_jobs(1, self.njobs // 2)
+        self.server.expect(SERVER, {'total_jobs': self.njobs})
+        classic, csize = self.stat_time(0)
+        binary, bsize = self.stat_time(1)
+        self.assertEqual(csize, bsize)
+        self.logger.info("binary DIS status took %.0f%% of the classic time"
+                         % (binary * 100.0 / classic))
@@ -0,0 +1,105 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2018 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# PBS Pro is free software. You can redistribute it and/or modify it under the
+# terms of the GNU Affero General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option) any
+# later version.
+#
+# PBS Pro is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.
+# See the GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# For a copy of the commercial license terms and conditions,
+# go to: (http://www.pbspro.com/UserArea/agreement.html)
+# or contact the Altair Legal Department.
+#
+# Altair’s dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of PBS Pro and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair’s trademarks, including but not limited to "PBS™",
+# "PBS Professional®", and "PBS Pro™" and Altair’s logos is subject to Altair's
+# trademark licensing policies.
+
+
+from tests.performance import *
+
+
+class TestHookEventPerf(TestPerformance):
+    """
+    Measure the cost a queuejob hook adds to each job submission
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.njobs = 1000
+
+    def submit_time(self):
+        """
+        Submit self.njobs jobs and return the time taken in seconds
+        """
+        start = time.time()
+        for _ in range(self.njobs):
+            self.server.submit(Job(TEST_USER))
+        elapsed = time.time() - start
+        self.server.cleanup_jobs()
+        return elapsed
+
+    @timeout(1800)
+    def test_queuejob_hook_overhead(self):
+        """
+        Compare submission time without a hook, with a hook that only
+        reads the submitted job, and with a hook that also walks the
+        server's queues and jobs
+        """
+        base = self.submit_time()
+
+        job_only = """
+import pbs
+e = pbs.event()
+if e.job.Resource_List['ncpus'] > 1000:
+    e.reject("too many cpus")
+s = pbs.server()
+e.accept()
+"""
+        a = {'event': 'queuejob', 'enabled': 'True'}
+        self.server.create_import_hook("perf_q", a, job_only)
+        t_job = self.submit_time()
+
+        walk = """
+import pbs
+e = pbs.event()
+s = pbs.server()
+n = 0
+for q in s.queues():
+    n += 1
+for j in s.jobs():
+    n += 1
+e.accept()
+"""
+        self.server.manager(MGR_CMD_SET, HOOK, {'enabled': 'False'},
+                            'perf_q')
+        self.server.create_import_hook("perf_walk", a, walk)
+        t_walk = self.submit_time()
+
+        self.logger.info("%d submissions: no hook %.2fs, job-only hook "
+                         "%.2fs (%.2f ms/job), walking hook %.2fs "
+                         "(%.2f ms/job)" %
+                         (self.njobs, base, t_job,
+                          (t_job - base) * 1000.0 / self.njobs, t_walk,
+                          (t_walk - base) * 1000.0 / self.njobs))